@@ -62,9 +62,8 @@ void ABCcoeff(Cylinder_t *cylinder)
 {
 #ifdef _CYLIMGSTRESS
   int i,j,nzq;
-  fftw_complex *in, *out;
-  fftw_plan plan;
   fftw_complex *tq, *tr, *tz;
+  fftw_complex *T[3], *t[3];
   
   COMPLEX tr_ji, tq_ji, tz_ji;
   
@@ -72,9 +71,11 @@ void ABCcoeff(Cylinder_t *cylinder)
   tr = (fftw_complex *) fftw_malloc(sizeof(fftw_complex)*nz*nq);
   tz = (fftw_complex *) fftw_malloc(sizeof(fftw_complex)*nz*nq);
   
-  fourier_transform_forward(Tr,tr,nz,nq);
-  fourier_transform_forward(Tq,tq,nz,nq);
-  fourier_transform_forward(Tz,tz,nz,nq);
+  T[0] = Tr;  t[0] = tr;
+  T[1] = Tq;  t[1] = tq;
+  T[2] = Tz;  t[2] = tz;
+
+  fourier_transform_tractions(&cylinder->tractionFFT,T,t);
   
   nzq = nz*nq;
   
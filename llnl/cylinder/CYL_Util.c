@@ -236,12 +236,18 @@ void CYL_Init(Home_t *home,Cylinder_t **cyl_ptr)
 #ifdef  _CYLIMGSTRESS
   /* Allocate dynamic arrays */
   CYL_allocations(cylinder);
+
+  /* plan the surface field transforms */
+  fourier_transform_tractions_init(home,&cylinder->tractionFFT,
+				   cylinder->nz,cylinder->nq,3);
+  fourier_transform_inverse_init(home,&cylinder->inverseFFT,
+				 cylinder->nz,cylinder->nq,6);
   
   /* compute kz and kq */
   CYL_Create_Grids(home, cylinder);
 
   /* compute the matrices */
-  CYL_Create_Matrices(cylinder);
+  CYL_Create_Matrices(home, cylinder);
 #endif
 }
 
@@ -348,6 +354,10 @@ void CYL_Finish(Cylinder_t * cylinder)
       free(cylinder->rectgrids[i]);
     }
 
+#ifdef _CYLIMGSTRESS
+  fourier_transform_tractions_free(&cylinder->tractionFFT);
+  fourier_transform_inverse_free(&cylinder->inverseFFT);
+#endif
 }
 
 
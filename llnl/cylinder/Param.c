@@ -143,6 +143,14 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
         BindVar(CPList, "DLBfreq", &param->DLBfreq, V_INT, 1, VFLAG_NULL);
         param->DLBfreq = 3;
 
+/*
+ *      The force routines of this application do not record per-cell
+ *      costs, so keep the per-domain load model unless asked for.
+ */
+        BindVar(CPList, "DLBcellCost", &param->DLBcellCost, V_INT, 1,
+                VFLAG_NULL);
+        param->DLBcellCost = 0;
+
         BindVar(CPList, "xBoundMin", &param->xBoundMin, V_DBL, 1, VFLAG_NULL);
 
         BindVar(CPList, "xBoundMax", &param->xBoundMax, V_DBL, 1, VFLAG_NULL);
@@ -867,6 +875,10 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
         BindVar(CPList, "CYL_VSLength", &param->cyl_VSlength, V_DBL, 1,
                 VFLAG_NULL);
         param->cyl_VSlength = 1e4;
+
+        BindVar(CPList, "CYL_matrixCache", param->cyl_matrixCache, V_STRING, 1,
+                VFLAG_NULL);
+        param->cyl_matrixCache[0] = 0;
 // (2012.12.20/iryu)
 // For using nonlinear mobility law 
         BindVar(CPList, "threshold", &param->threshold, V_DBL, 1, VFLAG_NULL);
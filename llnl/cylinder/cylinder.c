@@ -7,6 +7,8 @@
  **************************************************************************/
 
 
+#include <string.h>
+
 #include "Home.h"
 
 #ifdef _CYLINDER
@@ -387,8 +389,10 @@ void CYL_Analysis(Cylinder_t *cylinder)
   double cq,sq;
   COMPLEX tr_jm, tq_jm, tz_jm;
   fftw_complex *tr, *tq, *tz;
+  fftw_complex *T[3], *t[3];
   COMPLEX *fr, *fq, *fz;
   COMPLEX *dur, *duq, *duz;
+  fftw_complex *out;
 
   nz = cylinder->nz;
   nq = cylinder->nq;
@@ -398,17 +402,21 @@ void CYL_Analysis(Cylinder_t *cylinder)
   tq = (fftw_complex *)malloc(sizeof(fftw_complex)*nz*nq);
   tz = (fftw_complex *)malloc(sizeof(fftw_complex)*nz*nq);
 
-  fourier_transform_forward(cylinder->Tr,tr,nz,nq);
-  fourier_transform_forward(cylinder->Tq,tq,nz,nq);
-  fourier_transform_forward(cylinder->Tz,tz,nz,nq);
+  T[0] = cylinder->Tr;  t[0] = tr;
+  T[1] = cylinder->Tq;  t[1] = tq;
+  T[2] = cylinder->Tz;  t[2] = tz;
+
+  fourier_transform_tractions(&cylinder->tractionFFT,T,t);
 
-  fr = (COMPLEX *)malloc(sizeof(COMPLEX)*nz*nq);
-  fq = (COMPLEX *)malloc(sizeof(COMPLEX)*nz*nq);
-  fz = (COMPLEX *)malloc(sizeof(COMPLEX)*nz*nq);
+  // The six fields are built directly in the input of the
+  // batched inverse transform.
+  fr  = (COMPLEX *)(cylinder->inverseFFT.in + 0*nzq);
+  fq  = (COMPLEX *)(cylinder->inverseFFT.in + 1*nzq);
+  fz  = (COMPLEX *)(cylinder->inverseFFT.in + 2*nzq);
 
-  dur = (COMPLEX *)malloc(sizeof(COMPLEX)*nz*nq);
-  duq = (COMPLEX *)malloc(sizeof(COMPLEX)*nz*nq);
-  duz = (COMPLEX *)malloc(sizeof(COMPLEX)*nz*nq);
+  dur = (COMPLEX *)(cylinder->inverseFFT.in + 3*nzq);
+  duq = (COMPLEX *)(cylinder->inverseFFT.in + 4*nzq);
+  duz = (COMPLEX *)(cylinder->inverseFFT.in + 5*nzq);
 
   for (j=0; j<nz; j++) 
     for (m=0; m<nq; m++) 
@@ -445,13 +453,17 @@ void CYL_Analysis(Cylinder_t *cylinder)
 	              + cylinder->ut[2][2][j][m]*tz_jm;
       }
   
-    fourier_transform_backward((fftw_complex *)cylinder->Fr,(fftw_complex *)fr,nz,nq);
-    fourier_transform_backward((fftw_complex *)cylinder->Fq,(fftw_complex *)fq,nz,nq);
-    fourier_transform_backward((fftw_complex *)cylinder->Fz,(fftw_complex *)fz,nz,nq);
+    fourier_transform_inverse(&cylinder->inverseFFT);
+
+    out = cylinder->inverseFFT.out;
+
+    memcpy(cylinder->Fr,  out + 0*nzq, sizeof(fftw_complex)*nzq);
+    memcpy(cylinder->Fq,  out + 1*nzq, sizeof(fftw_complex)*nzq);
+    memcpy(cylinder->Fz,  out + 2*nzq, sizeof(fftw_complex)*nzq);
 
-    fourier_transform_backward((fftw_complex *)cylinder->Dur,(fftw_complex *)dur,nz,nq);
-    fourier_transform_backward((fftw_complex *)cylinder->Duq,(fftw_complex *)duq,nz,nq);
-    fourier_transform_backward((fftw_complex *)cylinder->Duz,(fftw_complex *)duz,nz,nq);
+    memcpy(cylinder->Dur, out + 3*nzq, sizeof(fftw_complex)*nzq);
+    memcpy(cylinder->Duq, out + 4*nzq, sizeof(fftw_complex)*nzq);
+    memcpy(cylinder->Duz, out + 5*nzq, sizeof(fftw_complex)*nzq);
 
     for (j=0; j<nz; j++) 
         for (m=0; m<nq; m++) 
@@ -513,20 +525,190 @@ void CYL_Analysis(Cylinder_t *cylinder)
   free(tq);
   free(tz);
 
-  free(fr);
-  free(fq);
-  free(fz);
-
-  free(dur);
-  free(duq);
-  free(duz);
 #endif //_CYLIMGSTRESS
 }
 
-void CYL_Create_Matrices(Cylinder_t *cylinder)
+#ifdef _CYLIMGSTRESS
+/*
+ *  The mode matrices only depend on (radius, L, nz, nq, mu, nu) and
+ *  are expensive to build (a Bessel function evaluation and 3x3
+ *  inversions per mode), so they can be kept in a binary cache file
+ *  named by the CYL_matrixCache parameter.  The file starts with the
+ *  key it was built for and is ignored when the key does not match.
+ */
+#define CYL_MATRIX_CACHE_MAGIC   0x4d4c5943   /* "CYLM" */
+#define CYL_MATRIX_CACHE_VERSION 1
+#define CYL_NUM_MATRIX_SETS      10
+
+typedef COMPLEX **MatrixSet_t[3][3];
+
+typedef struct {
+    int    magic, version, nz, nq;
+    double radius, L, mu, nu;
+} MatrixCacheKey_t;
+
+static void GetMatrixSets(Cylinder_t *cylinder, MatrixSet_t *sets[])
+{
+    sets[0] = &cylinder->M;
+    sets[1] = &cylinder->N;
+    sets[2] = &cylinder->M2;
+    sets[3] = &cylinder->N2;
+    sets[4] = &cylinder->Minv;
+    sets[5] = &cylinder->Ninv;
+    sets[6] = &cylinder->M2inv;
+    sets[7] = &cylinder->N2inv;
+    sets[8] = &cylinder->ft;
+    sets[9] = &cylinder->ut;
+}
+
+static void SetMatrixCacheKey(Cylinder_t *cylinder, MatrixCacheKey_t *key)
+{
+    memset(key, 0, sizeof(MatrixCacheKey_t));
+
+    key->magic   = CYL_MATRIX_CACHE_MAGIC;
+    key->version = CYL_MATRIX_CACHE_VERSION;
+    key->nz      = cylinder->nz;
+    key->nq      = cylinder->nq;
+    key->radius  = cylinder->radius;
+    key->L       = cylinder->L;
+    key->mu      = cylinder->mu;
+    key->nu      = cylinder->nu;
+}
+
+static int ReadMatrixCache(Cylinder_t *cylinder, char *fileName)
+{
+/*
+ *  Returns 1 if all the matrices were read from the cache, 0 if the
+ *  file does not exist, is for another key or is truncated.
+ */
+    int i, j, k, s;
+    FILE *fp;
+    MatrixCacheKey_t key, fileKey;
+    MatrixSet_t *sets[CYL_NUM_MATRIX_SETS];
+
+    fp = fopen(fileName, "rb");
+    if (fp == (FILE *)NULL) return(0);
+
+    SetMatrixCacheKey(cylinder, &key);
+
+    if ((fread(&fileKey, sizeof(fileKey), 1, fp) != 1) ||
+        (fileKey.magic   != key.magic)   ||
+        (fileKey.version != key.version) ||
+        (fileKey.nz      != key.nz)      ||
+        (fileKey.nq      != key.nq)      ||
+        (fileKey.radius  != key.radius)  ||
+        (fileKey.L       != key.L)       ||
+        (fileKey.mu      != key.mu)      ||
+        (fileKey.nu      != key.nu)) {
+        fclose(fp);
+        return(0);
+    }
+
+    GetMatrixSets(cylinder, sets);
+
+    for (s = 0; s < CYL_NUM_MATRIX_SETS; s++)
+      for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+          for (k = 0; k < cylinder->nz; k++) {
+            if (fread((*sets[s])[i][j][k], sizeof(COMPLEX), cylinder->nq,
+                      fp) != (size_t)cylinder->nq) {
+                fclose(fp);
+                return(0);
+            }
+          }
+
+    fclose(fp);
+    return(1);
+}
+
+static void WriteMatrixCache(Cylinder_t *cylinder, char *fileName)
+{
+    int i, j, k, s, ok;
+    FILE *fp;
+    MatrixCacheKey_t key;
+    MatrixSet_t *sets[CYL_NUM_MATRIX_SETS];
+
+    fp = fopen(fileName, "wb");
+    if (fp == (FILE *)NULL) {
+        printf("Warning: unable to open matrix cache %s for writing\n",
+               fileName);
+        return;
+    }
+
+    SetMatrixCacheKey(cylinder, &key);
+    ok = (fwrite(&key, sizeof(key), 1, fp) == 1);
+
+    GetMatrixSets(cylinder, sets);
+
+    for (s = 0; s < CYL_NUM_MATRIX_SETS && ok; s++)
+      for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+          for (k = 0; k < cylinder->nz; k++)
+            ok = ok && (fwrite((*sets[s])[i][j][k], sizeof(COMPLEX),
+                               cylinder->nq, fp) == (size_t)cylinder->nq);
+
+    fclose(fp);
+
+    if (!ok) {
+        printf("Warning: error writing matrix cache %s\n", fileName);
+        remove(fileName);
+    }
+}
+
+#ifdef PARALLEL
+static void BcastMatrices(Home_t *home, Cylinder_t *cylinder)
+{
+/*
+ *  Send the matrices read by domain 0 to all domains in one message.
+ */
+    int i, j, k, s, n;
+    int nz = cylinder->nz;
+    int nq = cylinder->nq;
+    COMPLEX *buf;
+    MatrixSet_t *sets[CYL_NUM_MATRIX_SETS];
+
+    GetMatrixSets(cylinder, sets);
+
+    buf = (COMPLEX *)malloc(sizeof(COMPLEX)*CYL_NUM_MATRIX_SETS*9*nz*nq);
+    if (buf == (COMPLEX *)NULL) {
+        printf("Not enough memory to broadcast the cylinder matrices\n");
+        exit(0);
+    }
+
+    if (home->myDomain == 0) {
+        n = 0;
+        for (s = 0; s < CYL_NUM_MATRIX_SETS; s++)
+          for (i = 0; i < 3; i++)
+            for (j = 0; j < 3; j++)
+              for (k = 0; k < nz; k++, n += nq)
+                memcpy(buf+n, (*sets[s])[i][j][k], sizeof(COMPLEX)*nq);
+    }
+
+    MPI_Bcast(buf, 2*CYL_NUM_MATRIX_SETS*9*nz*nq, MPI_DOUBLE, 0,
+              MPI_COMM_WORLD);
+
+    if (home->myDomain != 0) {
+        n = 0;
+        for (s = 0; s < CYL_NUM_MATRIX_SETS; s++)
+          for (i = 0; i < 3; i++)
+            for (j = 0; j < 3; j++)
+              for (k = 0; k < nz; k++, n += nq)
+                memcpy((*sets[s])[i][j][k], buf+n, sizeof(COMPLEX)*nq);
+    }
+
+    free(buf);
+}
+#endif
+#endif //_CYLIMGSTRESS
+
+void CYL_Create_Matrices(Home_t *home, Cylinder_t *cylinder)
 {
     int nz,nq;
     double L, radius, mu, nu, lambda;
+#ifdef _CYLIMGSTRESS
+    int cached = 0;
+    char *cacheFile = home->param->cyl_matrixCache;
+#endif
     
     nz = cylinder->nz;
     nq = cylinder->nq;
@@ -541,6 +723,22 @@ void CYL_Create_Matrices(Cylinder_t *cylinder)
        based on the appropriate stress algorithm */
    
 #ifdef _CYLIMGSTRESS 
+    if (cacheFile[0] != 0) {
+        if (home->myDomain == 0) {
+            cached = ReadMatrixCache(cylinder, cacheFile);
+        }
+#ifdef PARALLEL
+        MPI_Bcast(&cached, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        if (cached) BcastMatrices(home, cylinder);
+#endif
+        if (cached) {
+            if (home->myDomain == 0) {
+                printf("Cylinder matrices read from %s\n", cacheFile);
+            }
+            return;
+        }
+    }
+
     mmatrix                (cylinder);
     nmatrix                (cylinder);
     minvmatrix             (cylinder);
@@ -551,6 +749,10 @@ void CYL_Create_Matrices(Cylinder_t *cylinder)
     n2invmatrix            (cylinder);
     bodyforce_matrix       (cylinder);
     displacementjump_matrix(cylinder);
+
+    if ((cacheFile[0] != 0) && (home->myDomain == 0)) {
+        WriteMatrixCache(cylinder, cacheFile);
+    }
 #endif 
 }
 
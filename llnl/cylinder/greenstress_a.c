@@ -22,143 +22,108 @@ void greenstress_a(Cylinder_t *cylinder, double r[3],
  * stress[6]    :   Stress at r[3] due to the body forces
  *                  sxx syy szz syz sxz sxy
  *                  s00 s11 s22 s12 s02 s01
+ *
+ * The pole contributions of one row of grid points (fixed z) are
+ * summed in a branch-free inner loop over the nq angular points: the
+ * grid coordinates of a row are contiguous, the body forces are read
+ * as (real, imaginary) pairs, and the factors common to all poles
+ * (alpha, the weight w) are applied once at the end, so the loop
+ * vectorizes across points.  With a single row (nz == 1) the row is
+ * also summed at its periodic image one length L away, each copy
+ * with weight 1/2.
  **************************************************************************/
 
-    int i,j,k,l,m,n,nq,nz;
-    double mu,nu,lambda,L,radius;
-    double alpha,beta;
-    double R,Ra,Ra2,Ra3;
-    double gamma0,gamma1,gamma2,w;
-    double x,y,z,x2,y2,z2,x3,y3,z3;
-    double B[3];
-    double stress[6];
+    int j,m,img,nimg,nq,nz;
+    double nu,L,a2;
+    double alpha,w,zoff;
+    double s0,s1,s2,s3,s4,s5;
+    double *xg,*yg,*zg,*Bx,*By,*Bz;
 
-    mu     = cylinder->mu;
     nu     = cylinder->nu;
     L      = cylinder->L;
-    radius = cylinder->radius;
     nz     = cylinder->nz;
     nq     = cylinder->nq;
 
-    stress[0] = 0.0;
-    stress[1] = 0.0;
-    stress[2] = 0.0; 
-    stress[3] = 0.0;
-    stress[4] = 0.0;
-    stress[5] = 0.0;
-
 /* Compute pole contributions :)*/
 
     alpha = 1.0/8.0/M_PI/(1-nu);
-    beta  = 1.0-2.0*nu;
-    
-    for (j=0; j<nz; j++) {
-      for (m=0; m<nq; m++) {
-	
-#ifndef _CYGWIN
-	B[0] = *(cylinder->Fx+m+j*nq);
-	B[1] = *(cylinder->Fy+m+j*nq);
-	B[2] = *(cylinder->Fz+m+j*nq);
-#else
-	B[0] = *(cylinder->Fx+m+j*nq)[0];
-	B[1] = *(cylinder->Fy+m+j*nq)[0];
-	B[2] = *(cylinder->Fz+m+j*nq)[0];
+    a2    = a*a;
+
+    if (nz==1) {
+      nimg = 2;
+      w    = 0.5;
+    }
+    else {
+      nimg = 1;
+      w    = 1.0;
+    }
+
+    s0 = 0.0; s1 = 0.0; s2 = 0.0;
+    s3 = 0.0; s4 = 0.0; s5 = 0.0;
+
+    for (img=0; img<nimg; img++) {
+      zoff = img*L;
+
+      for (j=0; j<nz; j++) {
+
+	xg = cylinder->rectgrids[0][j];
+	yg = cylinder->rectgrids[1][j];
+	zg = cylinder->rectgrids[2][j];
+
+	// Real parts of the body forces, valid for both definitions
+	// of fftw_complex.
+	Bx = (double *)(cylinder->Fx+j*nq);
+	By = (double *)(cylinder->Fy+j*nq);
+	Bz = (double *)(cylinder->Fz+j*nq);
+
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#pragma omp simd reduction(+:s0,s1,s2,s3,s4,s5)
 #endif
-	
-	x = r[0]-cylinder->rectgrids[0][j][m];
-	y = r[1]-cylinder->rectgrids[1][j][m];
-	z = r[2]-cylinder->rectgrids[2][j][m];
-	Ra2 = x*x+y*y+z*z+a*a;
-	Ra  = sqrt(Ra2);
-	Ra3 = Ra*Ra2;
-	R   = sqrt(x*x+y*y+z*z);
-	
-	x2 = x*x;
-	x3 = x*x2;
-	y2 = y*y;
-	y3 = y*y2;
-	z2 = z*z;
-	z3 = z*z2;
-	
-	gamma0 = 3*R*R/Ra2-5;
-	gamma1 = 1+nu*gamma0;
-	gamma2 = (1-nu)*gamma0+1;
-	
-	if (nz==1)
-	  w=0.5;
-	else
-	  w=1.0;
-	
-	stress[0] = stress[0] + w*(alpha/Ra3*((gamma1+2*gamma2)*x-3*x3/Ra2)*B[0] +
-				   alpha/Ra3*(gamma1*y-3*x2*y/Ra2)*B[1] + 
-				   alpha/Ra3*(gamma1*z-3*x2*z/Ra2)*B[2] ) ;
-	
-	stress[1] = stress[1] + w*(alpha/Ra3*(gamma1*x-3*y2*x/Ra2)*B[0] + 
-				   alpha/Ra3*((gamma1+2*gamma2)*y-3*y3/Ra2)*B[1] + 
-				   alpha/Ra3*(gamma1*z-3*y2*z/Ra2)*B[2] ) ;
-	
-	stress[2] = stress[2] + w*(alpha/Ra3*(gamma1*x-3*z2*x/Ra2)*B[0] +
-				   alpha/Ra3*(gamma1*y-3*z2*y/Ra2)*B[1] +
-				   alpha/Ra3*((gamma1+2*gamma2)*z-3*z3/Ra2)*B[2] ) ;     
-	
-	stress[3] = stress[3] + w*(alpha/Ra3*(-3*x*y*z/Ra2)*B[0] +
-				   alpha/Ra3*(gamma2*z-3*y2*z/Ra2)*B[1] +
-				   alpha/Ra3*(gamma2*y-3*z2*y/Ra2)*B[2] ) ;      
-	
-	stress[4] = stress[4] + w*(alpha/Ra3*(gamma2*z-3*x2*z/Ra2)*B[0] +
-				   alpha/Ra3*(-3*x*y*z/Ra2)*B[1] + 
-				   alpha/Ra3*(gamma2*x-3*z2*x/Ra2)*B[2] );  
-	
-	stress[5] = stress[5] + w*(alpha/Ra3*(gamma2*y-3*x2*y/Ra2)*B[0] +
-				   alpha/Ra3*(gamma2*x-3*y2*x/Ra2)*B[1] +
-				   alpha/Ra3*(-3*x*y*z/Ra2)*B[2] ) ;
-	
-	if (nz==1) 
-	  {
-	    z =  r[2]-cylinder->rectgrids[2][j][m]-(n+1)*L;
-	    Ra2 = x*x+y*y+z*z+a*a;
-	    Ra  = sqrt(Ra2);
-	    R   = sqrt(x*x+y*y+z*z);
-	    
-	    gamma0 = 3*R*R/Ra2-5;
-	    gamma1 = 1+nu*gamma0;
-	    gamma2 = (1-nu)*gamma0+1;
-	    
-	    stress[0] = stress[0] + w*(alpha/Ra3*((gamma1+2*gamma2)*x-3*x3/Ra2)*B[0] +
-				       alpha/Ra3*(gamma1*y-3*x2*y/Ra2)*B[1] + 
-				       alpha/Ra3*(gamma1*z-3*x2*z/Ra2)*B[2] ) ;
-	    
-	    stress[1] = stress[1] + w*(alpha/Ra3*(gamma1*x-3*y2*x/Ra2)*B[0] + 
-				       alpha/Ra3*((gamma1+2*gamma2)*y-3*y3/Ra2)*B[1] + 
-				       alpha/Ra3*(gamma1*z-3*y2*z/Ra2)*B[2] ) ;
-	    
-	    stress[2] = stress[2] + w*(alpha/Ra3*(gamma1*x-3*z2*x/Ra2)*B[0] +
-				       alpha/Ra3*(gamma1*y-3*z2*y/Ra2)*B[1] +
-				       alpha/Ra3*((gamma1+2*gamma2)*z-3*z3/Ra2)*B[2] ) ;     
-	    
-	    stress[3] = stress[3] + w*(alpha/Ra3*(-3*x*y*z/Ra2)*B[0] +
-				       alpha/Ra3*(gamma2*z-3*y2*z/Ra2)*B[1] +
-				       alpha/Ra3*(gamma2*y-3*z2*y/Ra2)*B[2] ) ;      
-	    
-	    stress[4] = stress[4] + w*(alpha/Ra3*(gamma2*z-3*x2*z/Ra2)*B[0] +
-				       alpha/Ra3*(-3*x*y*z/Ra2)*B[1] + 
-				       alpha/Ra3*(gamma2*x-3*z2*x/Ra2)*B[2] );  
-	    
-	    stress[5] = stress[5] + w*(alpha/Ra3*(gamma2*y-3*x2*y/Ra2)*B[0] +
-				       alpha/Ra3*(gamma2*x-3*y2*x/Ra2)*B[1] +
-				       alpha/Ra3*(-3*x*y*z/Ra2)*B[2] ) ;
-	  }
+	for (m=0; m<nq; m++) {
+	  double x,y,z,R2,Ra2,Ra,f,h;
+	  double gamma0,gamma1,gamma2,d;
+	  double B0,B1,B2;
+
+	  B0 = Bx[2*m];
+	  B1 = By[2*m];
+	  B2 = Bz[2*m];
+
+	  x = r[0]-xg[m];
+	  y = r[1]-yg[m];
+	  z = r[2]-zg[m]-zoff;
+
+	  R2  = x*x+y*y+z*z;
+	  Ra2 = R2+a2;
+	  Ra  = sqrt(Ra2);
+	  f   = 1.0/(Ra*Ra2);
+	  h   = 3.0/Ra2;
+
+	  gamma0 = R2*h-5;
+	  gamma1 = 1+nu*gamma0;
+	  gamma2 = (1-nu)*gamma0+1;
+
+	  d = x*B0+y*B1+z*B2;
+
+	  s0 += f*(gamma1*d + 2*gamma2*x*B0 - h*x*x*d);
+	  s1 += f*(gamma1*d + 2*gamma2*y*B1 - h*y*y*d);
+	  s2 += f*(gamma1*d + 2*gamma2*z*B2 - h*z*z*d);
+	  s3 += f*(gamma2*(z*B1+y*B2) - h*y*z*d);
+	  s4 += f*(gamma2*(z*B0+x*B2) - h*x*z*d);
+	  s5 += f*(gamma2*(y*B0+x*B1) - h*x*y*d);
+	}
       }
     }
 
+    s0 *= w*alpha; s1 *= w*alpha; s2 *= w*alpha;
+    s3 *= w*alpha; s4 *= w*alpha; s5 *= w*alpha;
     
-    FinalStress[0][0] = stress[0];
-    FinalStress[0][1] = stress[5];
-    FinalStress[0][2] = stress[4];
-    FinalStress[1][0] = stress[5];
-    FinalStress[1][1] = stress[1];
-    FinalStress[1][2] = stress[3];
-    FinalStress[2][0] = stress[4];
-    FinalStress[2][1] = stress[3];
-    FinalStress[2][2] = stress[2];
+    FinalStress[0][0] = s0;
+    FinalStress[0][1] = s5;
+    FinalStress[0][2] = s4;
+    FinalStress[1][0] = s5;
+    FinalStress[1][1] = s1;
+    FinalStress[1][2] = s3;
+    FinalStress[2][0] = s4;
+    FinalStress[2][1] = s3;
+    FinalStress[2][2] = s2;
 }
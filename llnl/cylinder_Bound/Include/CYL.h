@@ -41,6 +41,22 @@ typedef std::complex<double> complex;
 #define VALS_PER_SEG 9
 #define NumNucSite 2000
 
+/* Persistent batched real-to-complex transform of the surface tractions */
+typedef struct {
+  int           nx, ny, howmany;
+  double*       in;      // howmany real nx*ny arrays
+  fftw_complex* out;     // howmany nx*(ny/2+1) half spectra
+  fftw_plan     plan;
+} TractionFFT_t;
+
+/* Persistent batched complex inverse transform */
+typedef struct {
+  int           nx, ny, howmany;
+  fftw_complex* in;      // howmany nx*ny spectra
+  fftw_complex* out;     // howmany nx*ny results
+  fftw_plan     plan;
+} InverseFFT_t;
+
 /* Cylinder structure definition*/
 struct _cylinder 
 {
@@ -73,6 +89,9 @@ struct _cylinder
   fftw_complex*   Dux;
   fftw_complex*   Duy;  
 
+  TractionFFT_t   tractionFFT;    // Transforms Tr, Tq, Tz
+  InverseFFT_t    inverseFFT;     // Transforms Fr, Fq, Fz, Dur, Duq, Duz
+
   COMPLEX** M[3][3]; 
   COMPLEX** N[3][3];
   COMPLEX** M2[3][3];
@@ -147,13 +166,18 @@ void CYL_Init(Home_t *home, Cylinder_t **cyl_ptr);
 void CYL_Step(Home_t *home, Cylinder_t *cylinder);
 void CYL_Finish(Cylinder_t *cylinder);
 
-void CYL_Create_Matrices(Cylinder_t *cylinder);
+void CYL_Create_Matrices(Home_t *home, Cylinder_t *cylinder);
 void CYL_Create_Grids   (Home_t *home, Cylinder_t *cylinder);
 
-void fourier_transform_forward(fftw_complex* M,fftw_complex* m, 
-			       int nz, int nq);
-void fourier_transform_backward(fftw_complex* M, fftw_complex* m, 
-				int nz, int nq);
+void fourier_transform_tractions_init(Home_t *home, TractionFFT_t *fft,
+				      int nx, int ny, int howmany);
+void fourier_transform_tractions(TractionFFT_t *fft, fftw_complex **T,
+				 fftw_complex **t);
+void fourier_transform_tractions_free(TractionFFT_t *fft);
+void fourier_transform_inverse_init(Home_t *home, InverseFFT_t *fft,
+				    int nx, int ny, int howmany);
+void fourier_transform_inverse(InverseFFT_t *fft);
+void fourier_transform_inverse_free(InverseFFT_t *fft);
 
 int Split(Home_t *home,Node_t *nodea,Node_t *nodeb,real8 radius);
 void GetSurfaceNode(Param_t *param,Node_t *nodea,Node_t *nodeb,
@@ -150,6 +150,13 @@ typedef struct {
         real8 (*burgList)[3];       /* Array of burgers vectors */
 
         real8 (*planeList)[3];      /* Arraay of burgers vector planes */
+
+        real8 (*glideDirCrystal)[3]; /* Screw glide directions, 3 rows  */
+                                     /* per burgers vector starting at  */
+                                     /* row 3*burgIndex.  Crystal frame */
+
+        real8 (*glideDirLab)[3];     /* Same as <glideDirCrystal> but   */
+                                     /* in the laboratory frame         */
 } BurgInfo_t;
 
 
@@ -379,6 +386,21 @@ struct _home {
  */
         int       cycleForceCalcCount;
 
+/*
+ *      Per-cell cost accounting for the dynamic load balancing.
+ *      <cellCost> accumulates (for the current cycle only) the work
+ *      this domain performed on behalf of each simulation cell
+ *      (nXcells*nYcells*nZcells elements, no ghost cells).
+ *      <cellLoad> holds the global load histogram built from all
+ *      domains' cell costs at the last rebalance, sorted by cell.
+ *      The pieces for cell N are elements <cellLoadIndex>[N] through
+ *      <cellLoadIndex>[N+1]-1 (see Decomp.c).  All are NULL when the
+ *      cell-based cost model is not in use.
+ */
+        real8     *cellCost;
+        real8     *cellLoad;
+        int       *cellLoadIndex;
+
 /*
  *      For some simulations, the geometric information (burgers vectors,
  *      normal planes) may be provided in a user-specified laboratory frame.
@@ -105,6 +105,10 @@ struct _param {
  */
         int   decompType;       /* Selects decomposition type */
         int   DLBfreq;          /* how often to load balance */
+        int   DLBcellCost;      /* Toggles use of the per-cell cost */
+                                /* histogram when placing new domain */
+                                /* boundaries.  If zero, load is     */
+                                /* assumed uniform within a domain   */
         int   numDLBCycles;     /* Number of initial load-balance-only */
                                 /* cycles to be executed before main   */
                                 /* processing loop is entered.  This   */
@@ -266,6 +270,12 @@ struct _param {
                                    /* initialization to point to the      */
                                    /* appropriate mobility function       */
 
+        void  (*mobilityCacheFunc)(Home_t *home, Node_t **nodeList,
+                                   int numNodes);  /* Fills the per-arm   */
+                                   /* mobility cache of a list of nodes   */
+                                   /* before their mobility is evaluated. */
+                                   /* NULL if the law does not cache.     */
+
         real8 MobScrew;
         real8 MobEdge;
         real8 MobClimb;
@@ -544,6 +554,8 @@ struct _param {
 	                            /* function of the size of the segment.             */
 				    /* Maybe the average size of a segment * 100        */
 	real8 cyl_delSegLength;     /* Counts deleted segments during TF remesh         */
+	char  cyl_matrixCache[MAX_STRING_LEN]; /* Binary cache file for the  */
+	                            /* mode matrices. Empty string disables caching.    */
 	int NimgPBC;		    /*Number of periodic image in Z direction for AllSegmentStress*/		
 	int Loading_Direction;	    /*Loading direction= Postive : tension/twist (2014.06.25/iryu)  
                                                          Negative: compression / untwist*/		
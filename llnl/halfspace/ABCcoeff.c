@@ -29,6 +29,7 @@ void ABCcoeff(HalfSpace_t *halfspace)
 #endif
 
   COMPLEX ttx,tty,ttz;
+  fftw_complex *T[3], *t[3];
   nx = halfspace->nx;
   ny = halfspace->ny;
 
@@ -38,9 +39,15 @@ void ABCcoeff(HalfSpace_t *halfspace)
    ty = (COMPLEX *) malloc(sizeof(COMPLEX)*nx*ny);
    tz = (COMPLEX *) malloc(sizeof(COMPLEX)*nx*ny);
 
-   fourier_transform_forward(Tx,(fftw_complex *)tx,nx,ny);
-   fourier_transform_forward(Ty,(fftw_complex *)ty,nx,ny);
-   fourier_transform_forward(Tz,(fftw_complex *)tz,nx,ny);
+   T[0] = Tx;
+   T[1] = Ty;
+   T[2] = Tz;
+
+   t[0] = (fftw_complex *)tx;
+   t[1] = (fftw_complex *)ty;
+   t[2] = (fftw_complex *)tz;
+
+   fourier_transform_tractions(&halfspace->tractionFFT,T,t);
 
    for (i=0; i<nx; i++)
      for (j=0; j<ny; j++)
@@ -21,12 +21,224 @@
 #include "HS.h"
 #include "Yoffe.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 /*
  *      Calculate Yoffe image stresses due to all segments that intersect
  *      with free surfaces at point (xm, ym, zm) 
  *
+ *      The segments are looked up in halfspace->yoffeIndex, which
+ *      BuildSurfaceSegIndex rebuilds from the surface segment list
+ *      each time the list changes.  The index only holds segments that
+ *      pass SanityCheckYoffe, so the check is done once per segment
+ *      instead of once per segment and field point.  When
+ *      param->hs_yoffeCutoff is positive, only segments whose surface
+ *      node lies within that distance of the field point contribute,
+ *      and only the bins overlapping the cutoff sphere are visited.
+ *      With no cutoff (the default) all segments contribute, as
+ *      before.
+ *
+ */
+
+
+void FreeSurfaceSegIndex(SurfaceSegIndex_t *index)
+{
+  if (index->segList  != (real8 *)NULL) free(index->segList);
+  if (index->binStart != (int *)NULL)   free(index->binStart);
+
+  index->segList  = (real8 *)NULL;
+  index->binStart = (int *)NULL;
+  index->segCount = 0;
+}
+
+
+static int SurfaceSegBin(SurfaceSegIndex_t *index, real8 pos[3])
+{
+  int k, ib[3];
+
+  for (k = 0; k < 3; k++)
+    {
+      ib[k] = (int)((pos[k] - index->binMin[k]) / index->binSize);
+      ib[k] = MAX(0, MIN(index->nb[k]-1, ib[k]));
+    }
+
+  return (ib[0]*index->nb[1] + ib[1])*index->nb[2] + ib[2];
+}
+
+
+void BuildSurfaceSegIndex(Home_t *home, HalfSpace_t *halfspace)
+{
+  int     i, k, n, bin, nBins, numSegs;
+  int     *keep, *segBin, *next;
+  real8   *seg, minPos[3], maxPos[3];
+  SurfaceSegIndex_t *index;
+
+  index = &halfspace->yoffeIndex;
+
+  FreeSurfaceSegIndex(index);
+
+  index->cutoff = home->param->hs_yoffeCutoff;
+  numSegs = halfspace->surfaceSegCount;
+
+  if (numSegs == 0) return;
+
+  keep   = (int *)malloc(numSegs * sizeof(int));
+  segBin = (int *)malloc(numSegs * sizeof(int));
+
+/*
+ *      Drop the segments Yoffe cannot handle and get the extent
+ *      of the remaining surface nodes.
  */
+  n = 0;
+
+  for (i = 0; i < numSegs; i++)
+    {
+      seg = &halfspace->surfaceSegList[i*VALS_PER_SEG];
+
+      if (SanityCheckYoffe(seg[2], HALFSPACE_SURFACE_NODE, 
+			   seg[5], 0, 0.0)) continue;
+
+      for (k = 0; k < 3; k++)
+	{
+	  minPos[k] = (n == 0) ? seg[k] : MIN(minPos[k], seg[k]);
+	  maxPos[k] = (n == 0) ? seg[k] : MAX(maxPos[k], seg[k]);
+	}
+
+      keep[n++] = i;
+    }
+
+/*
+ *      Bins are one cutoff radius wide, made coarser if needed to
+ *      keep the number of bins in line with the number of segments.
+ *      Without a cutoff all segments go into a single bin.
+ */
+  for (k = 0; k < 3; k++)
+    {
+      index->binMin[k] = (n > 0) ? minPos[k] : 0.0;
+      index->nb[k] = 1;
+    }
+
+  index->binSize = 1.0;
+
+  if (index->cutoff > 0.0 && n > 0)
+    {
+      index->binSize = index->cutoff;
+
+      do 
+	{
+	  for (k = 0; k < 3; k++)
+	    index->nb[k] = (int)((maxPos[k]-minPos[k])/index->binSize) + 1;
+
+	  nBins = index->nb[0]*index->nb[1]*index->nb[2];
+	  if (nBins > 8*n) index->binSize *= 2.0;
+
+	} while (nBins > 8*n);
+    }
+
+  nBins = index->nb[0]*index->nb[1]*index->nb[2];
+
+  index->segCount = n;
+  index->segList  = (real8 *)malloc((n+1) * VALS_PER_SEG * sizeof(real8));
+  index->binStart = (int *)calloc(nBins+1, sizeof(int));
+  next            = (int *)malloc(nBins * sizeof(int));
+
+/*
+ *      Count the segments per bin, then copy them in bin order
+ */
+  for (i = 0; i < n; i++)
+    {
+      seg = &halfspace->surfaceSegList[keep[i]*VALS_PER_SEG];
+      segBin[i] = SurfaceSegBin(index, seg);
+      index->binStart[segBin[i]+1]++;
+    }
+
+  for (bin = 0; bin < nBins; bin++)
+    {
+      index->binStart[bin+1] += index->binStart[bin];
+      next[bin] = index->binStart[bin];
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      seg = &halfspace->surfaceSegList[keep[i]*VALS_PER_SEG];
+      memcpy(&index->segList[(next[segBin[i]]++)*VALS_PER_SEG], seg,
+	     VALS_PER_SEG * sizeof(real8));
+    }
+
+  free(keep);
+  free(segBin);
+  free(next);
+}
+
+
+static void IndexedYoffeStress(SurfaceSegIndex_t *index, real8 MU, real8 NU,
+			       real8 r[3], real8 yofStress[3][3])
+{
+  int   i, ii, jj, k, s, bx, by, bz, bin;
+  int   lo[3], hi[3];
+  real8 dx, dy, dz, cutoff2;
+  real8 *seg, rs[3], rm[3], burg[3], sigma[3][3];
+
+  Init3x3(yofStress);
+
+  if (index->segCount == 0) return;
+
+  cutoff2 = index->cutoff * index->cutoff;
+
+  for (k = 0; k < 3; k++)
+    {
+      if (index->cutoff > 0.0)
+	{
+	  lo[k] = (int)floor((r[k]-index->cutoff-index->binMin[k])/index->binSize);
+	  hi[k] = (int)floor((r[k]+index->cutoff-index->binMin[k])/index->binSize);
+	  lo[k] = MAX(lo[k], 0);
+	  hi[k] = MIN(hi[k], index->nb[k]-1);
+	  if (lo[k] > hi[k]) return;
+	}
+      else
+	{
+	  lo[k] = 0;
+	  hi[k] = index->nb[k]-1;
+	}
+    }
+
+  for (bx = lo[0]; bx <= hi[0]; bx++)
+    for (by = lo[1]; by <= hi[1]; by++)
+      for (bz = lo[2]; bz <= hi[2]; bz++)
+	{
+	  bin = (bx*index->nb[1] + by)*index->nb[2] + bz;
+
+	  for (s = index->binStart[bin]; s < index->binStart[bin+1]; s++)
+	    {
+	      seg = &index->segList[s*VALS_PER_SEG];
+
+	      if (index->cutoff > 0.0)
+		{
+		  dx = seg[0] - r[0];
+		  dy = seg[1] - r[1];
+		  dz = seg[2] - r[2];
+		  if (dx*dx + dy*dy + dz*dz > cutoff2) continue;
+		}
+
+	      for (i = 0; i < 3; i++)
+		{
+		  rs[i]   = seg[i];
+		  rm[i]   = seg[3+i];
+		  burg[i] = seg[6+i];
+		}
+
+	      ComputeYoffeStress(r[0],r[1],r[2],
+				 rs,rm,burg,MU,NU,sigma);
+
+	      for (ii = 0; ii < 3; ii++)
+		for (jj = 0; jj < 3; jj++)
+		  yofStress[ii][jj] += sigma[ii][jj];
+	    }
+	}
+}
 
 
 /* Uses list of surface segments */
@@ -39,11 +251,8 @@ void YesListAllYoffeStress(Home_t *home, HalfSpace_t *halfspace,
 		    real8 xm,real8 ym,real8 zm, real8 yofStress[3][3])
 
 {
-  int     i, j, ii, jj, icheck, bufIndex, signVal;
-  real8   MU, NU, a,t;
-  real8   *segList;
-  real8   r[3], rs[3], rm[3];
-  real8   sigma[3][3], surfaceNorm[3], burg[3];
+  real8   MU, NU, t;
+  real8   r[3];
   Param_t *param;
   
   
@@ -57,23 +266,18 @@ void YesListAllYoffeStress(Home_t *home, HalfSpace_t *halfspace,
 
   MU = param->shearModulus;
   NU = param->pois;
-  a  = param->rc;
   
   t = 0.0;
   
   if (fabs(zm) > t) return;
 
-  segList = halfspace->surfaceSegList;
-  
   r[0] = xm;
   r[1] = ym;
   r[2] = zm;
   
-  bufIndex = 0;
-  
 /*
- *      Loop through all surface-intersecting segments in the
- *      simulation.
+ *      Loop through the surface-intersecting segments in the
+ *      simulation (see BuildSurfaceSegIndex).
  *
  *      Note:  The segment 'list' is a flat array of real8's
  *      in which each segment is represented by the following
@@ -82,44 +286,36 @@ void YesListAllYoffeStress(Home_t *home, HalfSpace_t *halfspace,
  *          * 3 coordinates of segment endpoint 2
  *          * 3 coordinates of Burgers vector
  */
+  IndexedYoffeStress(&halfspace->yoffeIndex, MU, NU, r, yofStress);
+  
+  return;
+}
 
-  for (i = 0; i < halfspace->surfaceSegCount; i++) 
-    {
-      
-      rs[0] = segList[bufIndex++];
-      rs[1] = segList[bufIndex++];
-      rs[2] = segList[bufIndex++];
-      
-      rm[0] = segList[bufIndex++];
-      rm[1] = segList[bufIndex++];
-      rm[2] = segList[bufIndex++];
-      
-      burg[0] = segList[bufIndex++];
-      burg[1] = segList[bufIndex++];
-      burg[2] = segList[bufIndex++];
-      
-/* 
- *        During time integration, nodes can be 
- *        positioned such that Yoffe crashes.
- *        Do not call Yoffe if this is the case.
+
+/*
+ *      Same as AllYoffeStress for the <numPoints> field points r[],
+ *      with the points shared among the threads.
  */
-      icheck = SanityCheckYoffe(rs[2], HALFSPACE_SURFACE_NODE,
-				rm[2], 0,t);
+void AllYoffeStressBatch(Home_t *home, HalfSpace_t *halfspace,
+			 int numPoints, real8 (*r)[3],
+			 real8 (*yofStress)[3][3])
+{
+  int   p;
+  real8 MU, NU;
 
-      if (icheck) continue;
-      
-      ComputeYoffeStress(r[0],r[1],r[2],
-			 rs,rm,burg,MU,NU,sigma);
-      
-      
-      for (ii = 0; ii < 3; ii++)
-	for (jj = 0; jj < 3; jj++)
-	  {
-	    yofStress[ii][jj] += sigma[ii][jj];
-	  }      
+  MU = home->param->shearModulus;
+  NU = home->param->pois;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for (p = 0; p < numPoints; p++)
+    {
+      if (fabs(r[p][2]) > 0.0)
+	Init3x3(yofStress[p]);
+      else
+	IndexedYoffeStress(&halfspace->yoffeIndex, MU, NU, r[p], yofStress[p]);
     }
-  
-  return;
 }
 
 
@@ -792,6 +988,10 @@ void BuildSurfaceSegList(Home_t *home, HalfSpace_t *halfspace)
 
         }
 
+#ifndef _NOYOFFESTRESS
+        BuildSurfaceSegIndex(home, halfspace);
+#endif
+
 /*
  *      And be sure to clean up...
  */
@@ -1,34 +1,50 @@
 #include "Home.h"
 #include "HS.h"
 
-#define Stress  (halfspace->Stress)
-#define grids   (halfspace->Grid)
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
-void DispStress(HalfSpace_t *halfspace,real8 r[3], real8 stress[3][3])
-{
 /***************************************************************************
- * This program computes the stress from the displacement field using 
- * elasticity theory in a thin film and tractions computed in HSUtil.c
- * from AllSegmentStress.c
- * Sylvie Aubry, Wed Feb 27 2008
+ * The image stress at a point r is the sum over all nx*ny Fourier modes
+ * of the stress coefficients built from A, B, C times exp(i(kx x+ky y)).
+ *
+ * Summing the modes directly for each segment midpoint costs O(nx*ny)
+ * per point.  Instead, once per cycle (after ABCcoeff), HS_ImgStressGrid
+ * evaluates the sum on a set of depth layers with one inverse FFT per
+ * stress component and layer, on an in-plane grid oversampled by
+ * param->hs_imgStressOversample to keep the interpolation error small.
+ * DispStress then only interpolates the tabulated stress (trilinear,
+ * periodic in x and y).  Points outside the tabulated depth range, or
+ * all points when hs_imgStressFFT is zero, use the direct modal sum.
+ *
+ * Layout of halfspace->imgStress: imgNz layers of imgNx*imgNy grid
+ * points with the 6 independent components of each point contiguous:
  *
+ *   imgStress[((k*imgNx + p)*imgNy + q)*6 + c]
+ *
+ * with c = 0..5 for xx, yy, zz, zx, yz, xy.
+ *
+ * The stress of the refined surface patches (see SurfacePatches.c) is
+ * added on top, by direct modal sums over the few patches whose domain
+ * holds the point.
  **************************************************************************/
 
-  int i, j, m, n;
+#define IMG_INDEX(k,p,q,c) \
+        ((((k)*halfspace->imgNx + (p))*halfspace->imgNy + (q))*6 + (c))
+
+static void ModeStress(HalfSpace_t *halfspace, int i, int j, real8 z,
+                       COMPLEX s[6])
+{
+/***************************************************************************
+ * Stress coefficients of mode (i,j) at depth z without the in-plane
+ * phase factor exp(i(kx x+ky y)).
+ **************************************************************************/
   double kx, ky;
-  double kz, kx2, ky2, kz2, kz3, kxy, kxz, kyz,kxmy;
+  double kz, kx2, ky2, kz2, kxy, kxmy;
   double lm, l2m,lpm,lmpm,l2mpm;
-  double alpha;
-  double x,y,z;
+  COMPLEX expk;
 
-  double complex expk;
-  
-  int nim    = halfspace->numimages;
-  int nx     = halfspace->nx;
-  int ny     = halfspace->ny;
-
-  double HSLx     = halfspace->HSLx;
-  double HSLy     = halfspace->HSLy;
   double mu       = halfspace->mu;
   double lambda   = halfspace->lambda;
 
@@ -38,68 +54,272 @@ void DispStress(HalfSpace_t *halfspace,real8 r[3], real8 stress[3][3])
   l2mpm= l2m/lm;
   lpm = mu/lm;
 
-  // r is the point at the mid segment between two nodes.
-  // stress is evaluated for each kx,ky in [1:nx]*[1:ny] at this point
-  
-  for (i=0; i<3; i++) 
-    for (j = 0; j < 3; j++)
-      stress[i][j] = 0.0;
-  
+  kx = halfspace->kx[i];
+  ky = halfspace->ky[j];
+
+  kx2 = kx*kx;
+  ky2 = ky*ky;
+
+  kz2 = kx2+ky2;
+  kxmy = kx2-ky2;
+
+  kz  = sqrt(kz2);
+  kxy = kx*ky;
+
+  COMPLEX A = halfspace->A[i][j];
+  COMPLEX B = halfspace->B[i][j];
+  COMPLEX C = halfspace->C[i][j];
+
+  expk  = mu*exp(kz*z);
+
+  s[0] = 2*expk*((I*A*kx2*z-I*B*kxy-C*kx2)+I*A*kz*lmpm);
+  s[1] = 2*expk*((I*A*ky2*z+I*B*kxy-C*ky2)+I*A*kz*lmpm);
+  s[2] = 2*expk*((-I*A*z+C)*kz2+I*A*kz*l2mpm);
+
+  s[3] = expk*((2*A*kx*z-B*ky+2*I*C*kx)*kz-2*A*kx*lpm);
+  s[4] = expk*((2*A*ky*z+B*kx+2*I*C*ky)*kz-2*A*ky*lpm);
+  s[5] = I*expk*(2*A*kxy*z+B*kxmy+2*I*C*kxy);
+}
+
+static void DispStressDirect(HalfSpace_t *halfspace,real8 r[3],
+                             real8 stress[3][3])
+{
+  int i, j, c;
+  double x,y,z;
+  double alpha, sig[6];
+  COMPLEX phase, s[6];
+
+  int nx     = halfspace->nx;
+  int ny     = halfspace->ny;
+
+  double HSLx     = halfspace->HSLx;
+  double HSLy     = halfspace->HSLy;
+
+  // Translated for FFT origin accuracy.  The modes are periodic in
+  // HSLx and HSLy, so periodic images give the same contribution.
+  x = r[0] + HSLx*0.5;
+  y = r[1] + HSLy*0.5;
   z = r[2];
-    
-  for (j=0; j<ny; j++) 
+
+  for (c=0; c<6; c++) sig[c] = 0.0;
+
+  for (j=0; j<ny; j++)
+    for (i=0; i<nx; i++)
+      {
+	ModeStress(halfspace,i,j,z,s);
+
+	alpha = halfspace->kx[i]*x+halfspace->ky[j]*y;
+	phase = cos(alpha)+I*sin(alpha);
+
+	for (c=0; c<6; c++) sig[c] += creal(phase*s[c]);
+      }
+
+  stress[0][0] = sig[0];
+  stress[1][1] = sig[1];
+  stress[2][2] = sig[2];
+  stress[2][0] = sig[3];
+  stress[1][2] = sig[4];
+  stress[0][1] = sig[5];
+}
+
+static void PatchStress(HalfSpace_t *halfspace, real8 r[3],
+                        real8 stress[3][3])
+{
+/***************************************************************************
+ * Add the stress of the surface patches at point r to the six
+ * independent components of stress.  The patch
+ * coefficients are swapped into a private copy of the model patch so
+ * that threads can evaluate points concurrently.
+ **************************************************************************/
+  int n;
+  real8 rl[3], s[3][3];
+  HalfSpace_t patch;
+  SurfacePatch_t *p;
+
+  patch = *halfspace->patchModel;
+
+  if (r[2] < -MAX(patch.HSLx, patch.HSLy)) return;
+
+  for (n=0; n<halfspace->numPatches; n++)
     {
-      ky = halfspace->ky[j];
-      ky2 = ky*ky;
-      
-      for (i=0; i<nx; i++) 
-	{
-	  kx = halfspace->kx[i];
-	  kx2 = kx*kx;
-	  
-	  kz2 = kx2+ky2;
-	  kxmy = kx2-ky2;
-	      
-	  kz  = sqrt(kz2);
-	  kz3 = kz2*kz;
-	  
-	  kxz = kx*kz;
-	  kyz = ky*kz;
-	  
-	  kxy = kx*ky;
-	  
-	  double complex A = halfspace->A[i][j];
-	  double complex B = halfspace->B[i][j];
-	  double complex C = halfspace->C[i][j];
-	  
-	  for (n=-nim; n<nim+1; n++) 
-	    for (m=-nim; m<nim+1; m++) 
-	      { 
-		// Translated for FFT origin accuracy
-		x = r[0] + HSLx*0.5 - n*HSLx;
-		y = r[1] + HSLy*0.5 - m*HSLy;
-		
-		alpha = kx*x+ky*y;
-		expk  = mu*exp(kz*z)*(cos(alpha)+I*sin(alpha));
-		
-		Stress[0][0][i][j] = 2*expk*((I*A*kx2*z-I*B*kxy-C*kx2)+I*A*kz*lmpm);
-		Stress[1][1][i][j] = 2*expk*((I*A*ky2*z+I*B*kxy-C*ky2)+I*A*kz*lmpm);
-		Stress[2][2][i][j] = 2*expk*((-I*A*z+C)*kz2+I*A*kz*l2mpm);
-
-		Stress[2][0][i][j] = expk*((2*A*kx*z-B*ky+2*I*C*kx)*kz-2*A*kx*lpm);
-		Stress[1][2][i][j] = expk*((2*A*ky*z+B*kx+2*I*C*ky)*kz-2*A*ky*lpm);
-		Stress[0][1][i][j] = I*expk*(2*A*kxy*z+B*kxmy+2*I*C*kxy);
+      p = &halfspace->patches[n];
+
+      // Nearest periodic image of the point relative to the patch center
+      rl[0] = r[0] - p->center[0];
+      rl[1] = r[1] - p->center[1];
+      rl[2] = r[2];
+
+      rl[0] -= halfspace->HSLx*rint(rl[0]/halfspace->HSLx);
+      rl[1] -= halfspace->HSLy*rint(rl[1]/halfspace->HSLy);
+
+      if (fabs(rl[0]) >= 0.5*patch.HSLx || fabs(rl[1]) >= 0.5*patch.HSLy)
+	continue;
+
+      patch.A = p->A;
+      patch.B = p->B;
+      patch.C = p->C;
+
+      DispStressDirect(&patch,rl,s);
+
+      stress[0][0] += s[0][0];
+      stress[1][1] += s[1][1];
+      stress[2][2] += s[2][2];
+      stress[2][0] += s[2][0];
+      stress[1][2] += s[1][2];
+      stress[0][1] += s[0][1];
+    }
+}
+
+void HS_ImgStressGrid(HalfSpace_t *halfspace)
+{
+/***************************************************************************
+ * Tabulate the image stress on the depth layers.  Must be called after
+ * ABCcoeff each time the coefficients change.
+ **************************************************************************/
+  int k;
+
+  int nx     = halfspace->nx;
+  int ny     = halfspace->ny;
+  int nxf    = halfspace->imgNx;
+  int nyf    = halfspace->imgNy;
+  int nz     = halfspace->imgNz;
+
+  if (!halfspace->imgStressFFT) return;
+
+#ifdef _OPENMP
+#pragma omp parallel private(k)
+#endif
+  {
+    int i, j, p, q, c, ip, jq;
+    real8 z;
+    COMPLEX *modeS, *in, *out;
+
+    modeS = (COMPLEX *)malloc(sizeof(COMPLEX)*nx*ny*6);
+    in    = (COMPLEX *)fftw_malloc(sizeof(fftw_complex)*nxf*nyf);
+    out   = (COMPLEX *)fftw_malloc(sizeof(fftw_complex)*nxf*nyf);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+    for (k=0; k<nz; k++)
+      {
+	z = halfspace->imgZmin + k*halfspace->imgDz;
+
+	for (i=0; i<nx; i++)
+	  for (j=0; j<ny; j++)
+	    ModeStress(halfspace,i,j,z,&modeS[(i*ny+j)*6]);
+
+	for (c=0; c<6; c++)
+	  {
+	    for (p=0; p<nxf*nyf; p++) in[p] = 0.0;
+
+	    // Mode (i,j) goes to the padded index with the same
+	    // (possibly negative) wave number.
+	    for (i=0; i<nx; i++)
+	      {
+		ip = (halfspace->kx[i] < 0.0) ? nxf-nx+i : i;
+
+		for (j=0; j<ny; j++)
+		  {
+		    jq = (halfspace->ky[j] < 0.0) ? nyf-ny+j : j;
+		    in[jq+ip*nyf] = modeS[(i*ny+j)*6+c];
+		  }
 	      }
+
+	    fftw_execute_dft(halfspace->imgPlan,(fftw_complex *)in,
+			     (fftw_complex *)out);
+
+	    for (p=0; p<nxf; p++)
+	      for (q=0; q<nyf; q++)
+		halfspace->imgStress[IMG_INDEX(k,p,q,c)] =
+		  creal(out[q+p*nyf]);
+	  }
+      }
+
+    free(modeS);
+    fftw_free(in);
+    fftw_free(out);
+  }
+}
+
+void DispStress(HalfSpace_t *halfspace,real8 r[3], real8 stress[3][3])
+{
+/***************************************************************************
+ * This program computes the stress from the displacement field using
+ * elasticity theory in a thin film and tractions computed in HSUtil.c
+ * from AllSegmentStress.c
+ * Sylvie Aubry, Wed Feb 27 2008
+ *
+ **************************************************************************/
+
+  int c, p0, p1, q0, q1, k0, k1;
+  real8 fx, fy, fz, wx, wy, wz;
+  real8 zmax, sig[6];
+
+  int nxf    = halfspace->imgNx;
+  int nyf    = halfspace->imgNy;
+  int nz     = halfspace->imgNz;
+
+  double HSLx     = halfspace->HSLx;
+  double HSLy     = halfspace->HSLy;
+
+  // r is the point at the mid segment between two nodes.
+
+  stress[0][0] = 0.0; stress[0][1] = 0.0; stress[0][2] = 0.0;
+  stress[1][0] = 0.0; stress[1][1] = 0.0; stress[1][2] = 0.0;
+  stress[2][0] = 0.0; stress[2][1] = 0.0; stress[2][2] = 0.0;
+
+  zmax = halfspace->imgZmin + (nz-1)*halfspace->imgDz;
+
+  if (!halfspace->imgStressFFT ||
+      r[2] < halfspace->imgZmin || r[2] > zmax)
+    {
+      DispStressDirect(halfspace,r,stress);
+    }
+  else
+    {
+      // Translated for FFT origin accuracy
+      fx = (r[0] + HSLx*0.5) * nxf / HSLx;
+      fy = (r[1] + HSLy*0.5) * nyf / HSLy;
+      fz = (r[2] - halfspace->imgZmin) / halfspace->imgDz;
+
+      p0 = (int)floor(fx);
+      q0 = (int)floor(fy);
+      k0 = MIN((int)floor(fz), nz-2);
+
+      wx = fx - p0;
+      wy = fy - q0;
+      wz = fz - k0;
+
+      p0 %= nxf; if (p0 < 0) p0 += nxf;
+      q0 %= nyf; if (q0 < 0) q0 += nyf;
+
+      p1 = (p0+1) % nxf;
+      q1 = (q0+1) % nyf;
+      k1 = k0+1;
+
+      for (c=0; c<6; c++)
+	{
+	  sig[c] =
+	    (1.0-wz)*((1.0-wx)*((1.0-wy)*halfspace->imgStress[IMG_INDEX(k0,p0,q0,c)] +
+				     wy *halfspace->imgStress[IMG_INDEX(k0,p0,q1,c)]) +
+		           wx *((1.0-wy)*halfspace->imgStress[IMG_INDEX(k0,p1,q0,c)] +
+				     wy *halfspace->imgStress[IMG_INDEX(k0,p1,q1,c)])) +
+	         wz *((1.0-wx)*((1.0-wy)*halfspace->imgStress[IMG_INDEX(k1,p0,q0,c)] +
+				     wy *halfspace->imgStress[IMG_INDEX(k1,p0,q1,c)]) +
+		           wx *((1.0-wy)*halfspace->imgStress[IMG_INDEX(k1,p1,q0,c)] +
+				     wy *halfspace->imgStress[IMG_INDEX(k1,p1,q1,c)]));
 	}
+
+      stress[0][0] = sig[0];
+      stress[1][1] = sig[1];
+      stress[2][2] = sig[2];
+      stress[2][0] = sig[3];
+      stress[1][2] = sig[4];
+      stress[0][1] = sig[5];
     }
-  int k, l; 
-  for (k=0; k<3; k++) 
-    for (l=0; l<3; l++) 
-      for (i=0; i<nx; i++) 
-	for (j=0; j<ny; j++) 
-	  {	
-	    stress[k][l] += creal(Stress[k][l][i][j]);
-	  }
+
+  if (halfspace->numPatches > 0) PatchStress(halfspace,r,stress);
 
   //printf("stress %f %f %f\n",r[0],r[1],r[2]);
   //printf("%f %f %f %f %f %f\n",stress[0][2],stress[1][2]);
@@ -110,5 +330,3 @@ void DispStress(HalfSpace_t *halfspace,real8 r[3], real8 stress[3][3])
 
   return;
 }
-
-  
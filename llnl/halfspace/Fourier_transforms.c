@@ -1,20 +1,147 @@
 #ifdef _HALFSPACE
 #ifdef _HSIMGSTRESS
 
+#include <string.h>
+
 #include "Home.h"
 #include "HS.h"
 
-void fourier_transform_forward(fftw_complex* M,fftw_complex* m, 
-			       int nx, int ny)
+/***************************************************************************
+ * Forward transforms of the surface tractions.
+ *
+ * The tractions are real and the grid size does not change during a
+ * run, so a single FFTW_MEASURE plan for a batch of real-to-complex
+ * transforms (one per traction component) is created once at startup
+ * and reused every step.  When running in parallel, domain 0 does the
+ * measuring and broadcasts the resulting wisdom so that every domain
+ * executes the same plan and computes identical coefficients.
+ **************************************************************************/
+
+#ifdef PARALLEL
+static void BroadcastWisdom(Home_t *home)
 {
-  fftw_plan plan;
+  int   wisdomLen = 0;
+  char *wisdom = (char *)NULL;
+
+  if (home->myDomain == 0)
+    {
+      wisdom = fftw_export_wisdom_to_string();
+      wisdomLen = strlen(wisdom) + 1;
+    }
+
+  MPI_Bcast(&wisdomLen, 1, MPI_INT, 0, MPI_COMM_WORLD);
 
-  plan = fftw_plan_dft_2d(nx,ny,M,m,FFTW_FORWARD,FFTW_ESTIMATE);
-  fftw_execute(plan);
-  
-  fftw_destroy_plan(plan);
+  if (home->myDomain != 0) wisdom = (char *)malloc(wisdomLen);
+
+  MPI_Bcast(wisdom, wisdomLen, MPI_CHAR, 0, MPI_COMM_WORLD);
+
+  if (home->myDomain != 0) fftw_import_wisdom_from_string(wisdom);
+
+  free(wisdom);
 }
+#endif
 
+void fourier_transform_tractions_init(Home_t *home, TractionFFT_t *fft,
+				      int nx, int ny, int howmany)
+{
+  int n[2];
+  int nyh = ny/2 + 1;
+
+  fft->nx = nx;
+  fft->ny = ny;
+  fft->howmany = howmany;
+
+  fft->in  = (double *)fftw_malloc(sizeof(double)*howmany*nx*ny);
+  fft->out = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*howmany*nx*nyh);
+
+  if (fft->in == NULL || fft->out == NULL)
+    {
+      printf("Not enough memory to allocate traction FFT arrays\n");
+      exit(0);
+    }
+
+  n[0] = nx;
+  n[1] = ny;
+
+#ifdef PARALLEL
+  if (home->myDomain == 0)
 #endif
+    fft->plan = fftw_plan_many_dft_r2c(2, n, howmany,
+				       fft->in, NULL, 1, nx*ny,
+				       fft->out, NULL, 1, nx*nyh,
+				       FFTW_MEASURE);
+#ifdef PARALLEL
+  BroadcastWisdom(home);
+
+  if (home->myDomain != 0)
+    fft->plan = fftw_plan_many_dft_r2c(2, n, howmany,
+				       fft->in, NULL, 1, nx*ny,
+				       fft->out, NULL, 1, nx*nyh,
+				       FFTW_MEASURE);
 #endif
+}
+
+void fourier_transform_tractions(TractionFFT_t *fft, fftw_complex **T,
+				 fftw_complex **t)
+{
+/***************************************************************************
+ * Forward transform the real parts of the <howmany> nx*ny arrays T[]
+ * and return the full (not half) spectra in t[], laid out like the
+ * output of a complex nx*ny transform.  The modes not computed by
+ * the r2c transform are recovered from the Hermitian symmetry
+ * t(i,j) = conj(t(-i,-j)).
+ **************************************************************************/
+  int c, i, j, k, ic;
+  double *Tc, *tc, *hc;
+
+  int nx  = fft->nx;
+  int ny  = fft->ny;
+  int nxy = nx*ny;
+  int nyh = ny/2 + 1;
+
+  // fftw_complex is handled as pairs of doubles so that the same
+  // code serves both the C99 complex and the double[2] definitions.
+  for (c=0; c<fft->howmany; c++)
+    {
+      Tc = (double *)T[c];
+      for (k=0; k<nxy; k++)
+	fft->in[c*nxy+k] = Tc[2*k];
+    }
+
+  fftw_execute(fft->plan);
+
+  for (c=0; c<fft->howmany; c++)
+    {
+      tc = (double *)t[c];
+      hc = (double *)(fft->out + c*nx*nyh);
+
+      for (i=0; i<nx; i++)
+	{
+	  ic = (nx-i) % nx;
 
+	  for (j=0; j<ny; j++)
+	    {
+	      if (j < nyh)
+		{
+		  tc[2*(j+i*ny)]   =  hc[2*(j+i*nyh)];
+		  tc[2*(j+i*ny)+1] =  hc[2*(j+i*nyh)+1];
+		}
+	      else
+		{
+		  tc[2*(j+i*ny)]   =  hc[2*((ny-j)+ic*nyh)];
+		  tc[2*(j+i*ny)+1] = -hc[2*((ny-j)+ic*nyh)+1];
+		}
+	    }
+	}
+    }
+}
+
+void fourier_transform_tractions_free(TractionFFT_t *fft)
+{
+  fftw_destroy_plan(fft->plan);
+  fftw_free(fft->in);
+  fftw_free(fft->out);
+}
+
+#endif
+#endif
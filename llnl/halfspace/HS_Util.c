@@ -133,6 +133,10 @@ void HS_Init(Home_t *home,HalfSpace_t **tf_ptr)
 #ifdef  _HSIMGSTRESS
   /* Allocate dynamic arrays */
   HS_allocations(home,halfspace);
+
+  /* plan the traction transforms */
+  fourier_transform_tractions_init(home,&halfspace->tractionFFT,
+				   halfspace->nx,halfspace->ny,3);
   
   /* compute kx and ky */
   HS_Create_kpoints(halfspace);
@@ -143,6 +147,12 @@ void HS_Init(Home_t *home,HalfSpace_t **tf_ptr)
   /* create cartesian grid */
   HS_Create_Grid(param,halfspace);
 
+  /* create depth layers for the image stress */
+  HS_Create_ImgStressGrid(param,halfspace);
+
+  /* set up the refined surface patches */
+  HS_Create_SurfacePatches(home,halfspace);
+
 #endif
 }
 
@@ -155,6 +165,14 @@ void HS_Step(Home_t *home,HalfSpace_t *halfspace)
   // Calculates ABCEFG coefficient for stress tensor used 
   // in ParaDiS code.
   ABCcoeff(halfspace);
+
+#ifdef _HSIMGSTRESS
+  // Tabulates the image stress for DispStress.
+  HS_ImgStressGrid(halfspace);
+
+  // Corrects the image stress near the surface intersections.
+  HS_SurfacePatches(home,halfspace);
+#endif
 }
 
 
@@ -200,6 +218,20 @@ void HS_Finish(HalfSpace_t * halfspace)
       free(halfspace->Grid[i]);
     }
 
+#ifdef _HSIMGSTRESS
+  fourier_transform_tractions_free(&halfspace->tractionFFT);
+  HS_Free_SurfacePatches(halfspace);
+#endif
+
+  if (halfspace->imgStressFFT)
+    {
+      free(halfspace->imgStress);
+      fftw_destroy_plan(halfspace->imgPlan);
+    }
+
+#ifndef _NOYOFFESTRESS
+  FreeSurfaceSegIndex(&halfspace->yoffeIndex);
+#endif
 }
 
 
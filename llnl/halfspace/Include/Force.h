@@ -10,6 +10,25 @@
  ***************************************************************************/
 #include "Home.h"
 
+/*
+ *      Semi-infinite segment set up by SemiInfiniteSegInit() for use
+ *      with SemiInfiniteSegSegForceSum().
+ */
+typedef struct {
+        real8 p1[3];     /* endpoint on the surface           */
+        real8 p2[3];     /* second point on the segment       */
+        real8 bp[3];     /* burgers vector                    */
+        real8 tp[3];     /* unit line direction p1->p2        */
+        real8 bpctp[3];  /* bp x tp                           */
+        real8 tpdbp;     /* tp . bp                           */
+} SemiInfSeg_t;
+
+/*
+ *      Number of semi-infinite segments SemiInfiniteSegSegForceSum()
+ *      evaluates per vectorized pass.
+ */
+#define SEMI_INF_CHUNK 64
+
 void AddtoArmForce(Node_t *node, int arm, real8 f[3]);
 void AddtoNodeForce(Node_t *node, real8 f[3]);
 void ComputeForces(Home_t *home, Node_t *node1, Node_t *node2,
@@ -26,6 +45,9 @@ void dSegImgStress(Home_t *home, real8 Sigma[][3],
         real8 dlx, real8 dly, real8 dlz,
         real8 burgX, real8 burgY, real8 burgZ,
         real8 rx, real8 ry, real8 rz, int pbc);
+void dSegImgStressRijm(Home_t *home, real8 Sigma[][3], real8 Rijmarray[10],
+        real8 dlx, real8 dly, real8 dlz,
+        real8 burgX, real8 burgY, real8 burgZ);
 void EstRefinementForces(Home_t *home, Node_t *node1, Node_t *node2,
         real8 newPos[3], real8 vec[3], real8 f0Seg1[3], real8 f1Seg1[3],
         real8 f0Seg2[3], real8 f1Seg2[3]);
@@ -42,6 +64,9 @@ void FindSubFSeg(Home_t *home, real8 p1[3], real8 p2[3], real8 burg[3],
         real8 oldfp1[3], real8 oldfp2[3], real8 newpos[3],
         real8 f0seg1[3], real8 f1seg1[3], real8 f0seg2[3],
         real8 f1seg2[3]);
+void InterpolateRijm(Home_t *home, real8 rt[3], real8 Rijmarray[10], int pbc);
+void InterpolateRijmBatch(Home_t *home, int numPoints, real8 (*rt)[3],
+        real8 (*Rijmarray)[10], int *pbc);
 void GetFieldPointStress(Home_t *home, real8 x, real8 y, real8 z,
         real8 totStress[3][3]);
 
@@ -124,6 +149,8 @@ void SelfForce(int coreOnly, real8 MU, real8 NU,
         real8 bx, real8 by, real8 bz, real8 x1, real8 y1, real8 z1,
         real8 x2, real8 y2, real8 z2, real8 a,  real8 Ecore,
         real8 f1[3], real8 f2[3]);
+void SemiInfiniteSegInit(SemiInfSeg_t *seg, real8 p1[3], real8 p2[3],
+        real8 bp[3]);
 void SemiInfiniteSegSegForce(real8 p1x, real8 p1y, real8 p1z,
         real8 p2x, real8 p2y, real8 p2z,
         real8 p3x, real8 p3y, real8 p3z,
@@ -134,6 +161,9 @@ void SemiInfiniteSegSegForce(real8 p1x, real8 p1y, real8 p1z,
         real8 *fp1x, real8 *fp1y, real8 *fp1z,
         real8 *fp3x, real8 *fp3y, real8 *fp3z,
         real8 *fp4x, real8 *fp4y, real8 *fp4z);
+void SemiInfiniteSegSegForceSum(SemiInfSeg_t *segList, int numSegs,
+        real8 x3[3], real8 x4[3], real8 b[3], real8 a, real8 MU, real8 NU,
+        real8 f3[3], real8 f4[3]);
 
 #ifdef _HALFSPACE
 void SetOneNodeForce(Home_t *home, HalfSpace_t *halfspace, Node_t *node1);
@@ -37,6 +37,41 @@ typedef std::complex<double> complex;
  */ 
 #define VALS_PER_SEG 9
 
+/* Persistent batched real-to-complex transform of the surface tractions */
+typedef struct {
+  int           nx, ny, howmany;
+  double*       in;      // howmany real nx*ny arrays
+  fftw_complex* out;     // howmany nx*(ny/2+1) half spectra
+  fftw_plan     plan;
+} TractionFFT_t;
+
+/*
+ * Surface segments that passed SanityCheckYoffe, binned on a uniform
+ * grid by the position of their surface node (see AllYoffeStress.c)
+ */
+typedef struct {
+  int     segCount;
+  real8*  segList;       // VALS_PER_SEG values per segment, sorted by bin
+  real8   cutoff;        // Yoffe cutoff radius, 0 = no cutoff
+  int     nb[3];         // Number of bins in x, y, z
+  real8   binMin[3], binSize;
+  int*    binStart;      // Bin b holds segments binStart[b]..binStart[b+1]-1
+} SurfaceSegIndex_t;
+
+/*
+ * Locally refined correction patch of the surface traction grid
+ * (see SurfacePatches.c).  The patch solves the halfspace problem for
+ * the traction left over by the coarse grid on one tile of the surface,
+ * on a periodic domain twice the tile size centered on the tile.
+ */
+typedef struct {
+  int       tile[2];       // Tile indices in x and y
+  real8     center[2];     // Center of the tile and of the patch domain
+  COMPLEX** A;
+  COMPLEX** B;
+  COMPLEX** C;
+} SurfacePatch_t;
+
 /* Half Space structure definition*/
 struct _halfspace 
 {
@@ -60,6 +95,12 @@ struct _halfspace
   fftw_complex*     Ty;
   fftw_complex*     Tz;
 
+  TractionFFT_t     tractionFFT;                   // Transforms Tx, Ty, Tz
+
+  /* Rows [tractionRow0, tractionRow0+tractionRows) of the traction
+   * grid this domain computes the Yoffe stress for in HS_stress_boundary */
+  int               tractionRow0, tractionRows;
+
   //fftw_complex*     Tx;
   //fftw_complex*     Ty;
   //fftw_complex*     Tz;
@@ -76,6 +117,21 @@ struct _halfspace
 
   double**  Grid[3];
 
+  /* Image stress tabulated on depth layers (see DispStress.c) */
+  int       imgStressFFT;
+  int       imgNx, imgNy, imgNz;
+  double    imgZmin, imgDz;
+  double*   imgStress;
+  fftw_plan imgPlan;
+
+  /* Refined patches on the surface tiles holding surface intersections.
+   * patchModel holds the wave numbers, matrices and traction transform
+   * shared by all the patches, which only differ by their coefficients */
+  int               patchCells, patchRefine;      // Tile width in coarse cells, refinement
+  int               numPatches, allocPatches;
+  SurfacePatch_t*   patches;
+  struct _halfspace *patchModel;
+
 
 #if !defined _NOYOFFESTRESS | !defined _NOVIRTUALSEG
 /*
@@ -87,6 +143,10 @@ struct _halfspace
         int   surfaceSegCount;
         real8 *surfaceSegList;
 #endif
+
+#ifndef _NOYOFFESTRESS
+        SurfaceSegIndex_t yoffeIndex;
+#endif
 };
 
 typedef struct _halfspace HalfSpace_t;
@@ -100,8 +160,15 @@ void HS_allocations(Home_t *home, HalfSpace_t *halfspace);
 void HS_Create_Matrices(HalfSpace_t *halfspace);
 void HS_Create_Grid(Param_t *param, HalfSpace_t *halfspace);
 void HS_Create_kpoints(HalfSpace_t *halfspace);
+void HS_Create_ImgStressGrid(Param_t *param, HalfSpace_t *halfspace);
+void HS_ImgStressGrid(HalfSpace_t *halfspace);
 void HS_stress_boundary(Home_t *home,HalfSpace_t *halfspace);
 
+/* Refined surface patches in HS/SurfacePatches.c */
+void HS_Create_SurfacePatches(Home_t *home, HalfSpace_t *halfspace);
+void HS_SurfacePatches(Home_t *home, HalfSpace_t *halfspace);
+void HS_Free_SurfacePatches(HalfSpace_t *halfspace);
+
 /* ParaDiS routines in HS_Util.c */
 void HS_Init(Home_t *home,HalfSpace_t **tf_ptr);
 void HS_Step(Home_t *home,HalfSpace_t *halfspace);
@@ -118,11 +185,18 @@ void HalfSpace_Remesh(Home_t *home,HalfSpace_t *halfspace);
 void AllSegmentStress(Home_t *home,HalfSpace_t *halfspace,
 		      real8 xm, real8 ym, real8 zm,
                       real8 totStress[3][3]);
+char *MarkNativeSegCells(Home_t *home);
+int  NearNativeSegs(Home_t *home, char *nativeSegCell,
+		    real8 x, real8 y, real8 z);
+int  isRightDom(Home_t *home,real8 x, real8 y, real8 z);
 void FreeCellCters(void);
 
 /* Fourier Transform */
-void  fourier_transform_forward(fftw_complex* M, fftw_complex* m, 
-				int nx, int ny);
+void fourier_transform_tractions_init(Home_t *home, TractionFFT_t *fft,
+				      int nx, int ny, int howmany);
+void fourier_transform_tractions(TractionFFT_t *fft, fftw_complex **T,
+				 fftw_complex **t);
+void fourier_transform_tractions_free(TractionFFT_t *fft);
 
 /* Virtual functions */
 
@@ -141,6 +215,11 @@ void ComputeVirtualForces(Home_t *home, HalfSpace_t *halfspace,
 #ifndef _NOYOFFESTRESS
 void AllYoffeStress(Home_t *, HalfSpace_t *halfspace, 
 		    double, double, double, double[3][3]);
+void AllYoffeStressBatch(Home_t *home, HalfSpace_t *halfspace,
+			 int numPoints, real8 (*r)[3],
+			 real8 (*yofStress)[3][3]);
+void BuildSurfaceSegIndex(Home_t *home, HalfSpace_t *halfspace);
+void FreeSurfaceSegIndex(SurfaceSegIndex_t *index);
 void ComputeYoffeStress(real8 x,real8 y,real8 z,
 			real8 rs[3],real8 rm[3],
 			real8 b[3], real8 MU,real8 NU,
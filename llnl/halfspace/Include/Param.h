@@ -105,6 +105,10 @@ struct _param {
  */
         int   decompType;       /* Selects decomposition type */
         int   DLBfreq;          /* how often to load balance */
+        int   DLBcellCost;      /* Toggles use of the per-cell cost */
+                                /* histogram when placing new domain */
+                                /* boundaries.  If zero, load is     */
+                                /* assumed uniform within a domain   */
         int   numDLBCycles;     /* Number of initial load-balance-only */
                                 /* cycles to be executed before main   */
                                 /* processing loop is entered.  This   */
@@ -265,6 +269,12 @@ struct _param {
                                    /* initialization to point to the      */
                                    /* appropriate mobility function       */
 
+        void  (*mobilityCacheFunc)(Home_t *home, Node_t **nodeList,
+                                   int numNodes);  /* Fills the per-arm   */
+                                   /* mobility cache of a list of nodes   */
+                                   /* before their mobility is evaluated. */
+                                   /* NULL if the law does not cache.     */
+
         real8 MobScrew;
         real8 MobEdge;
         real8 MobClimb;
@@ -546,6 +556,19 @@ struct _param {
   real8 hs_Mx;              /* Bending moments                                  */
   real8 hs_Bend_theta;      /* Angle between the bending axis and x-ais         */
 
+  int hs_imgStressFFT;      /* Toggle: 1 = tabulate the image stress on depth   */
+                            /* layers by inverse FFT and interpolate, 0 = sum   */
+                            /* the Fourier modes directly at each point         */
+  int hs_imgStressOversample; /* In-plane refinement of the image stress grid */
+                            /* relative to hs_nx, hs_ny                         */
+  real8 hs_yoffeCutoff;     /* Only surface segments whose surface node lies    */
+                            /* within this distance of a point contribute to    */
+                            /* its Yoffe stress.  0 = no cutoff                 */
+  int hs_patchCells;        /* Width, in hs_nx x hs_ny grid cells, of the       */
+                            /* surface tiles refined around surface             */
+                            /* intersections.  0 = no refinement                */
+  int hs_patchRefine;       /* Refinement of the tractions on those tiles       */
+
   real8 HS_delSegLength;    /* Counts deleted segments during HS remesh         */
 #endif
 
@@ -143,6 +143,14 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
         BindVar(CPList, "DLBfreq", &param->DLBfreq, V_INT, 1, VFLAG_NULL);
         param->DLBfreq = 3;
 
+/*
+ *      The force routines of this application do not record per-cell
+ *      costs, so keep the per-domain load model unless asked for.
+ */
+        BindVar(CPList, "DLBcellCost", &param->DLBcellCost, V_INT, 1,
+                VFLAG_NULL);
+        param->DLBcellCost = 0;
+
         BindVar(CPList, "xBoundMin", &param->xBoundMin, V_DBL, 1, VFLAG_NULL);
 
         BindVar(CPList, "xBoundMax", &param->xBoundMax, V_DBL, 1, VFLAG_NULL);
@@ -866,6 +874,26 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
                 VFLAG_NULL);
         param->hs_Bend_theta = 0.0;
 
+        BindVar(CPList, "HS_imgStressFFT", &param->hs_imgStressFFT, V_INT, 1,
+                VFLAG_NULL);
+        param->hs_imgStressFFT = 1;
+
+        BindVar(CPList, "HS_imgStressOversample",
+                &param->hs_imgStressOversample, V_INT, 1, VFLAG_NULL);
+        param->hs_imgStressOversample = 2;
+
+        BindVar(CPList, "HS_YoffeCutoff", &param->hs_yoffeCutoff, V_DBL, 1,
+                VFLAG_NULL);
+        param->hs_yoffeCutoff = 0.0;
+
+        BindVar(CPList, "HS_patchCells", &param->hs_patchCells, V_INT, 1,
+                VFLAG_NULL);
+        param->hs_patchCells = 0;
+
+        BindVar(CPList, "HS_patchRefine", &param->hs_patchRefine, V_INT, 1,
+                VFLAG_NULL);
+        param->hs_patchRefine = 4;
+
 #endif
 
         return;
@@ -0,0 +1,420 @@
+/***************************************************************************
+ *
+ *  Module      : SurfacePatches.c
+ *  Description : Locally refined corrections to the surface tractions
+ *                near the surface intersections
+ *
+ *  The coarse nx*ny grid of HS_stress_boundary only cancels the
+ *  tractions at its grid points.  Near a segment crossing the surface
+ *  the traction varies on a scale much smaller than the grid spacing,
+ *  and refining the whole grid to that scale is expensive.  Instead,
+ *  the surface is divided into tiles of param->hs_patchCells coarse
+ *  cells, and each tile holding (or within one coarse cell of) the
+ *  surface node of a segment in halfspace->surfaceSegList gets a patch:
+ *
+ *    - the tractions are evaluated on the tile at param->hs_patchRefine
+ *      times the coarse resolution;
+ *    - the traction of the coarse image stress is subtracted, leaving
+ *      the residual the coarse grid did not cancel.  It vanishes at the
+ *      coarse grid points, so it is small on the tile edges, which lie
+ *      on coarse grid lines;
+ *    - the residual, zero outside the tile, is solved for with the same
+ *      Fourier method as the coarse grid, on a periodic domain twice
+ *      the tile size centered on the tile.
+ *
+ *  DispStress adds the stress of every patch whose domain holds the
+ *  field point (down to a depth of one domain width, below which the
+ *  lowest patch mode has decayed to a few 1e-3).  The tiles do not
+ *  overlap, so neither do the residuals.
+ *
+ *  All the patches share the wave numbers, matrices and traction
+ *  transform of halfspace->patchModel and only differ by their A, B, C
+ *  coefficients.  The patches are few and small, so every domain
+ *  solves all of them; only the traction evaluation is distributed.
+ *
+ **************************************************************************/
+
+#include <string.h>
+
+#include "Home.h"
+#include "Util.h"
+
+#ifdef _HALFSPACE
+#ifdef _HSIMGSTRESS
+
+#include "HS.h"
+
+static COMPLEX **AllocCoeff(int nx, int ny)
+{
+  int i;
+  COMPLEX **a;
+
+  a = (COMPLEX **)malloc(sizeof(COMPLEX*)*nx);
+  if (a == NULL) Fatal("Not enough memory to allocate patch coefficients");
+
+  for (i=0; i<nx; i++)
+    {
+      a[i] = (COMPLEX *)malloc(sizeof(COMPLEX)*ny);
+      if (a[i] == NULL)
+	Fatal("Not enough memory to allocate patch coefficients");
+    }
+
+  return a;
+}
+
+static void FreeCoeff(COMPLEX **a, int nx)
+{
+  int i;
+
+  for (i=0; i<nx; i++) free(a[i]);
+  free(a);
+}
+
+void HS_Create_SurfacePatches(Home_t *home, HalfSpace_t *halfspace)
+{
+  // Set up the model patch: a periodic domain of two by two tiles,
+  // sampled at the refined resolution.
+
+  int i, j, nPad;
+  Param_t *param = home->param;
+  HalfSpace_t *model;
+
+  halfspace->patchCells  = param->hs_patchCells;
+  halfspace->patchRefine = MAX(1, param->hs_patchRefine);
+  halfspace->numPatches  = 0;
+
+  if (halfspace->patchCells <= 0) return;
+
+  if (halfspace->nx % halfspace->patchCells != 0 ||
+      halfspace->ny % halfspace->patchCells != 0)
+    Fatal("HS_patchCells (%d) must divide HS_nx (%d) and HS_ny (%d)",
+	  halfspace->patchCells, halfspace->nx, halfspace->ny);
+
+  nPad = 2*halfspace->patchCells*halfspace->patchRefine;
+
+  model = (HalfSpace_t *)calloc(1, sizeof(HalfSpace_t));
+  halfspace->patchModel = model;
+
+  model->nx     = nPad;
+  model->ny     = nPad;
+  model->HSLx   = 2.0*halfspace->patchCells*halfspace->HSLx/halfspace->nx;
+  model->HSLy   = 2.0*halfspace->patchCells*halfspace->HSLy/halfspace->ny;
+  model->mu     = halfspace->mu;
+  model->nu     = halfspace->nu;
+  model->lambda = halfspace->lambda;
+
+  model->kx = (double *)malloc(sizeof(double)*nPad);
+  model->ky = (double *)malloc(sizeof(double)*nPad);
+  model->Tx = (fftw_complex *)malloc(sizeof(fftw_complex)*nPad*nPad);
+  model->Ty = (fftw_complex *)malloc(sizeof(fftw_complex)*nPad*nPad);
+  model->Tz = (fftw_complex *)malloc(sizeof(fftw_complex)*nPad*nPad);
+
+  if (model->kx == NULL || model->ky == NULL ||
+      model->Tx == NULL || model->Ty == NULL || model->Tz == NULL)
+    Fatal("Not enough memory to allocate the surface patches");
+
+  for (i=0; i<3; i++)
+    for (j=0; j<3; j++)
+      model->MInv[i][j] = AllocCoeff(nPad, nPad);
+
+  HS_Create_kpoints(model);
+  Minvmatrix(model);
+
+  fourier_transform_tractions_init(home,&model->tractionFFT,nPad,nPad,3);
+
+  // Only the tile is filled in later on, the rest of the domain stays
+  // traction free.
+  memset(model->Tx, 0, sizeof(fftw_complex)*nPad*nPad);
+  memset(model->Ty, 0, sizeof(fftw_complex)*nPad*nPad);
+  memset(model->Tz, 0, sizeof(fftw_complex)*nPad*nPad);
+
+  if (home->myDomain == 0)
+    printf("Surface patches of %d x %d cells refined %d times\n\n",
+	   halfspace->patchCells, halfspace->patchCells,
+	   halfspace->patchRefine);
+}
+
+void HS_Free_SurfacePatches(HalfSpace_t *halfspace)
+{
+  int i, j, nPad;
+  HalfSpace_t *model = halfspace->patchModel;
+
+  if (model == (HalfSpace_t *)NULL) return;
+
+  nPad = model->nx;
+
+  for (i=0; i<halfspace->allocPatches; i++)
+    {
+      FreeCoeff(halfspace->patches[i].A, nPad);
+      FreeCoeff(halfspace->patches[i].B, nPad);
+      FreeCoeff(halfspace->patches[i].C, nPad);
+    }
+  free(halfspace->patches);
+
+  for (i=0; i<3; i++)
+    for (j=0; j<3; j++)
+      FreeCoeff(model->MInv[i][j], nPad);
+
+  fourier_transform_tractions_free(&model->tractionFFT);
+
+  free(model->kx);free(model->ky);
+  free(model->Tx);free(model->Ty);free(model->Tz);
+  free(model);
+
+  halfspace->patchModel   = (HalfSpace_t *)NULL;
+  halfspace->patches      = (SurfacePatch_t *)NULL;
+  halfspace->numPatches   = 0;
+  halfspace->allocPatches = 0;
+}
+
+static int MarkPatchTiles(Home_t *home, HalfSpace_t *halfspace,
+			  char *tileMark, int ntx, int nty)
+{
+  // Mark the tiles holding a surface node, and their neighbors when
+  // the node is within one coarse cell of the common edge.
+
+  int numTiles = 0;
+
+#if !defined _NOYOFFESTRESS | !defined _NOVIRTUALSEG
+  int   s, ix, iy, dx, dy, tx, ty, lox, hix, loy, hiy;
+  real8 fx, fy, margin;
+  Param_t *param = home->param;
+
+  real8 tileX = halfspace->HSLx/ntx;
+  real8 tileY = halfspace->HSLy/nty;
+
+  margin = 1.0/halfspace->patchCells;
+
+  for (s=0; s<halfspace->surfaceSegCount; s++)
+    {
+      fx = (halfspace->surfaceSegList[s*VALS_PER_SEG  ] - param->minSideX)/tileX;
+      fy = (halfspace->surfaceSegList[s*VALS_PER_SEG+1] - param->minSideY)/tileY;
+
+      ix = (int)floor(fx);
+      iy = (int)floor(fy);
+
+      fx -= ix;
+      fy -= iy;
+
+      lox = (fx < margin)       ? -1 : 0;
+      hix = (fx > 1.0 - margin) ?  1 : 0;
+      loy = (fy < margin)       ? -1 : 0;
+      hiy = (fy > 1.0 - margin) ?  1 : 0;
+
+      for (dx=lox; dx<=hix; dx++)
+	for (dy=loy; dy<=hiy; dy++)
+	  {
+	    tx = (ix+dx) % ntx; if (tx < 0) tx += ntx;
+	    ty = (iy+dy) % nty; if (ty < 0) ty += nty;
+
+	    if (!tileMark[tx*nty+ty]) numTiles++;
+	    tileMark[tx*nty+ty] = 1;
+	  }
+    }
+#endif
+
+  return numTiles;
+}
+
+void HS_SurfacePatches(Home_t *home, HalfSpace_t *halfspace)
+{
+  // Rebuild the patches around the current surface intersections.
+  // Must be called after ABCcoeff and HS_ImgStressGrid, since the
+  // residual tractions are taken against the coarse image stress.
+
+  int i, j, k, a, b, n, numTiles, tx, ty;
+  int ntx, nty, nt, i0, nPad, numPoints, doPoint;
+  char *tileMark, *nativeSegCell;
+  real8 tileX, tileY, hx, hy, x0, y0;
+  real8 s[3][3], sc[3][3], r[3];
+  real8 (*pts)[3], *t, *T[3];
+  SurfacePatch_t *patch;
+  HalfSpace_t *model = halfspace->patchModel;
+  Param_t *param = home->param;
+
+  int numDomains = home->numDomains;
+  int myDomain   = home->myDomain;
+
+  // DispStress must only see the coarse image stress below.
+  halfspace->numPatches = 0;
+
+  if (model == (HalfSpace_t *)NULL) return;
+
+  ntx  = halfspace->nx/halfspace->patchCells;
+  nty  = halfspace->ny/halfspace->patchCells;
+  nt   = halfspace->patchCells*halfspace->patchRefine;
+  nPad = model->nx;
+  i0   = (nPad - nt)/2;
+
+  tileX = halfspace->HSLx/ntx;
+  tileY = halfspace->HSLy/nty;
+  hx    = tileX/nt;
+  hy    = tileY/nt;
+
+  tileMark = (char *)calloc(ntx*nty, sizeof(char));
+  numTiles = MarkPatchTiles(home, halfspace, tileMark, ntx, nty);
+
+  if (numTiles == 0)
+    {
+      free(tileMark);
+      return;
+    }
+
+  if (numTiles > halfspace->allocPatches)
+    {
+      halfspace->patches = (SurfacePatch_t *)
+	realloc(halfspace->patches, sizeof(SurfacePatch_t)*numTiles);
+      if (halfspace->patches == NULL)
+	Fatal("Not enough memory to allocate the surface patches");
+
+      for (n=halfspace->allocPatches; n<numTiles; n++)
+	{
+	  halfspace->patches[n].A = AllocCoeff(nPad, nPad);
+	  halfspace->patches[n].B = AllocCoeff(nPad, nPad);
+	  halfspace->patches[n].C = AllocCoeff(nPad, nPad);
+	}
+      halfspace->allocPatches = numTiles;
+    }
+
+  // Tiles in a fixed order so every domain builds the same list.  The
+  // domain of a patch is centered on its tile.
+  n = 0;
+  for (tx=0; tx<ntx; tx++)
+    for (ty=0; ty<nty; ty++)
+      {
+	if (!tileMark[tx*nty+ty]) continue;
+
+	patch = &halfspace->patches[n++];
+	patch->tile[0]   = tx;
+	patch->tile[1]   = ty;
+	patch->center[0] = param->minSideX + tx*tileX - i0*hx + 0.5*model->HSLx;
+	patch->center[1] = param->minSideY + ty*tileY - i0*hy + 0.5*model->HSLy;
+      }
+  free(tileMark);
+
+  // Refined points of all the tiles, nt*nt per tile
+  numPoints = numTiles*nt*nt;
+  pts = (real8 (*)[3])malloc(sizeof(real8[3])*numPoints);
+  t   = (real8 *)calloc(numPoints*3, sizeof(real8));
+
+  for (n=0; n<numTiles; n++)
+    {
+      patch = &halfspace->patches[n];
+      x0 = param->minSideX + patch->tile[0]*tileX;
+      y0 = param->minSideY + patch->tile[1]*tileY;
+
+      for (a=0; a<nt; a++)
+	for (b=0; b<nt; b++)
+	  {
+	    k = (n*nt + a)*nt + b;
+	    pts[k][0] = x0 + a*hx;
+	    pts[k][1] = y0 + b*hy;
+	    pts[k][2] = 0.0;
+	  }
+    }
+
+  // Tractions at the refined points, split among the domains like in
+  // HS_stress_boundary: the local stress near the native segments, the
+  // remote stress inside the domain and the Yoffe stress on an equal
+  // share of the points.
+  nativeSegCell = MarkNativeSegCells(home);
+
+  for (k=0; k<numPoints; k++)
+    {
+      doPoint = NearNativeSegs(home,nativeSegCell,
+			       pts[k][0],pts[k][1],pts[k][2]) ||
+	        (isRightDom(home,pts[k][0],pts[k][1],pts[k][2]) == myDomain);
+
+      if (!doPoint) continue;
+
+      AllSegmentStress(home,halfspace,pts[k][0],pts[k][1],pts[k][2],s);
+
+      t[k*3  ] = -s[0][2];
+      t[k*3+1] = -s[1][2];
+      t[k*3+2] = -s[2][2];
+    }
+
+  free(nativeSegCell);
+
+#ifndef _NOYOFFESTRESS
+  {
+    int m;
+    real8 (*ypts)[3], (*Ys)[3][3];
+
+    m = (numPoints - myDomain + numDomains - 1)/numDomains;
+    ypts = (real8 (*)[3])malloc(sizeof(real8[3])*(m+1));
+    Ys   = (real8 (*)[3][3])malloc(sizeof(real8[3][3])*(m+1));
+
+    for (j=0; j<m; j++)
+      {
+	k = myDomain + j*numDomains;
+	ypts[j][0] = pts[k][0];
+	ypts[j][1] = pts[k][1];
+	ypts[j][2] = pts[k][2];
+      }
+
+    AllYoffeStressBatch(home,halfspace,m,ypts,Ys);
+
+    for (j=0; j<m; j++)
+      {
+	k = myDomain + j*numDomains;
+	t[k*3  ] -= Ys[j][0][2];
+	t[k*3+1] -= Ys[j][1][2];
+	t[k*3+2] -= Ys[j][2][2];
+      }
+
+    free(ypts);free(Ys);
+  }
+#endif
+
+#ifdef PARALLEL
+  MPI_Allreduce(MPI_IN_PLACE, t, numPoints*3, MPI_DOUBLE, MPI_SUM,
+		MPI_COMM_WORLD);
+#endif
+
+  // Subtract the traction of the coarse image stress and solve each
+  // patch for what is left.  Only the real parts of the tractions are
+  // set (see fourier_transform_tractions).
+  T[0] = (real8 *)model->Tx;
+  T[1] = (real8 *)model->Ty;
+  T[2] = (real8 *)model->Tz;
+
+  for (n=0; n<numTiles; n++)
+    {
+      patch = &halfspace->patches[n];
+
+      for (a=0; a<nt; a++)
+	for (b=0; b<nt; b++)
+	  {
+	    k = (n*nt + a)*nt + b;
+
+	    r[0] = pts[k][0];
+	    r[1] = pts[k][1];
+	    r[2] = pts[k][2];
+	    DispStress(halfspace,r,sc);
+
+	    i = i0 + a;
+	    j = i0 + b;
+	    T[0][2*(j+i*nPad)] = t[k*3  ] - sc[0][2];
+	    T[1][2*(j+i*nPad)] = t[k*3+1] - sc[1][2];
+	    T[2][2*(j+i*nPad)] = t[k*3+2] - sc[2][2];
+	  }
+
+      model->A = patch->A;
+      model->B = patch->B;
+      model->C = patch->C;
+
+      ABCcoeff(model);
+    }
+
+  model->A = (COMPLEX **)NULL;
+  model->B = (COMPLEX **)NULL;
+  model->C = (COMPLEX **)NULL;
+
+  free(pts);free(t);
+
+  halfspace->numPatches = numTiles;
+}
+
+#endif
+#endif
@@ -187,6 +187,54 @@ void HS_Create_Grid(Param_t *param, HalfSpace_t *halfspace)
     }
 }
 
+void HS_Create_ImgStressGrid(Param_t *param, HalfSpace_t *halfspace)
+{
+  // Depth layers on which HS_ImgStressGrid tabulates the image
+  // stress.  The layers run from the bottom of the simulation box
+  // up to the free surface at z = 0 and are spaced like the
+  // in-plane grid points.
+
+  int ov;
+  real8 depth, dz;
+  fftw_complex *in, *out;
+
+  halfspace->imgStressFFT = param->hs_imgStressFFT;
+  if (!halfspace->imgStressFFT) return;
+
+  ov = MAX(1, param->hs_imgStressOversample);
+
+  halfspace->imgNx = ov*halfspace->nx;
+  halfspace->imgNy = ov*halfspace->ny;
+
+  dz = MIN(halfspace->HSLx/halfspace->imgNx, halfspace->HSLy/halfspace->imgNy);
+  depth = MAX(-param->minSideZ, dz);
+
+  halfspace->imgNz = (int)ceil(depth/dz) + 1;
+  halfspace->imgDz = depth/(halfspace->imgNz-1);
+  halfspace->imgZmin = -depth;
+
+  halfspace->imgStress = (double *)malloc(sizeof(double)*6*halfspace->imgNz*
+					  halfspace->imgNx*halfspace->imgNy);
+  if (halfspace->imgStress == NULL) 
+    {
+      printf("Not enough memory to allocate image stress grid\n");
+      exit(0);
+    }
+
+  // FFTW_ESTIMATE does not touch the arrays, which are only needed
+  // here to set up the plan.  HS_ImgStressGrid executes the plan on
+  // its own (per thread) arrays.
+  in  = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+				    halfspace->imgNx*halfspace->imgNy);
+  out = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+				    halfspace->imgNx*halfspace->imgNy);
+
+  halfspace->imgPlan = fftw_plan_dft_2d(halfspace->imgNx,halfspace->imgNy,
+					in,out,FFTW_BACKWARD,FFTW_ESTIMATE);
+  fftw_free(in);
+  fftw_free(out);
+}
+
 void HS_Create_kpoints(HalfSpace_t *halfspace)
 {
   int i,j;
@@ -223,93 +271,134 @@ void HS_stress_boundary(Home_t *home,HalfSpace_t *halfspace)
   // Calculate Tractions on half space surfaces from stress in the system
   // F = sigma . n  = -T 
   // Done every time step 
-
-  int i,j,k,l;
+  //
+  // Each domain only evaluates the grid points its own segments
+  // contribute to: the points near cells holding its native segments
+  // (local stress), the points inside its domain (remote stress) and,
+  // for the Yoffe stress which is computed from the global surface
+  // segment list, the points of its slice of grid rows.  The partial
+  // tractions are then summed over all domains, since every domain
+  // does the traction FFT on the whole grid.
+
+  int i,j,k,n;
+  int doPoint, inSlice;
+  char *nativeSegCell;
   real8 s[3][3],grids[3];
+  real8 (*pts)[3], (*Ys)[3][3];
 
   int nx = halfspace->nx;
   int ny = halfspace->ny;
-  real8 HSLx = halfspace->HSLx;
-  real8 HSLy = halfspace->HSLy;
-  real8 *tx, *ty, *tz, *tx_tot, *ty_tot, *tz_tot;
+  int numDomains = home->numDomains;
+  int myDomain   = home->myDomain;
+  real8 *t, *t_tot;
+
+  // Rows of the traction grid this domain computes the Yoffe stress for
+  halfspace->tractionRow0 = (myDomain*nx)/numDomains;
+  halfspace->tractionRows = ((myDomain+1)*nx)/numDomains - 
+                            halfspace->tractionRow0;
+
+  // The three components of a grid point are kept together
+  t     = (real8 *)calloc(1, sizeof(double)*nx*ny*3);
+  t_tot = (real8 *)malloc(sizeof(double)*nx*ny*3);
 
-  // Allocate tx, ty, tz
-  tx = (real8 *)malloc(sizeof(double)*nx*ny);
-  ty = (real8 *)malloc(sizeof(double)*nx*ny);
-  tz = (real8 *)malloc(sizeof(double)*nx*ny);
+  nativeSegCell = MarkNativeSegCells(home);
 
-  tx_tot = (real8 *)malloc(sizeof(double)*nx*ny);
-  ty_tot = (real8 *)malloc(sizeof(double)*nx*ny);
-  tz_tot = (real8 *)malloc(sizeof(double)*nx*ny);
+#ifndef _NOYOFFESTRESS
+  // Yoffe stress at all the points of this domain's rows at once
+  n = halfspace->tractionRows*ny;
+  pts = (real8 (*)[3])malloc(sizeof(real8[3])*(n+1));
+  Ys  = (real8 (*)[3][3])malloc(sizeof(real8[3][3])*(n+1));
+
+  for (k=0; k<n; k++) 
+    {
+      i = halfspace->tractionRow0 + k/ny;
+      j = k % ny;
+      pts[k][0] = halfspace->Grid[0][i][j];
+      pts[k][1] = halfspace->Grid[1][i][j];
+      pts[k][2] = halfspace->Grid[2][i][j];
+    }
 
+  AllYoffeStressBatch(home,halfspace,n,pts,Ys);
+#endif
 
   // Top surface 
   for (i=0; i<nx; i++) 
-    for (j=0; j<ny; j++) 
-      {
-	grids[0] = halfspace->Grid[0][i][j];
-	grids[1] = halfspace->Grid[1][i][j];
-	grids[2] = halfspace->Grid[2][i][j];
-	
-	AllSegmentStress(home,halfspace,grids[0],grids[1],grids[2],s);
+    {
+      inSlice = (i >= halfspace->tractionRow0 && 
+		 i <  halfspace->tractionRow0 + halfspace->tractionRows);
+
+      for (j=0; j<ny; j++) 
+	{
+	  grids[0] = halfspace->Grid[0][i][j];
+	  grids[1] = halfspace->Grid[1][i][j];
+	  grids[2] = halfspace->Grid[2][i][j];
+
+	  doPoint = NearNativeSegs(home,nativeSegCell,
+				   grids[0],grids[1],grids[2]) ||
+	            (isRightDom(home,grids[0],grids[1],grids[2]) == myDomain);
+
+	  if (doPoint)
+	    AllSegmentStress(home,halfspace,grids[0],grids[1],grids[2],s);
+	  else
+	    Init3x3(s);
 
-#if 1
 #ifndef _NOYOFFESTRESS
-	int ii,jj;
-	real8 Ys[3][3];
-	AllYoffeStress(home,halfspace,grids[0],grids[1],grids[2],Ys);
-	for (ii=0; ii<3; ii++) 
-	  for (jj=0; jj<3; jj++)
-	    s[ii][jj] += Ys[ii][jj];
-#endif
+	  int ii,jj;
+	  if (inSlice)
+	    {
+	      k = (i-halfspace->tractionRow0)*ny + j;
+	      for (ii=0; ii<3; ii++) 
+		for (jj=0; jj<3; jj++)
+		  s[ii][jj] += Ys[k][ii][jj];
+	      doPoint = 1;
+	    }
 #endif
 
-        tx[j+i*ny+nx*ny] = -s[0][2];
-        ty[j+i*ny+nx*ny] = -s[1][2];
-        tz[j+i*ny+nx*ny] = -s[2][2];
-      }
+	  if (!doPoint) continue;
+
+	  k = (j+i*ny)*3;
+	  t[k  ] = -s[0][2];
+	  t[k+1] = -s[1][2];
+	  t[k+2] = -s[2][2];
+	}
+    }
+
+  free(nativeSegCell);
+
+#ifndef _NOYOFFESTRESS
+  free(pts);free(Ys);
+#endif
 
 #ifdef PARALLEL
-  MPI_Allreduce(tx, tx_tot, nx*ny, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(ty, ty_tot, nx*ny, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(tz, tz_tot, nx*ny, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(t, t_tot, nx*ny*3, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
 #else
-  for (i = 0; i < nx; i++)
-    for (j = 0; j < ny; j++)
-      {
-	tx_tot[j+i*ny] = tx[j+i*ny];
-	ty_tot[j+i*ny] = ty[j+i*ny];
-	tz_tot[j+i*ny] = tz[j+i*ny];
-      }
+  for (k=0; k<nx*ny*3; k++) t_tot[k] = t[k];
 #endif
 
-
-
   for (i=0; i<nx; i++)
     {
       for (j=0; j<ny; j++) 
 	{
+	  k = (j+i*ny)*3;
 #ifndef _CYGWIN
-        halfspace->Tx[j+i*ny] = tx_tot[j+i*ny+nx*ny];
-	halfspace->Ty[j+i*ny] = ty_tot[j+i*ny+nx*ny];
-	halfspace->Tz[j+i*ny] = tz_tot[j+i*ny+nx*ny];
+	  halfspace->Tx[j+i*ny] = t_tot[k  ];
+	  halfspace->Ty[j+i*ny] = t_tot[k+1];
+	  halfspace->Tz[j+i*ny] = t_tot[k+2];
 #else
-	halfspace->Tx[j+i*ny][0] = tx_tot[j+i*ny+nx*ny];
-	halfspace->Ty[j+i*ny][0] = ty_tot[j+i*ny+nx*ny];
-	halfspace->Tz[j+i*ny][0] = tz_tot[j+i*ny+nx*ny];
+	  halfspace->Tx[j+i*ny][0] = t_tot[k  ];
+	  halfspace->Ty[j+i*ny][0] = t_tot[k+1];
+	  halfspace->Tz[j+i*ny][0] = t_tot[k+2];
 
-	halfspace->Tx[j+i*ny][1] = 0.0;
-	halfspace->Ty[j+i*ny][1] = 0.0;
-	halfspace->Tz[j+i*ny][1] = 0.0;
+	  halfspace->Tx[j+i*ny][1] = 0.0;
+	  halfspace->Ty[j+i*ny][1] = 0.0;
+	  halfspace->Tz[j+i*ny][1] = 0.0;
 #endif
-      }
+	}
     }
 
-  free(tx);free(ty);free(tz);
-  free(tx_tot);free(ty_tot);free(tz_tot);
+  free(t);free(t_tot);
 }
 
-
 int Split(Home_t *home,Node_t *nodeout,Node_t *nodein, real8 t)
 {
   // Create a node between nodeout and nodein on the halfspace surface.
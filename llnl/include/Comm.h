@@ -37,6 +37,15 @@
 #define FLTS_PER_MIRROR_ARM  9
 #define EXTRA_MIRROR_INTS    6
 
+/*
+ *	For sending the reduced segment summary to domain zero for
+ *	X-window plotting.  Each segment is sent as the coordinates
+ *	of both endpoints, the owning domain (or -1 if the segment
+ *	spans domains) and a color index derived from the burgers
+ *	vector.
+ */
+#define VALS_PER_PLOT_SEG    8
+
 /*
  *	message tags
  */
@@ -18,6 +18,37 @@
 #define DLB_USE_WALLCLK_TIME    0
 #define DLB_USE_FORCECALC_COUNT 1
 
+/*
+ *      When the cell-based cost model is enabled, the work done each
+ *      cycle is accumulated per simulation cell and the cell costs of
+ *      each domain are later scaled so they sum to the domain's
+ *      measured load.  The weights below therefore only need to
+ *      reflect the cost of the various operations relative to one
+ *      another.
+ *
+ *      DLB_COST_SEGPAIR    one segment/segment force calculation
+ *      DLB_COST_NATIVESEG  self-force, PK force, etc. for one native
+ *                          segment
+ *      DLB_COST_GAUSSPT    one Gauss point evaluation of the remote
+ *                          (fast multipole) stress on a segment
+ *      DLB_COST_COLLISION  one candidate node examined during
+ *                          collision handling
+ */
+#define DLB_COST_SEGPAIR    1.0
+#define DLB_COST_NATIVESEG  1.0
+#define DLB_COST_GAUSSPT    1.0
+#define DLB_COST_COLLISION  0.25
+
+/*
+ *      The global load histogram consists of one piece per simulation
+ *      cell per domain.  Each piece contains DLB_PIECE_SIZE values; the
+ *      load followed by the min and max coordinates of the portion of
+ *      the cell within the domain.  When the histogram is projected
+ *      onto a single dimension, DLB_PROFILE_BINS bins are used per cell.
+ */
+#define DLB_PIECE_SIZE      7
+#define DLB_PROFILE_BINS    16
+
 /*
  *      When allocating an RB decomposition structure, in some cases
  *      we want to allocate a new decomposition and initialize it from
@@ -79,18 +110,48 @@ struct _rbdecomp {
 };
 
 
+/*
+ *      The SFCDecomp_t structure defines a decomposition in which the
+ *      simulation cells are ordered along a Hilbert space-filling curve
+ *      and each domain owns a contiguous range of the curve.  Domain
+ *      <n> owns the cells at curve positions domStart[n] through
+ *      domStart[n+1]-1.  The bounding box of the cells owned by each
+ *      domain is kept in domBounds (min XYZ followed by max XYZ) and is
+ *      what the rest of the code sees as the domain boundaries.
+ *
+ *      Cells are identified here by (i * nYcells + j) * nZcells + k
+ *      where i, j, k are the zero-based indices of a primary cell.
+ *
+ *      See comments in SFCDecomp.c for more details.
+ */
+typedef struct {
+        int     cellGeom[3];
+        int     numCells;
+        int     numDomains;
+        int     *domStart;
+        int     *cellOrder;
+        int     *cellRank;
+        real8   *domBounds;
+} SFCDecomp_t;
+
+
 /*
  *      Include prototypes for the set of generic function calls
  *      used to obtain information related to the domain decomposition.
  */
+void AddCellCost(Home_t *home, real8 x, real8 y, real8 z, real8 cost);
 void BroadcastDecomp(Home_t *home, void *decomp);
 void DLBfreeOld(Home_t *home);
 int  FindCoordDomain(Home_t *home, int updateCoords, real8 *x,
          real8 *y, real8 *z);
+real8 FindCellLoadCoord(Home_t *home, real8 *profile, int dim,
+         real8 minCoord, real8 maxCoord, real8 neededLoad);
 void FreeDecomp(Home_t *home, void *decomp);
 void GetAllDecompBounds(Home_t *home, real8 **decompBounds, int *numValues);
 void GetCellDomainList(Home_t *home, int cellID, int *domCount,
          int **domList);
+real8 GetCellLoadProfile(Home_t *home, real8 boxMin[3], real8 boxMax[3],
+         int dim, real8 **profile);
 void GetLocalDomainBounds(Home_t *home, void *decomp);
 void XPlotDecomp(Home_t *home, real8 xMin, real8 yMin, real8 zMin,
          real8 lMax, int color, real8 lineWidth);
@@ -60,4 +60,29 @@ int  Mobility_FCC_0b(Home_t *home, Node_t *node);
 int  Mobility_FCC_climb(Home_t *home, Node_t *node);
 int  Mobility_Relax(Home_t *home, Node_t *node);
 
+/*
+ *      Evaluate the mobility function for a list of nodes (threaded
+ *      if OpenMP is enabled).  Returns 1 if the velocity of any node
+ *      could not be calculated, 0 otherwise.
+ */
+int  EvalMobilityBatch(Home_t *home, Node_t **nodeList, int numNodes,
+         int zeroOnErr);
+
+/*
+ *      Per-arm cache of the values a mobility law computes for a
+ *      single segment (see MobilityCache.c).  A MobSegFunc_t computes
+ *      those values from the segment vector (neighbor position minus
+ *      node position, after ZImage()) and the burgers vector of an arm.
+ */
+typedef void (*MobSegFunc_t)(Home_t *home, real8 seg[3], real8 burg[3],
+         real8 *values);
+
+void   MobilityCacheFill(Home_t *home, Node_t **nodeList, int numNodes,
+         MobSegFunc_t segFunc);
+real8 *MobilityCacheLookup(Home_t *home, Node_t *node, int arm,
+         real8 seg[3], real8 burg[3]);
+
+void   MobilityCache_BCC_0(Home_t *home, Node_t **nodeList, int numNodes);
+void   MobilityCache_FCC_0(Home_t *home, Node_t **nodeList, int numNodes);
+
 #endif /* _MOBILITY_H */
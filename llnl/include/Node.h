@@ -32,6 +32,7 @@
 #define NO_COLLISIONS        0x04
 #define NO_MESH_COARSEN      0x08
 #define NODE_CHK_DBL_LINK    0x10
+#define NODE_REMESH_LOCK     0x20
 
 /*
  *      Used as bit flags to indicate the type of nodal data items
@@ -41,6 +42,15 @@
 #define NODE_CURR_VEL 0x02
 #define NODE_OLD_VEL  0x04
 
+/*
+ *      Layout of the per-arm mobility cache (see MobilityCache.c).
+ *      Each arm owns MOB_CACHE_SIZE values: the segment vector and
+ *      burgers vector the entry was computed for, followed by the
+ *      values the mobility law computed for that segment.
+ */
+#define MOB_CACHE_KEY_SIZE 6
+#define MOB_CACHE_SIZE     (MOB_CACHE_KEY_SIZE + 13)
+
 struct _node {
 	int	flags;
         
@@ -75,6 +85,9 @@ struct _node {
 	real8	*sigbLoc;		/* sig.b on arms (numNbr*3) */
 	real8	*sigbRem;		/* sig.b on arms (numNbr*3) */
 
+	real8	*mobCache;		/* per-arm mobility cache */
+					/* (numNbr*MOB_CACHE_SIZE)  */
+
 	int	*armCoordIndex;		/* Array of indices (1 per arm) into */
 					/* the mirror domain's arrays of     */
 					/* coordinates (armX, armY, armZ)    */
@@ -27,7 +27,17 @@ void  CreateFCCPerfectLoop(Home_t *home, InData_t *inData, int cubeLength,
           int numChains, int seed, real8 *totDislocLen, int dislocType);
 void  InitRemesh(InData_t *inData, int domValue, int startIndex);
 real8 randm(int *seed);
-void  WriteInitialNodeData(Home_t *home, InData_t *inData, int lastBlock);
+void  WriteInitialNodeData(Home_t *home, InData_t *inData, int numSections,
+          int *sectionLen);
+
+
+/*
+ *      Maximum number of sections into which a generator may split
+ *      its nodes when writing the data file.  Only generators that
+ *      do not number their nodes consecutively by chain/loop need
+ *      more than one section (see WriteInitialNodeData()).
+ */
+#define MAX_GEN_SECTIONS	2
 
 
 /*
@@ -73,12 +73,16 @@ void GetMinDist(
         real8 *dist2, real8 *ddist2dt, real8 *L1, real8 *L2);
 void GetNbrCoords(Home_t *home, Node_t *node, int arm, real8 *x, real8 *y,
         real8 *z);
+int  GetBurgIndex(Home_t *home, real8 burg[3]);
+int  *GetCrossSlipCandidates(Home_t *home, real8 thetacrit,
+        real8 noiseFactor, real8 weightFactor, int *numCandidates);
 void GetParallelIOGroup(Home_t *home);
 void HandleCollisions(Home_t *home);
 void PredictiveCollisions(Home_t *home);
 void ProximityCollisions(Home_t *home);
 void HeapAdd(int **heap, int *heapSize, int *heapCnt, int value);
 int  HeapRemove(int *heap, int *heapCnt);
+void InitBurgInfo(Home_t *home);
 void InitRemoteDomains(Home_t *home);
 void InputSanity(Home_t *home);
 void LoadCurve(Home_t *home, real8 deltaStress[3][3]);
@@ -93,6 +97,7 @@ void RemapArmTag(Home_t *home, Tag_t *oldTag, Tag_t *newTag);
 void Remesh(Home_t *home);
 void RemeshRule_2(Home_t *home);
 void RemeshRule_3(Home_t *home);
+void RemeshRule_4(Home_t *home);
 void ResetGlidePlanes(Home_t *home);
 void SetLatestRestart(char *fileName);
 void SortNodesForCollision(Home_t *home);
@@ -105,6 +105,10 @@ struct _param {
  */
         int   decompType;       /* Selects decomposition type */
         int   DLBfreq;          /* how often to load balance */
+        int   DLBcellCost;      /* Toggles use of the per-cell cost */
+                                /* histogram when placing new domain */
+                                /* boundaries.  If zero, load is     */
+                                /* assumed uniform within a domain   */
         int   numDLBCycles;     /* Number of initial load-balance-only */
                                 /* cycles to be executed before main   */
                                 /* processing loop is entered.  This   */
@@ -152,6 +156,12 @@ struct _param {
                              /* remeshAreaRatio and hence not user-provided*/
         real8 remeshAreaMin; /* This values is based on the minSeg value  */
                              /* and hence not specified by the user.      */
+        real8 remeshAngleMin;    /* Remesh rule 4 only: 2-nodes with a */
+        real8 remeshAngleMax;    /* line turning angle (radians) below */
+        real8 remeshForceErrMin; /* the min and relative force error   */
+        real8 remeshForceErrMax; /* below the min may be coarsened out;*/
+                                 /* arms of 2-nodes with either above  */
+                                 /* the max are bisected.              */
         int splitMultiNodeFreq;  /* Code will attempt to split multi-nodes */
                                  /* every cycle that is a multiple of this */
                                  /* value. */
@@ -261,6 +271,12 @@ struct _param {
                                    /* initialization to point to the      */
                                    /* appropriate mobility function       */
 
+        void  (*mobilityCacheFunc)(Home_t *home, Node_t **nodeList,
+                                   int numNodes);  /* Fills the per-arm   */
+                                   /* mobility cache of a list of nodes   */
+                                   /* before their mobility is evaluated. */
+                                   /* NULL if the law does not cache.     */
+
         real8 MobScrew;
         real8 MobEdge;
         real8 MobClimb;
@@ -359,6 +375,22 @@ struct _param {
 
         char  winDefaultsFile[MAX_STRING_LEN];
 
+/*
+ *      X-window plot summary controls.  When <winSummary> is set, each
+ *      domain sends only a down-sampled, spatially culled set of
+ *      segments to task zero for display rather than its full nodal
+ *      data.  See CommSendPlotSummary.c for details.
+ */
+        int   winSummary;          /* 1 to plot the reduced segment set,  */
+                                   /* 0 to download all mirror domains    */
+        int   winSummaryRes;       /* voxels along longest box side used  */
+                                   /* when down-sampling segments         */
+        int   winSummaryMaxSegs;   /* max segments sent to task zero, or  */
+                                   /* <= 0 for no limit                   */
+        real8 winSummaryMin[3];    /* bounds of the region to be plotted. */
+        real8 winSummaryMax[3];    /* No culling is done in any dimension */
+                                   /* for which max <= min                */
+
 
 
 /*
@@ -0,0 +1,24 @@
+/*****************************************************************************
+ *
+ *  Remesh.h   Define the prototypes for the remesh functions shared
+ *             by the remesh rules (see RemeshCommon.c)
+ *
+ ****************************************************************************/
+
+#ifndef _Remesh_h
+#define _Remesh_h
+
+/*
+ *      Optional rule specific coarsening test handed to MeshCoarsen().
+ *      It is invoked (possibly from several threads at once) for
+ *      2-nodes that pass the generic coarsening restrictions but not
+ *      the minimum length or area criteria, and returns 1 if the node
+ *      may be coarsened out anyway.
+ */
+typedef int (*CoarsenTest_t)(Home_t *home, Node_t *node, Node_t *nbr1,
+        Node_t *nbr2, real8 vec1[3], real8 vec2[3]);
+
+int  *GetRefineCandidates(Home_t *home, int *numCandidates);
+void MeshCoarsen(Home_t *home, CoarsenTest_t extraTest);
+
+#endif
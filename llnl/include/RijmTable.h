@@ -0,0 +1,93 @@
+/***************************************************************************
+ *
+ *      Module:       RijmTable.h
+ *      Description:  Definitions and prototypes for handling the
+ *                    tabulated Rijm image stress tables used by the
+ *                    deWit interactions when the fast multipole code
+ *                    is not enabled.
+ *
+ *                    The tables may be provided either in the original
+ *                    text format generated by StressTableGen, or in a
+ *                    binary format.  Binary tables are memory mapped
+ *                    read-only by every task, so all tasks on a node
+ *                    share a single physical copy of the table via the
+ *                    system page cache rather than each task holding
+ *                    its own copy on the heap.
+ *
+ *                    Binary file layout (native byte order):
+ *
+ *                        RijmTableHeader_t header
+ *                        (padding to RIJM_HEADER_BYTES)
+ *                        real8 data[numBricks * RIJM_BRICK_VOL * 10]
+ *
+ *                    The grid is stored in cubic bricks of RIJM_BRICK
+ *                    points per side so the neighboring grid points used
+ *                    by an interpolation are close together in memory.
+ *                    Each grid point holds the 10 independent Rijm
+ *                    components contiguously.
+ *
+ ***************************************************************************/
+#ifndef _RijmTable_h
+#define _RijmTable_h
+
+#include "Typedefs.h"
+
+#define RIJM_TABLE_MAGIC   "RIJMTBL"
+#define RIJM_TABLE_VERSION 1
+
+#define RIJM_HEADER_BYTES  128
+#define RIJM_NUM_COMP      10
+
+#define RIJM_BRICK_SHIFT   2
+#define RIJM_BRICK         (1 << RIJM_BRICK_SHIFT)
+#define RIJM_BRICK_MASK    (RIJM_BRICK - 1)
+#define RIJM_BRICK_VOL     (RIJM_BRICK * RIJM_BRICK * RIJM_BRICK)
+
+/*
+ *      Number of field points callers typically pass to
+ *      InterpolateRijmBatch() per call.
+ */
+#define RIJM_BATCH_SIZE    32
+
+typedef struct {
+        char  magic[8];        /* RIJM_TABLE_MAGIC                      */
+        int   version;         /* RIJM_TABLE_VERSION                    */
+        int   brickSize;       /* RIJM_BRICK used when writing the file */
+        int   gridSize[3];     /* number of grid points in X, Y and Z   */
+        int   numImages[3];    /* number of images summed in X, Y and Z */
+        real8 boxSize[3];      /* box dimensions used to build table    */
+} RijmTableHeader_t;
+
+typedef struct {
+        int   gridSize[3];
+        int   numImages[3];
+        int   numBricks[3];
+        real8 boxSize[3];
+
+        real8 *data;           /* brick-ordered table values            */
+        int   dataLen;         /* number of real8 values in <data>      */
+
+        void  *mapAddr;        /* start of mapped file, or NULL if the  */
+        size_t mapLen;         /* table was allocated on the heap       */
+} RijmTable_t;
+
+/*
+ *      Return the offset within the table data of the first of the
+ *      RIJM_NUM_COMP components at grid point (i, j, k)
+ */
+#define RIJM_TABLE_OFFSET(tbl, i, j, k)                                    \
+        ((((((i) >> RIJM_BRICK_SHIFT) * (tbl)->numBricks[1] +              \
+            ((j) >> RIJM_BRICK_SHIFT)) * (tbl)->numBricks[2] +             \
+            ((k) >> RIJM_BRICK_SHIFT)) * RIJM_BRICK_VOL +                  \
+          ((((i) & RIJM_BRICK_MASK) << (2*RIJM_BRICK_SHIFT)) |             \
+           (((j) & RIJM_BRICK_MASK) << RIJM_BRICK_SHIFT) |                 \
+            ((k) & RIJM_BRICK_MASK))) * RIJM_NUM_COMP)
+
+void RijmTableAlloc(RijmTable_t *tbl, int gridSize[3]);
+void RijmTableFree(RijmTable_t *tbl);
+int  RijmTableIsBinary(char *fileName);
+int  RijmTableMapBinary(char *fileName, RijmTable_t *tbl);
+void RijmTableReadText(char *fileName, RijmTable_t *tbl);
+void RijmTableWriteBinary(char *fileName, RijmTable_t *tbl);
+
+#endif /* _RijmTable_h */
@@ -0,0 +1,32 @@
+/***************************************************************************
+ *
+ *      Module:         SFCDecomp.h
+ *      Description:    Contains prototypes for the public functions
+ *                      used to create, access and manipulate a domain
+ *                      decomposition based on a space-filling curve
+ *                      through the simulation cells.
+ *
+ ***************************************************************************/
+#ifndef _SFCDecomp_h
+#define _SFCDecomp_h
+
+void BroadcastSFCDecomp(Home_t *home, SFCDecomp_t *decomp);
+int  FindSFCDecompCoordDomain(Home_t *home, SFCDecomp_t *decomp, real8 x,
+         real8 y, real8 z);
+void FreeSFCDecomp(SFCDecomp_t *decomp);
+void GetAllSFCDecompBounds(Home_t *home, SFCDecomp_t *decomp, real8 *bounds);
+void GetSFCDecompCellDomainList(Home_t *home, int cellID, int *domCount,
+         int **domList);
+void GetSFCDecompLocalDomainBounds(Home_t *home, SFCDecomp_t *decomp);
+void ReadBinSFCDecompBounds(Home_t *home, void *filePtr, int numXDoms,
+         int numYDoms, int numZDoms, SFCDecomp_t **oldDecomp);
+void ReadSFCDecompBounds(Home_t *home, void **filePtr, int numXDoms,
+         int numYDoms, int numZDoms, int saveDecomp,
+         SFCDecomp_t **oldDecomp);
+int  SFCRebalance(Home_t *home, real8 *loadData);
+void UniformSFCDecomp(Param_t *param, SFCDecomp_t **uniDecomp);
+void WriteSFCDecompBounds(Home_t *home, FILE *fp, SFCDecomp_t *decomp);
+void XPlotSFCDecomp(Home_t *home, SFCDecomp_t *decomp, real8 xMin,
+         real8 yMin, real8 zMin, real8 lMax, int color, real8 lineWidth);
+
+#endif
@@ -38,6 +38,8 @@ int    EncodeDomainIdx(Home_t *home, int iXdom, int jYdom, int kZdom);
 /*
  *      Various numerical operations
  */
+void   ApplyGlideConstraints(int numNorms, real8 *nx, real8 *ny, real8 *nz,
+          real8 *velx, real8 *vely, real8 *velz);
 void   cross(real8 a[3], real8 b[3], real8 c[3]);
 void   CSpline(real8 *x, real8 *y, real8 *y2, int numPoints);
 void   CSplint(real8 *xa, real8 *ya, real8 *y2, int numPoints,
@@ -47,6 +49,8 @@ void   FindAbsMax(real8 *array, int numElements, real8 *maxVal,
           int *indexOfMax);
 void   FindAbsMin(real8 *array, int numElements, real8 *minVal,
           int *indexOfMin);
+int    FindIndependentConstraints(int numVec, real8 *vx, real8 *vy,
+          real8 *vz);
 void   FindMax(real8 *array, int numElements, real8 *maxVal,
           int *indexOfMax);
 void   FindMin(real8 *array, int numElements, real8 *minVal,
@@ -161,6 +165,7 @@ void   Fatal(char *format, ...);
 #endif
 
 void   Plot(Home_t *home, int domIndex, int blkFlag);
+void   PlotSummary(Home_t *home, real8 *segList, int segCount);
 void   WriteArms(Home_t *home, char *baseFileName, int ioGroup,
           int firstInGroup, int writePrologue, int writeEpilogue);
 void   WriteDensFlux(char *fname, Home_t *home);
@@ -0,0 +1,252 @@
+/***************************************************************************
+ *
+ *      Module:       BurgInfo.c
+ *      Description:  Contains functions for building and searching the
+ *                    table of burgers vectors and associated glide planes
+ *                    (home->burgData) for the crystal structures in
+ *                    which the set of glide burgers vectors is known
+ *                    up front.
+ *
+ *                    For each burgers vector the table also holds the
+ *                    three directions in which a screw dislocation with
+ *                    that burgers vector may glide (one per glide plane)
+ *                    in both the crystal and laboratory frames.  These
+ *                    are used by the cross-slip functions, which would
+ *                    otherwise rebuild and rotate them for every node
+ *                    they examine.
+ *
+ *      Includes public functions:
+ *          GetBurgIndex()
+ *          InitBurgInfo()
+ *
+ *      Includes private functions:
+ *          SetBCCScrewGlideDirs()
+ *          SetFCCScrewGlideDirs()
+ *
+ ***************************************************************************/
+#include <math.h>
+#include "Home.h"
+#include "Util.h"
+#include "Mobility.h"
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     SetBCCScrewGlideDirs
+ *      Description:  Set the three <112> type directions in which a
+ *                    BCC screw dislocation may glide on its <110> type
+ *                    glide planes.
+ *
+ *      Arguments:
+ *          burg      unit burgers vector in the crystal frame
+ *          glideDir  array in which to return the glide directions
+ *                    in the crystal frame, one per row.
+ *
+ *------------------------------------------------------------------------*/
+static void SetBCCScrewGlideDirs(real8 burg[3], real8 glideDir[3][3])
+{
+        int   m, n;
+        real8 tmp33[3][3];
+
+        Matrix31Vector3Mult(burg, burg, tmp33);
+
+        for (m = 0; m < 3; m++) {
+            for (n = 0; n < 3; n++) {
+                glideDir[m][n] = ((m==n)-tmp33[m][n])*sqrt(1.5);
+            }
+        }
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     SetFCCScrewGlideDirs
+ *      Description:  Set the two <112> type directions in which an
+ *                    FCC screw dislocation may glide on its <111> type
+ *                    glide planes.  e.g. for burg = [ 1  1  0 ], the
+ *                    two glide directions are [ 1 -1  2 ] and
+ *                    [ 1 -1 -2 ].  The third row is zeroed.
+ *
+ *      Arguments:
+ *          burg      unit burgers vector in the crystal frame
+ *          glideDir  array in which to return the glide directions
+ *                    in the crystal frame, one per row.
+ *
+ *------------------------------------------------------------------------*/
+static void SetFCCScrewGlideDirs(real8 burg[3], real8 glideDir[3][3])
+{
+        int   n;
+        real8 tmp, eps = 1.0e-06;
+
+        tmp = 1.0;
+
+        for (n = 0; n < 3; n++) {
+            if (fabs(burg[n]) > eps) {
+                glideDir[0][n] = (burg[n]*tmp > 0) ? 1.0 : -1.0;
+                glideDir[1][n] = (burg[n]*tmp > 0) ? 1.0 : -1.0;
+                tmp = -1.0;
+            } else {
+                glideDir[0][n] =  2.0;
+                glideDir[1][n] = -2.0;
+            }
+        }
+
+        VECTOR_ZERO(glideDir[2]);
+
+        for (n = 0; n < 3; n++) {
+            glideDir[0][n] *= sqrt(1.0/6.0);
+            glideDir[1][n] *= sqrt(1.0/6.0);
+        }
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     InitBurgInfo
+ *      Description:  Build the table of glide burgers vectors, glide
+ *                    planes and screw glide directions for the current
+ *                    material type.  Both signs of each burgers vector
+ *                    are included.  For material types for which no
+ *                    table is defined, the table is left empty.
+ *
+ *                    Must be called after the material type and the
+ *                    lab frame rotation matrices have been set up.
+ *
+ *------------------------------------------------------------------------*/
+void InitBurgInfo(Home_t *home)
+{
+        int        i, j, k, b, numBurg, planesPerBurg;
+        real8      burg[3];
+        real8      glideDir[3][3];
+        Param_t    *param;
+        BurgInfo_t *burgData;
+
+        param    = home->param;
+        burgData = &home->burgData;
+
+        switch (param->materialType) {
+            case MAT_TYPE_BCC:
+                numBurg = 8;
+                planesPerBurg = 3;
+                break;
+            case MAT_TYPE_FCC:
+                numBurg = 12;
+                planesPerBurg = 2;
+                break;
+            default:
+                return;
+        }
+
+        burgData->numBurgVectors = numBurg;
+        burgData->numPlanes = numBurg * planesPerBurg;
+
+        burgData->numPlanesPerBurg = (int *)malloc(numBurg * sizeof(int));
+        burgData->burgFirstPlaneIndex = (int *)malloc(numBurg * sizeof(int));
+        burgData->burgList = (real8 (*)[3])malloc(numBurg * sizeof(real8 [3]));
+        burgData->planeList = (real8 (*)[3])malloc(burgData->numPlanes *
+                                                   sizeof(real8 [3]));
+        burgData->glideDirCrystal = (real8 (*)[3])malloc(3 * numBurg *
+                                                         sizeof(real8 [3]));
+        burgData->glideDirLab = (real8 (*)[3])malloc(3 * numBurg *
+                                                     sizeof(real8 [3]));
+
+/*
+ *      BCC burgers vectors are the 1/2<111> types, FCC burgers
+ *      vectors the 1/2<110> types.
+ */
+        b = 0;
+
+        if (param->materialType == MAT_TYPE_BCC) {
+            for (i = 0; i < 8; i++) {
+                burgData->burgList[b][X] = ((i & 4) ? -1.0 : 1.0) / sqrt(3.0);
+                burgData->burgList[b][Y] = ((i & 2) ? -1.0 : 1.0) / sqrt(3.0);
+                burgData->burgList[b][Z] = ((i & 1) ? -1.0 : 1.0) / sqrt(3.0);
+                b++;
+            }
+        } else {
+            for (i = 0; i < 3; i++) {
+                for (j = 0; j < 4; j++) {
+                    VECTOR_ZERO(burgData->burgList[b]);
+                    burgData->burgList[b][i] =
+                            ((j & 2) ? -1.0 : 1.0) / sqrt(2.0);
+                    burgData->burgList[b][(i+1)%3] =
+                            ((j & 1) ? -1.0 : 1.0) / sqrt(2.0);
+                    b++;
+                }
+            }
+        }
+
+/*
+ *      Each glide plane is the plane containing the burgers vector
+ *      and the corresponding screw glide direction.
+ */
+        for (b = 0; b < numBurg; b++) {
+
+            VECTOR_COPY(burg, burgData->burgList[b]);
+
+            if (param->materialType == MAT_TYPE_BCC) {
+                SetBCCScrewGlideDirs(burg, glideDir);
+            } else {
+                SetFCCScrewGlideDirs(burg, glideDir);
+            }
+
+            burgData->numPlanesPerBurg[b] = planesPerBurg;
+            burgData->burgFirstPlaneIndex[b] = b * planesPerBurg;
+
+            for (k = 0; k < 3; k++) {
+
+                VECTOR_COPY(burgData->glideDirCrystal[3*b+k], glideDir[k]);
+
+                if (param->useLabFrame) {
+                    Matrix33Vector3Multiply(home->rotMatrix, glideDir[k],
+                                            burgData->glideDirLab[3*b+k]);
+                } else {
+                    VECTOR_COPY(burgData->glideDirLab[3*b+k], glideDir[k]);
+                }
+
+                if (k < planesPerBurg) {
+                    NormalizedCrossVector(burg, glideDir[k],
+                            burgData->planeList[b*planesPerBurg+k]);
+                }
+            }
+        }
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     GetBurgIndex
+ *      Description:  Find the specified burgers vector in the burgers
+ *                    vector table.
+ *
+ *      Arguments:
+ *          burg   unit burgers vector in the crystal frame
+ *
+ *      Returns:  index of the burgers vector in home->burgData.burgList,
+ *                or -1 if it is not in the table.
+ *
+ *------------------------------------------------------------------------*/
+int GetBurgIndex(Home_t *home, real8 burg[3])
+{
+        int        b;
+        real8      eps = 1.0e-06;
+        BurgInfo_t *burgData;
+
+        burgData = &home->burgData;
+
+        for (b = 0; b < burgData->numBurgVectors; b++) {
+            if ((fabs(burg[X] - burgData->burgList[b][X]) < eps) &&
+                (fabs(burg[Y] - burgData->burgList[b][Y]) < eps) &&
+                (fabs(burg[Z] - burgData->burgList[b][Z]) < eps)) {
+                return(b);
+            }
+        }
+
+        return(-1);
+}
@@ -0,0 +1,463 @@
+/*-------------------------------------------------------------------------
+ *
+ *      Module:       CommSendPlotSummary.c
+ *      Description:  This module contains the functions needed to send
+ *                    a reduced (down-sampled and spatially culled)
+ *                    representation of every domain's dislocation
+ *                    segments to task zero for the X-window display.
+ *
+ *                    This is an alternative to the mirror domain
+ *                    download done in CommSendMirrorNodes() which
+ *                    ships the complete nodal data of every domain
+ *                    through task zero.  Here each domain does the
+ *                    reduction on its own data in parallel:
+ *
+ *                    1) Segments with both endpoints outside the
+ *                       user-specified view region are discarded.
+ *                    2) Segment endpoints are snapped to the centers
+ *                       of a coarse grid of voxels (<winSummaryRes>
+ *                       voxels along the longest side of the problem
+ *                       space).  Segments that collapse to a single
+ *                       voxel are dropped and duplicate voxel pairs
+ *                       are merged.  Since consecutive segments of a
+ *                       dislocation line share a snapped endpoint the
+ *                       reduced lines remain connected.
+ *                    3) If the global number of reduced segments still
+ *                       exceeds <winSummaryMaxSegs>, each domain keeps
+ *                       only its proportional share of the budget.
+ *
+ *                    The reduced segments are then gathered to task zero
+ *                    in a single collective operation, so the memory
+ *                    required on task zero is bounded by the segment
+ *                    budget rather than the total problem size.
+ *
+ *      Includes public functions:
+ *          CommSendPlotSummary()
+ *
+ *      Includes private functions:
+ *          BuildPlotSummary()
+ *          GenSummaryOutput()
+ *          PlotSegCmp()
+ *          VoxelIndex()
+ *
+ *------------------------------------------------------------------------*/
+#include "Home.h"
+#include "Node.h"
+#include "Comm.h"
+#include "Util.h"
+
+#ifdef PARALLEL
+#include "mpi.h"
+#endif
+
+/*
+ *      Temporary structure used while reducing the local segment
+ *      list.  The voxel keys uniquely identify the (snapped) segment
+ *      and are used for sorting and merging duplicates.
+ */
+typedef struct {
+        long long voxKey1;
+        long long voxKey2;
+        real8     vals[VALS_PER_PLOT_SEG];
+} PlotSeg_t;
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    PlotSegCmp
+ *      Description: Comparison function for qsort() used to order
+ *                   the reduced segments by their voxel keys.
+ *
+ *------------------------------------------------------------------------*/
+static int PlotSegCmp(const void *a, const void *b)
+{
+        const PlotSeg_t *seg1 = (const PlotSeg_t *)a;
+        const PlotSeg_t *seg2 = (const PlotSeg_t *)b;
+
+        if (seg1->voxKey1 < seg2->voxKey1) return(-1);
+        if (seg1->voxKey1 > seg2->voxKey1) return(1);
+        if (seg1->voxKey2 < seg2->voxKey2) return(-1);
+        if (seg1->voxKey2 > seg2->voxKey2) return(1);
+
+        return(0);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    VoxelIndex
+ *      Description: Determine the voxel containing the specified point,
+ *                   snap the point to the center of that voxel and
+ *                   return an encoded index of the voxel.
+ *
+ *      Arguments:
+ *          pos      Coordinates of the point.  On return contains the
+ *                   coordinates of the center of the containing voxel.
+ *          boxMin   Minimum coordinates of the problem space
+ *          voxSize  Edge length of a voxel
+ *          numVox   Number of voxels in each dimension
+ *
+ *------------------------------------------------------------------------*/
+static long long VoxelIndex(real8 pos[3], real8 boxMin[3], real8 voxSize,
+                            int numVox[3])
+{
+        int       i, idx[3];
+        long long key;
+
+        for (i = 0; i < 3; i++) {
+/*
+ *          Points slightly outside the primary image (i.e. the far
+ *          end of a segment crossing a periodic boundary) may fall
+ *          one voxel beyond the grid; that is okay, we just need
+ *          the index to be unique and consistent.
+ */
+            idx[i] = (int)floor((pos[i] - boxMin[i]) / voxSize);
+            pos[i] = boxMin[i] + ((real8)idx[i] + 0.5) * voxSize;
+            idx[i] += 1;
+        }
+
+        key = ((long long)idx[X] * (long long)(numVox[Y] + 2) +
+               (long long)idx[Y]) * (long long)(numVox[Z] + 2) +
+               (long long)idx[Z];
+
+        return(key);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    BuildPlotSummary
+ *      Description: Create the down-sampled list of segments owned by
+ *                   this domain that are to be sent to task zero.
+ *
+ *      Arguments:
+ *          segList   Location in which to return to the caller a
+ *                    pointer to the array of reduced segments.  Each
+ *                    segment is represented by VALS_PER_PLOT_SEG
+ *                    values.  Caller is responsible for freeing the
+ *                    array.
+ *          segCount  Location in which to return to the caller the
+ *                    number of segments in <segList>.
+ *
+ *------------------------------------------------------------------------*/
+static void BuildPlotSummary(Home_t *home, real8 **segList, int *segCount)
+{
+        int       i, arm, maxSegs, numSegs, numKept;
+        int       numVox[3], doCull[3];
+        int       localCount, globalCount, localBudget;
+        real8     voxSize, maxSide, keepFrac, keepAccum;
+        real8     boxMin[3], boxLen[3];
+        real8     *list;
+        PlotSeg_t *seg, *plotSegs;
+        Param_t   *param;
+
+        param = home->param;
+
+        boxMin[X] = param->minSideX;
+        boxMin[Y] = param->minSideY;
+        boxMin[Z] = param->minSideZ;
+
+        boxLen[X] = param->maxSideX - param->minSideX;
+        boxLen[Y] = param->maxSideY - param->minSideY;
+        boxLen[Z] = param->maxSideZ - param->minSideZ;
+
+        maxSide = MAX(boxLen[X], MAX(boxLen[Y], boxLen[Z]));
+        voxSize = maxSide / (real8)MAX(param->winSummaryRes, 1);
+
+        for (i = 0; i < 3; i++) {
+            numVox[i] = (int)ceil(boxLen[i] / voxSize);
+            doCull[i] = (param->winSummaryMax[i] > param->winSummaryMin[i]);
+        }
+
+/*
+ *      Count the local segments so we have an upper bound on the
+ *      size of the temporary array
+ */
+        maxSegs = 0;
+
+        for (i = 0; i < home->newNodeKeyPtr; i++) {
+            Node_t *node;
+
+            if ((node = home->nodeKeys[i]) == (Node_t *)NULL) continue;
+            maxSegs += node->numNbrs;
+        }
+
+        plotSegs = (PlotSeg_t *)malloc(MAX(maxSegs, 1) * sizeof(PlotSeg_t));
+        numSegs = 0;
+
+/*
+ *      Loop through all the native nodes and add to the list each
+ *      segment owned by this domain which is not culled.
+ */
+        for (i = 0; i < home->newNodeKeyPtr; i++) {
+            Node_t *node, *nbrNode;
+
+            if ((node = home->nodeKeys[i]) == (Node_t *)NULL) continue;
+
+            for (arm = 0; arm < node->numNbrs; arm++) {
+                int   dim, inView;
+                real8 p1[3], p2[3];
+
+                nbrNode = GetNeighborNode(home, node, arm);
+
+                if (nbrNode == (Node_t *)NULL) continue;
+                if (OrderNodes(node, nbrNode) <= 0) continue;
+
+                p1[X] = node->x;
+                p1[Y] = node->y;
+                p1[Z] = node->z;
+
+                p2[X] = nbrNode->x;
+                p2[Y] = nbrNode->y;
+                p2[Z] = nbrNode->z;
+
+                PBCPOSITION(param, p1[X], p1[Y], p1[Z],
+                            &p2[X], &p2[Y], &p2[Z]);
+
+/*
+ *              Cull the segment if both endpoints are outside the
+ *              view region in any of the restricted dimensions.
+ */
+                inView = 1;
+
+                for (dim = 0; dim < 3; dim++) {
+                    if (!doCull[dim]) continue;
+                    if (((p1[dim] < param->winSummaryMin[dim]) ||
+                         (p1[dim] > param->winSummaryMax[dim])) &&
+                        ((p2[dim] < param->winSummaryMin[dim]) ||
+                         (p2[dim] > param->winSummaryMax[dim]))) {
+                        inView = 0;
+                        break;
+                    }
+                }
+
+                if (!inView) continue;
+
+                seg = &plotSegs[numSegs];
+
+                seg->voxKey1 = VoxelIndex(p1, boxMin, voxSize, numVox);
+                seg->voxKey2 = VoxelIndex(p2, boxMin, voxSize, numVox);
+
+/*
+ *              Segments contained within a single voxel are not
+ *              visible at the summary resolution.
+ */
+                if (seg->voxKey1 == seg->voxKey2) continue;
+
+/*
+ *              Order the endpoints so duplicate segments have
+ *              identical keys regardless of direction.
+ */
+                if (seg->voxKey1 > seg->voxKey2) {
+                    long long tmpKey;
+                    real8     tmpPos[3];
+
+                    tmpKey = seg->voxKey1;
+                    seg->voxKey1 = seg->voxKey2;
+                    seg->voxKey2 = tmpKey;
+
+                    VECTOR_COPY(tmpPos, p1);
+                    VECTOR_COPY(p1, p2);
+                    VECTOR_COPY(p2, tmpPos);
+                }
+
+                seg->vals[0] = p1[X];
+                seg->vals[1] = p1[Y];
+                seg->vals[2] = p1[Z];
+                seg->vals[3] = p2[X];
+                seg->vals[4] = p2[Y];
+                seg->vals[5] = p2[Z];
+
+/*
+ *              Segments spanning two domains are flagged with a
+ *              negative domain ID so they may be colored accordingly
+ */
+                seg->vals[6] = (nbrNode->myTag.domainID ==
+                                node->myTag.domainID) ?
+                               (real8)home->myDomain : -1.0;
+
+                seg->vals[7] = (real8)((int)(fabs(node->burgX[arm]) * 4 +
+                                             fabs(node->burgY[arm]) * 2 +
+                                             fabs(node->burgZ[arm])));
+                numSegs++;
+            }
+        }
+
+/*
+ *      Merge any segments that map to the same pair of voxels
+ */
+        if (numSegs > 1) {
+            int j;
+
+            qsort(plotSegs, numSegs, sizeof(PlotSeg_t), PlotSegCmp);
+
+            for (i = 1, j = 0; i < numSegs; i++) {
+                if (PlotSegCmp(&plotSegs[i], &plotSegs[j]) != 0) {
+                    j++;
+                    if (j != i) plotSegs[j] = plotSegs[i];
+                }
+            }
+
+            numSegs = j + 1;
+        }
+
+/*
+ *      If the total number of segments is still above the global
+ *      budget, determine this domain's share of that budget.
+ */
+        localCount = numSegs;
+        globalCount = localCount;
+
+#ifdef PARALLEL
+        MPI_Allreduce(&localCount, &globalCount, 1, MPI_INT, MPI_SUM,
+                      MPI_COMM_WORLD);
+#endif
+
+        localBudget = localCount;
+
+        if ((param->winSummaryMaxSegs > 0) &&
+            (globalCount > param->winSummaryMaxSegs)) {
+            localBudget = (int)((real8)param->winSummaryMaxSegs *
+                                (real8)localCount / (real8)globalCount);
+        }
+
+/*
+ *      Copy the surviving segments into the caller's list.  If we are
+ *      over budget, keep an evenly spaced subset of the segments.
+ */
+        list = (real8 *)malloc(MAX(localBudget, 1) * VALS_PER_PLOT_SEG *
+                               sizeof(real8));
+
+        keepFrac = (numSegs > 0) ? (real8)localBudget / (real8)numSegs : 0.0;
+        keepAccum = 0.0;
+        numKept = 0;
+
+        for (i = 0; i < numSegs; i++) {
+
+            keepAccum += keepFrac;
+
+            if ((keepAccum < 1.0) || (numKept >= localBudget)) continue;
+
+            keepAccum -= 1.0;
+
+            memcpy(&list[numKept * VALS_PER_PLOT_SEG], plotSegs[i].vals,
+                   VALS_PER_PLOT_SEG * sizeof(real8));
+            numKept++;
+        }
+
+        free(plotSegs);
+
+        *segList  = list;
+        *segCount = numKept;
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    GenSummaryOutput
+ *      Description: Invokes X-Window plotting of the reduced segment
+ *                   list at the given stage.
+ *
+ *      Arguments:
+ *          stage     indicates the current stage of the program
+ *                    execution.  Valid values are:
+ *                        STAGE_INIT
+ *                        STAGE_CYCLE
+ *          segList   array of reduced segments from all domains
+ *          segCount  number of segments in <segList>
+ *
+ *------------------------------------------------------------------------*/
+static void GenSummaryOutput(Home_t *home, int stage, real8 *segList,
+                             int segCount)
+{
+#ifndef NO_XWINDOW
+        switch (stage) {
+        case STAGE_CYCLE:
+            TimerStart(home, PLOT);
+            PlotSummary(home, segList, segCount);
+            TimerStop(home, PLOT);
+#ifdef NO_THREAD
+            WinEvolve();
+#endif
+            break;
+
+        case STAGE_INIT:
+            PlotSummary(home, segList, segCount);
+            break;
+        }
+#endif
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    CommSendPlotSummary
+ *      Description: Have every domain build a reduced representation
+ *                   of its segments, gather the reduced data onto
+ *                   task zero, and generate the X-window display from it.
+ *
+ *      Arguments:
+ *          stage    indicates the current stage of the program
+ *                   execution.  See GenSummaryOutput() for valid values.
+ *
+ *------------------------------------------------------------------------*/
+void CommSendPlotSummary(Home_t *home, int stage)
+{
+        int   segCount, totalSegs;
+        real8 *segList, *allSegs;
+#ifdef PARALLEL
+        int   i, numDomains;
+        int   *recvCounts = (int *)NULL, *recvOffsets = (int *)NULL;
+#endif
+
+        BuildPlotSummary(home, &segList, &segCount);
+
+#ifdef PARALLEL
+        numDomains = home->numDomains;
+        allSegs = (real8 *)NULL;
+        totalSegs = 0;
+
+        if (home->myDomain == 0) {
+            recvCounts  = (int *)malloc(numDomains * sizeof(int));
+            recvOffsets = (int *)malloc(numDomains * sizeof(int));
+        }
+
+        MPI_Gather(&segCount, 1, MPI_INT, recvCounts, 1, MPI_INT, 0,
+                   MPI_COMM_WORLD);
+
+        if (home->myDomain == 0) {
+            for (i = 0; i < numDomains; i++) {
+                recvOffsets[i] = totalSegs * VALS_PER_PLOT_SEG;
+                totalSegs += recvCounts[i];
+                recvCounts[i] *= VALS_PER_PLOT_SEG;
+            }
+
+            allSegs = (real8 *)malloc(MAX(totalSegs, 1) * VALS_PER_PLOT_SEG *
+                                      sizeof(real8));
+        }
+
+        MPI_Gatherv(segList, segCount * VALS_PER_PLOT_SEG, MPI_DOUBLE,
+                    allSegs, recvCounts, recvOffsets, MPI_DOUBLE, 0,
+                    MPI_COMM_WORLD);
+
+        free(segList);
+
+        if (home->myDomain == 0) {
+            free(recvCounts);
+            free(recvOffsets);
+        }
+#else
+        allSegs = segList;
+        totalSegs = segCount;
+#endif
+
+        if (home->myDomain == 0) {
+            GenSummaryOutput(home, stage, allSegs, totalSegs);
+            free(allSegs);
+        }
+
+        return;
+}
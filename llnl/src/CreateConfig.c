@@ -5,6 +5,14 @@
  *                    nodal data for various types of initial dislocation
  *                    structures.
  *
+ *                    When run on multiple tasks, each generator creates
+ *                    only a contiguous block of the chains (or loops,
+ *                    sources, etc) as selected by GetItemRange().  The
+ *                    random number sequence is advanced past the values
+ *                    that would have been used by the preceding items so
+ *                    each task creates exactly the nodes a single task
+ *                    would have created for the same items.
+ *
  *      Includes functions:
  *
  *              CreateEdges()
@@ -14,6 +22,9 @@
  *              CreateFCCConfig()
  *              CreateFCCIrradConfig()
  *              CreateFCCPerfectLoop()  >>> Not yet fully implemented <<<
+ *              GetItemRange()
+ *              IncDislocationDensity()
+ *              SkipRandm()
  *
  *****************************************************************************/
 #include "Home.h"
@@ -60,6 +71,60 @@ static void IncDislocationDensity(InData_t *inData, real8 *totDislocLen)
 }
 
 
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     GetItemRange
+ *      Description:  Determine the block of items (chains, loops, etc)
+ *                    to be created by this task.  Items are split into
+ *                    contiguous blocks assigned in task order, so the
+ *                    node tags and the order of the nodes across the
+ *                    data file segments are the same as if the items
+ *                    were all created by a single task.
+ *
+ *      Arguments:
+ *          numItems   total number of items to be created
+ *          firstItem  location in which to return the index of the
+ *                     first item to be created by this task
+ *          lastItem   location in which to return the index one past
+ *                     the last item to be created by this task
+ *
+ *-------------------------------------------------------------------------*/
+static void GetItemRange(Home_t *home, int numItems, int *firstItem,
+                         int *lastItem)
+{
+        *firstItem = (int)(((long long)numItems * home->myDomain) /
+                           home->numDomains);
+        *lastItem  = (int)(((long long)numItems * (home->myDomain + 1)) /
+                           home->numDomains);
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     SkipRandm
+ *      Description:  Advance the random number sequence past the
+ *                    values that would have been drawn while creating
+ *                    the items assigned to lower numbered tasks.
+ *
+ *      Arguments:
+ *          seed      current seed for the random number generator
+ *          numDraws  number of random values to skip
+ *
+ *-------------------------------------------------------------------------*/
+static void SkipRandm(int *seed, int numDraws)
+{
+        int i;
+
+        for (i = 0; i < numDraws; i++) {
+            (void)randm(seed);
+        }
+
+        return;
+}
+
+
 /*---------------------------------------------------------------------------
  *
  *      Function:     CreatePrismaticLoop
@@ -90,8 +155,10 @@ void CreatePrismaticLoop(Home_t *home, InData_t *inData, int cubeLength,
                          int dislocType)
 {
         int     id, loopIndex, burgIndex, dIndex, nextNode, newNodeIndex;
-        int     minBurgIndex, maxBurgIndex, lastBlock, numSegs;
+        int     minBurgIndex, maxBurgIndex, numSegs;
+        int     firstLoop, lastLoop;
         int     startRemeshIndex = 0;
+        int     sectionLen[2];
         int     nbr1Index;
         real8   cubeSize;
         real8   x, y, z, ux, uy, uz;
@@ -406,12 +473,22 @@ void CreatePrismaticLoop(Home_t *home, InData_t *inData, int cubeLength,
 
         inData->nodeCount = 0;
         nextNode = 0;
-        burgIndex = maxBurgIndex;
+
+/*
+ *      Only create the loops assigned to this task, but start the
+ *      burgers vector cycle and the random number sequence where
+ *      they would be had the preceding loops been created here.
+ */
+        GetItemRange(home, numLoops, &firstLoop, &lastLoop);
+        SkipRandm(&seed, 3 * firstLoop);
+
+        burgIndex = minBurgIndex + (firstLoop + maxBurgIndex - minBurgIndex) %
+                    (maxBurgIndex - minBurgIndex + 1);
 
 /*
  *      Create one loop at a time, cycling through burgers vectors as we go.
  */
-        for (loopIndex = 0; loopIndex < numLoops; loopIndex++) {
+        for (loopIndex = firstLoop; loopIndex < lastLoop; loopIndex++) {
 
             if (++burgIndex > maxBurgIndex) {
                 burgIndex = minBurgIndex;
@@ -512,23 +589,25 @@ void CreatePrismaticLoop(Home_t *home, InData_t *inData, int cubeLength,
             }  /*  for (id = nextNode; ...) */
 
             nextNode += numSegs; 
-            lastBlock = (loopIndex == (numLoops-1));
-            
+
+        }  /* for (loopIndex = firstLoop; ...) */
+
 /*
- *          When we've generated the nodal data for the final loop,
- *          write all the data out to disk.
- */
-            if (lastBlock) {
-                IncDislocationDensity(inData, totDislocLen);
-                InitRemesh(inData, dislocType, startRemeshIndex);
-                param->nodeCount = inData->nodeCount;
-                WriteInitialNodeData(home, inData, lastBlock);
-                FreeInNodeArray(inData, inData->nodeCount);
-                inData->nodeCount = 0;
-                nextNode = 0;
-            }
+ *      Now that the nodal data for all the loops has been generated,
+ *      write all the data out to disk.  Nodes added by the remesh
+ *      follow the nodes of all the loops, so they are written as a
+ *      separate section.
+ */
+        IncDislocationDensity(inData, totDislocLen);
+        InitRemesh(inData, dislocType, startRemeshIndex);
 
-        }  /* for (loopIndex = 0; ...) */
+        sectionLen[0] = nextNode;
+        sectionLen[1] = inData->nodeCount - nextNode;
+
+        param->nodeCount = inData->nodeCount;
+        WriteInitialNodeData(home, inData, 2, sectionLen);
+        FreeInNodeArray(inData, inData->nodeCount);
+        inData->nodeCount = 0;
 
         return;
 }
@@ -551,8 +630,8 @@ void CreateScrewConfig(Home_t *home, InData_t *inData, int cubeLength,
                        int dislocType)
 {
         int      ic, np, ip, id0;
-        int      burgIndex, gpIndex, newNodeIndex, lastBlock;
-        int      nbr1Index, nbr2Index;
+        int      burgIndex, gpIndex, newNodeIndex;
+        int      nbr1Index, nbr2Index, firstChain, lastChain;
         int      startRemeshIndex = 0;
         real8    xp[3], yp[3], zp[3], cubeSize;
         real8    burg[4][3], glidePlane[4][6][3];
@@ -711,10 +790,13 @@ void CreateScrewConfig(Home_t *home, InData_t *inData, int cubeLength,
         id0 = 0;
         inData->nodeCount = 0;
 
+        GetItemRange(home, numChains, &firstChain, &lastChain);
+        SkipRandm(&seed, 3 * firstChain);
+
 /*
  *      Create the specified number of chains.
  */
-        for (ic = 0; ic < numChains; ic++) {
+        for (ic = firstChain; ic < lastChain; ic++) {
 
             np = 3;
             newNodeIndex = inData->nodeCount;
@@ -788,24 +870,23 @@ void CreateScrewConfig(Home_t *home, InData_t *inData, int cubeLength,
  *          The initial segments created are not necessarily limited to
  *          param->maxSegLen, so a call to InitRemesh() is needed to
  *          chop any excessively long segments into proper lengths.
- *          When we've generated the nodal data for the final chain,
- *          write the current block of nodal data to the file.
  */
             InitRemesh(inData, dislocType, startRemeshIndex);
 
-            lastBlock = (ic == numChains - 1);
-            if (lastBlock) {
-                IncDislocationDensity(inData, totDislocLen);
-                param->nodeCount = inData->nodeCount;
-                WriteInitialNodeData(home, inData, lastBlock);
-                FreeInNodeArray(inData, inData->nodeCount);
-                inData->nodeCount = 0;
-            }
-
             id0 = inData->nodeCount;
             startRemeshIndex = id0;
         }
 
+/*
+ *      Nodal data for the final chain has been generated, so
+ *      write the block of nodal data to the file.
+ */
+        IncDislocationDensity(inData, totDislocLen);
+        param->nodeCount = inData->nodeCount;
+        WriteInitialNodeData(home, inData, 1, &inData->nodeCount);
+        FreeInNodeArray(inData, inData->nodeCount);
+        inData->nodeCount = 0;
+
         return;
 }
 
@@ -833,8 +914,9 @@ void CreateFCCIrradConfig(Home_t *home, InData_t *inData, int cubeLength,
 {
         int      ic, np, ip, id0, i;
         int      nplane, indp, indb, indf, inds, indr;
-        int      newNodeIndex, lastBlock;
+        int      newNodeIndex, firstChain, lastChain, firstLoop, lastLoop;
         int      startRemeshIndex = 0;
+        int      sectionLen[2];
         real8    inv3, inv6, invsq2, sq2over3;
         real8    xp[6], yp[6], zp[6], cubeSize;
         real8    tnx[4], tny[4], tnz[4], burg[12][3];
@@ -910,7 +992,12 @@ void CreateFCCIrradConfig(Home_t *home, InData_t *inData, int cubeLength,
         id0 = 0;
         inData->nodeCount = 0;
 
-        for (ic = 0; ic < numChains; ic++) {
+        GetItemRange(home, numChains, &firstChain, &lastChain);
+        GetItemRange(home, numLoops, &firstLoop, &lastLoop);
+
+        SkipRandm(&seed, 3 * firstChain);
+
+        for (ic = firstChain; ic < lastChain; ic++) {
 
             np = 3;    /* number of points along 1 chain */
             newNodeIndex = inData->nodeCount;
@@ -1006,10 +1093,18 @@ void CreateFCCIrradConfig(Home_t *home, InData_t *inData, int cubeLength,
 
         } /* end of chains */
 
+/*
+ *      The chains are written as one section of the data file
+ *      followed by the loops as a second section.
+ */
+        sectionLen[0] = inData->nodeCount;
+
+        SkipRandm(&seed, 3 * (numChains - lastChain) + 3 * firstLoop);
+
 /*
  *      Place hexagonal loops
  */
-        for (ic = 0; ic < numLoops; ic++) {
+        for (ic = firstLoop; ic < lastLoop; ic++) {
             np = 6;     /* creation of hexagonal loop */
             newNodeIndex = inData->nodeCount;
             inData->nodeCount += np;
@@ -1103,25 +1198,26 @@ void CreateFCCIrradConfig(Home_t *home, InData_t *inData, int cubeLength,
  *          The initial segments created are not necessarily limited to
  *          param->maxSegLen, so a call to InitRemesh() is needed to
  *          chop any excessively long segments into proper lengths.
- *          When we've generated the nodal data for the final chain,
- *          write the block of nodal data to the file.
  */
             InitRemesh(inData, dislocType, startRemeshIndex);
 
-            lastBlock = (ic == (numLoops - 1));
-            if (lastBlock) {
-                IncDislocationDensity(inData, totDislocLen);
-                param->nodeCount = inData->nodeCount;
-                WriteInitialNodeData(home, inData, lastBlock);
-                FreeInNodeArray(inData, inData->nodeCount);
-                inData->nodeCount = 0;
-            }
-
             id0 = inData->nodeCount;
             startRemeshIndex = id0;
 
         } /* end of loops */
 
+/*
+ *      Nodal data for the final loop has been generated, so
+ *      write the block of nodal data to the file.
+ */
+        sectionLen[1] = inData->nodeCount - sectionLen[0];
+
+        IncDislocationDensity(inData, totDislocLen);
+        param->nodeCount = inData->nodeCount;
+        WriteInitialNodeData(home, inData, 2, sectionLen);
+        FreeInNodeArray(inData, inData->nodeCount);
+        inData->nodeCount = 0;
+
         return; 
 }
 
@@ -1145,7 +1241,7 @@ void CreateFCCConfig(Home_t *home, InData_t *inData, int cubeLength,
 {
         int      ic, np, ip, id0, i;
         int      nplane, indp, indb, indf, inds, indr;
-        int      newNodeIndex, lastBlock;
+        int      newNodeIndex, firstChain, lastChain;
         int      startRemeshIndex = 0;
         real8    invsq2;
         real8    xp[3], yp[3], zp[3];
@@ -1217,7 +1313,10 @@ void CreateFCCConfig(Home_t *home, InData_t *inData, int cubeLength,
         id0 = 0;
         inData->nodeCount = 0;
 
-        for (ic = 0; ic < numChains; ic++) {
+        GetItemRange(home, numChains, &firstChain, &lastChain);
+        SkipRandm(&seed, 3 * firstChain);
+
+        for (ic = firstChain; ic < lastChain; ic++) {
 
             np = 3;    /* number of points along 1 chain */
 
@@ -1312,25 +1411,24 @@ void CreateFCCConfig(Home_t *home, InData_t *inData, int cubeLength,
  *          The initial segments created are not necessarily limited to
  *          param->maxSegLen, so a call to InitRemesh() is needed to
  *          chop any excessively long segments into proper lengths.
- *          When we've generated the nodal data for the final chain,
- *          write the block of nodal data to the file.
  */
             InitRemesh(inData, dislocType, startRemeshIndex);
 
-            lastBlock = (ic == (numChains - 1));
-            if (lastBlock) {
-                IncDislocationDensity(inData, totDislocLen);
-                param->nodeCount = inData->nodeCount;
-                WriteInitialNodeData(home, inData, lastBlock);
-                FreeInNodeArray(inData, inData->nodeCount);
-                inData->nodeCount = 0;
-            }
-
             id0 = inData->nodeCount;
             startRemeshIndex = id0;
 
         } /* loop over chains */
 
+/*
+ *      Nodal data for the final chain has been generated, so
+ *      write the block of nodal data to the file.
+ */
+        IncDislocationDensity(inData, totDislocLen);
+        param->nodeCount = inData->nodeCount;
+        WriteInitialNodeData(home, inData, 1, &inData->nodeCount);
+        FreeInNodeArray(inData, inData->nodeCount);
+        inData->nodeCount = 0;
+
         return;
 }
 
@@ -1359,9 +1457,9 @@ void CreateFCCPerfectLoop(Home_t *home, InData_t *inData, int cubeLength,
                           int dislocType)
 {
         int      nplane, indexplane, ic, np, ip, id0, i;
-        int      inds11, inds12, inds21, inds22;
-        int      indp, indp1, indp2, indb1, indb2, indr;
-        int      newNodeIndex, lastBlock;
+        int      inds11 = 0, inds12 = 0, inds21 = 0, inds22 = 0;
+        int      indp, indp1 = 0, indp2 = 0, indb1 = 0, indb2 = 0, indr;
+        int      newNodeIndex, firstChain, lastChain;
         int      startRemeshIndex = 0;
         real8    prisml, invsq2, cubeSize;
         real8    xp[4], yp[4], zp[4];
@@ -1436,7 +1534,10 @@ void CreateFCCPerfectLoop(Home_t *home, InData_t *inData, int cubeLength,
         id0 = 0;
         inData->nodeCount = 0;
 
-        for (ic = 0; ic < numChains; ic++) {
+        GetItemRange(home, numChains, &firstChain, &lastChain);
+        SkipRandm(&seed, 3 * firstChain);
+
+        for (ic = firstChain; ic < lastChain; ic++) {
 
             np = 4;    /* number of points along 1 chain */
             newNodeIndex = inData->nodeCount;
@@ -1609,25 +1710,24 @@ void CreateFCCPerfectLoop(Home_t *home, InData_t *inData, int cubeLength,
  *          The initial segments created are not necessarily limited to
  *          param->maxSegLen, so a call to InitRemesh() is needed to
  *          chop any excessively long segments into proper lengths.
- *          When we've generated the nodal data for the final chain,
- *          write the block of nodal data to the file.
  */
             InitRemesh(inData, dislocType, startRemeshIndex);
 
-            lastBlock = (ic == (numChains - 1));
-            if (lastBlock) {
-                IncDislocationDensity(inData, totDislocLen);
-                param->nodeCount = inData->nodeCount;
-                WriteInitialNodeData(home, inData, lastBlock);
-                FreeInNodeArray(inData, inData->nodeCount);
-                inData->nodeCount = 0;
-            }
-
             id0 = inData->nodeCount;
             startRemeshIndex = id0;
 
         } /* loop over chains */
 
+/*
+ *      Nodal data for the final chain has been generated, so
+ *      write the block of nodal data to the file.
+ */
+        IncDislocationDensity(inData, totDislocLen);
+        param->nodeCount = inData->nodeCount;
+        WriteInitialNodeData(home, inData, 1, &inData->nodeCount);
+        FreeInNodeArray(inData, inData->nodeCount);
+        inData->nodeCount = 0;
+
         return;
 }
 
@@ -1655,7 +1755,7 @@ void CreateFiniteMixedConfig(Home_t *home, InData_t *inData, int cubeLength,
                              int dislocType)
 {
         int      i, lineIndex, chain, baseNodeID, numPoints;
-        int      newNodeIndex, lastBlock, burgIndex;
+        int      newNodeIndex, burgIndex, firstChain, lastChain;
         int      isScrew, gpIndex, gpBurgIndex;
         int      startRemeshIndex = 0;
         int      signFact; 
@@ -1913,7 +2013,10 @@ void CreateFiniteMixedConfig(Home_t *home, InData_t *inData, int cubeLength,
         baseNodeID = 0;
         inData->nodeCount = 0;
 
-        for (chain = 0; chain < numChains; chain++) {
+        GetItemRange(home, numChains, &firstChain, &lastChain);
+        SkipRandm(&seed, 3 * firstChain);
+
+        for (chain = firstChain; chain < lastChain; chain++) {
         
             numPoints = 3;
             lineIndex = chain % 16; 
@@ -2122,25 +2225,23 @@ void CreateFiniteMixedConfig(Home_t *home, InData_t *inData, int cubeLength,
  *          The initial segments created are not necessarily limited to
  *          param->maxSegLen, so a call to InitRemesh() is needed to
  *          chop any excessively long segments into proper lengths.
- *          When we've generated the nodal data for the final chain,
- *          write the block of nodal data to the file.
  */
             InitRemesh(inData, dislocType, startRemeshIndex);
 
-            lastBlock = (chain == (numChains - 1));
-
-            if (lastBlock) {
-                    IncDislocationDensity(inData, totDislocLen);
-                    param->nodeCount = inData->nodeCount;
-                    WriteInitialNodeData(home, inData, lastBlock);
-                    FreeInNodeArray(inData, inData->nodeCount);
-                    inData->nodeCount = 0;
-            }
-
             baseNodeID = inData->nodeCount;
             startRemeshIndex = baseNodeID;
 
-        }  /* for (chain = 0; chain < numChains; ...) */
+        }  /* for (chain = firstChain; chain < lastChain; ...) */
+
+/*
+ *      Nodal data for the final chain has been generated, so
+ *      write the block of nodal data to the file.
+ */
+        IncDislocationDensity(inData, totDislocLen);
+        param->nodeCount = inData->nodeCount;
+        WriteInitialNodeData(home, inData, 1, &inData->nodeCount);
+        FreeInNodeArray(inData, inData->nodeCount);
+        inData->nodeCount = 0;
 
         return;
 }
@@ -2173,7 +2274,7 @@ void CreateFRSource(Home_t *home, InData_t *inData, int cubeLength,
                     real8 *totDislocLen, int dislocType)
 {
         int      i, lineIndex, chain, baseNodeID, numPoints;
-        int      newNodeIndex, lastBlock, burgIndex;
+        int      newNodeIndex, burgIndex, firstChain, lastChain;
         int      isScrew, gpIndex, gpBurgIndex;
         int      lenRange;
         int      startRemeshIndex = 0;
@@ -2352,7 +2453,10 @@ void CreateFRSource(Home_t *home, InData_t *inData, int cubeLength,
         baseNodeID = 0;
         inData->nodeCount = 0;
 
-        for (chain = 0; chain < numSources; chain++) {
+        GetItemRange(home, numSources, &firstChain, &lastChain);
+        SkipRandm(&seed, (lenRange > 0 ? 4 : 3) * firstChain);
+
+        for (chain = firstChain; chain < lastChain; chain++) {
 
             numPoints = 3;
             lineIndex = chain % 4;
@@ -2496,25 +2600,23 @@ void CreateFRSource(Home_t *home, InData_t *inData, int cubeLength,
  *          The initial segments created are not necessarily limited to
  *          param->maxSegLen, so a call to InitRemesh() is needed to
  *          chop any excessively long segments into proper lengths.
- *          When we've generated the nodal data for the final chain,
- *          write the block of nodal data to the file.
  */
             InitRemesh(inData, dislocType, startRemeshIndex);
 
-            lastBlock = (chain == (numSources - 1));
-
-            if (lastBlock) {
-                    IncDislocationDensity(inData, totDislocLen);
-                    param->nodeCount = inData->nodeCount;
-                    WriteInitialNodeData(home, inData, lastBlock);
-                    FreeInNodeArray(inData, inData->nodeCount);
-                    inData->nodeCount = 0;
-            }
-
             baseNodeID = inData->nodeCount;
             startRemeshIndex = baseNodeID;
 
-        }  /* for (chain = 0; chain < numChains; ...) */
+        }  /* for (chain = firstChain; chain < lastChain; ...) */
+
+/*
+ *      Nodal data for the final source has been generated, so
+ *      write the block of nodal data to the file.
+ */
+        IncDislocationDensity(inData, totDislocLen);
+        param->nodeCount = inData->nodeCount;
+        WriteInitialNodeData(home, inData, 1, &inData->nodeCount);
+        FreeInNodeArray(inData, inData->nodeCount);
+        inData->nodeCount = 0;
 
         return;
 }
@@ -2543,7 +2645,7 @@ void CreateEdges(Home_t *home, InData_t *inData, int cubeLength,
                  int numChains, int seed, real8 *totDislocLen,
                  int dislocType)
 {
-        int           ic, ip, np, id0, lastBlock, signFactor;
+        int           ic, ip, np, id0, signFactor, firstChain, lastChain;
         int           newNodeIndex, startRemeshIndex;
         int           ldIndex, gpIndex, burgIndex, nbr1Index, nbr2Index;
         real8         posFactor, cubeSize;
@@ -2586,10 +2688,13 @@ void CreateEdges(Home_t *home, InData_t *inData, int cubeLength,
         startRemeshIndex = 0;
         posFactor = 0.333 * cubeSize;
 
+        GetItemRange(home, numChains, &firstChain, &lastChain);
+        SkipRandm(&seed, 3 * firstChain);
+
 /*
  *      Create the specified number of chains.
  */
-        for (ic = 0; ic < numChains; ic++) {
+        for (ic = firstChain; ic < lastChain; ic++) {
 
             gpIndex = ic % 12; 
             burgIndex = gpIndex % 4;
@@ -2672,22 +2777,22 @@ void CreateEdges(Home_t *home, InData_t *inData, int cubeLength,
  *          The initial segments created are not necessarily limited to
  *          param->maxSegLen, so a call to InitRemesh() is needed to
  *          chop any excessively long segments into proper lengths.
- *          When we've generated the nodal data for the final chain,
- *          write the current block of nodal data to the file.
  */
             InitRemesh(inData, dislocType, startRemeshIndex);
 
-            lastBlock = (ic == numChains - 1);
-            if (lastBlock) {
-                IncDislocationDensity(inData, totDislocLen);
-                param->nodeCount = inData->nodeCount;
-                WriteInitialNodeData(home, inData, lastBlock);
-                FreeInNodeArray(inData, inData->nodeCount);
-                inData->nodeCount = 0;
-            }
-
             id0 = inData->nodeCount;
             startRemeshIndex = id0;
         }
+
+/*
+ *      Nodal data for the final chain has been generated, so
+ *      write the block of nodal data to the file.
+ */
+        IncDislocationDensity(inData, totDislocLen);
+        param->nodeCount = inData->nodeCount;
+        WriteInitialNodeData(home, inData, 1, &inData->nodeCount);
+        FreeInNodeArray(inData, inData->nodeCount);
+        inData->nodeCount = 0;
+
         return;
 }
@@ -84,6 +84,7 @@
  *      Includes functions:
  *          CrossSlip()
  *          DumpCrossSlipEvent()
+ *          GetCrossSlipCandidates()
  *          ResetPosition()
  *          RestoreCrossSlipForce()
  *          SaveCrossSlipInfo()
@@ -333,6 +334,257 @@ void RestoreCrossSlipForce(Node_t *node, Node_t *nbr1, Node_t *nbr2,
 }
 
 
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       GetCrossSlipCandidates()
+ *
+ *      Description:    Screen all 2-nodes native to this domain (threaded)
+ *                      and return the nodeKeys indices of those for which
+ *                      one of the cross-slip conditions (classic or
+ *                      zipper) is met.  The screen applies the same
+ *                      tests as the material-specific cross-slip
+ *                      functions up to the point where nodes would be
+ *                      moved or forces recomputed, and modifies nothing.
+ *
+ *                      The caller must re-apply the tests to each
+ *                      candidate, in order, since a cross-slip event may
+ *                      reposition the neighbors of later candidates.
+ *                      A node that only becomes eligible because of an
+ *                      earlier event in the same cycle is reconsidered
+ *                      the next cycle.
+ *
+ *      Arguments:
+ *          thetacrit     critical angle (radians) for a segment to be
+ *                        considered close to screw
+ *          noiseFactor   factor used in calculating the force threshold
+ *                        the cross-slip plane force must exceed
+ *          weightFactor  weight on the primary plane force in the same
+ *                        comparison
+ *          numCandidates location in which to return the number of
+ *                        candidate nodes
+ *
+ *      Returns:  pointer to an array of <numCandidates> nodeKeys indices
+ *                in ascending order.  The caller is responsible for
+ *                freeing the array.
+ *
+ *-------------------------------------------------------------------------*/
+int *GetCrossSlipCandidates(Home_t *home, real8 thetacrit, real8 noiseFactor,
+                            real8 weightFactor, int *numCandidates)
+{
+        int     i, j, numNodes, numCands, thisDom, opClass;
+        int     burgIndex, numPlanes, plane1, plane2, fplane;
+        int     seg1_is_screw, seg2_is_screw, bothseg_are_screw;
+        int     *candList, *isCand;
+        real8   s2thetacrit, burgSize, fnodeThreshold, fcrit;
+        real8   test1, test2, test3, testmax1, testmax2, testmax3;
+        real8   nodep[3], nbr1p[3], nbr2p[3];
+        real8   vec1[3], vec2[3], vec3[3];
+        real8   burgLab[3], burgCrystal[3], fLab[3], fCrystal[3];
+        real8   segplane1[3], segplane2[3], tmpPlane[3];
+        real8   tmp3[3], tmp3B[3], tmp3C[3];
+        real8   (*glideDirCrystal)[3];
+        Node_t  *node, *nbr1, *nbr2;
+        Param_t *param;
+
+        param   = home->param;
+        thisDom = home->myDomain;
+        opClass = OPCLASS_COLLISION;
+
+        s2thetacrit = sin(thetacrit) * sin(thetacrit);
+
+        numNodes = home->newNodeKeyPtr;
+        numCands = 0;
+
+        candList = (int *)malloc((numNodes + 1) * sizeof(int));
+        isCand   = (int *)malloc((numNodes + 1) * sizeof(int));
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) \
+        private(j, burgIndex, numPlanes, plane1, plane2, fplane, \
+                seg1_is_screw, seg2_is_screw, bothseg_are_screw, \
+                burgSize, fnodeThreshold, fcrit, test1, test2, test3, \
+                testmax1, testmax2, testmax3, nodep, nbr1p, nbr2p, \
+                vec1, vec2, vec3, burgLab, burgCrystal, fLab, fCrystal, \
+                segplane1, segplane2, tmpPlane, tmp3, tmp3B, tmp3C, \
+                glideDirCrystal, node, nbr1, nbr2)
+#endif
+        for (i = 0; i < numNodes; i++) {
+
+            isCand[i] = 0;
+
+            node = home->nodeKeys[i];
+            if (node == (Node_t *)NULL) continue;
+
+            if ((node->numNbrs != 2) || (node->constraint != UNCONSTRAINED)) {
+                continue;
+            }
+
+            burgLab[X] = node->burgX[0];
+            burgLab[Y] = node->burgY[0];
+            burgLab[Z] = node->burgZ[0];
+
+            VECTOR_COPY(burgCrystal, burgLab);
+
+            if (param->useLabFrame) {
+                Matrix33Vector3Multiply(home->rotMatrixInverse, burgLab,
+                                        burgCrystal);
+            }
+
+            burgSize = sqrt(DotProduct(burgLab, burgLab));
+
+            NormalizeVec(burgLab);
+            NormalizeVec(burgCrystal);
+
+/*
+ *          Only glide burgers vectors are in the table
+ */
+            burgIndex = GetBurgIndex(home, burgCrystal);
+            if (burgIndex < 0) continue;
+
+            if ((!DomainOwnsSeg(home, opClass, thisDom, &node->nbrTag[0])) ||
+                (!DomainOwnsSeg(home, opClass, thisDom, &node->nbrTag[1]))) {
+                continue;
+            }
+
+/*
+ *          Let the caller deal with any missing neighbors.
+ */
+            nbr1 = GetNeighborNode(home, node, 0);
+            nbr2 = GetNeighborNode(home, node, 1);
+
+            if ((nbr1 == (Node_t *)NULL) || (nbr2 == (Node_t *)NULL)) {
+                isCand[i] = 1;
+                continue;
+            }
+
+            nodep[X] = node->x; nodep[Y] = node->y; nodep[Z] = node->z;
+            nbr1p[X] = nbr1->x; nbr1p[Y] = nbr1->y; nbr1p[Z] = nbr1->z;
+            nbr2p[X] = nbr2->x; nbr2p[Y] = nbr2->y; nbr2p[Z] = nbr2->z;
+
+            PBCPOSITION(param, nodep[X], nodep[Y], nodep[Z],
+                        &nbr1p[X], &nbr1p[Y], &nbr1p[Z]);
+            PBCPOSITION(param, nodep[X], nodep[Y], nodep[Z],
+                        &nbr2p[X], &nbr2p[Y], &nbr2p[Z]);
+
+            vec1[X] = nbr1p[X] - nbr2p[X];
+            vec1[Y] = nbr1p[Y] - nbr2p[Y];
+            vec1[Z] = nbr1p[Z] - nbr2p[Z];
+
+            vec2[X] = nodep[X] - nbr1p[X];
+            vec2[Y] = nodep[Y] - nbr1p[Y];
+            vec2[Z] = nodep[Z] - nbr1p[Z];
+
+            vec3[X] = nodep[X] - nbr2p[X];
+            vec3[Y] = nodep[Y] - nbr2p[Y];
+            vec3[Z] = nodep[Z] - nbr2p[Z];
+
+            test1 = DotProduct(vec1, burgLab);
+            test2 = DotProduct(vec2, burgLab);
+            test3 = DotProduct(vec3, burgLab);
+
+            test1 = test1 * test1;
+            test2 = test2 * test2;
+            test3 = test3 * test3;
+
+            testmax1 = DotProduct(vec1, vec1);
+            testmax2 = DotProduct(vec2, vec2);
+            testmax3 = DotProduct(vec3, vec3);
+
+            seg1_is_screw = ((testmax2 - test2) < (testmax2 * s2thetacrit));
+            seg2_is_screw = ((testmax3 - test3) < (testmax3 * s2thetacrit));
+            bothseg_are_screw =
+                    (((testmax2 - test2) < (4.0 * testmax2 * s2thetacrit)) &&
+                     ((testmax3 - test3) < (4.0 * testmax3 * s2thetacrit)) &&
+                     ((testmax1 - test1) < (testmax1 * s2thetacrit)));
+
+            if (!(seg1_is_screw || seg2_is_screw || bothseg_are_screw)) {
+                continue;
+            }
+
+            fnodeThreshold = noiseFactor * param->shearModulus * burgSize *
+                             0.5 * (sqrt(testmax2) + sqrt(testmax3));
+
+/*
+ *          Find the planes of the two segments and the plane whose
+ *          screw glide direction sees the largest force.
+ */
+            glideDirCrystal = &home->burgData.glideDirCrystal[3*burgIndex];
+            numPlanes = home->burgData.numPlanesPerBurg[burgIndex];
+
+            segplane1[X] = node->nx[0];
+            segplane1[Y] = node->ny[0];
+            segplane1[Z] = node->nz[0];
+
+            segplane2[X] = node->nx[1];
+            segplane2[Y] = node->ny[1];
+            segplane2[Z] = node->nz[1];
+
+            fLab[X] = node->fX;
+            fLab[Y] = node->fY;
+            fLab[Z] = node->fZ;
+
+            if (param->useLabFrame) {
+                Matrix33Vector3Multiply(home->rotMatrixInverse, segplane1,
+                                        tmpPlane);
+                VECTOR_COPY(segplane1, tmpPlane);
+
+                Matrix33Vector3Multiply(home->rotMatrixInverse, segplane2,
+                                        tmpPlane);
+                VECTOR_COPY(segplane2, tmpPlane);
+
+                Matrix33Vector3Multiply(home->rotMatrixInverse, fLab,
+                                        fCrystal);
+            } else {
+                VECTOR_COPY(fCrystal, fLab);
+            }
+
+            Matrix33Vector3Multiply(glideDirCrystal, segplane1, tmp3);
+            Matrix33Vector3Multiply(glideDirCrystal, segplane2, tmp3B);
+            Matrix33Vector3Multiply(glideDirCrystal, fCrystal, tmp3C);
+
+            plane1 = 0;
+            plane2 = 0;
+            fplane = 0;
+
+            for (j = 1; j < numPlanes; j++) {
+                plane1 = (fabs(tmp3[j])  < fabs(tmp3[plane1]))  ? j:plane1;
+                plane2 = (fabs(tmp3B[j]) < fabs(tmp3B[plane2])) ? j:plane2;
+                fplane = (fabs(tmp3C[j]) > fabs(tmp3C[fplane])) ? j:fplane;
+            }
+
+            fcrit = fabs(tmp3C[fplane]);
+
+            if ((bothseg_are_screw) && (plane1 == plane2) &&
+                (plane1 != fplane) &&
+                (fcrit > (weightFactor*fabs(tmp3C[plane1])+fnodeThreshold))) {
+                isCand[i] = 1;
+            } else if ((seg1_is_screw) && (plane1 != plane2) &&
+                       (plane2 == fplane) &&
+                       (fcrit > (weightFactor*fabs(tmp3C[plane1]) +
+                                 fnodeThreshold))) {
+                isCand[i] = 1;
+            } else if ((seg2_is_screw) && (plane1 != plane2) &&
+                       (plane1 == fplane) &&
+                       (fcrit > (weightFactor*fabs(tmp3C[plane2]) +
+                                 fnodeThreshold))) {
+                isCand[i] = 1;
+            }
+        }
+
+        for (i = 0; i < numNodes; i++) {
+            if (isCand[i]) {
+                candList[numCands++] = i;
+            }
+        }
+
+        free(isCand);
+
+        *numCandidates = numCands;
+
+        return(candList);
+}
+
+
 void CrossSlip(Home_t *home)
 {
         int enabled, matType;
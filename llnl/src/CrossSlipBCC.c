@@ -41,7 +41,8 @@ static int dbgDom;
  *-------------------------------------------------------------------------*/
 void CrossSlipBCC(Home_t *home)
 {
-        int    i, j, m, n;
+        int    j, cand, numCands, burgIndex;
+        int    *candList;
         int    plane1, plane2, fplane;
         int    pinned1, pinned2;
         int    opClass, thisDom;
@@ -57,8 +58,7 @@ void CrossSlipBCC(Home_t *home)
         real8  vec1[3], vec2[3], vec3[3];
         real8  segplane1[3], segplane2[3], newplane[3];
         real8  tmp3[3], tmp3B[3], tmp3C[3];
-        real8  tmp33[3][3];
-        real8  glideDirLab[3][3], glideDirCrystal[3][3];
+        real8  (*glideDirLab)[3], (*glideDirCrystal)[3];
         real8  burgLab[3], burgCrystal[3];
         real8  fLab[3], fCrystal[3];
         real8  nodePosOrig[3], nbr1PosOrig[3], nbr2PosOrig[3];
@@ -103,11 +103,17 @@ void CrossSlipBCC(Home_t *home)
         opClass = OPCLASS_COLLISION;
 
 /*
- *      Loop through all 2-nodes native to this domain
+ *      Loop through all 2-nodes native to this domain for which the
+ *      (threaded) screen found the cross-slip conditions to be met.
+ *      The conditions are re-evaluated here since the nodes may have
+ *      been moved by an earlier cross-slip event.
  */
-        for (i = 0; i < home->newNodeKeyPtr; i++) {
+        candList = GetCrossSlipCandidates(home, thetacrit, noiseFactor,
+                                          weightFactor, &numCands);
 
-            if ((node = home->nodeKeys[i]) == (Node_t *)NULL) {
+        for (cand = 0; cand < numCands; cand++) {
+
+            if ((node = home->nodeKeys[candList[cand]]) == (Node_t *)NULL) {
                 continue;
             }
 
@@ -141,9 +147,12 @@ void CrossSlipBCC(Home_t *home)
             NormalizeVec(burgCrystal);
 
 /*
- *          Only consider glide dislocations
+ *          Only consider glide dislocations, i.e. burgers vectors
+ *          of the <111> types in the burgers vector table.
  */
-            if (fabs(burgCrystal[X] * burgCrystal[Y] * burgCrystal[Z]) < eps) {
+            burgIndex = GetBurgIndex(home, burgCrystal);
+
+            if (burgIndex < 0) {
                 continue;
             }
 
@@ -265,22 +274,14 @@ void CrossSlipBCC(Home_t *home)
                                  0.5 * (L1 + L2);  
 
 /*
- *              Find which glide planes the segments are on.  Initial glidedir
- *              array contains glide planes in crystal frame
- *              For BCC Geometry burCrystal should be of <1 1 1> type
+ *              Find which glide planes the segments are on.  The burgers
+ *              vector table holds the three <112> type directions that a
+ *              screw dislocation may move in if glide is restricted to
+ *              <110> type glide planes, in both the crystal and lab frames.
  */
-                Matrix31Vector3Mult(burgCrystal, burgCrystal, tmp33);
+                glideDirCrystal = &home->burgData.glideDirCrystal[3*burgIndex];
+                glideDirLab = &home->burgData.glideDirLab[3*burgIndex];
 
-                for (m = 0; m < 3; m++) {
-                    for (n = 0; n < 3; n++) {
-                        glideDirCrystal[m][n] = ((m==n)-tmp33[m][n])*sqrt(1.5);
-                    }
-                }
-/*
- *              glideDirCrystal should now contian the three <112> type
- *              directions that a screw dislocation may move in if glide
- *              is restricted to <110> type glide planes
- */
                 segplane1[X] = node->nx[0];
                 segplane1[Y] = node->ny[0];
                 segplane1[Z] = node->nz[0];
@@ -290,21 +291,12 @@ void CrossSlipBCC(Home_t *home)
                 segplane2[Z] = node->nz[1];
 
 /*
- *              Need copies of the glideDir matrix and the force vector
- *              in both the lab frame and the crystal frame for later use.
- *              Also need to rotate the segment planes into the crystal frame.
+ *              Need copies of the force vector in both the lab frame and
+ *              the crystal frame for later use.  Also need to rotate the
+ *              segment planes into the crystal frame.
  */
                 if (param->useLabFrame) {
-                    int   row;
                     real8 tmpPlane[3];
-/*
- *                  Rotate initial glide dir array from crystal to lab frame
- */
-                    for (row = 0; row < 3; row++) {
-                        Matrix33Vector3Multiply(home->rotMatrix,
-                                                glideDirCrystal[row],
-                                                glideDirLab[row]);
-                    }
 /*
  *                  Rotate segment planes to crystal frame
  */
@@ -324,11 +316,8 @@ void CrossSlipBCC(Home_t *home)
                 } else {
 /*
  *                  Lab and crystal frames are identical, so just copy
- *                  the vectors
+ *                  the vector
  */
-                    VECTOR_COPY(glideDirLab[0], glideDirCrystal[0]);
-                    VECTOR_COPY(glideDirLab[1], glideDirCrystal[1]);
-                    VECTOR_COPY(glideDirLab[2], glideDirCrystal[2]);
                     VECTOR_COPY(fCrystal, fLab);
                 }
 
@@ -654,5 +643,7 @@ void CrossSlipBCC(Home_t *home)
 
         }  /* end loop over all nodes */
 
+        free(candList);
+
         return;
 }
@@ -35,7 +35,8 @@ static int dbgDom;
  *-------------------------------------------------------------------------*/
 void CrossSlipFCC(Home_t *home)
 {
-        int    i, j, n;
+        int    j, cand, numCands, burgIndex;
+        int    *candList;
         int    plane1, plane2, fplane;
         int    pinned1, pinned2;
         int    opClass, thisDom;
@@ -50,7 +51,7 @@ void CrossSlipFCC(Home_t *home)
         real8  vec1[3], vec2[3], vec3[3];
         real8  segplane1[3], segplane2[3], newplane[3];
         real8  tmp3[3], tmp3B[3], tmp3C[3];
-        real8  glideDirLab[3][3], glideDirCrystal[3][3];
+        real8  (*glideDirLab)[3], (*glideDirCrystal)[3];
         real8  fLab[3], fCrystal[3];
         real8  burgLab[3], burgCrystal[3];
         real8  nodePosOrig[3], nbr1PosOrig[3], nbr2PosOrig[3];
@@ -76,6 +77,7 @@ void CrossSlipFCC(Home_t *home)
         sthetacrit = sin(thetacrit);
         s2thetacrit = sthetacrit * sthetacrit;
         areamin = param->remeshAreaMin;
+        shearModulus = param->shearModulus;
 
 /*
  *      In order to cross-slip a node, the force on the cross-slip
@@ -94,11 +96,17 @@ void CrossSlipFCC(Home_t *home)
         opClass = OPCLASS_COLLISION;
 
 /*
- *      Loop through all 2-nodes native to this domain
+ *      Loop through all 2-nodes native to this domain for which the
+ *      (threaded) screen found the cross-slip conditions to be met.
+ *      The conditions are re-evaluated here since the nodes may have
+ *      been moved by an earlier cross-slip event.
  */
-        for (i = 0; i < home->newNodeKeyPtr; i++) {
+        candList = GetCrossSlipCandidates(home, thetacrit, noiseFactor,
+                                          weightFactor, &numCands);
 
-            if ((node = home->nodeKeys[i]) == (Node_t *)NULL) {
+        for (cand = 0; cand < numCands; cand++) {
+
+            if ((node = home->nodeKeys[candList[cand]]) == (Node_t *)NULL) {
                 continue;
             }
 
@@ -133,20 +141,12 @@ void CrossSlipFCC(Home_t *home)
 
 /*
  *          Only consider glide dislocations.  If burgers vector is not
- *          a [1 1 0] type, ignore it.
- */
-            if (!((fabs(fabs(burgCrystal[X])-fabs(burgCrystal[Y])) < eps ) &&
-                  (fabs(burgCrystal[Z]) < eps )) &&
-                !((fabs(fabs(burgCrystal[Y])-fabs(burgCrystal[Z])) < eps ) &&
-                  (fabs(burgCrystal[X]) < eps )) &&
-                !((fabs(fabs(burgCrystal[Z])-fabs(burgCrystal[X])) < eps ) &&
-                  (fabs(burgCrystal[Y]) < eps ))) {
-                 continue;
-            }
+ *          one of the [1 1 0] types in the burgers vector table, ignore it.
+ */
+            burgIndex = GetBurgIndex(home, burgCrystal);
 
-            if ((fabs(burgCrystal[X]) < eps) && (fabs(burgCrystal[Y]) < eps) &&
-                (fabs(burgCrystal[Z]) < eps )) {
-                 continue;
+            if (burgIndex < 0) {
+                continue;
             }
 
 /*
@@ -266,42 +266,18 @@ void CrossSlipFCC(Home_t *home)
                                  0.5 * (L1 + L2);
 
 /*
- *              Find which glide planes the segments are on
+ *              Find which glide planes the segments are on.  The burgers
+ *              vector table holds the two <112> type directions that a
+ *              screw dislocation may move in on its <111> type glide
+ *              planes (the third row is zero since for FCC there are
+ *              only two slip planes for a screw dislocation), in both
+ *              the crystal and lab frames.
  *              e.g. for burg = [ 1  1  0 ], the two glide directions are
  *                              [ 1 -1  2 ] and
  *                              [ 1 -1 -2 ] 
- *
- *              Use burgers vectors in crystal frame to generate initial glide
- *              planes in crystal frame.
- */
-                tmp = 1.0; 
-
-                for (n = 0; n < 3; n++) {
-                   if ( fabs(burgCrystal[n]) > eps ) {
-                      glideDirCrystal[0][n] =
-                              (burgCrystal[n]*tmp > 0) ? 1.0 : -1.0;
-                      glideDirCrystal[1][n] =
-                              (burgCrystal[n]*tmp > 0) ? 1.0 : -1.0;
-                      tmp = -1.0;
-                   } 
-                   else {
-                      glideDirCrystal[0][n] =  2.0;
-                      glideDirCrystal[1][n] = -2.0;
-                   }
-                }
-
-/*
- *              For FCC there are only two slip planes for screw dislocation
  */
-                VECTOR_ZERO(glideDirCrystal[2]);
-
-/*
- *              Normalization
- */
-                for (n = 0; n < 3; n++) {
-                    glideDirCrystal[0][n] *= sqrt(1.0/6.0);
-                    glideDirCrystal[1][n] *= sqrt(1.0/6.0);
-                }
+                glideDirCrystal = &home->burgData.glideDirCrystal[3*burgIndex];
+                glideDirLab = &home->burgData.glideDirLab[3*burgIndex];
 
                 segplane1[X] = node->nx[0];
                 segplane1[Y] = node->ny[0];
@@ -312,21 +288,12 @@ void CrossSlipFCC(Home_t *home)
                 segplane2[Z] = node->nz[1];
 
 /*
- *              Need copies of the glideDir matrix and the force vector
- *              in both the lab frame and the crystal frame for later use.
- *              Also need to rotate the segment planes into the crystal frame.
+ *              Need copies of the force vector in both the lab frame and
+ *              the crystal frame for later use.  Also need to rotate the
+ *              segment planes into the crystal frame.
  */
                 if (param->useLabFrame) {
-                    int   row;
                     real8 tmpPlane[3];
-/*
- *                  Rotate initial glide dir from crystal to lab frame
- */
-                    for (row = 0; row < 3; row++) {
-                        Matrix33Vector3Multiply(home->rotMatrix,
-                                                glideDirCrystal[row],
-                                                glideDirLab[row]);
-                    }
 /*
  *                  Rotate segment planes to crystal frame
  */
@@ -346,11 +313,8 @@ void CrossSlipFCC(Home_t *home)
                 } else {
 /*
  *                  Lab and crystal frames are identical, so just copy
- *                  the vectors
+ *                  the vector
  */
-                    VECTOR_COPY(glideDirLab[0], glideDirCrystal[0]);
-                    VECTOR_COPY(glideDirLab[1], glideDirCrystal[1]);
-                    VECTOR_COPY(glideDirLab[2], glideDirCrystal[2]);
                     VECTOR_COPY(fCrystal, fLab);
                 }
 
@@ -674,5 +638,7 @@ void CrossSlipFCC(Home_t *home)
 
         }  /* end loop over all nodes */
 
+        free(candList);
+
         return;
 }
@@ -10,11 +10,14 @@
  *                   currently in use. 
  *
  *      Includes public functions
+ *          AddCellCost()
  *          BroadcastDecomp()
+ *          FindCellLoadCoord()
  *          FindCoordDomain()
  *          FreeDecomp()
  *          GetAllDecompBounds()
  *          GetCellDomainList()
+ *          GetCellLoadProfile()
  *          GetLocalDomainBounds()
  *          ReadDecompBounds()
  *          Rebalance()
@@ -23,7 +26,9 @@
  *          XPlotDecomp()
  *
  *      Includes private functions
+ *          CellOverlap()
  *          DLBStats()
+ *          GetCellLoadData()
  *          GetLoadData()
  *
  ***************************************************************************/
@@ -32,6 +37,7 @@
 #include "Decomp.h"
 #include "RSDecomp.h"
 #include "RBDecomp.h"
+#include "SFCDecomp.h"
 
 /*
  *      Define some flags that toggle compile-time generation of
@@ -159,6 +165,9 @@ void BroadcastDecomp(Home_t *home, void *decomp)
         case 2:
             BroadcastRBDecomp(home, (RBDecomp_t *)decomp);
             break;
+        case 3:
+            BroadcastSFCDecomp(home, (SFCDecomp_t *)decomp);
+            break;
         }
 
 /*
@@ -207,6 +216,9 @@ void UniformDecomp(Home_t *home, void **decomp)
                           ALLOC_NEW_DECOMP);
             UniformRBDecomp(param, (RBDecomp_t *)*decomp, level);
             break;
+        case 3:
+            UniformSFCDecomp(param, (SFCDecomp_t **)decomp);
+            break;
         }
  
         return;
@@ -319,6 +331,17 @@ void ReadDecompBounds(Home_t *home, void **filePtr, int doBinRead,
                                (RBDecomp_t **)oldDecomp);
             }
             break;
+        case 3:
+            if (doBinRead) {
+                ReadBinSFCDecompBounds(home, (void *)filePtr, decompDomX,
+                                       decompDomY, decompDomZ,
+                                       (SFCDecomp_t **)oldDecomp);
+            } else {
+                ReadSFCDecompBounds(home, filePtr, decompDomX, decompDomY,
+                                    decompDomZ, saveDecomp,
+                                    (SFCDecomp_t **)oldDecomp);
+            }
+            break;
         }
 
         return;
@@ -352,6 +375,9 @@ void WriteDecompBounds(Home_t *home, FILE *fp)
             WriteRBDecompBounds(home, fp, (RBDecomp_t *)home->decomp,
                                 level);
             break;
+        case 3:
+            WriteSFCDecompBounds(home, fp, (SFCDecomp_t *)home->decomp);
+            break;
         }
 
         return;
@@ -393,6 +419,11 @@ void GetAllDecompBounds(Home_t *home, real8 **bounds, int *numBounds)
             *bounds = (real8 *)malloc(*numBounds * sizeof(real8));
             GetAllRBDecompBounds(home, (RBDecomp_t *)home->decomp, *bounds);
             break;
+        case 3:
+            *numBounds = home->numDomains + 4;
+            *bounds = (real8 *)malloc(*numBounds * sizeof(real8));
+            GetAllSFCDecompBounds(home, (SFCDecomp_t *)home->decomp, *bounds);
+            break;
         }
 
         return;
@@ -429,6 +460,10 @@ void XPlotDecomp(Home_t *home, real8 xMin, real8 yMin, real8 zMin, real8 lMax,
             XPlotRBDecomp(home, (RBDecomp_t *)home->decomp, xMin, yMin, zMin,
                         lMax, color, lineWidth);
             break;
+        case 3:
+            XPlotSFCDecomp(home, (SFCDecomp_t *)home->decomp, xMin, yMin,
+                           zMin, lMax, color, lineWidth);
+            break;
         }
 
         return;
@@ -461,6 +496,9 @@ void FreeDecomp(Home_t *home, void *decomp)
             case 2:
                 FreeRBDecomp((RBDecomp_t *)decomp);
                 break;
+            case 3:
+                FreeSFCDecomp((SFCDecomp_t *)decomp);
+                break;
             }
         }
 
@@ -489,6 +527,9 @@ void GetLocalDomainBounds(Home_t *home, void *decomp)
         case 2:
             GetRBDecompLocalDomainBounds(home, (RBDecomp_t *)decomp);
             break;
+        case 3:
+            GetSFCDecompLocalDomainBounds(home, (SFCDecomp_t *)decomp);
+            break;
         }
 
         return;
@@ -523,6 +564,9 @@ void GetCellDomainList(Home_t *home, int cellID, int *domCount, int **domList)
         case 2:
             GetRBDecompCellDomainList(home, cellID, domCount, domList);
             break;
+        case 3:
+            GetSFCDecompCellDomainList(home, cellID, domCount, domList);
+            break;
         }
 
         return;
@@ -581,6 +625,496 @@ static void GetLoadData(Home_t *home, int criteria, real8 **loadData)
 }
 
 
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    CellOverlap
+ *      Description: Return the fraction of the extent <cellMin> to
+ *                   <cellMax> that falls within the range <minCoord>
+ *                   to <maxCoord>.  A zero-width extent is treated
+ *                   as a point.
+ *
+ *------------------------------------------------------------------------*/
+static real8 CellOverlap(real8 minCoord, real8 maxCoord,
+                         real8 cellMin, real8 cellMax)
+{
+        real8 lo, hi;
+
+        if (cellMax <= cellMin) {
+            return(((cellMin >= minCoord) && (cellMin < maxCoord)) ? 1.0 : 0.0);
+        }
+
+        lo = MAX(minCoord, cellMin);
+        hi = MIN(maxCoord, cellMax);
+
+        if (hi <= lo) {
+            return(0.0);
+        }
+
+        return((hi - lo) / (cellMax - cellMin));
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    AddCellCost
+ *      Description: Add the specified cost to the simulation cell
+ *                   containing the given coordinates.  Costs accumulate
+ *                   until the next call to Rebalance().
+ *
+ *                   Note: the cost array is not locked, so this function
+ *                   must not be called from within a threaded region.
+ *
+ *      Arguments:
+ *          x, y, z   Coordinates at which the work was done
+ *          cost      Cost of the work (see DLB_COST_* in Decomp.h)
+ *
+ *------------------------------------------------------------------------*/
+void AddCellCost(Home_t *home, real8 x, real8 y, real8 z, real8 cost)
+{
+        int     i, numCells, cellIndex[3], cellsPerDim[3];
+        real8   pos[3], cellSize;
+        Param_t *param;
+
+        param = home->param;
+
+        if ((param->DLBcellCost == 0) ||
+            ((param->DLBfreq < 1) && (param->numDLBCycles < 1))) {
+            return;
+        }
+
+        cellsPerDim[X] = param->nXcells;
+        cellsPerDim[Y] = param->nYcells;
+        cellsPerDim[Z] = param->nZcells;
+
+        if (home->cellCost == (real8 *)NULL) {
+            numCells = cellsPerDim[X] * cellsPerDim[Y] * cellsPerDim[Z];
+            home->cellCost = (real8 *)calloc(1, numCells * sizeof(real8));
+        }
+
+        pos[X] = x;
+        pos[Y] = y;
+        pos[Z] = z;
+
+/*
+ *      Nodes may sit slightly outside the primary image or (for
+ *      free surfaces) on the boundary itself, so just attribute the
+ *      cost to the nearest cell.
+ */
+        for (i = 0; i < 3; i++) {
+            cellSize = (param->maxCoordinates[i] - param->minCoordinates[i]) /
+                       cellsPerDim[i];
+            cellIndex[i] = (int)floor((pos[i] - param->minCoordinates[i]) /
+                                      cellSize);
+            cellIndex[i] = MAX(0, MIN(cellsPerDim[i]-1, cellIndex[i]));
+        }
+
+        home->cellCost[(cellIndex[X] * cellsPerDim[Y] + cellIndex[Y]) *
+                       cellsPerDim[Z] + cellIndex[Z]] += cost;
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    GetCellLoadProfile
+ *      Description: Project the portion of the global load histogram
+ *                   falling within the specified box onto dimension
+ *                   <dim>.  The histogram consists of the load of each
+ *                   simulation cell within each domain; load is only
+ *                   assumed uniform within the intersection of a cell
+ *                   and a domain.  The resulting profile has
+ *                   DLB_PROFILE_BINS bins per cell along <dim>.
+ *
+ *      Arguments:
+ *          boxMin   Minimum coordinates of the box
+ *          boxMax   Maximum coordinates of the box
+ *          dim      Dimension (X, Y or Z) along which to project.
+ *          profile  Location in which to return to the caller the
+ *                   array containing the load within the box for each
+ *                   profile bin.  Caller is responsible for freeing
+ *                   the array.
+ *
+ *      Returns:  Total load within the box
+ *
+ *------------------------------------------------------------------------*/
+real8 GetCellLoadProfile(Home_t *home, real8 boxMin[3], real8 boxMax[3],
+                         int dim, real8 **profile)
+{
+        int     i, j, k, d, p, bin, numBins, cellID;
+        int     cellsPerDim[3], minIndex[3], maxIndex[3];
+        real8   cellSize[3], binSize, load, totLoad, lo, hi, binLo, binHi;
+        real8   *piece, *binLoad;
+        Param_t *param;
+
+        param = home->param;
+
+        cellsPerDim[X] = param->nXcells;
+        cellsPerDim[Y] = param->nYcells;
+        cellsPerDim[Z] = param->nZcells;
+
+        numBins = cellsPerDim[dim] * DLB_PROFILE_BINS;
+        binLoad = (real8 *)calloc(1, numBins * sizeof(real8));
+
+/*
+ *      Only bother with the range of cells the box may overlap
+ */
+        for (d = 0; d < 3; d++) {
+            cellSize[d] = (param->maxCoordinates[d] -
+                           param->minCoordinates[d]) / cellsPerDim[d];
+            minIndex[d] = (int)floor((boxMin[d] - param->minCoordinates[d]) /
+                                     cellSize[d]);
+            maxIndex[d] = (int)floor((boxMax[d] - param->minCoordinates[d]) /
+                                     cellSize[d]);
+            minIndex[d] = MAX(0, minIndex[d]);
+            maxIndex[d] = MIN(cellsPerDim[d]-1, maxIndex[d]);
+        }
+
+        binSize = cellSize[dim] / DLB_PROFILE_BINS;
+        totLoad = 0.0;
+
+        for (i = minIndex[X]; i <= maxIndex[X]; i++) {
+          for (j = minIndex[Y]; j <= maxIndex[Y]; j++) {
+            for (k = minIndex[Z]; k <= maxIndex[Z]; k++) {
+
+              cellID = (i * cellsPerDim[Y] + j) * cellsPerDim[Z] + k;
+
+              for (p = home->cellLoadIndex[cellID];
+                   p < home->cellLoadIndex[cellID+1]; p++) {
+
+/*
+ *                Each piece of the histogram consists of the load
+ *                followed by the min and max coordinates of the volume
+ *                over which the load is distributed.
+ */
+                  piece = &home->cellLoad[p * DLB_PIECE_SIZE];
+                  load = piece[0];
+
+                  for (d = 0; d < 3; d++) {
+                      if (d == dim) continue;
+                      load *= CellOverlap(boxMin[d], boxMax[d],
+                                          piece[1+d], piece[4+d]);
+                  }
+
+                  if (load == 0.0) {
+                      continue;
+                  }
+
+                  lo = piece[1+dim];
+                  hi = piece[4+dim];
+
+/*
+ *                Spread the load uniformly over the bins covered by
+ *                the piece, or drop it in a single bin if the piece has
+ *                no extent in this dimension.
+ */
+                  if (hi <= lo) {
+                      if ((lo < boxMin[dim]) || (lo >= boxMax[dim])) {
+                          continue;
+                      }
+                      bin = (int)floor((lo - param->minCoordinates[dim]) /
+                                       binSize);
+                      bin = MAX(0, MIN(numBins-1, bin));
+                      binLoad[bin] += load;
+                      totLoad += load;
+                      continue;
+                  }
+
+                  bin = (int)floor((MAX(lo, boxMin[dim]) -
+                                    param->minCoordinates[dim]) / binSize);
+                  bin = MAX(0, bin);
+
+                  for ( ; bin < numBins; bin++) {
+                      binLo = param->minCoordinates[dim] + bin * binSize;
+                      binHi = binLo + binSize;
+                      if ((binLo >= hi) || (binLo >= boxMax[dim])) break;
+                      binLo = MAX(binLo, MAX(lo, boxMin[dim]));
+                      binHi = MIN(binHi, MIN(hi, boxMax[dim]));
+                      if (binHi <= binLo) continue;
+                      binLoad[bin] += load * (binHi - binLo) / (hi - lo);
+                      totLoad += load * (binHi - binLo) / (hi - lo);
+                  }
+              }
+            }
+          }
+        }
+
+        *profile = binLoad;
+
+        return(totLoad);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    FindCellLoadCoord
+ *      Description: Given a load profile from GetCellLoadProfile(),
+ *                   find the coordinate between <minCoord> and
+ *                   <maxCoord> below which the accumulated load
+ *                   equals <neededLoad>.  The load is interpolated
+ *                   linearly within a profile bin.
+ *
+ *      Arguments:
+ *          profile     Load profile along dimension <dim>
+ *          dim         Dimension (X, Y or Z) of the profile
+ *          minCoord    Lower limit of the range over which the
+ *                      profile was taken
+ *          maxCoord    Upper limit of the range over which the
+ *                      profile was taken
+ *          neededLoad  Load to be accumulated
+ *
+ *      Returns:  The coordinate at which <neededLoad> is reached, or
+ *                <maxCoord> if the profile contains less load.
+ *
+ *------------------------------------------------------------------------*/
+real8 FindCellLoadCoord(Home_t *home, real8 *profile, int dim,
+                        real8 minCoord, real8 maxCoord, real8 neededLoad)
+{
+        int     i, numBins;
+        real8   binSize, lo, hi;
+        Param_t *param;
+
+        param = home->param;
+
+        numBins = DLB_PROFILE_BINS *
+                  ((dim == X) ? param->nXcells :
+                   ((dim == Y) ? param->nYcells : param->nZcells));
+
+        binSize = (param->maxCoordinates[dim] - param->minCoordinates[dim]) /
+                  numBins;
+
+        for (i = 0; i < numBins; i++) {
+
+            lo = MAX(minCoord, param->minCoordinates[dim] + i * binSize);
+            hi = MIN(maxCoord, param->minCoordinates[dim] + (i+1) * binSize);
+
+            if ((hi <= lo) || (profile[i] <= 0.0)) {
+                continue;
+            }
+
+            if (neededLoad <= profile[i]) {
+                return(lo + (hi - lo) * (neededLoad / profile[i]));
+            }
+
+            neededLoad -= profile[i];
+        }
+
+        return(maxCoord);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    GetCellLoadData
+ *      Description: Build the global load histogram used to place new
+ *                   domain boundaries.  The local cell costs accumulated
+ *                   this cycle are scaled so they sum to this domain's
+ *                   measured load, and the load of each cell is
+ *                   associated with the portion of the cell inside the
+ *                   local domain.  If no cost was recorded locally, the
+ *                   load is spread uniformly over the local domain.
+ *                   All domains then exchange their pieces of the
+ *                   histogram.
+ *
+ *      Arguments:
+ *          localLoad  Load of the local domain (wallclock time or
+ *                     force calc count)
+ *
+ *------------------------------------------------------------------------*/
+static void GetCellLoadData(Home_t *home, real8 localLoad)
+{
+        int     i, j, k, d, cellID, numCells, cellsPerDim[3], index[3];
+        int     numLocalPieces, numPieces, *cellCount;
+        real8   localCost, scale, cellMin, cellSize[3];
+        real8   domMin[3], domMax[3], volume;
+        real8   *cellCost, *localPieces, *allPieces, *piece;
+        Param_t *param;
+#ifdef PARALLEL
+        int     *pieceCounts, *displacements;
+#endif
+
+        param = home->param;
+
+        cellsPerDim[X] = param->nXcells;
+        cellsPerDim[Y] = param->nYcells;
+        cellsPerDim[Z] = param->nZcells;
+
+        numCells = cellsPerDim[X] * cellsPerDim[Y] * cellsPerDim[Z];
+
+        if (home->cellCost == (real8 *)NULL) {
+            home->cellCost = (real8 *)calloc(1, numCells * sizeof(real8));
+        }
+
+        if (home->cellLoadIndex == (int *)NULL) {
+            home->cellLoadIndex = (int *)malloc((numCells+1) * sizeof(int));
+        }
+
+        domMin[X] = home->domXmin;  domMax[X] = home->domXmax;
+        domMin[Y] = home->domYmin;  domMax[Y] = home->domYmax;
+        domMin[Z] = home->domZmin;  domMax[Z] = home->domZmax;
+
+        for (d = 0; d < 3; d++) {
+            cellSize[d] = (param->maxCoordinates[d] -
+                           param->minCoordinates[d]) / cellsPerDim[d];
+        }
+
+        cellCost = home->cellCost;
+        localCost = 0.0;
+
+        for (i = 0; i < numCells; i++) {
+            localCost += cellCost[i];
+        }
+
+        if (localCost > 0.0) {
+
+            scale = localLoad / localCost;
+
+            for (i = 0; i < numCells; i++) {
+                cellCost[i] *= scale;
+            }
+
+        } else if (localLoad > 0.0) {
+
+            volume = (domMax[X] - domMin[X]) * (domMax[Y] - domMin[Y]) *
+                     (domMax[Z] - domMin[Z]);
+
+            for (i = 0; i < numCells; i++) {
+                index[X] = i / (cellsPerDim[Y] * cellsPerDim[Z]);
+                index[Y] = (i / cellsPerDim[Z]) % cellsPerDim[Y];
+                index[Z] = i % cellsPerDim[Z];
+                cellCost[i] = localLoad * cellSize[X] * cellSize[Y] *
+                              cellSize[Z] / volume;
+                for (d = 0; d < 3; d++) {
+                    cellMin = param->minCoordinates[d] + index[d]*cellSize[d];
+                    cellCost[i] *= CellOverlap(domMin[d], domMax[d], cellMin,
+                                               cellMin + cellSize[d]);
+                }
+            }
+        }
+
+/*
+ *      Build the local pieces of the histogram.  Each consists of
+ *      the cell ID followed by the data described in
+ *      GetCellLoadProfile().  The load is associated with the
+ *      intersection of the cell and the local domain; if a node
+ *      was outside the domain (i.e. it has not yet been migrated)
+ *      the full cell extent is used in any dimension in which the
+ *      two don't intersect.
+ */
+        numLocalPieces = 0;
+
+        for (i = 0; i < numCells; i++) {
+            if (cellCost[i] > 0.0) numLocalPieces++;
+        }
+
+        localPieces = (real8 *)malloc((numLocalPieces+1) *
+                                      (DLB_PIECE_SIZE+1) * sizeof(real8));
+        piece = localPieces;
+
+        for (i = 0; i < cellsPerDim[X]; i++) {
+            index[X] = i;
+            for (j = 0; j < cellsPerDim[Y]; j++) {
+                index[Y] = j;
+                for (k = 0; k < cellsPerDim[Z]; k++) {
+                    index[Z] = k;
+
+                    cellID = (i * cellsPerDim[Y] + j) * cellsPerDim[Z] + k;
+
+                    if (cellCost[cellID] <= 0.0) {
+                        continue;
+                    }
+
+                    piece[0] = (real8)cellID;
+                    piece[1] = cellCost[cellID];
+
+                    for (d = 0; d < 3; d++) {
+                        cellMin = param->minCoordinates[d] +
+                                  index[d] * cellSize[d];
+                        piece[2+d] = MAX(cellMin, domMin[d]);
+                        piece[5+d] = MIN(cellMin + cellSize[d], domMax[d]);
+                        if (piece[5+d] < piece[2+d]) {
+                            piece[2+d] = cellMin;
+                            piece[5+d] = cellMin + cellSize[d];
+                        }
+                    }
+
+                    piece += DLB_PIECE_SIZE + 1;
+                }
+            }
+        }
+
+/*
+ *      Gather the pieces from all domains
+ */
+#ifdef PARALLEL
+        pieceCounts = (int *)malloc(home->numDomains * sizeof(int));
+        displacements = (int *)malloc(home->numDomains * sizeof(int));
+
+        i = numLocalPieces * (DLB_PIECE_SIZE+1);
+
+        MPI_Allgather(&i, 1, MPI_INT, pieceCounts, 1, MPI_INT,
+                      MPI_COMM_WORLD);
+
+        displacements[0] = 0;
+
+        for (i = 1; i < home->numDomains; i++) {
+            displacements[i] = displacements[i-1] + pieceCounts[i-1];
+        }
+
+        numPieces = (displacements[home->numDomains-1] +
+                     pieceCounts[home->numDomains-1]) / (DLB_PIECE_SIZE+1);
+
+        allPieces = (real8 *)malloc((numPieces+1) * (DLB_PIECE_SIZE+1) *
+                                    sizeof(real8));
+
+        MPI_Allgatherv(localPieces, numLocalPieces * (DLB_PIECE_SIZE+1),
+                       MPI_DOUBLE, allPieces, pieceCounts, displacements,
+                       MPI_DOUBLE, MPI_COMM_WORLD);
+
+        free(pieceCounts);
+        free(displacements);
+        free(localPieces);
+#else
+        numPieces = numLocalPieces;
+        allPieces = localPieces;
+#endif
+
+/*
+ *      Sort the pieces by cell so the pieces for any given cell
+ *      can be located quickly.
+ */
+        cellCount = (int *)calloc(1, (numCells+1) * sizeof(int));
+
+        for (i = 0; i < numPieces; i++) {
+            cellCount[(int)allPieces[i*(DLB_PIECE_SIZE+1)]]++;
+        }
+
+        home->cellLoadIndex[0] = 0;
+
+        for (i = 0; i < numCells; i++) {
+            home->cellLoadIndex[i+1] = home->cellLoadIndex[i] + cellCount[i];
+            cellCount[i] = home->cellLoadIndex[i];
+        }
+
+        free(home->cellLoad);
+        home->cellLoad = (real8 *)malloc((numPieces+1) * DLB_PIECE_SIZE *
+                                         sizeof(real8));
+
+        for (i = 0; i < numPieces; i++) {
+            piece = &allPieces[i*(DLB_PIECE_SIZE+1)];
+            cellID = (int)piece[0];
+            memcpy(&home->cellLoad[cellCount[cellID] * DLB_PIECE_SIZE],
+                   &piece[1], DLB_PIECE_SIZE * sizeof(real8));
+            cellCount[cellID]++;
+        }
+
+        free(cellCount);
+        free(allPieces);
+
+        return;
+}
+
+
 /*-------------------------------------------------------------------------
  *
  *      Function:    Rebalance
@@ -628,7 +1162,8 @@ void Rebalance(Home_t *home, int criteria)
  */
         if ((param->numDLBCycles > 0) || ((param->DLBfreq > 0) &&
             (((param->decompType == 1)&&(home->cycle%param->DLBfreq <= 3)) ||
-             ((param->decompType == 2)&&(home->cycle%param->DLBfreq == 0))))) {
+             ((param->decompType == 2)&&(home->cycle%param->DLBfreq == 0)) ||
+             ((param->decompType == 3)&&(home->cycle%param->DLBfreq == 0))))) {
 
 /*
  *          Decomposition requires the raw per-process load
@@ -640,6 +1175,16 @@ void Rebalance(Home_t *home, int criteria)
             DLBStats(home, loadData);
 #endif
 
+/*
+ *          Unless disabled, also build the histogram of the load
+ *          per simulation cell so the decomposition functions can
+ *          place boundaries where the load actually is rather than
+ *          assuming it is uniform within each domain.
+ */
+            if (param->DLBcellCost) {
+                GetCellLoadData(home, loadData[home->myDomain]);
+            }
+
             switch (param->decompType) {
             case 1:
 /*
@@ -722,6 +1267,15 @@ void Rebalance(Home_t *home, int criteria)
                 }
 
                 break;
+
+            case 3:
+/*
+ *              For space-filling curve decompositions, the domain
+ *              ranges along the curve are recalculated from scratch
+ *              (if the imbalance warrants it) by all domains at once.
+ */
+                didDLB = SFCRebalance(home, loadData);
+                break;
             }
 
 /*
@@ -743,6 +1297,14 @@ void Rebalance(Home_t *home, int criteria)
             }
         }
 
+/*
+ *      Per-cell costs are only accumulated over a single cycle (the
+ *      same period covered by the per-process load data).
+ */
+        if (home->cellCost != (real8 *)NULL) {
+            memset(home->cellCost, 0, param->nXcells * param->nYcells *
+                   param->nZcells * sizeof(real8));
+        }
 
         TimerStop(home, LOAD_BALANCE);
 
@@ -801,7 +1363,13 @@ int FindCoordDomain(Home_t *home, int updateCoords,
         yMax = home->domYmax;
         zMax = home->domZmax;
 
-        if (((newX >= xMin) && (newX < xMax)) &&
+/*
+ *      Note: domains of a space-filling-curve decomposition are sets
+ *      of cells whose bounds are only a bounding box, so the shortcut
+ *      does not apply there.
+ */
+        if ((param->decompType != 3) &&
+            ((newX >= xMin) && (newX < xMax)) &&
             ((newY >= yMin) && (newY < yMax)) &&
             ((newZ >= zMin) && (newZ < zMax))) {
             return(domID);
@@ -883,6 +1451,15 @@ int FindCoordDomain(Home_t *home, int updateCoords,
                                             newX, newY, newZ);
 
             break;
+        case 3:
+/*
+ *          Coordinates outside the problem space are assigned to
+ *          the closest cell by the lookup itself.
+ */
+            domID = FindSFCDecompCoordDomain(home,
+                                             (SFCDecomp_t *)home->decomp,
+                                             newX, newY, newZ);
+            break;
         }
 
         return(domID);
@@ -80,6 +80,7 @@ void DisableUnneededParams(Home_t *home)
  */
         if (param->DLBfreq < 1) {
             MarkParamDisabled(home->ctrlParamList, "decompType");
+            MarkParamDisabled(home->ctrlParamList, "DLBcellCost");
         }
 
 /*
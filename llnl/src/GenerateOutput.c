@@ -1379,11 +1379,17 @@ void GenerateOutput(Home_t *home, int stage)
 #ifndef NO_XWINDOW
 /*
  *      The X-Window plotting is a different beast since all
- *      the data must get filtered through processor zero...
- *      so for now we handle it the old way.
+ *      the data must get filtered through processor zero.  By
+ *      default only a reduced summary of each domain's segments
+ *      is sent, but the old way of downloading every domain's
+ *      full nodal data is still available.
  */
         if ((outputTypes & GEN_XWIN_DATA) != 0) {
-            CommSendMirrorNodes(home, stage);
+            if (param->winSummary) {
+                CommSendPlotSummary(home, stage);
+            } else {
+                CommSendMirrorNodes(home, stage);
+            }
         }
 
 /*
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *
+ *      Module:       GlideConstraints.c
+ *      Description:  Contains the glide plane constraint functions shared
+ *                    by the mobility laws.  These are kept out of Util.c
+ *                    so the surface applications, which build their own
+ *                    copies of Util.c, can link them as well.
+ *
+ *      Includes:
+ *              ApplyGlideConstraints()
+ *              FindIndependentConstraints()
+ *
+ ***************************************************************************/
+#include "Home.h"
+#include "Util.h"
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     FindIndependentConstraints
+ *      Description:  Reduce a set of constraint vectors (e.g. the glide
+ *                    plane normals of the segments attached to a node)
+ *                    to a linearly independent set.  Each vector is
+ *                    orthogonalized against all preceding vectors, and
+ *                    any vector that is left with a squared magnitude
+ *                    below FFACTOR_ORTH is taken to be dependent on the
+ *                    preceding vectors and zeroed.
+ *
+ *                    The vectors should be normalized on entry.
+ *
+ *      Arguments:
+ *          numVec       number of vectors in the set
+ *          vx, vy, vz   arrays of <numVec> X, Y and Z components of
+ *                       the vectors.  The reduced set is returned
+ *                       in the same arrays.
+ *
+ *      Returns:  The number of independent (non-zero) vectors
+ *
+ *------------------------------------------------------------------------*/
+int FindIndependentConstraints(int numVec, real8 *vx, real8 *vy, real8 *vz)
+{
+        int i, j, numIndependent;
+
+        numIndependent = numVec;
+
+        for (i = 0; i < numVec; i++) {
+
+            for (j = 0; j < i; j++) {
+                Orthogonalize(&vx[i], &vy[i], &vz[i], vx[j], vy[j], vz[j]);
+            }
+
+            if ((vx[i]*vx[i] + vy[i]*vy[i] + vz[i]*vz[i]) < FFACTOR_ORTH) {
+                vx[i] = 0.0;
+                vy[i] = 0.0;
+                vz[i] = 0.0;
+                numIndependent--;
+            }
+        }
+
+        return(numIndependent);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     ApplyGlideConstraints
+ *      Description:  Remove from a velocity the components normal to
+ *                    each of a set of glide plane normals.  The normals
+ *                    should already have been reduced to an independent
+ *                    set via FindIndependentConstraints(); zeroed
+ *                    entries in the set are skipped.
+ *
+ *      Arguments:
+ *          numNorms     number of plane normals
+ *          nx, ny, nz   arrays of <numNorms> X, Y and Z components of
+ *                       the plane normals
+ *          velx, vely, velz  Pointers to the three velocity components.
+ *                       The constrained velocity is returned via these
+ *                       same pointers.
+ *
+ *------------------------------------------------------------------------*/
+void ApplyGlideConstraints(int numNorms, real8 *nx, real8 *ny, real8 *nz,
+                           real8 *velx, real8 *vely, real8 *velz)
+{
+        int i;
+
+        for (i = 0; i < numNorms; i++) {
+            if ((nx[i] != 0.0) || (ny[i] != 0.0) || (nz[i] != 0.0)) {
+                Orthogonalize(velx, vely, velz, nx[i], ny[i], nz[i]);
+            }
+        }
+
+        return;
+}
@@ -554,6 +554,16 @@ void SetRemainingDefaults(Home_t *home)
                       param->remeshAreaMin, param->remeshAreaMax);
             }
 
+            if ((param->remeshRule == 4) &&
+                ((param->remeshAngleMin >= param->remeshAngleMax) ||
+                 (param->remeshForceErrMin >= param->remeshForceErrMax))) {
+                Fatal("remeshAngleMin and remeshForceErrMin must be less "
+                      "than remeshAngleMax\n    and remeshForceErrMax.  "
+                      "Current values = %lf, %lf, %lf, %lf",
+                      param->remeshAngleMin, param->remeshForceErrMin,
+                      param->remeshAngleMax, param->remeshForceErrMax);
+            }
+
 /*
  *          Now check for conditions that although not fatal, may result
  *          in undesired behaviour, and warn the user.
@@ -682,6 +692,7 @@ void SetRemainingDefaults(Home_t *home)
             param->materialType = MAT_TYPE_BCC;
             param->mobilityType = MOB_BCC_0;
             param->mobilityFunc = Mobility_BCC_0;
+            param->mobilityCacheFunc = MobilityCache_BCC_0;
             param->numBurgGroups = 5;
         } else if (strcmp(param->mobilityLaw, "BCC_0b") == 0) {
             param->materialType = MAT_TYPE_BCC;
@@ -697,6 +708,7 @@ void SetRemainingDefaults(Home_t *home)
             param->materialType = MAT_TYPE_FCC;
             param->mobilityType = MOB_FCC_0;
             param->mobilityFunc = Mobility_FCC_0;
+            param->mobilityCacheFunc = MobilityCache_FCC_0;
             param->numBurgGroups = 7;
         } else if (strcmp(param->mobilityLaw, "FCC_0b") == 0) {
             param->materialType = MAT_TYPE_FCC;
@@ -1598,6 +1610,13 @@ void Initialize(Home_t *home,int argc, char *argv[])
             Matrix33Invert(home->rotMatrix, home->rotMatrixInverse);
         }
 
+/*
+ *      Build the table of burgers vectors and glide planes for the
+ *      material type.  This depends on the lab frame rotation matrices
+ *      set above.
+ */
+        InitBurgInfo(home);
+
         CheckMemUsage(home, "Initialize");
 
         return;
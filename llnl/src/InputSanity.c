@@ -110,8 +110,8 @@ void InputSanity (Home_t *home)
 /*
  *      Verify the domain decomposition type specified is valid.
  */
-        if ((param->decompType < 1) || (param->decompType > 2)) {
-            Fatal("decompType=%d is invalid.  Type must be 1 or 2\n",
+        if ((param->decompType < 1) || (param->decompType > 3)) {
+            Fatal("decompType=%d is invalid.  Type must be 1, 2 or 3\n",
                   param->decompType);
         }
 
@@ -22,6 +22,7 @@
 #include <math.h>
 #include "Home.h"
 #include "Comm.h"
+#include "Decomp.h"
 #include "ParadisThread.h"
 
 
@@ -3008,6 +3009,33 @@ void LocalSegForces(Home_t *home, int reqType)
             }
         }
 
+/*
+ *      If the load-balancing is using the per-cell cost model, record
+ *      the work done above with the cells containing the segments.
+ *      Done outside the threaded loops since the cost array is not
+ *      locked.
+ */
+        if (param->DLBcellCost) {
+            real8 segCost;
+
+            segCost = DLB_COST_NATIVESEG;
+
+            if (param->fmEnabled) {
+                segCost += DLB_COST_GAUSSPT * param->fmNumPoints;
+            }
+
+            for (i = 0; i < nativeSegListCnt; i++) {
+                node1 = nativeSegList[i].seg->node1;
+                AddCellCost(home, node1->x, node1->y, node1->z, segCost);
+            }
+
+            for (i = 0; i < segPairListCnt; i++) {
+                node1 = segPairList[i].seg1->node1;
+                AddCellCost(home, node1->x, node1->y, node1->z,
+                            DLB_COST_SEGPAIR);
+            }
+        }
+
 /*
  *      Bump up the count of segments that will be sent to
  *      any remote domain owning one of the nodes in any
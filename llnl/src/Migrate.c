@@ -30,18 +30,37 @@
 #define MSG_MIG_NODES  3001
 
 /*
- *      Define some constants indicating the number of values that
- *      must be communicated for each node and arm in order to properly
- *      migrate a node.
+ *      Migrated nodes are sent as raw bytes: a MigHeader_t followed,
+ *      for each node, by a MigNode_t and one MigArm_t per arm.  All
+ *      three structures are a multiple of 8 bytes in size, so every
+ *      record in the buffer is suitably aligned.
  */
+typedef struct {
+        int   nodeCount;
+        int   armCount;
+} MigHeader_t;
+
+typedef struct {
+        int   index;
+        int   constraint;
+        int   numNbrs;
+        int   sgnv;
+        int   flags;
 #ifdef _FEM
-#define VALS_PER_MIG_NODE  19
-#else
-#define VALS_PER_MIG_NODE  14
+        int   fem_Surface[2];
+        real8 fem_Surface_Norm[3];
 #endif
+        real8 x, y, z;
+        real8 vX, vY, vZ;
+        real8 oldvX, oldvY, oldvZ;
+} MigNode_t;
 
-#define VALS_PER_MIG_ARM       11
-#define VALS_PER_MIG_EXTRA     2
+typedef struct {
+        Tag_t nbrTag;
+        real8 burg[3];
+        real8 norm[3];
+        real8 armf[3];
+} MigArm_t;
 
 
 #ifdef PARALLEL
@@ -54,11 +73,17 @@
  *      Description:  Identify all local entities that are outside the
  *                    local domains current boundaries (due to motion of
  *                    the entity or the domain boundaries themselves) and
- *                    require migration to remote domains.  Arrays (1 per
- *                    domain to which entities will be migrated) will be
- *                    created with indices of the entities to be migrated
- *                    to the remote domains along with counts of the entities
- *                    being migrated.
+ *                    require migration to remote domains.  A single
+ *                    list of the entities to be migrated is built,
+ *                    sorted by destination domain, along with the list
+ *                    of destination domains and the offset of each
+ *                    destination's entities in the migration list.
+ *
+ *                    Nodes inside the local domain's bounding box are
+ *                    accepted by FindCoordDomain() without searching
+ *                    the decomposition, so the search is only done for
+ *                    the (usually few) nodes near or past the domain
+ *                    boundaries.
  *
  *      Arguments:
  *          migCommList Pointer to an array of integers (1 per domain) 
@@ -66,40 +91,43 @@
  *                      will be set to 0 or 1 indicating if the current
  *                      domain will be migrating items to the corresponding
  *                      remote domain.
- *          migList     Array of pointers (1 per domain).  On exit from
- *                      the function, will contain pointers to lists
- *                      (integer arrays) of entities which are to be
- *                      migrated to the corresponding remote domains.
- *                      Any domain to which no entities are being migrated
- *                      will have a NULL pointer associated with its list.
- *          migListCnt  Array of integers containing 1 element per domain.
- *                      On return from the function, for a given domain
- *                      ID <n>, the number of nodes being migrated to the
- *                      remote domain will be specified in migListCnt[n]
+ *          migList     Pointer in which to return to the caller an array
+ *                      of the indices of all nodes to be migrated, grouped
+ *                      by destination domain.  The order of the groups
+ *                      matches <sendBufDest>.
  *          sendBufDest Pointer in which to return to the caller an array
  *                      of domain IDs to which this domain will be 
  *                      migrating nodes.
+ *          sendBufStart Pointer in which to return to the caller an
+ *                      array of <numSendBufs>+1 offsets into <migList>.
+ *                      Nodes sent to domain sendBufDest[n] are located
+ *                      at migList[sendBufStart[n]] through
+ *                      migList[sendBufStart[n+1]-1].
  *          numSendBufs Pointer to location in which to return to the 
  *                      caller the number of domains to which the local
  *                      domain will be migrating nodes.
  *
  *-------------------------------------------------------------------------*/
 static void BuildMigLists(Home_t *home, int *migCommList, int **migList,
-                          int *migListCnt, int **sendBufDest, int *numSendBufs)
+                          int **sendBufDest, int **sendBufStart,
+                          int *numSendBufs)
 {
-        int          i, j;
-        int          nodeCount, numDomains, thisDomain, destDom;
-        int          allocatedValues, sendBufCnt, listLen;
-        int          *sendBufList;
+        int          i, nodeCount, thisDomain, destDom;
+        int          numMigrators, allocatedMigrators, sendBufCnt;
+        int          *migIndex, *migDom, *destList, *destStart, *destSlot;
+        int          *list;
         Node_t       *node;
 
         nodeCount = home->newNodeKeyPtr;
-        numDomains = home->numDomains;
         thisDomain = home->myDomain;
 
+        numMigrators = 0;
+        allocatedMigrators = 0;
+        migIndex = (int *)NULL;
+        migDom = (int *)NULL;
+
         sendBufCnt = 0;
-        allocatedValues = 0;
-        sendBufList = (int *)NULL;
+        destList = (int *)NULL;
 
         for (i = 0; i < nodeCount; i++) {
 
@@ -117,46 +145,83 @@ static void BuildMigLists(Home_t *home, int *migCommList, int **migList,
             if (destDom == thisDomain) {
                 continue;
             }
+
 /*
- *          For any node that needs migrating, add the node to the list
- *          of nodes being sent to that particular remote domain, increment
- *          the count of nodes beng sent there.  Also set the flag for that
- *          remote domain in the list of domains to which this domain
- *          will need to migrate nodes.
+ *          Save the node and its destination.  The per-destination
+ *          lists are built in one pass once all migrators are known.
  */
-            migCommList[destDom] = 1;
-            migList[destDom] = (int *)realloc(migList[destDom],
-                                              (migListCnt[destDom]+1) *
-                                              sizeof(int));
-            migList[destDom][migListCnt[destDom]] = i;
-            migListCnt[destDom] += 1;
+            if (numMigrators == allocatedMigrators) {
+                allocatedMigrators += 100;
+                migIndex = (int *)realloc(migIndex, allocatedMigrators *
+                                          sizeof(int));
+                migDom = (int *)realloc(migDom, allocatedMigrators *
+                                        sizeof(int));
+            }
+
+            migIndex[numMigrators] = i;
+            migDom[numMigrators] = destDom;
+            numMigrators++;
 
 /*
- *          If the remote domain is not already on the list of domains
- *          to which this domain will be migrating stuff, add the remote
- *          domain ID to the list... so we don't have to loop through
- *          the entire list of remote domains later looking for the
- *          ones to which we're migrating stuff.
+ *          The first time a remote domain is seen, set the flag for it
+ *          in the list of domains to which this domain will need to
+ *          migrate nodes and add it to the list of destinations.
  */
-            for (j = 0; j < sendBufCnt; j++) {
-                if (destDom == sendBufList[j]) {
-                    break;
-                }
+            if (migCommList[destDom] == 0) {
+                migCommList[destDom] = 1;
+                destList = (int *)realloc(destList, (sendBufCnt+1) *
+                                          sizeof(int));
+                destList[sendBufCnt++] = destDom;
+            }
+        }
+
+/*
+ *      Group the migrators by destination (a counting sort, which
+ *      preserves the order of the nodes within each destination).
+ */
+        destStart = (int *)calloc(1, (sendBufCnt+1) * sizeof(int));
+        list = (int *)NULL;
+
+        if (numMigrators > 0) {
+
+            destSlot = (int *)malloc(home->numDomains * sizeof(int));
+
+            for (i = 0; i < sendBufCnt; i++) {
+                destSlot[destList[i]] = i;
+            }
+
+            for (i = 0; i < numMigrators; i++) {
+                destStart[destSlot[migDom[i]]+1]++;
+            }
+
+            for (i = 0; i < sendBufCnt; i++) {
+                destStart[i+1] += destStart[i];
+            }
+
+            list = (int *)malloc(numMigrators * sizeof(int));
+
+            for (i = 0; i < numMigrators; i++) {
+                list[destStart[destSlot[migDom[i]]]++] = migIndex[i];
             }
 
-            if (j == sendBufCnt) {
-                sendBufCnt += 1;
-                if (sendBufCnt > allocatedValues) {
-                    allocatedValues += 25;
-                    sendBufList = (int *)realloc(sendBufList, allocatedValues *
-                                                 sizeof(int));
-                }
-                sendBufList[sendBufCnt-1] = destDom;
+/*
+ *          The fill loop advanced each offset to the start of the
+ *          next group, so shift them back.
+ */
+            for (i = sendBufCnt; i > 0; i--) {
+                destStart[i] = destStart[i-1];
             }
-            
+            destStart[0] = 0;
+
+            free(destSlot);
         }
 
-        *sendBufDest = sendBufList;
+        free(migIndex);
+        free(migDom);
+
+        *migList = list;
+        *sendBufDest = destList;
+        *sendBufStart = destStart;
         *numSendBufs = sendBufCnt;
 
         return;
@@ -171,14 +236,9 @@ static void BuildMigLists(Home_t *home, int *migCommList, int **migList,
  *                    a remote domain.
  *
  *      Arguments:
- *          remDomID   ID of remote domain to which the specified entities
- *                     will be sent.
  *          migList    Array of integers containing IDs of all entities
  *                     to be packed into the buffer.
- *          migCounts  Array of counts of items being migrated to each
- *                     remote domain. Array size equals the number of domains
- *                     Number of nodes being migrated to domain X will be
- *                     located in migCounts[X]
+ *          migCount   Number of entities in <migList>
  *          sendBuf    Pointer in which to return the pointer to the
  *                     allocated buffer.  Caller will be responsible for
  *                     freeing the buffer.
@@ -186,90 +246,93 @@ static void BuildMigLists(Home_t *home, int *migCommList, int **migList,
  *                     caller.
  *
  *-------------------------------------------------------------------------*/
-static void PackMigrators(Home_t *home, int remDomID, int *migList,
-                          int *migCounts, real8 **sendBuf, int *sendBufLen)
+static void PackMigrators(Home_t *home, int *migList, int migCount,
+                          char **sendBuf, int *sendBufLen)
 {
-        int          i, j;
-        int          migNodeCount, armCount, numVals;
-        int          bufIndex;
-        real8        *buf;
+        int          i, j, armCount, bufLen;
+        char         *buf, *bufPtr;
         Node_t       *node;
-
-        armCount = 0;
-        bufIndex = 0;
-
-/*
- *      migCounts[remDomID] contains the number of nodes being
- *      migrated to the remote domain <remDomID.
- */
-        migNodeCount = migCounts[remDomID];
+        MigHeader_t  header;
+        MigNode_t    migNode;
+        MigArm_t     migArm;
 
 /*
  *      Determine how large a buffer is required to hold all the
  *      specified entities and allocate an appropriately sized buffer.
  */
-        for (i = 0; i < migNodeCount; i++) {
+        armCount = 0;
+
+        for (i = 0; i < migCount; i++) {
             armCount += home->nodeKeys[migList[i]]->numNbrs;
         }
 
-        numVals = migNodeCount * VALS_PER_MIG_NODE +
-                  armCount * VALS_PER_MIG_ARM  +
-                  VALS_PER_MIG_EXTRA;
+        bufLen = sizeof(MigHeader_t) +
+                 migCount * sizeof(MigNode_t) +
+                 armCount * sizeof(MigArm_t);
 
-        buf = (real8 *)malloc(numVals * sizeof(real8));
+        buf = (char *)malloc(bufLen);
+        bufPtr = buf;
 
-        buf[bufIndex++] = (real8)migNodeCount;
-        buf[bufIndex++] = 0.0;  /* reserved */
+        header.nodeCount = migCount;
+        header.armCount  = armCount;
+
+        memcpy(bufPtr, &header, sizeof(MigHeader_t));
+        bufPtr += sizeof(MigHeader_t);
 
 /*
  *      Loop through all the nodes to be sent and pack the necessary
  *      nodal data into the buffer.
  */
-        for (i = 0; i < migNodeCount; i++) {
+        for (i = 0; i < migCount; i++) {
             node = home->nodeKeys[migList[i]];
 
-            buf[bufIndex++] = (real8)node->myTag.index;
-            buf[bufIndex++] = (real8)node->constraint;
-            buf[bufIndex++] = (real8)node->numNbrs;
-            buf[bufIndex++] = (real8)node->sgnv;
-            buf[bufIndex++] = (real8)node->flags;
+            migNode.index      = node->myTag.index;
+            migNode.constraint = node->constraint;
+            migNode.numNbrs    = node->numNbrs;
+            migNode.sgnv       = node->sgnv;
+            migNode.flags      = node->flags;
 
-            buf[bufIndex++] = node->x;
-            buf[bufIndex++] = node->y;
-            buf[bufIndex++] = node->z;
+            migNode.x = node->x;
+            migNode.y = node->y;
+            migNode.z = node->z;
 
-            buf[bufIndex++] = node->vX;
-            buf[bufIndex++] = node->vY;
-            buf[bufIndex++] = node->vZ;
+            migNode.vX = node->vX;
+            migNode.vY = node->vY;
+            migNode.vZ = node->vZ;
 
-            buf[bufIndex++] = node->oldvX;
-            buf[bufIndex++] = node->oldvY;
-            buf[bufIndex++] = node->oldvZ;
+            migNode.oldvX = node->oldvX;
+            migNode.oldvY = node->oldvY;
+            migNode.oldvZ = node->oldvZ;
 
 #ifdef _FEM
-            buf[bufIndex++] = node->fem_Surface[0];
-            buf[bufIndex++] = node->fem_Surface[1];
+            migNode.fem_Surface[0] = node->fem_Surface[0];
+            migNode.fem_Surface[1] = node->fem_Surface[1];
 
-            buf[bufIndex++] = node->fem_Surface_Norm[0];
-            buf[bufIndex++] = node->fem_Surface_Norm[1];
-            buf[bufIndex++] = node->fem_Surface_Norm[2];
+            migNode.fem_Surface_Norm[0] = node->fem_Surface_Norm[0];
+            migNode.fem_Surface_Norm[1] = node->fem_Surface_Norm[1];
+            migNode.fem_Surface_Norm[2] = node->fem_Surface_Norm[2];
 #endif
+            memcpy(bufPtr, &migNode, sizeof(MigNode_t));
+            bufPtr += sizeof(MigNode_t);
+
             for (j = 0; j < node->numNbrs; j++) {
 
-                buf[bufIndex++] = (real8)node->nbrTag[j].domainID;
-                buf[bufIndex++] = (real8)node->nbrTag[j].index;
+                migArm.nbrTag = node->nbrTag[j];
 
-                buf[bufIndex++] = node->burgX[j];
-                buf[bufIndex++] = node->burgY[j];
-                buf[bufIndex++] = node->burgZ[j];
+                migArm.burg[0] = node->burgX[j];
+                migArm.burg[1] = node->burgY[j];
+                migArm.burg[2] = node->burgZ[j];
 
-                buf[bufIndex++] = node->nx[j];
-                buf[bufIndex++] = node->ny[j];
-                buf[bufIndex++] = node->nz[j];
+                migArm.norm[0] = node->nx[j];
+                migArm.norm[1] = node->ny[j];
+                migArm.norm[2] = node->nz[j];
 
-                buf[bufIndex++] = node->armfx[j];
-                buf[bufIndex++] = node->armfy[j];
-                buf[bufIndex++] = node->armfz[j];
+                migArm.armf[0] = node->armfx[j];
+                migArm.armf[1] = node->armfy[j];
+                migArm.armf[2] = node->armfz[j];
+
+                memcpy(bufPtr, &migArm, sizeof(MigArm_t));
+                bufPtr += sizeof(MigArm_t);
             }
 
 /*
@@ -284,7 +347,7 @@ static void PackMigrators(Home_t *home, int remDomID, int *migList,
  *      Caller is responsible for freeing the buffer.
  */
         *sendBuf = buf;
-        *sendBufLen = numVals * sizeof(real8);
+        *sendBufLen = bufLen;
 
         return;
 }
@@ -297,30 +360,33 @@ static void PackMigrators(Home_t *home, int remDomID, int *migList,
  *                    remote domain.
  *
  *      Arguments:
- *          buf      Array containing the nodal data
+ *          buf      Buffer containing the nodal data
  *          remDomID ID of the remote domain from which this buffer
  *                   was received.
  *
  *-------------------------------------------------------------------------*/
-static void UnpackMigrators(Home_t *home, real8 *buf, int remDomID)
+static void UnpackMigrators(Home_t *home, char *buf, int remDomID)
 {
-        int          i, j, bufIndex, nodeIndex, nodeCount, numNbrs;
+        int          i, j, nodeIndex, numNbrs;
         int          thisDomain;
-        int          newSize, newIndex;
+        char         *bufPtr;
         Tag_t        oldTag;
         Node_t       *node;
+        MigHeader_t  header;
+        MigNode_t    migNode;
+        MigArm_t     migArm;
 
         thisDomain = home->myDomain;
-        bufIndex = 0;
+        bufPtr = buf;
 
-/*
- *      Get the node count from the first element of the buffer.
- *      The second element is reserved,so skip it.
- */
-        nodeCount = (int)buf[bufIndex++];
-        bufIndex++;
+        memcpy(&header, bufPtr, sizeof(MigHeader_t));
+        bufPtr += sizeof(MigHeader_t);
+
+        for (i = 0; i < header.nodeCount; i++) {
+
+            memcpy(&migNode, bufPtr, sizeof(MigNode_t));
+            bufPtr += sizeof(MigNode_t);
 
-        for (i = 0; i < nodeCount; i++) {
 /*
  *          Add a new node to the list of local nodes and populate the
  *          node structure with data from the remote domain.  Also
@@ -335,34 +401,34 @@ static void UnpackMigrators(Home_t *home, real8 *buf, int remDomID)
             node->myTag.index    = nodeIndex;
 
             oldTag.domainID = remDomID;
-            oldTag.index    = (int)buf[bufIndex++];
+            oldTag.index    = migNode.index;
 
             AddTagMapping(home, &oldTag, &node->myTag);
 
-            node->constraint  = (int)buf[bufIndex++];
-            numNbrs           = (int)buf[bufIndex++];
-            node->sgnv        = (int)buf[bufIndex++];
-            node->flags       = (int)buf[bufIndex++];
+            node->constraint  = migNode.constraint;
+            numNbrs           = migNode.numNbrs;
+            node->sgnv        = migNode.sgnv;
+            node->flags       = migNode.flags;
 
-            node->x = buf[bufIndex++];
-            node->y = buf[bufIndex++];
-            node->z = buf[bufIndex++];
+            node->x = migNode.x;
+            node->y = migNode.y;
+            node->z = migNode.z;
 
-            node->vX = buf[bufIndex++];
-            node->vY = buf[bufIndex++];
-            node->vZ = buf[bufIndex++];
+            node->vX = migNode.vX;
+            node->vY = migNode.vY;
+            node->vZ = migNode.vZ;
 
-            node->oldvX = buf[bufIndex++];
-            node->oldvY = buf[bufIndex++];
-            node->oldvZ = buf[bufIndex++];
+            node->oldvX = migNode.oldvX;
+            node->oldvY = migNode.oldvY;
+            node->oldvZ = migNode.oldvZ;
 
 #ifdef _FEM
-            node->fem_Surface[0] = buf[bufIndex++];
-            node->fem_Surface[1] = buf[bufIndex++];
+            node->fem_Surface[0] = migNode.fem_Surface[0];
+            node->fem_Surface[1] = migNode.fem_Surface[1];
 
-            node->fem_Surface_Norm[0] = buf[bufIndex++];
-            node->fem_Surface_Norm[1] = buf[bufIndex++];
-            node->fem_Surface_Norm[2] = buf[bufIndex++];
+            node->fem_Surface_Norm[0] = migNode.fem_Surface_Norm[0];
+            node->fem_Surface_Norm[1] = migNode.fem_Surface_Norm[1];
+            node->fem_Surface_Norm[2] = migNode.fem_Surface_Norm[2];
 #endif
 
 /*
@@ -372,20 +438,22 @@ static void UnpackMigrators(Home_t *home, real8 *buf, int remDomID)
 
             for (j = 0; j < numNbrs; j++) {
 
-                node->nbrTag[j].domainID = (int)buf[bufIndex++];
-                node->nbrTag[j].index = (int)buf[bufIndex++];
+                memcpy(&migArm, bufPtr, sizeof(MigArm_t));
+                bufPtr += sizeof(MigArm_t);
 
-                node->burgX[j] = buf[bufIndex++];
-                node->burgY[j] = buf[bufIndex++];
-                node->burgZ[j] = buf[bufIndex++];
+                node->nbrTag[j] = migArm.nbrTag;
 
-                node->nx[j] = buf[bufIndex++];
-                node->ny[j] = buf[bufIndex++];
-                node->nz[j] = buf[bufIndex++];
+                node->burgX[j] = migArm.burg[0];
+                node->burgY[j] = migArm.burg[1];
+                node->burgZ[j] = migArm.burg[2];
 
-                node->armfx[j] = buf[bufIndex++];
-                node->armfy[j] = buf[bufIndex++];
-                node->armfz[j] = buf[bufIndex++];
+                node->nx[j] = migArm.norm[0];
+                node->ny[j] = migArm.norm[1];
+                node->nz[j] = migArm.norm[2];
+
+                node->armfx[j] = migArm.armf[0];
+                node->armfy[j] = migArm.armf[1];
+                node->armfz[j] = migArm.armf[2];
             }
         }
 
@@ -404,28 +472,25 @@ static void UnpackMigrators(Home_t *home, real8 *buf, int remDomID)
  *                      is set to 0 or 1 indicating if the current domain
  *                      will be migrating nodes to the corresponding
  *                      remote domain.
- *          migList     Array of pointers (1 per domain).  Contains
- *                      pointers to lists (integer arrays) of node IDs
- *                      which are to be migrated to the corresponding
- *                      remote domains.  Any domain to which no nodes
- *                      are being migrated will have a NULL pointer
- *                      associated with its list.
- *          migListCnt  Array of counts of items being migrated to each
- *                      remote domain. Array size equals the number of domains
- *                      Number of nodes being migrated to domain X will be
- *                      located in migCounts[X].
+ *          migList     Array of the indices of all nodes to be
+ *                      migrated, grouped by destination domain.
  *          sendBufDest Array of of domain IDs to which this domain will
  *                      be migrating nodes.
+ *          sendBufStart Array of offsets into <migList> of the nodes
+ *                      being sent to each domain in <sendBufDest>.
  *          numSendBufs The number of domains to which the local domain
  *                      will be migrating nodes.
  *
+ *      Returns:  The total number of domain pairs exchanging nodes
+ *                across all domains; zero if no node migrated anywhere.
+ *
  *-------------------------------------------------------------------------*/
-static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
-                              int *migListCnt, int *sendBufDest,
-                              int numSendBufs)
+static int CommSendMigrators(Home_t *home, int *migCommList, int *migList,
+                             int *sendBufDest, int *sendBufStart,
+                             int numSendBufs)
 {
-        int         i, numValues, numRecvBufs, recvIndex;
-        int         numDomains, thisDomain, domID;
+        int         i, numRecvBufs, recvIndex, globalMigCount;
+        int         numDomains, thisDomain;
         int         *glblMigCommList;
         int         *sendBufLen, *recvBufLen;
         char        **sendBuf, **recvBuf;
@@ -451,6 +516,12 @@ static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
 
         numRecvBufs = glblMigCommList[thisDomain];
 
+        globalMigCount = 0;
+
+        for (i = 0; i < numDomains; i++) {
+            globalMigCount += glblMigCommList[i];
+        }
+
         free(glblMigCommList);
 
 /*
@@ -458,7 +529,7 @@ static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
  *      will be migrating nodes
  */
         if (numSendBufs > 0) {
-            sendBuf = (char **)calloc(1, numSendBufs * sizeof(real8 *));
+            sendBuf = (char **)calloc(1, numSendBufs * sizeof(char *));
             sendBufLen = (int *)calloc(1, numSendBufs * sizeof(int));
             sendRequest = (MPI_Request *)malloc(numSendBufs *
                                                 sizeof(MPI_Request));
@@ -467,16 +538,16 @@ static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
         }
 
         for (i = 0; i < numSendBufs; i++) {
-            domID = sendBufDest[i];
-            PackMigrators(home, domID, migList[domID], migListCnt,
-                          (real8 **)&sendBuf[i], &sendBufLen[i]);
+            PackMigrators(home, &migList[sendBufStart[i]],
+                          sendBufStart[i+1] - sendBufStart[i],
+                          &sendBuf[i], &sendBufLen[i]);
         }
 
 /*
  *      Allocate arrays for handling incoming migrated nodes
  */
         if (numRecvBufs > 0) {
-            recvBuf = (char **)calloc(1, numRecvBufs * sizeof(real8 *));
+            recvBuf = (char **)calloc(1, numRecvBufs * sizeof(char *));
             recvBufLen = (int *)calloc(1, numRecvBufs * sizeof(int));
             recvRequest = (MPI_Request *)malloc(numRecvBufs *
                                                 sizeof(MPI_Request));
@@ -515,8 +586,7 @@ static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
  */
         for (i = 0; i < numRecvBufs; i++) {
             recvBuf[i] = (char *)malloc(recvBufLen[i]);
-            numValues = recvBufLen[i] / sizeof(real8);
-            MPI_Irecv(recvBuf[i], numValues, MPI_DOUBLE,
+            MPI_Irecv(recvBuf[i], recvBufLen[i], MPI_BYTE,
                       recvStatus[i].MPI_SOURCE, MSG_MIG_NODES,
                       MPI_COMM_WORLD, &recvRequest[i]);
         }
@@ -526,8 +596,7 @@ static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
  *      domains.
  */
         for (i = 0; i < numSendBufs; i++) {
-            numValues = sendBufLen[i] / sizeof(real8);
-            MPI_Isend(sendBuf[i], numValues, MPI_DOUBLE, sendBufDest[i],
+            MPI_Isend(sendBuf[i], sendBufLen[i], MPI_BYTE, sendBufDest[i],
                       MSG_MIG_NODES, MPI_COMM_WORLD, &sendRequest[i]);
         }
 
@@ -538,7 +607,7 @@ static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
         for (i = 0; i < numRecvBufs; i++) {
             MPI_Waitany(numRecvBufs, recvRequest, &recvIndex,
                         &recvStatus[0]);
-            UnpackMigrators(home, (real8 *)recvBuf[recvIndex],
+            UnpackMigrators(home, recvBuf[recvIndex],
                             recvStatus[0].MPI_SOURCE);
             free(recvBuf[recvIndex]);
         }
@@ -568,7 +637,7 @@ static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
             free(recvStatus);
         }
 
-        return;
+        return(globalMigCount);
 }
 #endif  /* ifdef PARALLEL */
 
@@ -584,9 +653,11 @@ static void CommSendMigrators(Home_t *home, int *migCommList, int **migList,
  *-------------------------------------------------------------------------*/
 void Migrate(Home_t *home)
 {
-        int    i, numDomains, numSendBufs;
-        int    *migCommList, **migList, *migListCnt;
-        int    *sendBufDest;
+#ifdef PARALLEL
+        int    numDomains, numSendBufs, globalMigCount;
+        int    *migCommList, *migList;
+        int    *sendBufDest, *sendBufStart;
+#endif
 
         TimerStart(home, MIGRATION);
 
@@ -599,11 +670,10 @@ void Migrate(Home_t *home)
 
         numSendBufs = 0;
         sendBufDest = (int *)NULL;
+        sendBufStart = (int *)NULL;
+        migList = (int *)NULL;
 
         migCommList = (int *)calloc(1, numDomains * sizeof(int));
-        migList = (int **)calloc(1, numDomains * sizeof(int *));
-
-        migListCnt = (int *)calloc(1, numDomains * sizeof(int));
 
 /*
  *      Look through all local nodes and determine which nodes need
@@ -612,25 +682,17 @@ void Migrate(Home_t *home)
  *      will migrate one or more nodes, build a list of the nodes
  *      to be sent to that domain.
  */
-        BuildMigLists(home, migCommList, migList, migListCnt,
-                      &sendBufDest, &numSendBufs);
-
-#if 0
-        for (i = 0; i < numDomains; i++) {
-            if (migListCnt[i]) {
-                printf("Task %d migrate %d nodes to %d\n", home->myDomain,
-                       migListCnt[i], i);
-            }
-        }
-#endif
+        BuildMigLists(home, migCommList, &migList, &sendBufDest,
+                      &sendBufStart, &numSendBufs);
 
 /*
  *      Send out all nodes (if any) that need to be migrated
  *      to remote domains and receive any nodes migrating from
  *      other domains.
  */
-        CommSendMigrators(home, migCommList, migList, migListCnt,
-                          sendBufDest, numSendBufs);
+        globalMigCount = CommSendMigrators(home, migCommList, migList,
+                                           sendBufDest, sendBufStart,
+                                           numSendBufs);
 
 /*
  *      All migrated nodes have been retagged.  Each domain now needs
@@ -638,20 +700,21 @@ void Migrate(Home_t *home)
  *      the old and new tags for all nodes it received during the
  *      migration.  Once that is done, the local domains go through
  *      all their own nodes reconciling the node tag changes.
+ *
+ *      Every domain has the same global count of migrations, so if
+ *      no node migrated anywhere, all domains skip the exchange.
  */
-        DistributeTagMaps(home);
+        if (globalMigCount > 0) {
+            DistributeTagMaps(home);
+        }
 
 /*
  *      Free up all temporary arrays before returning to the caller.
  */
-        for (i = 0; i < numSendBufs; i++) {
-            free(migList[sendBufDest[i]]);
-        }
-
         free(migList);
-        free(migListCnt);
         free(migCommList);
         free(sendBufDest);
+        free(sendBufStart);
 #endif  /* ifdef PARALLEL */
 
         TimerStop(home, MIGRATION);
@@ -0,0 +1,195 @@
+/***************************************************************************
+ *
+ *      Module:       MobilityCache.c
+ *      Description:  Contains functions for maintaining the per-arm
+ *                    cache of values a mobility law computes for a
+ *                    single segment (such as the segment's contribution
+ *                    to the drag matrix).
+ *
+ *                    An entry holds the segment vector and burgers
+ *                    vector it was computed for, and is only used if
+ *                    both match the arm exactly, so a cached value is
+ *                    always the value the mobility law would compute.
+ *                    The laws that use the cache compute values that
+ *                    are unchanged when both vectors are negated, so
+ *                    the entry of either endpoint of a segment can
+ *                    serve the other endpoint.
+ *
+ *                    Before the mobility of a list of nodes is
+ *                    evaluated, MobilityCacheFill() brings the entries
+ *                    up to date, computing each segment once.  The
+ *                    mobility functions then only read the cache via
+ *                    MobilityCacheLookup(), so they can be run on any
+ *                    number of nodes at once.
+ *
+ *      Includes:
+ *              MobilityCacheFill()
+ *              MobilityCacheLookup()
+ *              KeyMatches()  static
+ *
+ ***************************************************************************/
+#include "Home.h"
+#include "Mobility.h"
+#include "Util.h"
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     KeyMatches
+ *      Description:  Check whether a cache entry was computed for the
+ *                    given segment and burgers vectors, or (if <sign>
+ *                    is -1.0) for the reversed segment.
+ *
+ *------------------------------------------------------------------------*/
+static int KeyMatches(real8 *entry, real8 seg[3], real8 burg[3], real8 sign)
+{
+        return((entry[0] == sign * seg[0])  &&
+               (entry[1] == sign * seg[1])  &&
+               (entry[2] == sign * seg[2])  &&
+               (entry[3] == sign * burg[0]) &&
+               (entry[4] == sign * burg[1]) &&
+               (entry[5] == sign * burg[2]));
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     MobilityCacheFill
+ *      Description:  Update the mobility cache entries for the arms of
+ *                    the nodes in the list, calling <segFunc> only for
+ *                    entries whose segment or burgers vector changed.
+ *
+ *                    A segment between two native nodes is filled in
+ *                    by the endpoint with the lower tag only; the other
+ *                    endpoint finds the values through
+ *                    MobilityCacheLookup().  Each thread only writes
+ *                    the entries of the nodes it is handed, and nothing
+ *                    reads the cache until all threads are done.
+ *
+ *      Arguments:
+ *          nodeList   array of pointers to the nodes to be updated
+ *          numNodes   number of nodes in <nodeList>
+ *          segFunc    mobility law function computing the cached
+ *                     values for a single segment
+ *
+ *------------------------------------------------------------------------*/
+void MobilityCacheFill(Home_t *home, Node_t **nodeList, int numNodes,
+                       MobSegFunc_t segFunc)
+{
+        int     i;
+        Param_t *param;
+
+        param = home->param;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+        for (i = 0; i < numNodes; i++) {
+            int    arm;
+            real8  seg[3], burg[3];
+            real8  *entry;
+            Node_t *node, *nbr;
+
+            node = nodeList[i];
+
+            if (node->mobCache == (real8 *)NULL) {
+                continue;
+            }
+
+            for (arm = 0; arm < node->numNbrs; arm++) {
+
+                nbr = GetNeighborNode(home, node, arm);
+
+                if (nbr == (Node_t *)NULL) {
+                    continue;
+                }
+
+                if ((nbr->myTag.domainID == home->myDomain) &&
+                    (OrderNodes(nbr, node) < 0)) {
+                    continue;
+                }
+
+                seg[X] = nbr->x - node->x;
+                seg[Y] = nbr->y - node->y;
+                seg[Z] = nbr->z - node->z;
+
+                ZImage(param, &seg[X], &seg[Y], &seg[Z]);
+
+                burg[X] = node->burgX[arm];
+                burg[Y] = node->burgY[arm];
+                burg[Z] = node->burgZ[arm];
+
+                entry = &node->mobCache[arm * MOB_CACHE_SIZE];
+
+                if (KeyMatches(entry, seg, burg, 1.0)) {
+                    continue;
+                }
+
+                entry[0] = seg[X];
+                entry[1] = seg[Y];
+                entry[2] = seg[Z];
+                entry[3] = burg[X];
+                entry[4] = burg[Y];
+                entry[5] = burg[Z];
+
+                segFunc(home, seg, burg, &entry[MOB_CACHE_KEY_SIZE]);
+            }
+        }
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     MobilityCacheLookup
+ *      Description:  Find the cached values for the specified arm of
+ *                    a node.  The node's own entry for the arm is
+ *                    checked first, then the neighbor's entry for the
+ *                    same segment if the neighbor is a native node.
+ *
+ *      Arguments:
+ *          node  pointer to the node
+ *          arm   index of the segment in the node's arm list
+ *          seg   segment vector (neighbor position minus node
+ *                position, after ZImage())
+ *          burg  burgers vector of the arm
+ *
+ *      Returns:  pointer to the cached values or NULL if neither entry
+ *                was computed for this segment.
+ *
+ *------------------------------------------------------------------------*/
+real8 *MobilityCacheLookup(Home_t *home, Node_t *node, int arm,
+                           real8 seg[3], real8 burg[3])
+{
+        int    nbrArm;
+        real8  *entry;
+        Node_t *nbr;
+
+        if (node->mobCache != (real8 *)NULL) {
+            entry = &node->mobCache[arm * MOB_CACHE_SIZE];
+            if (KeyMatches(entry, seg, burg, 1.0)) {
+                return(&entry[MOB_CACHE_KEY_SIZE]);
+            }
+        }
+
+        nbr = GetNeighborNode(home, node, arm);
+
+        if ((nbr == (Node_t *)NULL) ||
+            (nbr->myTag.domainID != home->myDomain) ||
+            (nbr->mobCache == (real8 *)NULL)) {
+            return((real8 *)NULL);
+        }
+
+        if ((nbrArm = GetArmID(home, nbr, node)) < 0) {
+            return((real8 *)NULL);
+        }
+
+        entry = &nbr->mobCache[nbrArm * MOB_CACHE_SIZE];
+
+        if (KeyMatches(entry, seg, burg, -1.0)) {
+            return(&entry[MOB_CACHE_KEY_SIZE]);
+        }
+
+        return((real8 *)NULL);
+}
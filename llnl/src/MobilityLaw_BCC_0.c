@@ -7,6 +7,8 @@
  *      Includes functions:
  *
  *            Mobility_BCC_0()
+ *            MobilityCache_BCC_0()
+ *            SegDrag_BCC_0()  static
  *                
  ***************************************************************************/
 #include "Home.h"
@@ -26,22 +28,38 @@
 #define MIN(a,b)  ((a)<(b)?(a):(b))
 
 
+/*
+ *      Number of values cached per segment (see MobilityCache.c): the
+ *      upper triangle (xx, xy, xz, yy, yz, zz) of the segment's screw
+ *      (or [0 0 1]) drag terms, the same for the non-screw correction,
+ *      and the segment length.  The two sets of drag terms are kept
+ *      apart so they are added to the drag matrix in the same order
+ *      whether or not they come from the cache.
+ */
+#define BCC_0_SEG_VALUES 13
+
+
 /**************************************************************************
  *
- *      Function:     Mobility_BCC_0
- *      Description:  This function calculates the velocity for a single
- *                    specified node.
+ *      Function:     SegDrag_BCC_0
+ *      Description:  Calculate the contribution of a single segment to
+ *                    the drag matrix of its endpoints.  The values
+ *                    are the same for the reversed segment (<seg> and
+ *                    <burg> both negated).
  *
- *      Returns:  0 on success
- *                1 if velocity could not be determined
+ *      Arguments:
+ *          seg     segment vector (neighbor position minus node
+ *                  position, after ZImage())
+ *          burg    burgers vector of the segment
+ *          values  array in which to return the BCC_0_SEG_VALUES
+ *                  values described above.  The correction terms are
+ *                  zero if no correction applies.
  *
  *************************************************************************/
-int  Mobility_BCC_0(Home_t *home, Node_t *node)
+static void SegDrag_BCC_0(Home_t *home, real8 seg[3], real8 burg[3],
+                          real8 *values)
 {
-        int     i, j, nbrs;
-        int     numNonZeroLenSegs = 0;
-        real8   tmp, tmp3[3], vOld[3], totLength;
-        real8   massMult, massMatrix[3][3];
+        int     i;
         real8   bx, by, bz;
         real8   dx, dy, dz;
         real8   mx, my, mz;
@@ -53,8 +71,211 @@ int  Mobility_BCC_0(Home_t *home, Node_t *node)
         real8   invBscrew2, invBedge2;
         real8   BlmBsc, BclmBsc, BglmBsc, BlmBecl;
         real8   eps = 1.0e-12;
-        real8   nForce[3], nVel[3];
         real8   burgCryst[3];
+        real8   *Bscr, *Bcorr;
+        Param_t *param;
+
+        param = home->param;
+
+        Bscrew     = 1.0 / param->MobScrew;
+        Bedge      = 1.0 / param->MobEdge;
+        Beclimb    = 1.0 / param->MobClimb;
+
+        Bscrew2    = Bscrew * Bscrew;
+        Beclimb2   = Beclimb * Beclimb;
+
+        Bline      = 1.0e-2 * MIN(Bscrew, Bedge);
+        BlmBsc     = Bline - Bscrew;
+        BlmBecl    = Bline - Beclimb;
+
+        invBscrew2 = 1.0 / (Bscrew*Bscrew);
+        invBedge2  = 1.0 / (Bedge*Bedge);
+
+        Bscr  = &values[0];
+        Bcorr = &values[6];
+
+        for (i = 0; i < BCC_0_SEG_VALUES; i++) {
+            values[i] = 0.0;
+        }
+
+        bx = burg[X];
+        by = burg[Y];
+        bz = burg[Z];
+
+        bMag2 = (bx*bx + by*by + bz*bz);
+        invbMag2 = 1.0 / bMag2;
+
+        dx = seg[X];
+        dy = seg[Y];
+        dz = seg[Z];
+
+        mag2    = dx*dx + dy*dy + dz*dz;
+
+/*
+ *      Zero length segments are skipped by the mobility function.
+ */
+        if (mag2 < eps) {
+            return;
+        }
+
+        mag     = sqrt(mag2);
+        halfMag = 0.5 * mag;
+        invMag  = 1.0 / mag;
+
+        dx *= invMag;
+        dy *= invMag;
+        dz *= invMag;
+
+/*
+ *      Calculate how close to screw the arm is
+ */
+        costheta = (dx*bx + dy*by + dz*bz);
+        costheta2 = (costheta*costheta) * invbMag2;
+
+/*
+ *      [0 0 1] arms don't move as readily as other arms, so must be
+ *      handled specially.
+ *
+ *      If needed, rotate a copy of the burgers vector from the
+ *      laboratory frame to the crystal frame.
+ */
+        if (param->useLabFrame) {
+            real8 bTmp[3] = {bx, by, bz};
+            Matrix33Vector3Multiply(home->rotMatrixInverse,bTmp,burgCryst);
+        } else {
+            burgCryst[X] = bx;
+            burgCryst[Y] = by;
+            burgCryst[Z] = bz;
+        }
+
+        if (fabs(burgCryst[X]*burgCryst[Y]*burgCryst[Z]) < eps) {
+            Bscr[0] = halfMag * (dx*dx * BlmBecl + Beclimb);
+            Bscr[1] = halfMag * (dx*dy * BlmBecl);
+            Bscr[2] = halfMag * (dx*dz * BlmBecl);
+            Bscr[3] = halfMag * (dy*dy * BlmBecl + Beclimb);
+            Bscr[4] = halfMag * (dy*dz * BlmBecl);
+            Bscr[5] = halfMag * (dz*dz * BlmBecl + Beclimb);
+        } else  {
+/*
+ *          Arm is not [0 0 1], so build the drag matrix assuming the
+ *          dislocation is screw type
+ */
+            Bscr[0] = halfMag * (dx*dx * BlmBsc + Bscrew);
+            Bscr[1] = halfMag * (dx*dy * BlmBsc);
+            Bscr[2] = halfMag * (dx*dz * BlmBsc);
+            Bscr[3] = halfMag * (dy*dy * BlmBsc + Bscrew);
+            Bscr[4] = halfMag * (dy*dz * BlmBsc);
+            Bscr[5] = halfMag * (dz*dz * BlmBsc + Bscrew);
+
+/*
+ *          Now correct the drag matrix for dislocations that are
+ *          not screw
+ */
+            if ((1.0 - costheta2) > eps) {
+
+                invsqrt1mcostheta2 = 1.0 / sqrt((1.0 - costheta2) * bMag2);
+#ifdef NAN_CHECK
+                if (isnan(invsqrt1mcostheta2) != 0) {
+                    Fatal("Mobility_BCC_0: invsqrt1mcostheta2 = "
+                          "NaN\n  invsqrt1mcostheta2 = 1.0 / "
+                          "sqrt((1.0 - costheta2) * bMag2)\n  where"
+                          "costheta2 = %lf and bMag2 = %lf", costheta2,
+                          bMag2);
+                }
+#endif
+
+                xvector(bx, by, bz, dx, dy, dz, &nx, &ny, &nz);
+                nx *= invsqrt1mcostheta2;
+                ny *= invsqrt1mcostheta2;
+                nz *= invsqrt1mcostheta2;
+
+                xvector(nx, ny, nz, dx, dy, dz, &mx, &my, &mz);
+
+
+                Bglide = sqrt(invBedge2+(invBscrew2-invBedge2)*costheta2);
+                Bglide = 1.0 / Bglide;
+                Bclimb = sqrt(Beclimb2 + (Bscrew2 - Beclimb2) * costheta2);
+
+#ifdef NAN_CHECK
+                if (isnan(Bglide) != 0) {
+                    Fatal("Mobility_BCC_0: Bglide = NaN\n"
+                          "  Bglide = sqrt(invBedge2 + "
+                          "(invBscrew2-invBedge2)*costheta2)\n"
+                          "  where invBedge2 = %lf, invBscrew2 = %lf, "
+                          "costheta2 = %lf", invBedge2, invBscrew2,
+                          costheta2);
+                }
+
+                if (isnan(Bclimb) != 0) {
+                    Fatal("Mobility_BCC_0: Bclimb = NaN\n"
+                          "  Bclimb = sqrt(Beclimb2 + "
+                          "(Bscrew2-Beclimb2)*costheta2)\n"
+                          "  where Beclimb2 = %lf, Bscrew2 = %lf, "
+                          "costheta2 = %lf", Beclimb2, Bscrew2,
+                          costheta2);
+                }
+#endif
+                BclmBsc = Bclimb - Bscrew;
+                BglmBsc = Bglide - Bscrew;
+
+
+                Bcorr[0] = halfMag * (nx*nx * BclmBsc +
+                                      mx*mx * BglmBsc);
+                Bcorr[1] = halfMag * (nx*ny * BclmBsc +
+                                      mx*my * BglmBsc);
+                Bcorr[2] = halfMag * (nx*nz * BclmBsc +
+                                      mx*mz * BglmBsc);
+                Bcorr[3] = halfMag * (ny*ny * BclmBsc +
+                                      my*my * BglmBsc);
+                Bcorr[4] = halfMag * (ny*nz * BclmBsc +
+                                      my*mz * BglmBsc);
+                Bcorr[5] = halfMag * (nz*nz * BclmBsc +
+                                      mz*mz * BglmBsc);
+            }
+        }  /* End non-[0 0 1] arm */
+
+        values[12] = mag;
+
+        return;
+}
+
+
+/**************************************************************************
+ *
+ *      Function:     MobilityCache_BCC_0
+ *      Description:  Bring the per-segment drag terms cached for the
+ *                    arms of the given nodes up to date before
+ *                    Mobility_BCC_0() is evaluated for them.
+ *
+ *************************************************************************/
+void MobilityCache_BCC_0(Home_t *home, Node_t **nodeList, int numNodes)
+{
+        MobilityCacheFill(home, nodeList, numNodes, SegDrag_BCC_0);
+
+        return;
+}
+
+
+/**************************************************************************
+ *
+ *      Function:     Mobility_BCC_0
+ *      Description:  This function calculates the velocity for a single
+ *                    specified node.
+ *
+ *      Returns:  0 on success
+ *                1 if velocity could not be determined
+ *
+ *************************************************************************/
+int  Mobility_BCC_0(Home_t *home, Node_t *node)
+{
+        int     i, j, nbrs;
+        int     numNonZeroLenSegs = 0;
+        real8   tmp, tmp3[3], vOld[3], totLength;
+        real8   massMult, massMatrix[3][3];
+        real8   seg[3], burg[3];
+        real8   segValues[BCC_0_SEG_VALUES], *Bseg;
+        real8   eps = 1.0e-12;
+        real8   nForce[3], nVel[3];
         real8   Btotal[3][3] = {{0.0, 0.0, 0.0},
                                 {0.0, 0.0, 0.0},
                                 {0.0, 0.0, 0.0}};
@@ -75,20 +296,6 @@ int  Mobility_BCC_0(Home_t *home, Node_t *node)
 
         param = home->param;
 
-        Bscrew     = 1.0 / param->MobScrew;
-        Bedge      = 1.0 / param->MobEdge;
-        Beclimb    = 1.0 / param->MobClimb;
-
-        Bscrew2    = Bscrew * Bscrew;
-        Beclimb2   = Beclimb * Beclimb;
-
-        Bline      = 1.0e-2 * MIN(Bscrew, Bedge);
-        BlmBsc     = Bline - Bscrew;
-        BlmBecl    = Bline - Beclimb;
-
-        invBscrew2 = 1.0 / (Bscrew*Bscrew);
-        invBedge2  = 1.0 / (Bedge*Bedge);
-
         nbrs = node->numNbrs;
 
 /*
@@ -123,15 +330,8 @@ int  Mobility_BCC_0(Home_t *home, Node_t *node)
 
 	for (i = 0; i < nbrs; i++) {  
 
-            bx = node->burgX[i];
-            by = node->burgY[i];
-            bz = node->burgZ[i];
-
-            bMag2 = (bx*bx + by*by + bz*bz);
-            invbMag2 = 1.0 / bMag2;
-
 /*
- *          Calculate the length of the arm and its tangent line direction
+ *          Calculate the segment vector of the arm
  */
             nbrNode = GetNeighborNode(home, node, i);
 
@@ -141,141 +341,53 @@ int  Mobility_BCC_0(Home_t *home, Node_t *node)
                 continue;
             }
 
-            dx = nbrNode->x - node->x;
-            dy = nbrNode->y - node->y;
-            dz = nbrNode->z - node->z;
+            seg[X] = nbrNode->x - node->x;
+            seg[Y] = nbrNode->y - node->y;
+            seg[Z] = nbrNode->z - node->z;
 
-            ZImage(param, &dx, &dy, &dz);
-
-            mag2    = dx*dx + dy*dy + dz*dz;
+            ZImage(param, &seg[X], &seg[Y], &seg[Z]);
 
 /*
  *          If the segment is zero length (which can happen when
  *          the mobility function is being called from SplitMultiNodes())
  *          just skip the segment.
  */
-            if (mag2 < eps) {
+            if ((seg[X]*seg[X] + seg[Y]*seg[Y] + seg[Z]*seg[Z]) < eps) {
                 continue;
             }
 
             numNonZeroLenSegs++;
 
-            mag     = sqrt(mag2);
-            halfMag = 0.5 * mag;
-            invMag  = 1.0 / mag;
-
-            dx *= invMag;
-            dy *= invMag;
-            dz *= invMag;
+            burg[X] = node->burgX[i];
+            burg[Y] = node->burgY[i];
+            burg[Z] = node->burgZ[i];
 
 /*
- *          Calculate how close to screw the arm is
+ *          The drag terms of a segment depend only on its segment and
+ *          burgers vectors, so use the cached terms if there are any.
  */
-            costheta = (dx*bx + dy*by + dz*bz);
-            costheta2 = (costheta*costheta) * invbMag2;
+            Bseg = MobilityCacheLookup(home, node, i, seg, burg);
 
-/*
- *          [0 0 1] arms don't move as readily as other arms, so must be
- *          handled specially.
- *
- *          If needed, rotate a copy of the burgers vector from the
- *          laboratory frame to the crystal frame.
- */
-            if (param->useLabFrame) {
-                real8 bTmp[3] = {bx, by, bz};
-                Matrix33Vector3Multiply(home->rotMatrixInverse,bTmp,burgCryst);
-            } else {
-                burgCryst[X] = bx;
-                burgCryst[Y] = by;
-                burgCryst[Z] = bz;
+            if (Bseg == (real8 *)NULL) {
+                SegDrag_BCC_0(home, seg, burg, segValues);
+                Bseg = segValues;
             }
 
-            if (fabs(burgCryst[X]*burgCryst[Y]*burgCryst[Z]) < eps) {
-                Btotal[0][0] += halfMag * (dx*dx * BlmBecl + Beclimb);
-                Btotal[0][1] += halfMag * (dx*dy * BlmBecl);
-                Btotal[0][2] += halfMag * (dx*dz * BlmBecl);
-                Btotal[1][1] += halfMag * (dy*dy * BlmBecl + Beclimb);
-                Btotal[1][2] += halfMag * (dy*dz * BlmBecl);
-                Btotal[2][2] += halfMag * (dz*dz * BlmBecl + Beclimb);
-            } else  {
-/*
- *              Arm is not [0 0 1], so build the drag matrix assuming the
- *              dislocation is screw type
- */
-                Btotal[0][0] += halfMag * (dx*dx * BlmBsc + Bscrew);
-                Btotal[0][1] += halfMag * (dx*dy * BlmBsc);
-                Btotal[0][2] += halfMag * (dx*dz * BlmBsc);
-                Btotal[1][1] += halfMag * (dy*dy * BlmBsc + Bscrew);
-                Btotal[1][2] += halfMag * (dy*dz * BlmBsc);
-                Btotal[2][2] += halfMag * (dz*dz * BlmBsc + Bscrew);
-
-/*
- *              Now correct the drag matrix for dislocations that are
- *              not screw
- */
-                if ((1.0 - costheta2) > eps) {
-
-                    invsqrt1mcostheta2 = 1.0 / sqrt((1.0 - costheta2) * bMag2);
-#ifdef NAN_CHECK
-                    if (isnan(invsqrt1mcostheta2) != 0) {
-                        Fatal("Mobility_BCC_0: invsqrt1mcostheta2 = "
-                              "NaN\n  invsqrt1mcostheta2 = 1.0 / "
-                              "sqrt((1.0 - costheta2) * bMag2)\n  where"
-                              "costheta2 = %lf and bMag2 = %lf", costheta2,
-                              bMag2);
-                    }
-#endif
-
-                    xvector(bx, by, bz, dx, dy, dz, &nx, &ny, &nz);
-                    nx *= invsqrt1mcostheta2;
-                    ny *= invsqrt1mcostheta2;
-                    nz *= invsqrt1mcostheta2;
-
-                    xvector(nx, ny, nz, dx, dy, dz, &mx, &my, &mz);
-
-
-                    Bglide = sqrt(invBedge2+(invBscrew2-invBedge2)*costheta2);
-                    Bglide = 1.0 / Bglide;
-                    Bclimb = sqrt(Beclimb2 + (Bscrew2 - Beclimb2) * costheta2);
-
-#ifdef NAN_CHECK
-                    if (isnan(Bglide) != 0) {
-                        Fatal("Mobility_BCC_0: Bglide = NaN\n"
-                              "  Bglide = sqrt(invBedge2 + "
-                              "(invBscrew2-invBedge2)*costheta2)\n"
-                              "  where invBedge2 = %lf, invBscrew2 = %lf, "
-                              "costheta2 = %lf", invBedge2, invBscrew2,
-                              costheta2);
-                    }
-
-                    if (isnan(Bclimb) != 0) {
-                        Fatal("Mobility_BCC_0: Bclimb = NaN\n"
-                              "  Bclimb = sqrt(Beclimb2 + "
-                              "(Bscrew2-Beclimb2)*costheta2)\n"
-                              "  where Beclimb2 = %lf, Bscrew2 = %lf, "
-                              "costheta2 = %lf", Beclimb2, Bscrew2,
-                              costheta2);
-                    }
-#endif
-                    BclmBsc = Bclimb - Bscrew;
-                    BglmBsc = Bglide - Bscrew;
-
-
-                    Btotal[0][0] += halfMag * (nx*nx * BclmBsc +
-                                              mx*mx * BglmBsc);
-                    Btotal[0][1] += halfMag * (nx*ny * BclmBsc +
-                                              mx*my * BglmBsc);
-                    Btotal[0][2] += halfMag * (nx*nz * BclmBsc +
-                                              mx*mz * BglmBsc);
-                    Btotal[1][1] += halfMag * (ny*ny * BclmBsc +
-                                              my*my * BglmBsc);
-                    Btotal[1][2] += halfMag * (ny*nz * BclmBsc +
-                                              my*mz * BglmBsc);
-                    Btotal[2][2] += halfMag * (nz*nz * BclmBsc +
-                                              mz*mz * BglmBsc);
-                }
-            }  /* End non-[0 0 1] arm */
-            totLength += mag;
+            Btotal[0][0] += Bseg[0];
+            Btotal[0][1] += Bseg[1];
+            Btotal[0][2] += Bseg[2];
+            Btotal[1][1] += Bseg[3];
+            Btotal[1][2] += Bseg[4];
+            Btotal[2][2] += Bseg[5];
+
+            Btotal[0][0] += Bseg[6];
+            Btotal[0][1] += Bseg[7];
+            Btotal[0][2] += Bseg[8];
+            Btotal[1][1] += Bseg[9];
+            Btotal[1][2] += Bseg[10];
+            Btotal[2][2] += Bseg[11];
+
+            totLength += Bseg[12];
         }  /* End loop over arms */
 
         Btotal[1][0] = Btotal[0][1];
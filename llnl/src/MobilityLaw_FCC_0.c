@@ -26,6 +26,99 @@
 
 #define _ENABLE_LINE_CONSTRAINT 1
 
+/*
+ *  Number of values cached per segment (see MobilityCache.c): the
+ *  segment length, and the length divided by the segment's mobility.
+ */
+#define FCC_0_SEG_VALUES 2
+
+
+/*
+ *  SegDrag_FCC_0: calculate the length and the drag (length divided
+ *  by mobility) of a single segment from its segment vector (neighbor
+ *  position minus node position, after ZImage()) and burgers vector.
+ *  The values are the same for the reversed segment.
+ */
+static void SegDrag_FCC_0(Home_t *home, real8 seg[3], real8 burg[3],
+                          real8 *values)
+{
+    Param_t *param;
+    real8 dx, dy, dz, lx, ly, lz, lr;
+    real8 MobScrew, MobEdge, Mob;
+    real8 bx, by, bz, br, dangle;
+
+    param = home->param;
+
+    MobScrew = param->MobScrew;
+    MobEdge  = param->MobEdge;
+
+    dx = seg[X];
+    dy = seg[Y];
+    dz = seg[Z];
+
+/*
+ *  If needed, rotate the line sense from the laboratory frame to
+ *  the crystal frame.
+ */
+    if (param->useLabFrame) {
+        real8 dTmp[3] = {dx, dy, dz};
+        real8 dRot[3];
+
+        Matrix33Vector3Multiply(home->rotMatrixInverse, dTmp, dRot);
+
+        dx = dRot[0]; dy = dRot[1]; dz = dRot[2];
+    }
+
+    lr=sqrt(dx*dx+dy*dy+dz*dz);
+
+    values[0] = lr;
+    values[1] = 0.0;
+
+    if (lr == 0) return;
+
+    lx=dx/lr; ly=dy/lr; lz=dz/lr;
+
+    bx = burg[X];
+    by = burg[Y];
+    bz = burg[Z];
+/*
+ *  If needed, rotate the burgers vector from the laboratory frame to
+ *  the crystal frame.
+ */
+    if (param->useLabFrame) {
+        real8 bTmp[3] = {bx, by, bz};
+        real8 bRot[3];
+
+        Matrix33Vector3Multiply(home->rotMatrixInverse, bTmp, bRot);
+
+        bx = bRot[0]; by = bRot[1]; bz = bRot[2];
+    }
+
+    br = sqrt(bx*bx+by*by+bz*bz);
+    bx/=br; by/=br; bz/=br; /* unit vector along Burgers vector */
+
+    dangle = fabs(bx*lx+by*ly+bz*lz);
+    Mob=MobEdge+(MobScrew-MobEdge)*dangle;
+
+    values[1] = lr / Mob;
+
+    return;
+}
+
+
+/*
+ *  MobilityCache_FCC_0: bring the per-segment drag values cached for
+ *  the arms of the given nodes up to date before Mobility_FCC_0() is
+ *  evaluated for them.
+ */
+void MobilityCache_FCC_0(Home_t *home, Node_t **nodeList, int numNodes)
+{
+    MobilityCacheFill(home, nodeList, numNodes, SegDrag_FCC_0);
+
+    return;
+}
+
+
 int Mobility_FCC_0(Home_t *home, Node_t *node)
 {
     int numNonZeroLenSegs = 0;
@@ -35,18 +128,14 @@ int Mobility_FCC_0(Home_t *home, Node_t *node)
     real8 normX[100], normY[100], normZ[100], normx[100], normy[100], normz[100];
     real8 lineX[100], lineY[100], lineZ[100];
     real8 a, b;
-    real8 dx, dy, dz, lx, ly, lz, lr, LtimesB;
+    real8 dx, dy, dz, lr, LtimesB;
     real8 lcx, lcy, lcz, normdotlc;
     Node_t *nbr;
-    real8 MobScrew, MobEdge, Mob;
-    real8 bx, by, bz, br, dangle;
     real8 nForce[3];
+    real8 seg[3], burg[3], segValues[FCC_0_SEG_VALUES], *segDrag;
 
     param = home->param;
 
-    MobScrew = param->MobScrew;
-    MobEdge  = param->MobEdge;
-    
     nc = node->numNbrs;
     
 /*
@@ -166,37 +255,10 @@ int Mobility_FCC_0(Home_t *home, Node_t *node)
 
 
     /* Find independent glide constraints */ 
-    nconstraint = nc;
-    for(i=0;i<nc;i++)
-    {
-        for(j=0;j<i;j++)
-        {
-            Orthogonalize(normX+i,normY+i,normZ+i,normX[j],normY[j],normZ[j]);
-        }
-        if((normX[i]*normX[i]+normY[i]*normY[i]+normZ[i]*normZ[i])<FFACTOR_ORTH)
-        {
-            normX[i] = normY[i] = normZ[i] = 0;
-            nconstraint--;
-        }
-    }
+    nconstraint = FindIndependentConstraints(nc, normX, normY, normZ);
 
     /* Find independent line constraints */
-    nlc = 0;
-    for(i=0;i<nc;i++)
-    {
-        for(j=0;j<i;j++)
-        {
-            Orthogonalize(lineX+i,lineY+i,lineZ+i,lineX[j],lineY[j],lineZ[j]);
-        }
-        if((lineX[i]*lineX[i]+lineY[i]*lineY[i]+lineZ[i]*lineZ[i])<FFACTOR_ORTH)
-        {
-            lineX[i] = lineY[i] = lineZ[i] = 0;
-        }
-        else
-        {
-            nlc ++;
-        }
-    }
+    nlc = FindIndependentConstraints(nc, lineX, lineY, lineZ);
 
     /* find total dislocation length times drag coefficent (LtimesB)*/
     LtimesB=0;
@@ -209,19 +271,25 @@ int Mobility_FCC_0(Home_t *home, Node_t *node)
         ZImage (param, &dx, &dy, &dz) ;
 
 /*
- *      If needed, rotate the line sense from the laboratory frame to
- *      the crystal frame.
+ *      The drag of a segment depends only on its segment and burgers
+ *      vectors, so use the cached values if there are any.
  */
-        if (param->useLabFrame) {
-            real8 dTmp[3] = {dx, dy, dz};
-            real8 dRot[3];
+        seg[0] = dx;
+        seg[1] = dy;
+        seg[2] = dz;
 
-            Matrix33Vector3Multiply(home->rotMatrixInverse, dTmp, dRot);
+        burg[0] = node->burgX[j];
+        burg[1] = node->burgY[j];
+        burg[2] = node->burgZ[j];
 
-            dx = dRot[0]; dy = dRot[1]; dz = dRot[2];
+        segDrag = MobilityCacheLookup(home, node, j, seg, burg);
+
+        if (segDrag == (real8 *)NULL) {
+            SegDrag_FCC_0(home, seg, burg, segValues);
+            segDrag = segValues;
         }
 
-        lr=sqrt(dx*dx+dy*dy+dz*dz);
+        lr = segDrag[0];
         
         if (lr==0)
         { /* zero arm segment can happen after node split 
@@ -238,31 +306,7 @@ int Mobility_FCC_0(Home_t *home, Node_t *node)
                      node->myTag.domainID, node->myTag.index, lr);
            }
 
-           lx=dx/lr; ly=dy/lr; lz=dz/lr;
-
-           bx = node->burgX[j];
-           by = node->burgY[j];
-           bz = node->burgZ[j];
-/*
- *         If needed, rotate the burgers vector from the laboratory frame to
- *         the crystal frame.
- */
-           if (param->useLabFrame) {
-               real8 bTmp[3] = {bx, by, bz};
-               real8 bRot[3];
-
-               Matrix33Vector3Multiply(home->rotMatrixInverse, bTmp, bRot);
-
-               bx = bRot[0]; by = bRot[1]; bz = bRot[2];
-           }
-
-           br = sqrt(bx*bx+by*by+bz*bz);
-           bx/=br; by/=br; bz/=br; /* unit vector along Burgers vector */
-
-           dangle = fabs(bx*lx+by*ly+bz*lz);
-           Mob=MobEdge+(MobScrew-MobEdge)*dangle;
-
-           LtimesB+=(lr/Mob);
+           LtimesB+=segDrag[1];
 	}
     }
     LtimesB/=2;
@@ -288,14 +332,8 @@ int Mobility_FCC_0(Home_t *home, Node_t *node)
     
 
     /* Orthogonalize with glide plane constraints */
-    for(i=0;i<nc;i++)
-    {
-        if((normX[i]!=0)||(normY[i]!=0)||(normZ[i]!=0))
-        {
-	     Orthogonalize(&VelxNode,&VelyNode,&VelzNode,
-                         normX[i],normY[i],normZ[i]);
-        }
-    }
+    ApplyGlideConstraints(nc, normX, normY, normZ,
+                          &VelxNode, &VelyNode, &VelzNode);
 
 
     /* Any dislocation with glide plane not {111} type can only move along its length
@@ -44,7 +44,7 @@ int Mobility_Relax(Home_t *home, Node_t *node)
     int nbrs;
     real8 Mx, My, Mz;
     real8 VelxNode, VelyNode, VelzNode, Veldotlcr;
-    int i, j, cst, nc, nconstraint, nlc;
+    int i, cst, nc, nlc;
     real8 normX[100], normY[100], normZ[100], normx[100], normy[100], normz[100];
     real8 burgX, burgY, burgZ, a, b;
     real8 dx, dy, dz, lx, ly, lz, lr, LtimesB, Lx, Ly, Lz;
@@ -102,21 +102,8 @@ int Mobility_Relax(Home_t *home, Node_t *node)
         }
     }
 
-    /* Find independent glide constraints */ 
-    nconstraint = nc;
-    for(i=0;i<nc;i++)
-    {
-        for(j=0;j<i;j++)
-        {
-            Orthogonalize(normX+i,normY+i,normZ+i,normX[j],normY[j],normZ[j]);
-        }
-        #define FFACTOR_ORTH 0.05
-        if((normX[i]*normX[i]+normY[i]*normY[i]+normZ[i]*normZ[i])<FFACTOR_ORTH)
-        {
-            normX[i] = normY[i] = normZ[i] = 0;
-            nconstraint--;
-        }
-    }
+    /* Reduce the glide constraints to an independent set */ 
+    (void)FindIndependentConstraints(nc, normX, normY, normZ);
 
     /* Velocity is simply proportional to total force per unit length */
     VelxNode = Mx * node->fX;
@@ -124,14 +111,8 @@ int Mobility_Relax(Home_t *home, Node_t *node)
     VelzNode = Mz * node->fZ;
 
     /* Orthogonalize with glide plane constraints */
-    for(i=0;i<nc;i++)
-    {
-        if((normX[i]!=0)||(normY[i]!=0)||(normZ[i]!=0))
-        {
-	     Orthogonalize(&VelxNode,&VelyNode,&VelzNode,
-                         normX[i],normY[i],normZ[i]);
-        }
-    }
+    ApplyGlideConstraints(nc, normX, normY, normZ,
+                          &VelxNode, &VelyNode, &VelzNode);
 
 #ifdef debug_nodevelocity
 /*
@@ -35,7 +35,9 @@
 
 #include "Home.h"
 #include "Util.h"
+#include "Decomp.h"
 #include "Mobility.h"
+#include "RijmTable.h"
 
 #if defined _FEM | defined _FEMIMGSTRESS
 #include "FEM.h"
@@ -211,15 +213,16 @@ static void GetFieldPointStressRem(Home_t *home, real8 x, real8 y, real8 z,
                                    int cellX, int cellY, int cellZ,
                                    real8 totStress[3][3])
 {
-        int     i, j, includePrimary;
-        int     cx, cy, cz, cellIndex;
+        int     i, j, n, includePrimary;
+        int     cx, cy, cz, czStart, cellIndex, numInBatch;
+        int     pbc[RIJM_BATCH_SIZE];
         int     xSkip1, xSkip2, xSkip3;
         int     ySkip1, ySkip2, ySkip3;
         int     zSkip1, zSkip2, zSkip3;
         real8   dx, dy, dz;
-        real8   xc, yc, zc;
         real8   burgX, burgY, burgZ;
         real8   delSig[3][3];
+        real8   rt[RIJM_BATCH_SIZE][3], Rijm[RIJM_BATCH_SIZE][10];
         Param_t *param;
 
         param = home->param;
@@ -325,99 +328,97 @@ static void GetFieldPointStressRem(Home_t *home, real8 x, real8 y, real8 z,
 
 /*
  *      Loop through all cells, and add the stress contribution from
- *      the cell to stress at the segment midpoint.
+ *      the cell to stress at the segment midpoint.  The Rijm values
+ *      depend only on the relative position of the cell and the field
+ *      point, so they are looked up once per cell (in batches) and
+ *      reused for each of the three components of the cell charge.
  */
         for (cx = 0; cx < param->nXcells; cx++) {
           for (cy = 0; cy < param->nYcells; cy++) {
-            for (cz = 0; cz < param->nZcells; cz++) {
+            for (czStart = 0; czStart < param->nZcells;
+                 czStart += RIJM_BATCH_SIZE) {
 
-                includePrimary = !(
-                    (cx==xSkip1 || cx==xSkip2 || cx==xSkip3) &&
-                    (cy==ySkip1 || cy==ySkip2 || cy==ySkip3) &&
-                    (cz==zSkip1 || cz==zSkip2 || cz==zSkip3));
+                numInBatch = MIN(RIJM_BATCH_SIZE, param->nZcells - czStart);
 
-/*
- *              Get the center point of cell [cx, cy, cz]
- */
-                xc = cellCenterX[cx];
-                yc = cellCenterY[cy];
-                zc = cellCenterZ[cz];
+                for (n = 0; n < numInBatch; n++) {
+
+                    cz = czStart + n;
+
+                    includePrimary = !(
+                        (cx==xSkip1 || cx==xSkip2 || cx==xSkip3) &&
+                        (cy==ySkip1 || cy==ySkip2 || cy==ySkip3) &&
+                        (cz==zSkip1 || cz==zSkip2 || cz==zSkip3));
 
 /*
- *              Get the stress at the specified point caused
- *              by the net charge tensor of the current cell.
+ *                  Get the center point of cell [cx, cy, cz] and its
+ *                  position relative to the field point.
  */
-                dx = xc - x;
-                dy = yc - y;
-                dz = zc - z;
+                    dx = cellCenterX[cx] - x;
+                    dy = cellCenterY[cy] - y;
+                    dz = cellCenterZ[cz] - z;
 
-                ZImage(param, &dx, &dy, &dz);
+                    ZImage(param, &dx, &dy, &dz);
 
-                xc = x + dx;
-                yc = y + dy;
-                zc = z + dz;
+                    rt[n][0] = -dx;
+                    rt[n][1] = -dy;
+                    rt[n][2] = -dz;
 
-                cellIndex = cz + param->nZcells*cy + 
-                            param->nZcells*param->nYcells*cx;
+                    pbc[n] = includePrimary;
+                }
 
-/*
- *              Stress (charge[.,1], [1,0,0])
- */
-                burgX = home->cellCharge[9*cellIndex];
-                burgY = home->cellCharge[9*cellIndex+3];
-                burgZ = home->cellCharge[9*cellIndex+6];
+                InterpolateRijmBatch(home, numInBatch, rt, Rijm, pbc);
 
-                dx = 1;
-                dy = 0;
-                dz = 0;
+                for (n = 0; n < numInBatch; n++) {
 
-                dSegImgStress(home, delSig, xc, yc, zc, dx, dy, dz, 
-                            burgX, burgY, burgZ, x, y, z,
-                            includePrimary);
+                    cz = czStart + n;
 
-                for (i = 0; i < 3; i++) 
-                    for (j = 0; j < 3; j++)
-                        totStress[i][j] += delSig[i][j];
+                    cellIndex = cz + param->nZcells*cy + 
+                                param->nZcells*param->nYcells*cx;
 
 /*
- *              Stress (charge[.,2], [0,1,0])
+ *                  Stress (charge[.,1], [1,0,0])
  */
-                burgX = home->cellCharge[9*cellIndex+1];
-                burgY = home->cellCharge[9*cellIndex+4];
-                burgZ = home->cellCharge[9*cellIndex+7];
-
-                dx = 0;
-                dy = 1;
-                dz = 0;
+                    burgX = home->cellCharge[9*cellIndex];
+                    burgY = home->cellCharge[9*cellIndex+3];
+                    burgZ = home->cellCharge[9*cellIndex+6];
 
-                dSegImgStress(home, delSig, xc, yc, zc, dx, dy, dz, 
-                            burgX, burgY, burgZ, x, y, z,
-                            includePrimary);
+                    dSegImgStressRijm(home, delSig, Rijm[n], 1.0, 0.0, 0.0,
+                                      burgX, burgY, burgZ);
 
-                for (i = 0; i < 3; i++) 
-                    for (j = 0; j < 3; j++)
-                        totStress[i][j] += delSig[i][j];
+                    for (i = 0; i < 3; i++) 
+                        for (j = 0; j < 3; j++)
+                            totStress[i][j] += delSig[i][j];
 
 /*
- *              Stress (charge[.,3], [0,0,1])
+ *                  Stress (charge[.,2], [0,1,0])
  */
-                burgX = home->cellCharge[9*cellIndex+2];
-                burgY = home->cellCharge[9*cellIndex+5];
-                burgZ = home->cellCharge[9*cellIndex+8];
+                    burgX = home->cellCharge[9*cellIndex+1];
+                    burgY = home->cellCharge[9*cellIndex+4];
+                    burgZ = home->cellCharge[9*cellIndex+7];
 
-                dx = 0;
-                dy = 0;
-                dz = 1;
+                    dSegImgStressRijm(home, delSig, Rijm[n], 0.0, 1.0, 0.0,
+                                      burgX, burgY, burgZ);
 
-                dSegImgStress(home, delSig, xc, yc, zc, dx, dy, dz, 
-                            burgX, burgY, burgZ, x, y, z,
-                            includePrimary);
+                    for (i = 0; i < 3; i++) 
+                        for (j = 0; j < 3; j++)
+                            totStress[i][j] += delSig[i][j];
 
-                for (i = 0; i < 3; i++) 
-                    for (j = 0; j < 3; j++)
-                        totStress[i][j] += delSig[i][j];
+/*
+ *                  Stress (charge[.,3], [0,0,1])
+ */
+                    burgX = home->cellCharge[9*cellIndex+2];
+                    burgY = home->cellCharge[9*cellIndex+5];
+                    burgZ = home->cellCharge[9*cellIndex+8];
+
+                    dSegImgStressRijm(home, delSig, Rijm[n], 0.0, 0.0, 1.0,
+                                      burgX, burgY, burgZ);
+
+                    for (i = 0; i < 3; i++) 
+                        for (j = 0; j < 3; j++)
+                            totStress[i][j] += delSig[i][j];
+                }
 
-            } /* end for(cz = 0; ...) */
+            } /* end for(czStart = 0; ...) */
           } /* end for(cy = 0; ...) */
         } /* end for(cx = 0; ...) */
 
@@ -718,6 +719,8 @@ void NodeForce(Home_t *home, int reqType)
                         if ((nbr->myTag.domainID == home->myDomain) &&
                             (OrderNodes(node, nbr) >= 0)) continue;
                         home->cycleForceCalcCount++;
+                        AddCellCost(home, node->x, node->y, node->z,
+                                    DLB_COST_NATIVESEG);
                     }
                 }
             }
@@ -119,120 +119,209 @@ void GetVelocityStatistics(Home_t *home)
 }
 
 
+/*
+ *      Nodes are grouped by arm count before the mobility is evaluated.
+ *      Nodes with more than MAX_BATCH_ARMS arms all go in the last group.
+ */
+#define MAX_BATCH_ARMS 8
+
+
 /*-------------------------------------------------------------------------
  *
- *      Function:    CalcNodeVelocities
- *      Description: Driver function that will invoke the appropriate
- *                   mobility function to update the velocity of every
- *                   native node, then apply the velocity cutoff if
- *                   applicable.
+ *      Function:    EvalMobilityBatch
+ *      Description: Invoke the mobility function for each node in
+ *                   the list.  The mobility functions only use local
+ *                   scratch space and update nothing but the velocity
+ *                   of the node they are given, so the nodes are
+ *                   distributed among the threads.  Callers should
+ *                   group nodes with the same number of arms together
+ *                   so that consecutive iterations follow the same
+ *                   path through the mobility function and have
+ *                   similar cost.
+ *
+ *                   The NODE_RESET_FORCES flag of each node is cleared.
  *
  *      Arguments:
+ *          nodeList   array of pointers to the nodes to be updated
+ *          numNodes   number of nodes in <nodeList>
  *          zeroOnErr  Flag indicating if nodal velocity should be
  *                     zeroed for any node for which the mobility
  *                     function was unable to calculate a velocity.
- *          doAll      Flag indicating if ALL nodes are to have
- *                     veolcity recalculated, or just those nodes
- *                     that have had their forces updated.
  *
  *      Returns:  0 if velocity was successfully calculated for all
  *                  nodes
- *                1 if the mobility functions were unable to converge
+ *                1 if the mobility function was unable to converge
  *                  on a velocity for one or more nodes.
  *
  *------------------------------------------------------------------------*/
-int CalcNodeVelocities(Home_t *home, int zeroOnErr, int doAll)
+int EvalMobilityBatch(Home_t *home, Node_t **nodeList, int numNodes,
+                      int zeroOnErr)
 {
-        int     domainMobError;
+        int     i, nodeMobError, mobError;
         Node_t  *node;
         Param_t *param;
 
-        TimerStart(home, CALC_VELOCITY);
-
         param = home->param;
-        domainMobError = 0;
+        mobError = 0;
 
+/*
+ *      If the mobility law caches its per-segment values, bring the
+ *      cache entries of these nodes up to date first.  The mobility
+ *      function then only reads the cache, so the nodes can still be
+ *      evaluated in any order by any thread.
+ */
+        if (param->mobilityCacheFunc != NULL) {
+            param->mobilityCacheFunc(home, nodeList, numNodes);
+        }
 
-//#pragma omp parallel reduction(+ : domainMobError) shared(doAll, zeroOnErr)
-        {
-            int    i, threadMobError = 0, nodeMobError;
-            int    threadID, threadIterStart, threadIterEnd;
-            Node_t *threadNode;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) private(node, nodeMobError) \
+                         reduction(|:mobError)
+#endif
+        for (i = 0; i < numNodes; i++) {
 
-            GetThreadIterationIndices(home->newNodeKeyPtr, &threadID,
-                                      &threadIterStart, &threadIterEnd);
+            node = nodeList[i];
 
+/*
+ *          If we encountered a mobility error on a previous node,
+ *          we'll probably be cutting the timestep, so don't
+ *          bother resetting the velocity of any subsequent nodes.
+ *          Each thread only knows of its own errors, which is
+ *          good enough for this purpose.
+ *
+ *          Note: continue the loop rather than breaking out, though,
+ *          because a 'break' from the loop would prevent the compiler
+ *          from threading the loop.
+ */
+            if (mobError != 0) {
+                continue;
+            }
 
-            for (i = threadIterStart; i < threadIterEnd; i++) {
 /*
- *              If we encountered a mobility error on a previous node,
- *              we'll probably be cutting the timestep, so don't
- *              bother restting the velocity of any subsequent nodes.
- *          
- *              Note: continue the loop rather than breaking out, though,
- *              because a 'break' from the loop would prevent the compiler
- *              from threading the loop.
+ *          We set a pointer to the appropriate mobility function
+ *          during initialization, so just invoke the function now.
  */
-                if (threadMobError != 0) {
-                    continue;
-                }
+            nodeMobError = param->mobilityFunc(home, node);
 
-                if ((threadNode = home->nodeKeys[i]) == (Node_t *)NULL) {
-                    continue;
-                }
+            mobError |= nodeMobError;
 
 /*
- *              If we do not need to recalculate velocity on ALL nodes,
- *              skip this node unless the forces have just been updated.
+ *          If we had problems calculating the mobility for
+ *          this node, do any special handling.
  */
-                if ((doAll == 0) &&
-                    ((threadNode->flags & NODE_RESET_FORCES) == 0)) {
-                    continue;
+            if (nodeMobError) {
+#ifdef DEBUG_TIMESTEP
+                printf("Mobility error on node (%d,%d)\n",
+                       node->myTag.domainID, node->myTag.index);
+                PrintNode(node);
+#endif
+                if (zeroOnErr) {
+                    node->vX = 0.0;
+                    node->vY = 0.0;
+                    node->vZ = 0.0;
                 }
+            }
 
 /*
- *              We set a pointer to the appropriate mobility function
- *              during initialization, so just invoke the function now.
- *              Need two error flags.  One to indicate if the current node
- *              had a mobility error, the other (which is returned to the
- *              caller) indicates if there were *any* nodes with mobility
- *              errors in the domain.
+ *          We also used the 'reset forces' flag to determine if we needed
+ *          to recalculate velocity, but now it can be reset.
  */
-//		printf("In Novelocity, Mobility is called  \n");
-		
-                nodeMobError = param->mobilityFunc(home, threadNode);
-//		printf("Novelocity is back \n");
+            node->flags &= ~NODE_RESET_FORCES;
+        }
+
+        return(mobError);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    CalcNodeVelocities
+ *      Description: Driver function that will invoke the appropriate
+ *                   mobility function to update the velocity of every
+ *                   native node, then apply the velocity cutoff if
+ *                   applicable.
+ *
+ *      Arguments:
+ *          zeroOnErr  Flag indicating if nodal velocity should be
+ *                     zeroed for any node for which the mobility
+ *                     function was unable to calculate a velocity.
+ *          doAll      Flag indicating if ALL nodes are to have
+ *                     veolcity recalculated, or just those nodes
+ *                     that have had their forces updated.
+ *
+ *      Returns:  0 if velocity was successfully calculated for all
+ *                  nodes
+ *                1 if the mobility functions were unable to converge
+ *                  on a velocity for one or more nodes.
+ *
+ *------------------------------------------------------------------------*/
+int CalcNodeVelocities(Home_t *home, int zeroOnErr, int doAll)
+{
+        int     i, group, numNodes, domainMobError;
+        int     groupStart[MAX_BATCH_ARMS+2];
+        Node_t  *node;
+        Node_t  **nodeList;
+
+        TimerStart(home, CALC_VELOCITY);
 
-                threadMobError |= nodeMobError;
+        domainMobError = 0;
 
 /*
- *              If we had problems calculating the mobility for
- *              this node, do any special handling.
+ *      Build the list of nodes that need their velocity calculated,
+ *      sorted by arm count.  The groups are ordered from the most to
+ *      the fewest arms so the more expensive nodes are handed out to
+ *      the threads first.
  */
-                if (nodeMobError) {
-#ifdef DEBUG_TIMESTEP
-                    printf("Mobility error on node (%d,%d)\n",
-                           threadNode->myTag.domainID, threadNode->myTag.index);
-                    PrintNode(threadNode);
-#endif
-                    if (zeroOnErr) {
-                        threadNode->vX = 0.0;
-                        threadNode->vY = 0.0;
-                        threadNode->vZ = 0.0;
-                    }
-                }
+        for (group = 0; group < MAX_BATCH_ARMS+2; group++) {
+            groupStart[group] = 0;
+        }
+
+        for (i = 0; i < home->newNodeKeyPtr; i++) {
+
+            if ((node = home->nodeKeys[i]) == (Node_t *)NULL) {
+                continue;
+            }
 
 /*
- *              We also used the 'reset forces' flag to determine if we needed
- *              to recalculate velocity, but now it can be reset.
+ *          If we do not need to recalculate velocity on ALL nodes,
+ *          skip this node unless the forces have just been updated.
  */
-                threadNode->flags &= ~NODE_RESET_FORCES;
+            if ((doAll == 0) && ((node->flags & NODE_RESET_FORCES) == 0)) {
+                continue;
             }
 
-            domainMobError = domainMobError + threadMobError;
+            group = MAX_BATCH_ARMS - MIN(node->numNbrs, MAX_BATCH_ARMS);
+            groupStart[group+1]++;
+        }
+
+        for (group = 0; group < MAX_BATCH_ARMS+1; group++) {
+            groupStart[group+1] += groupStart[group];
+        }
+
+        numNodes = groupStart[MAX_BATCH_ARMS+1];
 
-        }  /* end omp parallel section */
+        if (numNodes > 0) {
 
+            nodeList = (Node_t **)malloc(numNodes * sizeof(Node_t *));
+
+            for (i = 0; i < home->newNodeKeyPtr; i++) {
+
+                if ((node = home->nodeKeys[i]) == (Node_t *)NULL) {
+                    continue;
+                }
+
+                if ((doAll == 0) && ((node->flags & NODE_RESET_FORCES) == 0)) {
+                    continue;
+                }
+
+                group = MAX_BATCH_ARMS - MIN(node->numNbrs, MAX_BATCH_ARMS);
+                nodeList[groupStart[group]++] = node;
+            }
+
+            domainMobError = EvalMobilityBatch(home, nodeList, numNodes,
+                                               zeroOnErr);
+            free(nodeList);
+        }
 
 /*
  *      We need to zero out the 'reset forces' flag for all 
@@ -151,6 +151,24 @@ void ReleaseMemory(Home_t *home)
             home->cellCharge = NULL;
         }
 
+/*
+ *      Free the per-cell cost arrays used for load-balancing
+ */
+        if (home->cellCost) {
+            free(home->cellCost);
+            home->cellCost = NULL;
+        }
+
+        if (home->cellLoad) {
+            free(home->cellLoad);
+            home->cellLoad = NULL;
+        }
+
+        if (home->cellLoadIndex) {
+            free(home->cellLoadIndex);
+            home->cellLoadIndex = NULL;
+        }
+
 /*
  *      Free all memory associated with the domain decomposition
  */
@@ -227,6 +245,16 @@ void ReleaseMemory(Home_t *home)
             home->burgData.burgFirstPlaneIndex = (int *)NULL;
         }
 
+        if (home->burgData.glideDirCrystal != (real8 (*)[3])NULL) {
+            free(home->burgData.glideDirCrystal);
+            home->burgData.glideDirCrystal = (real8 (*)[3])NULL;
+        }
+
+        if (home->burgData.glideDirLab != (real8 (*)[3])NULL) {
+            free(home->burgData.glideDirLab);
+            home->burgData.glideDirLab = (real8 (*)[3])NULL;
+        }
+
         free(home->param);
         home->param = NULL;
 
@@ -12,7 +12,9 @@
  *              GetInArgs()
  *              InitDefaultValues()
  *              PrintHelp()
+ *              RenumberNodes()
  *              Usage()
+ *              WriteInitialNodeData()
  *
  *      Usage:
  *
@@ -73,6 +75,16 @@
  *      '-nloops' and hence is invalid.  Most options take on default values
  *      if none are specified on the command line.  
  *      
+ *      Parallel generation:
+ *
+ *      When built with MPI (paradisgenp), every task creates a contiguous
+ *      block of the chains/loops/sources and writes the nodes to its own
+ *      segment of the nodal data file (<outfile>.<segment>).  Node tags
+ *      are the same as those created by the serial generator for the
+ *      same seed, and concatenating the segments in order yields the
+ *      same nodal data as the serial generator writes, so only
+ *      the numFileSegments value in the header differs.
+ *      
  ***************************************************************************/
 #include <stdio.h>
 #include <stdarg.h>
@@ -88,6 +100,10 @@
 #include "Restart.h"
 #include "Decomp.h"
 
+#ifdef PARALLEL
+#include "mpi.h"
+#endif
+
 
 /*
  *      Define and initialize an array of structures for mapping
@@ -653,104 +669,224 @@ static void GetInArgs(int argc, char *argv[], InArgs_t *inArgs)
 }
 
 
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       RenumberNodes
+ *      Description:    Convert the node tags of the locally generated
+ *                      nodes to the tags the same nodes would have
+ *                      been given had all nodes been generated by a
+ *                      single task.
+ *
+ *                      The local node array consists of one or more
+ *                      sections.  In the serial node numbering, section
+ *                      N from all tasks (in task order) precedes section
+ *                      N+1 from any task.
+ *
+ *      Arguments:
+ *          numSections     number of sections in the node array
+ *          sectionLen      number of nodes in each section
+ *          totalNodeCount  location in which to return the number
+ *                          of nodes generated by all tasks
+ *
+ *-------------------------------------------------------------------------*/
+static void RenumberNodes(Home_t *home, InData_t *inData, int numSections,
+                          int *sectionLen, int *totalNodeCount)
+{
+#ifdef PARALLEL
+        int    i, iArm, sec;
+        int    localStart[MAX_GEN_SECTIONS], globalStart[MAX_GEN_SECTIONS];
+        int    sectionTotal[MAX_GEN_SECTIONS];
+        Node_t *node;
+
+/*
+ *      Find where each local section starts in the global numbering:
+ *      after the same section on all lower numbered tasks, and after
+ *      all preceding sections on all tasks.
+ */
+        MPI_Exscan(sectionLen, globalStart, numSections, MPI_INT, MPI_SUM,
+                   MPI_COMM_WORLD);
+        MPI_Allreduce(sectionLen, sectionTotal, numSections, MPI_INT,
+                      MPI_SUM, MPI_COMM_WORLD);
+
+        *totalNodeCount = 0;
+
+        for (sec = 0; sec < numSections; sec++) {
+            if (home->myDomain == 0) {
+                globalStart[sec] = 0;
+            }
+            localStart[sec] = (sec == 0) ? 0 :
+                              localStart[sec-1] + sectionLen[sec-1];
+            globalStart[sec] += *totalNodeCount;
+            *totalNodeCount += sectionTotal[sec];
+        }
+
+/*
+ *      Nodes only link to other nodes generated by the same task,
+ *      so all tags can be converted locally.
+ */
+#define GLOBAL_INDEX(_idx, _gIdx)                                       \
+        {                                                               \
+            for (sec = numSections - 1; sec > 0; sec--) {               \
+                if ((_idx) >= localStart[sec]) break;                   \
+            }                                                           \
+            (_gIdx) = (_idx) - localStart[sec] + globalStart[sec];      \
+        }
+
+        for (i = 0; i < inData->nodeCount; i++) {
+
+            node = &inData->node[i];
+
+            GLOBAL_INDEX(node->myTag.index, node->myTag.index);
+
+            for (iArm = 0; iArm < node->numNbrs; iArm++) {
+                GLOBAL_INDEX(node->nbrTag[iArm].index,
+                             node->nbrTag[iArm].index);
+            }
+        }
+
+#undef GLOBAL_INDEX
+
+#else
+        *totalNodeCount = inData->nodeCount;
+#endif
+        return;
+}
+
+
 /*---------------------------------------------------------------------------
  *
  *      Function:       WriteInitialNodeData
  *      Description:    Writes the nodal data for all nodes contained
- *                      in the inData->node list to the specified data
- *                      file.  The first call to ths function will
- *                      open up the output file, write the version
- *                      and header data and so on before writing nodal
- *                      data.  The final call (i.e. lastBlock == 1) will
- *                      insert the final node count into the data file
- *                      and clean up.
- *      Arguments:
+ *                      in the inData->node list to the data file.  The
+ *                      file (or first file segment when generating on
+ *                      multiple tasks) starts with the data file
+ *                      parameters and the domain decomposition.
  *
- *          lastBlock       set to 1 if if the supplied nodal data
- *                          is the last block of dfata to be written
- *                          to the specified file, set to zero in
- *                          all other cases.
+ *                      When generating on multiple tasks, each section
+ *                      of the local node array is written to a separate
+ *                      file segment so the segments can be read back in
+ *                      the order of the serial node numbering.  This
+ *                      function must be called by all tasks.
+ *
+ *      Arguments:
+ *          numSections     number of sections in the inData->node
+ *                          array.  May not exceed MAX_GEN_SECTIONS.
+ *          sectionLen      number of nodes in each section
  *
  *-------------------------------------------------------------------------*/
-void WriteInitialNodeData(Home_t *home, InData_t *inData, int lastBlock)
+void WriteInitialNodeData(Home_t *home, InData_t *inData, int numSections,
+                          int *sectionLen)
 {
-        int         i, iArm;
+        int         i, iArm, sec, segment, totalNodeCount;
+        int         firstNode, lastNode;
+        char        segmentName[512];
         Node_t      *node;
         Param_t     *param;
-        static int  totalNodeCount = 0;
-        static FILE *fp = (FILE *)NULL;
+        FILE        *fp;
 
 
         param = inData->param;
+
+        if ((numSections < 1) || (numSections > MAX_GEN_SECTIONS)) {
+            Fatal("WriteInitialNodeData: invalid section count %d",
+                  numSections);
+        }
+
+        RenumberNodes(home, inData, numSections, sectionLen, &totalNodeCount);
+
+        param->nodeCount = totalNodeCount;
+
 /*
- *      If this is the first block of data being written to
- *      this file (i.e. fp == NULL), do some basic initialization
+ *      A single task writes everything into one file.
  */
-        if (fp == (FILE *)NULL) {
+        if (home->numDomains == 1) {
+            numSections = 1;
+            param->numFileSegments = 1;
+        } else {
+            param->numFileSegments = numSections * home->numDomains;
+        }
+
+        firstNode = 0;
+
+        for (sec = 0; sec < numSections; sec++) {
+
+            segment = sec * home->numDomains + home->myDomain;
 
-            fp = fopen(param->node_data_file, "w");
+            if (param->numFileSegments == 1) {
+                snprintf(segmentName, sizeof(segmentName), "%s",
+                         param->node_data_file);
+            } else {
+                snprintf(segmentName, sizeof(segmentName), "%s.%d",
+                         param->node_data_file, segment);
+            }
+
+            fp = fopen(segmentName, "w");
             if (!fp) {
                 Fatal("%s: error %d opening file %s\n",
-                      "WriteInitialNodeData", errno,
-                      param->node_data_file);
+                      "WriteInitialNodeData", errno, segmentName);
             }
 
 /*
- *          Write data file parameters
+ *          The first segment contains the data file parameters
+ *          and domain decomposition
  */
-            WriteParam(home->dataParamList, -1, fp);
+            if (segment == 0) {
 
-/*
- *          Write the domain decomposition into the data file
- */
-            fprintf(fp, "\n#\n#  END OF DATA FILE PARAMETERS\n#\n\n");
+                WriteParam(home->dataParamList, -1, fp);
 
-            fprintf(fp, "domainDecomposition = \n");
-            WriteDecompBounds(home, fp);
+                fprintf(fp, "\n#\n#  END OF DATA FILE PARAMETERS\n#\n\n");
 
-            fprintf(fp, "nodalData = \n");
-            fprintf(fp, "#  Primary lines: node_tag, x, y, z, "
-                    "num_arms, constraint\n");
-            fprintf(fp, "#  Secondary lines: arm_tag, burgx, burgy, "
-                    "burgz, nx, ny, nz\n");
-        }
+                fprintf(fp, "domainDecomposition = \n");
+                WriteDecompBounds(home, fp);
+
+                fprintf(fp, "nodalData = \n");
+                fprintf(fp, "#  Primary lines: node_tag, x, y, z, "
+                        "num_arms, constraint\n");
+                fprintf(fp, "#  Secondary lines: arm_tag, burgx, burgy, "
+                        "burgz, nx, ny, nz\n");
+            }
 
 /*
- *      Dump all the nodal data in this block to the file
+ *          Dump all the nodal data in this section to the file
  */
-        totalNodeCount += inData->nodeCount;
+            if (home->numDomains == 1) {
+                lastNode = inData->nodeCount;
+            } else {
+                lastNode = firstNode + sectionLen[sec];
+            }
 
-        for (i = 0; i < inData->nodeCount; i++) {
+            for (i = firstNode; i < lastNode; i++) {
 
-            node = &inData->node[i];
+                node = &inData->node[i];
 
-            fprintf(fp,
-                    " %d,%d %.4f %.4f %.4f %d %d\n",
-                    node->myTag.domainID, node->myTag.index, 
-                    node->x, node->y, node->z, node->numNbrs,
-                    node->constraint);
+                fprintf(fp,
+                        " %d,%d %.4f %.4f %.4f %d %d\n",
+                        node->myTag.domainID, node->myTag.index, 
+                        node->x, node->y, node->z, node->numNbrs,
+                        node->constraint);
 
-            for (iArm = 0; iArm < node->numNbrs; iArm++) {
-                fprintf(fp, "   %d,%d %16.10e %16.10e %16.10e\n"
-                        "       %16.10e %16.10e %16.10e\n",
-                        node->nbrTag[iArm].domainID,
-                        node->nbrTag[iArm].index,
-                        node->burgX[iArm], node->burgY[iArm],
-                        node->burgZ[iArm], node->nx[iArm],
-                        node->ny[iArm], node->nz[iArm]);
+                for (iArm = 0; iArm < node->numNbrs; iArm++) {
+                    fprintf(fp, "   %d,%d %16.10e %16.10e %16.10e\n"
+                            "       %16.10e %16.10e %16.10e\n",
+                            node->nbrTag[iArm].domainID,
+                            node->nbrTag[iArm].index,
+                            node->burgX[iArm], node->burgY[iArm],
+                            node->burgZ[iArm], node->nx[iArm],
+                            node->ny[iArm], node->nz[iArm]);
+                }
             }
-        }
 
-
-/*
- *      If this is the last block of data being written to the
- *      file, seek back to the node count in the file, overwrite
- *      it with the final total, and cleanup.
- */
-        if (lastBlock) {
             fclose(fp);
-            fp = (FILE *)NULL;
+
+            firstNode = lastNode;
+        }
+
+        if (home->myDomain == 0) {
             printf("\nTotal node count:         %d\n", totalNodeCount);
+            if (param->numFileSegments > 1) {
+                printf("Data file segments:       %d\n",
+                       param->numFileSegments);
+            }
         }
 
         return;
@@ -763,6 +899,9 @@ main(int argc, char *argv[])
         real8           cellVolume, bMag2, burgVolFactor;
         real8           totDislocDensity;
         real8           totDislocLen = 0.0;
+#ifdef PARALLEL
+        real8           localDislocLen;
+#endif
         InArgs_t        inArgs;
         InData_t        inData;
         Param_t         *param;
@@ -777,7 +916,15 @@ main(int argc, char *argv[])
         inData.param = (Param_t *)calloc(1, sizeof(Param_t));
         home.dataParamList = (ParamList_t *)calloc(1, sizeof(ParamList_t));
         home.param = inData.param;
+
+#ifdef PARALLEL
+        MPI_Init(&argc, &argv);
+        MPI_Comm_rank(MPI_COMM_WORLD, &home.myDomain);
+        MPI_Comm_size(MPI_COMM_WORLD, &home.numDomains);
+#else
+        home.myDomain = 0;
         home.numDomains = 1;
+#endif
 
         InitDefaultValues(&inArgs);
         GetInArgs(argc, argv, &inArgs);
@@ -825,7 +972,9 @@ if ((inArgs.type == FTYPE_PRISMATIC_LOOP) && (inArgs.loopType != 1)) {
     exit(1);
 }
 #endif
-        PrintArgs(&inArgs); 
+        if (home.myDomain == 0) {
+            PrintArgs(&inArgs); 
+        }
 
 /*
  *      And some additional initializations for when we write the
@@ -956,15 +1105,29 @@ if ((inArgs.type == FTYPE_PRISMATIC_LOOP) && (inArgs.loopType != 1)) {
 /*
  *      Calculate the total dislocation density and print it.
  */
+#ifdef PARALLEL
+        localDislocLen = totDislocLen;
+        MPI_Reduce(&localDislocLen, &totDislocLen, 1, MPI_DOUBLE, MPI_SUM,
+                   0, MPI_COMM_WORLD);
+#endif
         cellVolume       = param->Lx * param->Ly * param->Lz;
         bMag2            = 2.725e-10 * 2.725e-10;
         burgVolFactor    = 1.0 / (bMag2 * cellVolume);
         totDislocDensity = totDislocLen * burgVolFactor;
 
-        printf("Total density:            %e\n", totDislocDensity);
-
         Meminfo(&memSize);
-        printf("\nEstimated memory usage = %d Kbytes\n\n", memSize);
 
+        if (home.myDomain == 0) {
+            printf("Total density:            %e\n", totDislocDensity);
+            printf("\nEstimated memory usage = %d Kbytes", memSize);
+            if (home.numDomains > 1) {
+                printf(" (task 0)");
+            }
+            printf("\n\n");
+        }
+
+#ifdef PARALLEL
+        MPI_Finalize();
+#endif
         exit(0);
 }
@@ -143,6 +143,10 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
         BindVar(CPList, "DLBfreq", &param->DLBfreq, V_INT, 1, VFLAG_NULL);
         param->DLBfreq = 3;
 
+        BindVar(CPList, "DLBcellCost", &param->DLBcellCost, V_INT, 1,
+                VFLAG_NULL);
+        param->DLBcellCost = 1;
+
         BindVar(CPList, "xBoundMin", &param->xBoundMin, V_DBL, 1, VFLAG_NULL);
 
         BindVar(CPList, "xBoundMax", &param->xBoundMax, V_DBL, 1, VFLAG_NULL);
@@ -216,6 +220,22 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
         BindVar(CPList, "remeshRule", &param->remeshRule, V_INT, 1, VFLAG_NULL);
         param->remeshRule = 2;
 
+        BindVar(CPList, "remeshAngleMin", &param->remeshAngleMin, V_DBL, 1,
+                VFLAG_NULL);
+        param->remeshAngleMin = 0.1;
+
+        BindVar(CPList, "remeshAngleMax", &param->remeshAngleMax, V_DBL, 1,
+                VFLAG_NULL);
+        param->remeshAngleMax = 0.5;
+
+        BindVar(CPList, "remeshForceErrMin", &param->remeshForceErrMin, V_DBL,
+                1, VFLAG_NULL);
+        param->remeshForceErrMin = 0.1;
+
+        BindVar(CPList, "remeshForceErrMax", &param->remeshForceErrMax, V_DBL,
+                1, VFLAG_NULL);
+        param->remeshForceErrMax = 1.0;
+
         BindVar(CPList, "splitMultiNodeFreq", &param->splitMultiNodeFreq,
                 V_INT, 1, VFLAG_NULL);
         param->splitMultiNodeFreq = 1;
@@ -737,6 +757,24 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
                 VFLAG_NULL);
         strcpy(param->winDefaultsFile, "inputs/paradis.xdefaults");
 
+        BindVar(CPList, "winSummary", &param->winSummary, V_INT, 1,
+                VFLAG_NULL);
+        param->winSummary = 1;
+
+        BindVar(CPList, "winSummaryRes", &param->winSummaryRes, V_INT, 1,
+                VFLAG_NULL);
+        param->winSummaryRes = 256;
+
+        BindVar(CPList, "winSummaryMaxSegs", &param->winSummaryMaxSegs,
+                V_INT, 1, VFLAG_NULL);
+        param->winSummaryMaxSegs = 250000;
+
+        BindVar(CPList, "winSummaryMin", param->winSummaryMin, V_DBL, 3,
+                VFLAG_NULL);
+
+        BindVar(CPList, "winSummaryMax", param->winSummaryMax, V_DBL, 3,
+                VFLAG_NULL);
+
 
 /*
  *      3D-dislocation density data
@@ -36,7 +36,9 @@ static void PickBCCScrewGlidePlane(real8 burgVec[3], real8 glidePlane[3])
 {
         real8        randVal;
         static int   seed = 8917346;
-//#pragma omp threadprivate (seed)
+#ifdef _OPENMP
+#pragma omp threadprivate (seed)
+#endif
 
         randVal = randm(&seed);
 
@@ -79,7 +81,9 @@ static void PickFCCScrewGlidePlane(real8 burgVec[3], real8 glidePlane[3])
 {
         real8        randVal;
         static int   seed = 8917346;
-//#pragma omp threadprivate (seed)
+#ifdef _OPENMP
+#pragma omp threadprivate (seed)
+#endif
 
         randVal = randm(&seed);
 
@@ -12,6 +12,7 @@
 #include "Util.h"
 #include "DisplayC.h"
 #include "Decomp.h"
+#include "Comm.h"
 #include <math.h>
 
 /*
@@ -24,6 +25,125 @@
                 
 
 
+/*
+ *      Scaling values shared between the functions that set up the
+ *      display, plot the dislocations and finish the display update.
+ */
+static real8    Lx, Ly, Lz, xmin, ymin, zmin, xmax, ymax, zmax;
+static real8    Lmax, a, b, c;
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     PlotSetup
+ *      Description:  Clear the display and plot the domain boundaries
+ *                    and free surfaces in preparation for plotting
+ *                    the dislocations.
+ *
+ *-------------------------------------------------------------------------*/
+static void PlotSetup(Home_t *home)
+{
+        Param_t         *param;
+        real8           x, y, z, x2, y2, z2;
+        unsigned        color;
+
+        param=home->param;
+
+        WinLock();
+        WinClear();
+
+        xmin=param->minSideX;  xmax=param->maxSideX;
+        ymin=param->minSideY;  ymax=param->maxSideY;
+        zmin=param->minSideZ;  zmax=param->maxSideZ;
+    
+        Lx=xmax-xmin;
+        Ly=ymax-ymin;
+        Lz=zmax-zmin;
+
+        Lmax = Lx;
+        if (Lmax<Ly) Lmax=Ly;
+        if (Lmax<Lz) Lmax=Lz;
+
+        a = Lx/Lmax;
+        b = Ly/Lmax;
+        c = Lz/Lmax;
+    
+        color=colors[9];
+
+/*
+ *      Using the domain decomposition data, plot all the domain
+ *      boundaries.
+ */
+        XPlotDecomp(home, xmin, ymin, zmin, Lmax, color, line_width);
+
+/*
+ *      Plot the free surfaces if periodic boundary conditions are
+ *      not enabled.
+ */
+        if (param->zBoundType==Free ||
+            param->yBoundType==Free ||
+            param->xBoundType==Free) {
+
+            x=(param->xBoundMin-xmin)/Lmax*2-1;
+            x2=(param->xBoundMax-xmin)/Lmax*2-1;
+
+            y=(param->yBoundMin-ymin)/Lmax*2-1;
+            y2=(param->yBoundMax-ymin)/Lmax*2-1;
+
+            z=(param->zBoundMin-zmin)/Lmax*2-1;
+            z2=(param->zBoundMax-zmin)/Lmax*2-1;
+
+            WinDrawLine(x,y,z,x2,y,z,color,line_width/2,0);
+            WinDrawLine(x,y2,z,x2,y2,z,color,line_width/2,0);
+            WinDrawLine(x,y,z2,x2,y,z2,color,line_width/2,0);
+            WinDrawLine(x,y2,z2,x2,y2,z2,color,line_width/2,0); 
+
+            WinDrawLine(x,y,z,x,y2,z,color,line_width/2,0);
+            WinDrawLine(x2,y,z,x2,y2,z,color,line_width/2,0);
+            WinDrawLine(x,y,z2,x,y2,z2,color,line_width/2,0);
+            WinDrawLine(x2,y,z2,x2,y2,z2,color,line_width/2,0); 
+
+            WinDrawLine(x,y,z,x,y,z2,color,line_width/2,0);
+            WinDrawLine(x,y2,z,x,y2,z2,color,line_width/2,0);
+            WinDrawLine(x2,y,z,x2,y,z2,color,line_width/2,0);
+            WinDrawLine(x2,y2,z,x2,y2,z2,color,line_width/2,0); 
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     PlotFinish
+ *      Description:  Draw the frame around the problem space and
+ *                    refresh the display.
+ *
+ *-------------------------------------------------------------------------*/
+static void PlotFinish(void)
+{
+        real8           x, y, z, x2, y2, z2;
+
+        drawsline(-a,-b,-c,-a,-b, c,colors[10],line_width,0);
+        drawsline(-a,-b, c,-a, b, c,colors[10],line_width,0);
+        drawsline(-a, b, c,-a, b,-c,colors[10],line_width,0);
+        drawsline(-a, b,-c,-a,-b,-c,colors[10],line_width,0);
+        drawsline( a,-b,-c, a,-b, c,colors[10],line_width,0);
+        drawsline( a,-b, c, a, b, c,colors[10],line_width,0);
+        drawsline( a, b, c, a, b,-c,colors[10],line_width,0);
+        drawsline( a, b,-c, a,-b,-c,colors[10],line_width,0);
+        drawsline(-a,-b,-c, a,-b,-c,colors[10],line_width,0);
+        drawsline(-a,-b, c, a,-b, c,colors[10],line_width,0);
+        drawsline(-a, b, c, a, b, c,colors[10],line_width,0);
+        drawsline(-a, b,-c, a, b,-c,colors[10],line_width,0);
+
+        WinUnlock();
+        WinRefresh();
+
+        return;
+}
+
+
 /*---------------------------------------------------------------------------
  *
  *      Function:     Plot
@@ -47,87 +167,22 @@
  *-------------------------------------------------------------------------*/
 void Plot(Home_t *home, int domIndex, int blkFlag) 
 {
-        Param_t         *param;
         int             i, j, index;
         int             newNodeKeyPtr;
         real8           x, y, z, x2, y2, z2;
         Node_t          *node;
         char            string[DSCLEN*10];
-        static unsigned color;
-        static real8    Lx, Ly, Lz, xmin, ymin, zmin, xmax, ymax, zmax;
-        static real8    Lmax, a, b, c;
+        unsigned        color;
     
         if (home->myDomain != 0) return;
 
-        param=home->param;
-
 /*
  *      If this is the first block (domain) of data being plotted during
  *      this update, do some basic initialization and setup.
  */
         if (blkFlag & FIRST_BLOCK) {
-
-            WinLock();
-            WinClear();
-
-            xmin=param->minSideX;  xmax=param->maxSideX;
-            ymin=param->minSideY;  ymax=param->maxSideY;
-            zmin=param->minSideZ;  zmax=param->maxSideZ;
-    
-            Lx=xmax-xmin;
-            Ly=ymax-ymin;
-            Lz=zmax-zmin;
-
-            Lmax = Lx;
-            if (Lmax<Ly) Lmax=Ly;
-            if (Lmax<Lz) Lmax=Lz;
-
-            a = Lx/Lmax;
-            b = Ly/Lmax;
-            c = Lz/Lmax;
-    
-            color=colors[9];
-
-/*
- *          Using the domain decomposition data, plot all the domain
- *          boundaries.
- */
-            XPlotDecomp(home, xmin, ymin, zmin, Lmax, color, line_width);
-
-/*
- *          Plot the free surfaces if periodic boundary conditions are
- *          not enabled.
- */
-            if (param->zBoundType==Free ||
-                param->yBoundType==Free ||
-                param->xBoundType==Free) {
-
-                x=(param->xBoundMin-xmin)/Lmax*2-1;
-                x2=(param->xBoundMax-xmin)/Lmax*2-1;
-
-                y=(param->yBoundMin-ymin)/Lmax*2-1;
-                y2=(param->yBoundMax-ymin)/Lmax*2-1;
-
-                z=(param->zBoundMin-zmin)/Lmax*2-1;
-                z2=(param->zBoundMax-zmin)/Lmax*2-1;
-
-                WinDrawLine(x,y,z,x2,y,z,color,line_width/2,0);
-                WinDrawLine(x,y2,z,x2,y2,z,color,line_width/2,0);
-                WinDrawLine(x,y,z2,x2,y,z2,color,line_width/2,0);
-                WinDrawLine(x,y2,z2,x2,y2,z2,color,line_width/2,0); 
-
-                WinDrawLine(x,y,z,x,y2,z,color,line_width/2,0);
-                WinDrawLine(x2,y,z,x2,y2,z,color,line_width/2,0);
-                WinDrawLine(x,y,z2,x,y2,z2,color,line_width/2,0);
-                WinDrawLine(x2,y,z2,x2,y2,z2,color,line_width/2,0); 
-
-                WinDrawLine(x,y,z,x,y,z2,color,line_width/2,0);
-                WinDrawLine(x,y2,z,x,y2,z2,color,line_width/2,0);
-                WinDrawLine(x2,y,z,x2,y,z2,color,line_width/2,0);
-                WinDrawLine(x2,y2,z,x2,y2,z2,color,line_width/2,0); 
-            }
-
-        }  /* if (blkFlag && FIRST_BLOCK) */
+            PlotSetup(home);
+        }
 
 /*
  *	plotting segments
@@ -249,24 +304,74 @@ fflush(stdout);
  *	this update, draw the frame and do basic cleanup.
  */
 	if (blkFlag & LAST_BLOCK) {
-
-		drawsline(-a,-b,-c,-a,-b, c,colors[10],line_width,0);
-		drawsline(-a,-b, c,-a, b, c,colors[10],line_width,0);
-		drawsline(-a, b, c,-a, b,-c,colors[10],line_width,0);
-		drawsline(-a, b,-c,-a,-b,-c,colors[10],line_width,0);
-		drawsline( a,-b,-c, a,-b, c,colors[10],line_width,0);
-		drawsline( a,-b, c, a, b, c,colors[10],line_width,0);
-		drawsline( a, b, c, a, b,-c,colors[10],line_width,0);
-		drawsline( a, b,-c, a,-b,-c,colors[10],line_width,0);
-		drawsline(-a,-b,-c, a,-b,-c,colors[10],line_width,0);
-		drawsline(-a,-b, c, a,-b, c,colors[10],line_width,0);
-		drawsline(-a, b, c, a, b, c,colors[10],line_width,0);
-		drawsline(-a, b,-c, a, b,-c,colors[10],line_width,0);
-
-		WinUnlock();
-		WinRefresh();
+		PlotFinish();
 	}
 }
 
 
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     PlotSummary
+ *      Description:  Plot the reduced set of segments gathered from
+ *                    all domains by CommSendPlotSummary() in an X-window
+ *                    display.  Unlike Plot(), all the data is handled
+ *                    in a single call and individual nodes are not
+ *                    drawn.
+ *
+ *      Args:
+ *          segList   array of segments, VALS_PER_PLOT_SEG values per
+ *                    segment (endpoint coordinates, owning domain or
+ *                    -1 if the segment spans domains, and burgers
+ *                    vector color index).
+ *          segCount  number of segments in <segList>
+ *
+ *-------------------------------------------------------------------------*/
+void PlotSummary(Home_t *home, real8 *segList, int segCount) 
+{
+        int             i, domIndex, burgIndex;
+        real8           x, y, z, x2, y2, z2;
+        real8           *seg;
+        unsigned        color;
+    
+        if (home->myDomain != 0) return;
+
+        PlotSetup(home);
+
+        for (i = 0; i < segCount; i++) {
+
+            seg = &segList[i * VALS_PER_PLOT_SEG];
+
+            x  = (seg[0]-xmin)/Lx; x  -= 0.5+pbcshift[0]; x  *= 2;
+            y  = (seg[1]-ymin)/Ly; y  -= 0.5+pbcshift[1]; y  *= 2;
+            z  = (seg[2]-zmin)/Lz; z  -= 0.5+pbcshift[2]; z  *= 2;
+
+            x2 = (seg[3]-xmin)/Lx; x2 -= 0.5+pbcshift[0]; x2 *= 2;
+            y2 = (seg[4]-ymin)/Ly; y2 -= 0.5+pbcshift[1]; y2 *= 2;
+            z2 = (seg[5]-zmin)/Lz; z2 -= 0.5+pbcshift[2]; z2 *= 2;
+
+            domIndex  = (int)seg[6];
+            burgIndex = (int)seg[7];
+
+            color = colors[1];
+
+            if (color_scheme == 1) {
+                if (domIndex >= 0) color = colors[domIndex%8+2];
+            } else if (color_scheme == 2) {
+                color = colors[burgIndex%8+2];
+            }
+
+/*
+ *          Do not draw segments across PBC
+ */
+            if ((fabs(x-x2)<=1) && (fabs(y-y2)<=1) && (fabs(z-z2)<=1)) {
+                WinDrawLine(x*a,y*b,z*c,x2*a,y2*b,z2*c, color,line_width,0);
+            }
+        }
+
+        PlotFinish();
+
+        return;
+}
+
+
 #endif
@@ -38,6 +38,7 @@
 #include "Home.h"
 #include "Util.h"
 #include "Comm.h"
+#include "Decomp.h"
 #include "Mobility.h"
 
 
@@ -884,6 +885,7 @@ void PredictiveCollisions(Home_t *home)
         int     splitSeg1, splitSeg2;
         int     cell2Index, nbrCell2Index, nextIndex;
         int     cell2X, cell2Y, cell2Z, cx, cy, cz;
+        int     numCandidates;
         int     localCollisionCnt, globalCollisionCnt;
         int     collisionConditionIsMet, adjustCollisionPoint;
         real8   mindist2, dist2, ddist2dt, L1, L2, eps, half;
@@ -902,6 +904,7 @@ void PredictiveCollisions(Home_t *home)
         real8   nodeVel[3], newNodeVel[3];
         real8   newPos[3], newVel[3];
         real8   vec1[3], vec2[3];
+        real8   candidatePos[3];
         real8   p1[3], p2[3], p3[3], p4[3];
         real8   v1[3], v2[3], v3[3], v4[3];
         Tag_t   oldTag1, oldTag2;
@@ -966,6 +969,17 @@ void PredictiveCollisions(Home_t *home)
 
             DecodeCell2Idx(home, cell2Index, &cell2X, &cell2Y, &cell2Z);
 
+/*
+ *          Keep track of the number of candidate nodes examined for
+ *          the load-balancing cost model.  Node1 may be gone by the
+ *          time we're done, so save its position now.
+ */
+            numCandidates = 0;
+
+            candidatePos[X] = node1->x;
+            candidatePos[Y] = node1->y;
+            candidatePos[Z] = node1->z;
+
             for (cx = cell2X - 1; cx <= cell2X + 1; cx++) {
              for (cy = cell2Y - 1; cy <= cell2Y + 1; cy++) {
               for (cz = cell2Z - 1; cz <= cell2Z + 1; cz++) {
@@ -992,6 +1006,8 @@ void PredictiveCollisions(Home_t *home)
                         continue;
                     }
 
+                    numCandidates++;
+
 /*
  *                  Loop over all arms of node1.  Skip any arms that
  *                  terminate at node3 (those hinge arms will be dealt
@@ -1704,6 +1720,10 @@ void PredictiveCollisions(Home_t *home)
             }  /* Loop over neighboring cell2s */
            }
           }
+
+            AddCellCost(home, candidatePos[X], candidatePos[Y],
+                        candidatePos[Z], DLB_COST_COLLISION * numCandidates);
+
         }  /* for (i = 0 ...) */
 
 /*
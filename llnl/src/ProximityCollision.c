@@ -35,6 +35,7 @@
 #include "Home.h"
 #include "Util.h"
 #include "Comm.h"
+#include "Decomp.h"
 #include "Mobility.h"
 
 
@@ -647,6 +648,7 @@ void ProximityCollisions(Home_t *home)
         int     splitSeg1, splitSeg2;
         int     cell2Index, nbrCell2Index, nextIndex;
         int     cell2X, cell2Y, cell2Z, cx, cy, cz;
+        int     numCandidates;
         int     localCollisionCnt, globalCollisionCnt;
         real8   mindist2, dist2, ddist2dt, L1, L2, eps, half;
         real8   x1, y1, z1, vx1, vy1, vz1;
@@ -663,6 +665,7 @@ void ProximityCollisions(Home_t *home)
         real8   nodeVel[3], newNodeVel[3];
         real8   newPos[3], newVel[3];
         real8   vec1[3], vec2[3];
+        real8   candidatePos[3];
         Tag_t   oldTag1, oldTag2;
         Node_t  *node1, *node2, *node3, *node4, *tmpNbr;
         Node_t  *mergenode1, *mergenode2, *targetNode;
@@ -724,6 +727,17 @@ void ProximityCollisions(Home_t *home)
 
             DecodeCell2Idx(home, cell2Index, &cell2X, &cell2Y, &cell2Z);
 
+/*
+ *          Keep track of the number of candidate nodes examined for
+ *          the load-balancing cost model.  Node1 may be gone by the
+ *          time we're done, so save its position now.
+ */
+            numCandidates = 0;
+
+            candidatePos[X] = node1->x;
+            candidatePos[Y] = node1->y;
+            candidatePos[Z] = node1->z;
+
             for (cx = cell2X - 1; cx <= cell2X + 1; cx++) {
              for (cy = cell2Y - 1; cy <= cell2Y + 1; cy++) {
               for (cz = cell2Z - 1; cz <= cell2Z + 1; cz++) {
@@ -750,6 +764,8 @@ void ProximityCollisions(Home_t *home)
                         continue;
                     }
 
+                    numCandidates++;
+
 /*
  *                  Loop over all arms of node1.  Skip any arms that
  *                  terminate at node3 (those hinge arms will be dealt
@@ -1602,6 +1618,10 @@ void ProximityCollisions(Home_t *home)
             }  /* Loop over neighboring cell2s */
            }
           }
+
+            AddCellCost(home, candidatePos[X], candidatePos[Y],
+                        candidatePos[Z], DLB_COST_COLLISION * numCandidates);
+
         }  /* for (i = 0 ...) */
 
 /*
@@ -40,6 +40,7 @@
  *
  *      Includes private functions:
  *          DecompID2DomID()
+ *          FindBisection()
  *          FindVolumeDomainList()
  *          GetBisection()
  *          GetDecompCnt()
@@ -84,6 +85,10 @@
  */
 #define DOMAIN_CNT_INCREMENT 20
 
+static void FindBisection(Home_t *home, RBDecomp_t *subDecomp, int dim,
+        int numElements, real8 *load, real8 *bounds, real8 *coord,
+        real8 minSideRatio);
+
 static void GetBisection(real8 newMinCoord, real8 newMaxCoord, int numElements,
         real8 *load, real8 *bounds, real8 *coord, real8 minSideRatio);
 
@@ -1203,6 +1208,67 @@ void GetBisection(real8 newMinCoord, real8 newMaxCoord, int numElements,
 }
 
 
+/*-------------------------------------------------------------------------
+ *
+ *      Function:       FindBisection
+ *      Description:    Find the coordinate of the plane bisecting a
+ *                      partition in the specified dimension.  If the
+ *                      global per-cell load histogram is available
+ *                      the plane is placed based on the load within
+ *                      the partition, otherwise GetBisection() is used
+ *                      to interpolate from the previous boundaries
+ *                      and loads, assuming the load is uniform within
+ *                      each of the previous subpartitions.
+ *
+ *      Arguments:
+ *          subDecomp     Lower subpartition being formed by the cut.
+ *                        At the time of the call its bounds must
+ *                        still cover the full region being bisected.
+ *          dim           Dimension (X, Y or Z) in which to cut.
+ *          numElements   Number of values in the <load> array.
+ *          load          Array of <numElements> values containing load data
+ *                        associated with volumes defined by <bounds>
+ *          bounds        Array of <numElements>+1 values defining volumes
+ *                        for which there is load data.
+ *          coord         Location in which to return to the caller the
+ *                        coordinate of the bisecting plane.
+ *          minSideRatio  portion of load to be accumulated on the minimum
+ *                        side of the bisection coordinate.  Must be 
+ *                        between 0.0 and 1.0.
+ * 
+ *-----------------------------------------------------------------------*/
+static void FindBisection(Home_t *home, RBDecomp_t *subDecomp, int dim,
+                          int numElements, real8 *load, real8 *bounds,
+                          real8 *coord, real8 minSideRatio)
+{
+        real8 totLoad;
+        real8 *profile;
+
+        if (home->cellLoad == (real8 *)NULL) {
+            GetBisection(subDecomp->cMin[dim], subDecomp->cMax[dim],
+                         numElements, load, bounds, coord, minSideRatio);
+            return;
+        }
+
+        totLoad = GetCellLoadProfile(home, subDecomp->cMin, subDecomp->cMax,
+                                     dim, &profile);
+
+        if (totLoad == 0.0) {
+            *coord = subDecomp->cMin[dim] +
+                     0.5 * (subDecomp->cMax[dim] - subDecomp->cMin[dim]);
+        } else {
+            *coord = FindCellLoadCoord(home, profile, dim,
+                                       subDecomp->cMin[dim],
+                                       subDecomp->cMax[dim],
+                                       totLoad * minSideRatio);
+        }
+
+        free(profile);
+
+        return;
+}
+
+
 /*-------------------------------------------------------------------------
  *
  *      Function:       SetAllRBDecompBounds
@@ -1808,8 +1874,8 @@ void RBDecomp(Home_t *home, RBDecomp_t *decomp, RBDecomp_t *oldDecomp,
                 oldBounds[1] = oldDecomp->subDecomp[LLF]->cMax[X];
                 oldBounds[2] = oldDecomp->cMax[X];
 
-                GetBisection(decomp->cMin[X], decomp->cMax[X], numSlices,
-                             sliceLoad, oldBounds, &coord, minRatio[X]);
+                FindBisection(home, subDecompList[LLF], X, numSlices,
+                              sliceLoad, oldBounds, &coord, minRatio[X]);
 
 /*
  *              If we're restricting the domain boundary motion at the
@@ -1868,8 +1934,8 @@ void RBDecomp(Home_t *home, RBDecomp_t *decomp, RBDecomp_t *oldDecomp,
                     oldBounds[1] = oldDecomp->subDecomp[LLF]->cMax[Y];
                     oldBounds[2] = oldDecomp->cMax[Y];
 
-                    GetBisection(decomp->cMin[Y], decomp->cMax[Y], numSlices,
-                                 sliceLoad, oldBounds, &coord, minRatio[Y]);
+                    FindBisection(home, subDecompList[LLF], Y, numSlices,
+                                  sliceLoad, oldBounds, &coord, minRatio[Y]);
 
                     if (restrictMovement) {
                         oldBisection = oldBounds[1];
@@ -1896,8 +1962,8 @@ void RBDecomp(Home_t *home, RBDecomp_t *decomp, RBDecomp_t *oldDecomp,
                     oldBounds[1] = oldDecomp->subDecomp[LRF]->cMax[Y];
                     oldBounds[2] = oldDecomp->cMax[Y];
 
-                    GetBisection(decomp->cMin[Y], decomp->cMax[Y], numSlices,
-                                 sliceLoad, oldBounds, &coord, minRatio[Y]);
+                    FindBisection(home, subDecompList[LRF], Y, numSlices,
+                                  sliceLoad, oldBounds, &coord, minRatio[Y]);
 
                     if (restrictMovement) {
                         oldBisection = oldBounds[1];
@@ -1940,8 +2006,8 @@ void RBDecomp(Home_t *home, RBDecomp_t *decomp, RBDecomp_t *oldDecomp,
                     oldBounds[1] = oldDecomp->subDecomp[LLF]->cMax[Z];
                     oldBounds[2] = oldDecomp->cMax[Z];
 
-                    GetBisection(decomp->cMin[Z], decomp->cMax[Z], numSlices,
-                                 sliceLoad, oldBounds, &coord, minRatio[Z]);
+                    FindBisection(home, subDecompList[LLF], Z, numSlices,
+                                  sliceLoad, oldBounds, &coord, minRatio[Z]);
 
                     if (restrictMovement) {
                         oldBisection = oldBounds[1];
@@ -1966,8 +2032,8 @@ void RBDecomp(Home_t *home, RBDecomp_t *decomp, RBDecomp_t *oldDecomp,
                     oldBounds[1] = oldDecomp->subDecomp[LRF]->cMax[Z];
                     oldBounds[2] = oldDecomp->cMax[Z];
 
-                    GetBisection(decomp->cMin[Z], decomp->cMax[Z], numSlices,
-                                 sliceLoad, oldBounds, &coord, minRatio[Z]);
+                    FindBisection(home, subDecompList[LRF], Z, numSlices,
+                                  sliceLoad, oldBounds, &coord, minRatio[Z]);
 
                     if (restrictMovement) {
                         oldBisection = oldBounds[1];
@@ -1992,8 +2058,8 @@ void RBDecomp(Home_t *home, RBDecomp_t *decomp, RBDecomp_t *oldDecomp,
                     oldBounds[1] = oldDecomp->subDecomp[ULF]->cMax[Z];
                     oldBounds[2] = oldDecomp->cMax[Z];
 
-                    GetBisection(decomp->cMin[Z], decomp->cMax[Z], numSlices,
-                                 sliceLoad, oldBounds, &coord, minRatio[Z]);
+                    FindBisection(home, subDecompList[ULF], Z, numSlices,
+                                  sliceLoad, oldBounds, &coord, minRatio[Z]);
 
                     if (restrictMovement) {
                         oldBisection = oldBounds[1];
@@ -2018,8 +2084,8 @@ void RBDecomp(Home_t *home, RBDecomp_t *decomp, RBDecomp_t *oldDecomp,
                     oldBounds[1] = oldDecomp->subDecomp[URF]->cMax[Z];
                     oldBounds[2] = oldDecomp->cMax[Z];
 
-                    GetBisection(decomp->cMin[Z], decomp->cMax[Z], numSlices,
-                                 sliceLoad, oldBounds, &coord, minRatio[Z]);
+                    FindBisection(home, subDecompList[URF], Z, numSlices,
+                                  sliceLoad, oldBounds, &coord, minRatio[Z]);
 
                     if (restrictMovement) {
                         oldBisection = oldBounds[1];
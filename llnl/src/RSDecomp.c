@@ -37,6 +37,7 @@
  *          XPlotRSDecomp()
  *
  *      Includes private functions:
+ *          DLBhistBounds()
  *          DLBnewBounds()
  *
  ***************************************************************************/
@@ -878,6 +879,82 @@ static void DLBnewBounds(real8 *Bold, real8 *Bnew, real8 *times, int numParts,
 }
 
 
+/*-------------------------------------------------------------------------
+ *
+ *      Function:     DLBhistBounds
+ *      Description:  Calculate new partition boundaries along
+ *                    dimension <dim> from the global per-cell load
+ *                    histogram.  Each interior boundary is placed
+ *                    where the load accumulated from the lower edge
+ *                    of the region equals the proper fraction of
+ *                    the total load in the region.
+ *
+ *                    Constrain Bnew[i] to lie inside the region bounded by:
+ *
+ *                        Bold[i] - shiftLimit and
+ *                        Bold[i] + shiftLimit
+ *
+ *      Arguments:
+ *          dim          Dimension (X, Y or Z) being balanced
+ *          boxMin       Minimum coordinates of the region being
+ *                       partitioned.  The <dim> component is ignored.
+ *          boxMax       Maximum coordinates of the region being
+ *                       partitioned.  The <dim> component is ignored.
+ *          Bold         Array of <numParts>+1 elements defining
+ *                       the previous partition boundaries.
+ *          Bnew         Array of <numParts>+1 elements in which
+ *                       to return to the caller the new partition
+ *                       boundaries.
+ *          numParts     Number of partitions 
+ *          shiftLimit   Hard limit on the distance an individual
+ *                       boundary may shift in a single rebalance.
+ *
+ *************************************************************************/
+static void DLBhistBounds(Home_t *home, int dim, real8 boxMin[3],
+                          real8 boxMax[3], real8 *Bold, real8 *Bnew,
+                          int numParts, real8 shiftLimit)
+{
+        int   i;
+        real8 totLoad, coord;
+        real8 regionMin[3], regionMax[3];
+        real8 *profile;
+
+        for (i = 0; i < 3; i++) {
+            regionMin[i] = boxMin[i];
+            regionMax[i] = boxMax[i];
+        }
+
+        regionMin[dim] = Bold[0];
+        regionMax[dim] = Bold[numParts];
+
+        totLoad = GetCellLoadProfile(home, regionMin, regionMax, dim, &profile);
+
+        for (i = 0; i <= numParts; i++) {
+            Bnew[i] = Bold[i];
+        }
+
+/*
+ *      Boundaries at lower and upper edges are static and don't
+ *      move.  If there is no load in the region, there's nothing
+ *      to balance so leave the interior boundaries alone as well.
+ */
+        if (totLoad > 0.0) {
+            for (i = 1; i < numParts; i++) {
+                coord = FindCellLoadCoord(home, profile, dim, Bold[0],
+                                          Bold[numParts],
+                                          totLoad * i / numParts);
+                coord = MAX(coord, Bold[i] - shiftLimit);
+                coord = MIN(coord, Bold[i] + shiftLimit);
+                Bnew[i] = coord;
+            }
+        }
+
+        free(profile);
+
+        return;
+}
+
+
 /*-----------------------------------------------------------------------
  *
  *      Function:     DLBalanceX
@@ -963,7 +1040,13 @@ void DLBalanceX(Home_t *home, real8 *loadData)
  */
         Bnew = (real8 *)malloc((nXdoms+1) * sizeof (real8));
 
-        DLBnewBounds(decomp->domBoundX, Bnew, valX, nXdoms, shiftLimit);
+        if (home->cellLoad != (real8 *)NULL) {
+            DLBhistBounds(home, X, home->param->minCoordinates,
+                          home->param->maxCoordinates, decomp->domBoundX,
+                          Bnew, nXdoms, shiftLimit);
+        } else {
+            DLBnewBounds(decomp->domBoundX, Bnew, valX, nXdoms, shiftLimit);
+        }
         
 /*
  *      Replace old X domain boundaries with new ones
@@ -996,6 +1079,7 @@ void DLBalanceY(Home_t *home, real8 *loadData)
         real8 *Bnew;
         real8 **valY;
         real8 cellSize, shiftLimit;
+        real8 boxMin[3], boxMax[3];
         RSDecomp_t *decomp;
         
         decomp = (RSDecomp_t *)home->decomp;
@@ -1012,6 +1096,14 @@ void DLBalanceY(Home_t *home, real8 *loadData)
         cellSize = home->param->Ly / home->param->nYcells;
         shiftLimit = 0.49 * cellSize;
 
+/*
+ *      Region partitioned when balancing with the cell load
+ *      histogram.  The extent in the previously partitioned
+ *      dimension(s) is set for each partition below.
+ */
+        VECTOR_COPY(boxMin, home->param->minCoordinates);
+        VECTOR_COPY(boxMax, home->param->maxCoordinates);
+
 /*
  *      Sum the total values in each y-partition
  */
@@ -1074,8 +1166,15 @@ void DLBalanceY(Home_t *home, real8 *loadData)
         Bnew = (real8 *) malloc ((nYdoms+1) * sizeof(real8));
         
         for (i = 0; i < nXdoms; i++) {
-            DLBnewBounds(decomp->domBoundY[i], Bnew, valY[i],
-                         nYdoms, shiftLimit);
+            if (home->cellLoad != (real8 *)NULL) {
+                boxMin[X] = decomp->domBoundX[i];
+                boxMax[X] = decomp->domBoundX[i+1];
+                DLBhistBounds(home, Y, boxMin, boxMax, decomp->domBoundY[i],
+                              Bnew, nYdoms, shiftLimit);
+            } else {
+                DLBnewBounds(decomp->domBoundY[i], Bnew, valY[i],
+                             nYdoms, shiftLimit);
+            }
         
 /*
  *          Replace old Y domain boundaries with new ones
@@ -1119,6 +1218,7 @@ void DLBalanceZ(Home_t *home, real8 *loadData)
         real8 *Bnew;
         real8 ***valZ;
         real8 cellSize, shiftLimit;
+        real8 boxMin[3], boxMax[3];
         RSDecomp_t *decomp;
         
         decomp = (RSDecomp_t *)home->decomp;
@@ -1135,6 +1235,14 @@ void DLBalanceZ(Home_t *home, real8 *loadData)
         cellSize = home->param->Lz / home->param->nZcells;
         shiftLimit = 0.49 * cellSize;
 
+/*
+ *      Region partitioned when balancing with the cell load
+ *      histogram.  The extent in the previously partitioned
+ *      dimension(s) is set for each partition below.
+ */
+        VECTOR_COPY(boxMin, home->param->minCoordinates);
+        VECTOR_COPY(boxMax, home->param->maxCoordinates);
+
 /*
  *      Reorganize loadData into a 3D array, valZ, for convenience.
  *      IMPORTANT: Assumes domain # assignment in dimension order
@@ -1199,8 +1307,18 @@ void DLBalanceZ(Home_t *home, real8 *loadData)
         
         for (i = 0; i < nXdoms; i++) {
             for (j = 0; j < nYdoms; j++) {
-                DLBnewBounds(decomp->domBoundZ[i][j], Bnew, valZ[i][j],
-                             nZdoms, shiftLimit);
+                if (home->cellLoad != (real8 *)NULL) {
+                    boxMin[X] = decomp->domBoundX[i];
+                    boxMax[X] = decomp->domBoundX[i+1];
+                    boxMin[Y] = decomp->domBoundY[i][j];
+                    boxMax[Y] = decomp->domBoundY[i][j+1];
+                    DLBhistBounds(home, Z, boxMin, boxMax,
+                                  decomp->domBoundZ[i][j], Bnew, nZdoms,
+                                  shiftLimit);
+                } else {
+                    DLBnewBounds(decomp->domBoundZ[i][j], Bnew, valZ[i][j],
+                                 nZdoms, shiftLimit);
+                }
 
 /*
  *              Replace old Z boundaries with new ones
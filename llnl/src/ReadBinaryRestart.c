@@ -307,8 +307,8 @@ void ReadBinDataFile(Home_t *home, InData_t *inData, char *dataFile)
 /*
  *          Do a quick sanity check on the decomposition type
  */
-            if ((param->dataDecompType < 1) || (param->dataDecompType > 2)) {
-                Fatal("dataDecompType=%d is invalid.  Type must be 1 or 2\n",
+            if ((param->dataDecompType < 1) || (param->dataDecompType > 3)) {
+                Fatal("dataDecompType=%d is invalid.  Type must be 1, 2 or 3\n",
                       param->dataDecompType);
             }
 
@@ -572,8 +572,8 @@ void ReadNodeDataFile(Home_t *home, InData_t *inData, char *dataFile)
  *                          Do a quick verification of the decomposition type
  */
                             if ((param->dataDecompType < 1) ||
-                                (param->dataDecompType > 2)) {
-                                Fatal("dataDecompType=%d is invalid.  Type must be 1 or 2\n",
+                                (param->dataDecompType > 3)) {
+                                Fatal("dataDecompType=%d is invalid.  Type must be 1, 2 or 3\n",
                                       param->dataDecompType);
                             }
 
@@ -148,16 +148,38 @@ static void UnpackTagMap(Home_t *home, int *buf)
  *                    since they were retagged (if necessary) during
  *                    the initial node distribution.
  *
+ *                    Only arms pointing to nodes of a domain that
+ *                    appears in the tag map can need retagging, so
+ *                    the search is skipped for all other arms.  The
+ *                    old tags come from the restart file, which may
+ *                    have been written by more domains than this run
+ *                    uses, so the list of such domains is sized by
+ *                    the largest domain ID in the tag map.
+ *
  *------------------------------------------------------------------------*/
 static void RemapArmTags(Home_t *home)
 {
-        int      i, armID, maxNodeKey;
+        int      i, armID, maxNodeKey, numRemapDoms, domID;
+        char     *remapDom;
         Node_t   *node;
         TagMap_t key;
         TagMap_t *mapping;
 
         maxNodeKey = home->newNodeKeyPtr;
 
+        numRemapDoms = 0;
+
+        for (i = 0; i < home->tagMapEnts; i++) {
+            numRemapDoms = MAX(numRemapDoms,
+                               home->tagMap[i].oldTag.domainID + 1);
+        }
+
+        remapDom = (char *)calloc(1, numRemapDoms * sizeof(char));
+
+        for (i = 0; i < home->tagMapEnts; i++) {
+            remapDom[home->tagMap[i].oldTag.domainID] = 1;
+        }
+
         for (i = 0; i < maxNodeKey; i++) {
 
             if ((node = home->nodeKeys[i]) == (Node_t *)NULL) {
@@ -166,6 +188,13 @@ static void RemapArmTags(Home_t *home)
 
             for (armID = 0; armID < node->numNbrs; armID++) {
 
+                domID = node->nbrTag[armID].domainID;
+
+                if ((domID < 0) || (domID >= numRemapDoms) ||
+                    !remapDom[domID]) {
+                    continue;
+                }
+
                 key.oldTag.domainID = node->nbrTag[armID].domainID;
                 key.oldTag.index    = node->nbrTag[armID].index;
 
@@ -184,6 +213,8 @@ static void RemapArmTags(Home_t *home)
             }
         }
 
+        free(remapDom);
+
         return;
 }
 
@@ -17,7 +17,9 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "Home.h"
+#include "Util.h"
 #include "Comm.h"
 #include "Topology.h"
 
@@ -329,6 +331,9 @@ void Remesh(Home_t *home)
         case 3:
             RemeshRule_3(home);
             break;
+        case 4:
+            RemeshRule_4(home);
+            break;
         default:
             Fatal("Remesh: undefined remesh rule %d", param->remeshRule);
             break;
@@ -0,0 +1,688 @@
+/*****************************************************************************
+ *
+ *      Module:         RemeshRule_4.c
+ *      Description:    This module contains functions specific to
+ *                      version 4 remesh for coarsening or refining
+ *                      the mesh topology.  This version adapts the
+ *                      discretization to the local line curvature
+ *                      and to the variation of the force along the
+ *                      line rather than only to segment lengths and
+ *                      triangle areas.
+ *
+ *                      At each 2-node two quantities are evaluated:
+ *
+ *                      - the turning angle of the line at the node
+ *                      - the relative difference between the force per
+ *                        unit length at the node and the value linearly
+ *                        interpolated from the two neighbors.  The force
+ *                        per unit length at the ends of each segment is
+ *                        recovered from the segment forces left by the
+ *                        last force calculation.
+ *
+ *                      A node where both are small (below remeshAngleMin
+ *                      and remeshForceErrMin) sits in a smooth field on
+ *                      a nearly straight line, and is coarsened out as
+ *                      long as the resulting segment is no longer than
+ *                      the usual coarsening limits (see MeshCoarsen()).
+ *                      The segments at a 2-node where the turning angle
+ *                      exceeds remeshAngleMax are bisected if they are at
+ *                      least twice minSeg in length, and where the force
+ *                      error exceeds remeshForceErrMax if they are also
+ *                      at least half of maxSeg.  The minSeg and maxSeg
+ *                      limits and the small-area coarsening of remesh
+ *                      rule 2 still apply.
+ *
+ *      Included functions:
+ *              AdaptiveCoarsenOK()
+ *              BisectArm()
+ *              EvalAdaptiveRefine()
+ *              MeshRefine()
+ *              NodeRemeshMetrics()
+ *              RemeshRule_4()
+ *              SegForceDensity()
+ *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+#include "Home.h"
+#include "Util.h"
+#include "QueueOps.h"
+#include "Mobility.h"
+#include "Remesh.h"
+
+static int dbgDom;
+
+/*
+ *      Refinement decision for a single native node, made before any
+ *      of the refinement for the cycle is done.
+ */
+typedef struct {
+        int   index;       /* nodeKeys index of the node */
+        int   numSplits;   /* number of 2-node arms to bisect */
+        int   checkLength; /* non-zero if the node is not a 2-node */
+                           /* and has an arm longer than maxSeg    */
+        Tag_t nbrTag[2];   /* neighbors at the ends of the 2-node  */
+                           /* arms to bisect                       */
+} RefineOp_t;
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    SegForceDensity
+ *      Description: Recover the force per unit length at both ends
+ *                   of a segment from the segment forces at the two
+ *                   endpoints, assuming the force per unit length
+ *                   varies linearly along the segment.  The self-force
+ *                   of the segment acts at its endpoints rather than
+ *                   along its length, so it is removed first (as in
+ *                   FindSubFSeg()).
+ *
+ *      Arguments:
+ *          node    pointer to the first endpoint
+ *          arm     index of the segment in <node>'s arm list
+ *          nbr     pointer to the second endpoint
+ *          vec     vector from <node> to <nbr>
+ *          len     length of the segment
+ *          q0      array in which to return the force per unit
+ *                  length at <node>
+ *          q1      array in which to return the force per unit
+ *                  length at <nbr>
+ *
+ *      Returns:  1 on success, 0 if the forces are not available
+ *
+ *------------------------------------------------------------------------*/
+static int SegForceDensity(Home_t *home, Node_t *node, int arm, Node_t *nbr,
+                           real8 vec[3], real8 len, real8 q0[3], real8 q1[3])
+{
+        int     nbrArm;
+        real8   f0[3], f1[3], fs0[3], fs1[3];
+        Param_t *param;
+
+        param = home->param;
+
+        nbrArm = GetArmID(home, nbr, node);
+
+        if ((nbrArm < 0) || (len < 1.0e-10)) {
+            return(0);
+        }
+
+        f0[X] = node->armfx[arm];
+        f0[Y] = node->armfy[arm];
+        f0[Z] = node->armfz[arm];
+
+        f1[X] = nbr->armfx[nbrArm];
+        f1[Y] = nbr->armfy[nbrArm];
+        f1[Z] = nbr->armfz[nbrArm];
+
+        SelfForce(0, param->shearModulus, param->pois,
+                  node->burgX[arm], node->burgY[arm], node->burgZ[arm],
+                  node->x, node->y, node->z,
+                  node->x + vec[X], node->y + vec[Y], node->z + vec[Z],
+                  param->rc, param->Ecore, fs0, fs1);
+
+        f0[X] -= fs0[X];
+        f0[Y] -= fs0[Y];
+        f0[Z] -= fs0[Z];
+
+        f1[X] -= fs1[X];
+        f1[Y] -= fs1[Y];
+        f1[Z] -= fs1[Z];
+
+        q0[X] = ((4.0 * f0[X]) - (2.0 * f1[X])) / len;
+        q0[Y] = ((4.0 * f0[Y]) - (2.0 * f1[Y])) / len;
+        q0[Z] = ((4.0 * f0[Z]) - (2.0 * f1[Z])) / len;
+
+        q1[X] = ((4.0 * f1[X]) - (2.0 * f0[X])) / len;
+        q1[Y] = ((4.0 * f1[Y]) - (2.0 * f0[Y])) / len;
+        q1[Z] = ((4.0 * f1[Z]) - (2.0 * f0[Z])) / len;
+
+        return(1);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    NodeRemeshMetrics
+ *      Description: Calculate the turning angle of the line at a 2-node
+ *                   and the relative error in the force per unit length
+ *                   at the node if it were interpolated linearly from
+ *                   its two neighbors.  Nothing is modified, so this
+ *                   may be invoked for many nodes concurrently.
+ *
+ *      Arguments:
+ *          node      pointer to the 2-node
+ *          nbr1      pointer to the neighbor at the end of arm 0
+ *          nbr2      pointer to the neighbor at the end of arm 1
+ *          vec1      vector from <node> to <nbr1>
+ *          vec2      vector from <node> to <nbr2>
+ *          turnAngle location in which to return the turning angle
+ *                    (radians)
+ *          forceErr  location in which to return the relative force
+ *                    error, or -1.0 if the forces on the segments are
+ *                    not current.
+ *
+ *------------------------------------------------------------------------*/
+static void NodeRemeshMetrics(Home_t *home, Node_t *node, Node_t *nbr1,
+                              Node_t *nbr2, real8 vec1[3], real8 vec2[3],
+                              real8 *turnAngle, real8 *forceErr)
+{
+        real8 r1, r2, cosAngle, frac, scale;
+        real8 q1Node[3], q1Nbr[3], q2Node[3], q2Nbr[3];
+        real8 qNode[3], qLin[3], diff[3];
+
+        r1 = sqrt(DotProduct(vec1, vec1));
+        r2 = sqrt(DotProduct(vec2, vec2));
+
+        *forceErr = -1.0;
+
+        if ((r1 < 1.0e-10) || (r2 < 1.0e-10)) {
+            *turnAngle = 0.0;
+            return;
+        }
+
+/*
+ *      A straight line runs from <nbr1> through <node> to <nbr2>,
+ *      so the turning angle is the angle between -vec1 and vec2.
+ */
+        cosAngle = -DotProduct(vec1, vec2) / (r1 * r2);
+        cosAngle = MAX(-1.0, MIN(1.0, cosAngle));
+
+        *turnAngle = acos(cosAngle);
+
+/*
+ *      Forces flagged for recalculation are estimates from earlier
+ *      topological changes and not good enough for this purpose.
+ */
+        if ((node->flags | nbr1->flags | nbr2->flags) & NODE_RESET_FORCES) {
+            return;
+        }
+
+        if (!SegForceDensity(home, node, 0, nbr1, vec1, r1, q1Node, q1Nbr) ||
+            !SegForceDensity(home, node, 1, nbr2, vec2, r2, q2Node, q2Nbr)) {
+            return;
+        }
+
+        frac = r1 / (r1 + r2);
+
+        qNode[X] = 0.5 * (q1Node[X] + q2Node[X]);
+        qNode[Y] = 0.5 * (q1Node[Y] + q2Node[Y]);
+        qNode[Z] = 0.5 * (q1Node[Z] + q2Node[Z]);
+
+        qLin[X] = q1Nbr[X] + frac * (q2Nbr[X] - q1Nbr[X]);
+        qLin[Y] = q1Nbr[Y] + frac * (q2Nbr[Y] - q1Nbr[Y]);
+        qLin[Z] = q1Nbr[Z] + frac * (q2Nbr[Z] - q1Nbr[Z]);
+
+        diff[X] = qNode[X] - qLin[X];
+        diff[Y] = qNode[Y] - qLin[Y];
+        diff[Z] = qNode[Z] - qLin[Z];
+
+        scale = MAX(DotProduct(qNode, qNode), DotProduct(q1Nbr, q1Nbr));
+        scale = MAX(scale, DotProduct(q2Nbr, q2Nbr));
+
+        if (scale < 1.0e-20) {
+            *forceErr = 0.0;
+        } else {
+            *forceErr = sqrt(DotProduct(diff, diff) / scale);
+        }
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    AdaptiveCoarsenOK
+ *      Description: Determine if a 2-node lies in a smooth enough
+ *                   region that remesh rule 4 may coarsen it out
+ *                   regardless of its segment lengths.  Invoked by
+ *                   MeshCoarsen() for nodes that have passed all the
+ *                   other coarsening restrictions, possibly from
+ *                   several threads at once.
+ *
+ *      Arguments:
+ *          node      pointer to the 2-node
+ *          nbr1      pointer to the neighbor at the end of arm 0
+ *          nbr2      pointer to the neighbor at the end of arm 1
+ *          vec1      vector from <node> to <nbr1>
+ *          vec2      vector from <node> to <nbr2>
+ *
+ *      Returns:  1 if the node may be coarsened out, 0 otherwise
+ *
+ *------------------------------------------------------------------------*/
+static int AdaptiveCoarsenOK(Home_t *home, Node_t *node, Node_t *nbr1,
+                             Node_t *nbr2, real8 vec1[3], real8 vec2[3])
+{
+        real8   turnAngle, forceErr;
+        Param_t *param;
+
+        param = home->param;
+
+        NodeRemeshMetrics(home, node, nbr1, nbr2, vec1, vec2,
+                          &turnAngle, &forceErr);
+
+        if ((turnAngle < param->remeshAngleMin) &&
+            (forceErr >= 0.0) && (forceErr < param->remeshForceErrMin)) {
+            return(1);
+        }
+
+        return(0);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    EvalAdaptiveRefine
+ *      Description: Determine which segments of a native node should be
+ *                   bisected this cycle.  Nothing is modified, so this
+ *                   may be invoked for many nodes concurrently.
+ *
+ *      Arguments:
+ *          node   pointer to the node to evaluate
+ *          op     refinement decision for the node.  The caller must
+ *                 have zeroed the <numSplits> and <checkLength> values.
+ *
+ *------------------------------------------------------------------------*/
+static void EvalAdaptiveRefine(Home_t *home, Node_t *node, RefineOp_t *op)
+{
+        int     arm, thisDomain;
+        real8   segLen, minBisect, minForceBisect, maxSeg2;
+        real8   turnAngle, forceErr;
+        real8   vec[2][3];
+        Node_t  *nbr, *nbrs[2];
+        Param_t *param;
+
+        thisDomain = home->myDomain;
+        param      = home->param;
+
+        minBisect      = 2.0 * param->minSeg;
+        minForceBisect = MAX(minBisect, 0.5 * param->maxSeg);
+        maxSeg2        = param->maxSeg * param->maxSeg;
+
+/*
+ *      For nodes with other than exactly two arms, we just bisect any
+ *      owned arm exceeding the max segment length.  Just flag the node
+ *      here; the arm lengths will be checked again as the arms are
+ *      bisected.
+ */
+        if (node->numNbrs != 2) {
+
+            for (arm = 0; arm < node->numNbrs; arm++) {
+
+                nbr = GetNeighborNode(home, node, arm);
+                if (nbr == (Node_t *)NULL) continue;
+
+                if (!DomainOwnsSeg(home, OPCLASS_REMESH, thisDomain,
+                                   &nbr->myTag)) {
+                    continue;
+                }
+
+                vec[0][X] = nbr->x - node->x;
+                vec[0][Y] = nbr->y - node->y;
+                vec[0][Z] = nbr->z - node->z;
+
+                ZImage(param, &vec[0][X], &vec[0][Y], &vec[0][Z]);
+
+                if (DotProduct(vec[0], vec[0]) > maxSeg2) {
+                    op->checkLength = 1;
+                    return;
+                }
+            }
+
+            return;
+        }
+
+        for (arm = 0; arm < 2; arm++) {
+
+            nbrs[arm] = GetNeighborNode(home, node, arm);
+
+            if (nbrs[arm] == (Node_t *)NULL) {
+                printf("WARNING: Neighbor not found at %s line %d\n",
+                       __FILE__, __LINE__);
+                return;
+            }
+
+            vec[arm][X] = nbrs[arm]->x - node->x;
+            vec[arm][Y] = nbrs[arm]->y - node->y;
+            vec[arm][Z] = nbrs[arm]->z - node->z;
+
+            ZImage(param, &vec[arm][X], &vec[arm][Y], &vec[arm][Z]);
+        }
+
+        NodeRemeshMetrics(home, node, nbrs[0], nbrs[1], vec[0], vec[1],
+                          &turnAngle, &forceErr);
+
+        for (arm = 0; arm < 2; arm++) {
+
+            nbr = nbrs[arm];
+
+/*
+ *          Only the domain owning a segment may split it, and if both
+ *          endpoints are flagged to have forces updated, forces and
+ *          velocities may not be good enough to accurately position
+ *          the new node.
+ */
+            if (!DomainOwnsSeg(home, OPCLASS_REMESH, thisDomain,
+                               &nbr->myTag)) {
+                continue;
+            }
+
+            if (((node->flags & NODE_RESET_FORCES) != 0) &&
+                ((nbr->flags & NODE_RESET_FORCES) != 0)) {
+                continue;
+            }
+
+            segLen = sqrt(DotProduct(vec[arm], vec[arm]));
+
+/*
+ *          The force error is measured over the two segments at the
+ *          node, so bisecting them only resolves the field better while
+ *          they are still long.  Limit the force criterion to segments
+ *          of at least half the maximum length so that a noisy force
+ *          field does not drive the discretization down to minSeg.
+ */
+            if ((segLen > param->maxSeg) ||
+                ((segLen >= minBisect) &&
+                 (turnAngle > param->remeshAngleMax)) ||
+                ((segLen >= minForceBisect) &&
+                 (forceErr > param->remeshForceErrMax))) {
+                op->nbrTag[op->numSplits] = nbr->myTag;
+                op->numSplits++;
+            }
+        }
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    BisectArm
+ *      Description: Bisect a segment by splitting the specified node
+ *                   and placing the new node at the segment midpoint.
+ *
+ *      Arguments:
+ *          origNode  Pointer to location containing the pointer to
+ *                    the node to be split.  On return to the caller
+ *                    this will contain a pointer to the node left at
+ *                    the position <origNode> was in on entry.
+ *          nbr       Pointer to node at the end of the segment to
+ *                    be bisected.
+ *          armID     Index of the segment in <origNode>'s arm list
+ *          vec       Vector from <origNode> to <nbr>
+ *
+ *      Returns:  1 if the segment was bisected, 0 if not
+ *
+ *------------------------------------------------------------------------*/
+static int BisectArm(Home_t *home, Node_t **origNode, Node_t *nbr,
+                     int armID, real8 vec[3])
+{
+        int     splitStatus, globalOp, *armList, armCount;
+        real8   newVel[3], newPos[3], nodeVel[3], nodePos[3];
+        real8   f0seg1[3], f0seg2[3], f1seg1[3], f1seg2[3];
+        Node_t  *node, *splitNode1, *splitNode2;
+        Param_t *param;
+#ifdef DEBUG_TOPOLOGY_CHANGES
+        Tag_t   oldTag1, oldTag2;
+#endif
+
+        param = home->param;
+        armList = &armID;
+        armCount = 1;
+        node = *origNode;
+
+        newVel[X] = (node->vX + nbr->vX) * 0.5;
+        newVel[Y] = (node->vY + nbr->vY) * 0.5;
+        newVel[Z] = (node->vZ + nbr->vZ) * 0.5;
+
+        newPos[X] = node->x + (vec[X] * 0.5);
+        newPos[Y] = node->y + (vec[Y] * 0.5);
+        newPos[Z] = node->z + (vec[Z] * 0.5);
+
+        EstRefinementForces(home, node, nbr, newPos, vec,
+                            f0seg1, f1seg1, f0seg2, f1seg2);
+
+        FoldBox(param, &newPos[X], &newPos[Y], &newPos[Z]);
+
+/*
+ *      This should be a global operation distributed out to remote
+ *      domains only if the neighbor node is in another domain.
+ */
+        globalOp = (nbr->myTag.domainID != node->myTag.domainID);
+
+        nodePos[X] = node->x;
+        nodePos[Y] = node->y;
+        nodePos[Z] = node->z;
+
+        nodeVel[X] = node->vX;
+        nodeVel[Y] = node->vY;
+        nodeVel[Z] = node->vZ;
+
+#ifdef DEBUG_TOPOLOGY_CHANGES
+        oldTag1 = node->myTag;
+        oldTag2 = nbr->myTag;
+#endif
+
+        splitStatus = SplitNode(home, OPCLASS_REMESH, node, nodePos, newPos,
+                                nodeVel, newVel, armCount, armList,
+                                globalOp, &splitNode1, &splitNode2, 0);
+
+        if (splitStatus != SPLIT_SUCCESS) {
+            return(0);
+        }
+
+        *origNode = splitNode1;
+
+/*
+ *      The force estimates above are good enough for the remainder of
+ *      this timestep, but mark the force and velocity data for some
+ *      nodes as obsolete so that more accurate forces will be
+ *      recalculated either at the end of this timestep, or the
+ *      beginning of the next.
+ */
+        MarkNodeForceObsolete(home, splitNode1);
+        MarkNodeForceObsolete(home, splitNode2);
+        MarkNodeForceObsolete(home, nbr);
+
+        ResetSegForces(home, splitNode1, &splitNode2->myTag,
+                       f0seg1[X], f0seg1[Y], f0seg1[Z], 1);
+
+        ResetSegForces(home, splitNode2, &splitNode1->myTag,
+                       f1seg1[X], f1seg1[Y], f1seg1[Z], 1);
+
+        ResetSegForces(home, splitNode2, &nbr->myTag,
+                       f0seg2[X], f0seg2[Y], f0seg2[Z], 1);
+
+        ResetSegForces(home, nbr, &splitNode2->myTag,
+                       f1seg2[X], f1seg2[Y], f1seg2[Z], 1);
+
+        (void)EvaluateMobility(home, splitNode1);
+        (void)EvaluateMobility(home, splitNode2);
+        (void)EvaluateMobility(home, nbr);
+
+#ifdef DEBUG_TOPOLOGY_CHANGES
+        if ((dbgDom < 0) || (dbgDom == home->myDomain)) {
+            printf("Remesh/refine4:  (%d,%d)--(%d,%d) ==> "
+                   "(%d,%d)--(%d,%d)--(%d,%d)\n",
+                   oldTag1.domainID, oldTag1.index,
+                   oldTag2.domainID, oldTag2.index,
+                   splitNode1->myTag.domainID, splitNode1->myTag.index,
+                   splitNode2->myTag.domainID, splitNode2->myTag.index,
+                   nbr->myTag.domainID, nbr->myTag.index);
+            PrintNode(splitNode1);
+            PrintNode(splitNode2);
+            PrintNode(nbr);
+        }
+#endif
+
+        return(1);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    MeshRefine
+ *      Description: Bisect segments where the line is too long, too
+ *                   strongly curved, or the force along it varies too
+ *                   much to be represented by the current nodes.
+ *
+ *                   All native nodes are evaluated (threaded) before any
+ *                   segment is bisected, so the curvature and force
+ *                   criteria are always applied to the discretization
+ *                   at the start of the cycle; the new nodes are not
+ *                   reconsidered until the next cycle.  A segment that
+ *                   both of its endpoints want to bisect is bisected
+ *                   only once, since the second endpoint no longer has
+ *                   an arm to the original neighbor.
+ *
+ *------------------------------------------------------------------------*/
+static void MeshRefine(Home_t *home)
+{
+        int        i, k, arm, thisDomain, numNodes, numOps;
+        int        localRefineCnt;
+        real8      maxSeg2, vec[3];
+        Node_t     *node, *nbr;
+        Param_t    *param;
+        RefineOp_t *opList;
+
+        thisDomain = home->myDomain;
+        param      = home->param;
+
+        maxSeg2 = param->maxSeg * param->maxSeg;
+
+        localRefineCnt = 0;
+
+        numNodes = home->newNodeKeyPtr;
+        opList = (RefineOp_t *)malloc((numNodes + 1) * sizeof(RefineOp_t));
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) private(node)
+#endif
+        for (i = 0; i < numNodes; i++) {
+
+            opList[i].index = i;
+            opList[i].numSplits = 0;
+            opList[i].checkLength = 0;
+
+            node = home->nodeKeys[i];
+            if (node == (Node_t *)NULL) continue;
+
+            EvalAdaptiveRefine(home, node, &opList[i]);
+        }
+
+/*
+ *      Compact the list down to the nodes with work to do.
+ */
+        numOps = 0;
+
+        for (i = 0; i < numNodes; i++) {
+            if ((opList[i].numSplits > 0) || opList[i].checkLength) {
+                opList[numOps++] = opList[i];
+            }
+        }
+
+        for (i = 0; i < numOps; i++) {
+
+            node = home->nodeKeys[opList[i].index];
+            if (node == (Node_t *)NULL) continue;
+
+/*
+ *          Bisect the 2-node arms selected above, provided the node
+ *          is still connected to the same neighbor.
+ */
+            for (k = 0; k < opList[i].numSplits; k++) {
+
+                nbr = GetNodeFromTag(home, opList[i].nbrTag[k]);
+                arm = GetArmID(home, node, nbr);
+
+                if (arm < 0) continue;
+
+                vec[X] = nbr->x - node->x;
+                vec[Y] = nbr->y - node->y;
+                vec[Z] = nbr->z - node->z;
+
+                ZImage(param, &vec[X], &vec[Y], &vec[Z]);
+
+                localRefineCnt += BisectArm(home, &node, nbr, arm, vec);
+            }
+
+            if (!opList[i].checkLength) continue;
+
+/*
+ *          Bisect any owned arm exceeding the max segment length.  The
+ *          arm at <arm> is moved to the new node when the segment is
+ *          bisected, so only advance to the next arm if it was not.
+ */
+            for (arm = 0; arm < node->numNbrs; ) {
+
+                nbr = GetNeighborNode(home, node, arm);
+
+                if ((nbr == (Node_t *)NULL) ||
+                    !DomainOwnsSeg(home, OPCLASS_REMESH, thisDomain,
+                                   &nbr->myTag)) {
+                    arm++;
+                    continue;
+                }
+
+                vec[X] = nbr->x - node->x;
+                vec[Y] = nbr->y - node->y;
+                vec[Z] = nbr->z - node->z;
+
+                ZImage(param, &vec[X], &vec[Y], &vec[Z]);
+
+                if ((DotProduct(vec, vec) > maxSeg2) &&
+                    BisectArm(home, &node, nbr, arm, vec)) {
+                    localRefineCnt++;
+                } else {
+                    arm++;
+                }
+            }
+        }
+
+        free(opList);
+
+#ifdef DEBUG_LOG_MESH_REFINE
+        {
+            int globalRefineCnt;
+#ifdef PARALLEL
+            MPI_Reduce(&localRefineCnt, &globalRefineCnt, 1, MPI_INT,
+                       MPI_SUM, 0, MPI_COMM_WORLD);
+#else
+            globalRefineCnt = localRefineCnt;
+#endif
+            if (home->myDomain == 0) {
+                printf("  Remesh: refine count = %d\n", globalRefineCnt);
+            }
+        }
+#endif
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    RemeshRule_4
+ *      Description: Base function which invokes all subroutines
+ *                   needed for handling mesh operations specific
+ *                   to the fourth remesh rule
+ *
+ *------------------------------------------------------------------------*/
+void RemeshRule_4(Home_t *home)
+{
+
+#ifdef DEBUG_TOPOLOGY_DOMAIN
+        dbgDom = DEBUG_TOPOLOGY_DOMAIN;
+#else
+        dbgDom = -1;
+#endif
+
+/*
+ *      MeshCoarsen() adds the smooth-region criteria of this rule
+ *      (see AdaptiveCoarsenOK()) to the usual ones.
+ */
+        MeshCoarsen(home, AdaptiveCoarsenOK);
+        MeshRefine(home);
+
+        return;
+}
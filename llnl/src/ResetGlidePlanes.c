@@ -30,8 +30,13 @@ void ResetGlidePlanes(Home_t *home)
  
 /*
  *      Loop through all the nodes looking for segments owned
- *      by the local domain.
+ *      by the local domain.  Each segment is only handled from one
+ *      end, so no two threads update the glide plane of the same arm.
  */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) \
+        private(j, nbrSegID, numNbrs, lDir, burg, newPlane, node, nbrNode)
+#endif
         for (i = 0; i < numNodes; i++) {
 
             if ((node = home->nodeKeys[i]) == (Node_t *)NULL) {
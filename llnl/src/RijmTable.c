@@ -0,0 +1,295 @@
+/***************************************************************************
+ *
+ *      Module:       RijmTable.c
+ *      Description:  Contains functions for allocating, reading,
+ *                    memory mapping and writing the Rijm image stress
+ *                    tables.  See RijmTable.h for a description of the
+ *                    binary table format.
+ *
+ *      Includes public functions:
+ *          RijmTableAlloc()
+ *          RijmTableFree()
+ *          RijmTableIsBinary()
+ *          RijmTableMapBinary()
+ *          RijmTableReadText()
+ *          RijmTableWriteBinary()
+ *
+ *      Includes private functions:
+ *          RijmTableSetGeometry()
+ *
+ **************************************************************************/
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include "Home.h"
+#include "Util.h"
+#include "RijmTable.h"
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     RijmTableSetGeometry
+ *      Description:  Set the grid size and the number of bricks in each
+ *                    dimension and the total number of values needed
+ *                    to hold the brick-ordered table.
+ *
+ *-------------------------------------------------------------------------*/
+static void RijmTableSetGeometry(RijmTable_t *tbl, int gridSize[3])
+{
+        int i;
+
+        tbl->dataLen = RIJM_BRICK_VOL * RIJM_NUM_COMP;
+
+        for (i = 0; i < 3; i++) {
+            tbl->gridSize[i] = gridSize[i];
+            tbl->numBricks[i] = (gridSize[i] + RIJM_BRICK - 1) / RIJM_BRICK;
+            tbl->dataLen *= tbl->numBricks[i];
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     RijmTableAlloc
+ *      Description:  Allocate a zeroed heap table for a grid of the
+ *                    specified size.
+ *
+ *-------------------------------------------------------------------------*/
+void RijmTableAlloc(RijmTable_t *tbl, int gridSize[3])
+{
+        RijmTableSetGeometry(tbl, gridSize);
+
+        tbl->data = (real8 *)calloc(1, tbl->dataLen * sizeof(real8));
+        tbl->mapAddr = (void *)NULL;
+        tbl->mapLen = 0;
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     RijmTableFree
+ *      Description:  Release the table data, unmapping the table file
+ *                    if the table was memory mapped.
+ *
+ *-------------------------------------------------------------------------*/
+void RijmTableFree(RijmTable_t *tbl)
+{
+        if (tbl->mapAddr != (void *)NULL) {
+            munmap(tbl->mapAddr, tbl->mapLen);
+            tbl->mapAddr = (void *)NULL;
+            tbl->mapLen = 0;
+        } else if (tbl->data != (real8 *)NULL) {
+            free(tbl->data);
+        }
+
+        tbl->data = (real8 *)NULL;
+        tbl->dataLen = 0;
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     RijmTableIsBinary
+ *      Description:  Determine if the specified file is a binary
+ *                    Rijm table.
+ *
+ *      Returns:  1 if the file begins with the binary table signature
+ *                0 in all other cases
+ *
+ *-------------------------------------------------------------------------*/
+int RijmTableIsBinary(char *fileName)
+{
+        char magic[8];
+        FILE *fp;
+
+        if ((fp = fopen(fileName, "r")) == (FILE *)NULL) {
+            return(0);
+        }
+
+        memset(magic, 0, sizeof(magic));
+        fread(magic, 1, sizeof(magic), fp);
+        fclose(fp);
+
+        return(strncmp(magic, RIJM_TABLE_MAGIC, sizeof(magic)) == 0);
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     RijmTableMapBinary
+ *      Description:  Map a binary Rijm table file read-only into memory.
+ *                    Since the mapping is shared and read-only, the
+ *                    operating system keeps a single copy of the
+ *                    table data for all processes on a node mapping
+ *                    the same file.
+ *
+ *      Returns:  1 on success, 0 if the file could not be mapped.
+ *                Fatal errors are generated for an invalid file.
+ *
+ *-------------------------------------------------------------------------*/
+int RijmTableMapBinary(char *fileName, RijmTable_t *tbl)
+{
+        int               fd;
+        size_t            expectedLen;
+        void              *addr;
+        struct stat       statBuf;
+        RijmTableHeader_t *header;
+
+        if ((fd = open(fileName, O_RDONLY)) < 0) {
+            return(0);
+        }
+
+        if (fstat(fd, &statBuf) != 0) {
+            close(fd);
+            return(0);
+        }
+
+        if (statBuf.st_size < RIJM_HEADER_BYTES) {
+            close(fd);
+            Fatal("RijmTableMapBinary: %s is not a valid Rijm table",
+                  fileName);
+        }
+
+        addr = mmap((void *)NULL, (size_t)statBuf.st_size, PROT_READ,
+                    MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (addr == MAP_FAILED) {
+            return(0);
+        }
+
+        header = (RijmTableHeader_t *)addr;
+
+        if ((strncmp(header->magic, RIJM_TABLE_MAGIC,
+                     sizeof(header->magic)) != 0) ||
+            (header->version != RIJM_TABLE_VERSION) ||
+            (header->brickSize != RIJM_BRICK)) {
+            munmap(addr, (size_t)statBuf.st_size);
+            Fatal("RijmTableMapBinary: %s has unsupported format "
+                  "(version %d, brick size %d)", fileName,
+                  header->version, header->brickSize);
+        }
+
+        RijmTableSetGeometry(tbl, header->gridSize);
+
+        expectedLen = RIJM_HEADER_BYTES + tbl->dataLen * sizeof(real8);
+
+        if ((size_t)statBuf.st_size < expectedLen) {
+            munmap(addr, (size_t)statBuf.st_size);
+            Fatal("RijmTableMapBinary: %s is truncated (%lu of %lu bytes)",
+                  fileName, (unsigned long)statBuf.st_size,
+                  (unsigned long)expectedLen);
+        }
+
+        VECTOR_COPY(tbl->numImages, header->numImages);
+        VECTOR_COPY(tbl->boxSize, header->boxSize);
+
+        tbl->mapAddr = addr;
+        tbl->mapLen = (size_t)statBuf.st_size;
+        tbl->data = (real8 *)((char *)addr + RIJM_HEADER_BYTES);
+
+        return(1);
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     RijmTableReadText
+ *      Description:  Read a text format Rijm table (as generated by
+ *                    StressTableGen) into a newly allocated heap table.
+ *
+ *-------------------------------------------------------------------------*/
+void RijmTableReadText(char *fileName, RijmTable_t *tbl)
+{
+        int  i, j, k, m, offset;
+        int  gridSize[3], numImages[3];
+        real8 boxSize[3];
+        FILE *fp;
+
+        if ((fp = fopen(fileName, "r")) == (FILE *)NULL) {
+            Fatal("RijmTableReadText: Open error %d on %s", errno, fileName);
+        }
+
+        if ((fscanf(fp, "%d %d %d", &gridSize[0], &gridSize[1],
+                    &gridSize[2]) != 3) ||
+            (fscanf(fp, "%le %le %le", &boxSize[0], &boxSize[1],
+                    &boxSize[2]) != 3) ||
+            (fscanf(fp, "%d %d %d", &numImages[0], &numImages[1],
+                    &numImages[2]) != 3)) {
+            Fatal("RijmTableReadText: Error reading header of %s", fileName);
+        }
+
+        RijmTableAlloc(tbl, gridSize);
+
+        VECTOR_COPY(tbl->numImages, numImages);
+        VECTOR_COPY(tbl->boxSize, boxSize);
+
+        for (i = 0; i < gridSize[0]; i++) {
+            for (j = 0; j < gridSize[1]; j++) {
+                for (k = 0; k < gridSize[2]; k++) {
+                    offset = RIJM_TABLE_OFFSET(tbl, i, j, k);
+                    for (m = 0; m < RIJM_NUM_COMP; m++) {
+                        if (fscanf(fp, "%le\n", &tbl->data[offset+m]) != 1) {
+                            Fatal("RijmTableReadText: Premature EOF on %s",
+                                  fileName);
+                        }
+                    }
+                }
+            }
+        }
+
+        fclose(fp);
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     RijmTableWriteBinary
+ *      Description:  Write the table to the specified file in the
+ *                    binary format that may be memory mapped by
+ *                    RijmTableMapBinary().
+ *
+ *-------------------------------------------------------------------------*/
+void RijmTableWriteBinary(char *fileName, RijmTable_t *tbl)
+{
+        char              headerBuf[RIJM_HEADER_BYTES];
+        FILE              *fp;
+        RijmTableHeader_t *header;
+
+        memset(headerBuf, 0, sizeof(headerBuf));
+
+        header = (RijmTableHeader_t *)headerBuf;
+
+        strncpy(header->magic, RIJM_TABLE_MAGIC, sizeof(header->magic));
+        header->version = RIJM_TABLE_VERSION;
+        header->brickSize = RIJM_BRICK;
+
+        VECTOR_COPY(header->gridSize, tbl->gridSize);
+        VECTOR_COPY(header->numImages, tbl->numImages);
+        VECTOR_COPY(header->boxSize, tbl->boxSize);
+
+        if ((fp = fopen(fileName, "w")) == (FILE *)NULL) {
+            Fatal("RijmTableWriteBinary: Open error %d on %s",
+                  errno, fileName);
+        }
+
+        if ((fwrite(headerBuf, 1, RIJM_HEADER_BYTES, fp) != RIJM_HEADER_BYTES) ||
+            (fwrite(tbl->data, sizeof(real8), tbl->dataLen, fp) !=
+             (size_t)tbl->dataLen)) {
+            Fatal("RijmTableWriteBinary: Write error %d on %s",
+                  errno, fileName);
+        }
+
+        fclose(fp);
+
+        return;
+}
@@ -0,0 +1,1039 @@
+/****************************************************************************
+ *
+ *      Module:      SFCDecomp.c
+ *      Description: Contains functions needed for both generating and
+ *                   accessing a domain decomposition based on a
+ *                   space-filling curve.
+ *
+ *                   The simulation cells are ordered along a Hilbert
+ *                   curve and each domain is assigned a contiguous
+ *                   range of that ordering.  Because the Hilbert curve
+ *                   preserves locality, the cells in a range form a
+ *                   compact region, but unlike the recursive sectioning
+ *                   and bisection decompositions, the regions are not
+ *                   restricted to boxes and can follow the load much
+ *                   more closely when it is concentrated in a small
+ *                   part of the problem space.  Rebalancing simply
+ *                   slides the range boundaries along the curve.
+ *
+ *                   For non power-of-two cell geometries the curve is
+ *                   generated in the enclosing power-of-two cube and
+ *                   the cells are ordered by their position along it.
+ *
+ *                   The rest of the code deals with axis-aligned domain
+ *                   boundaries, so the bounds of each domain are taken
+ *                   to be the bounding box of the cells it owns.  The
+ *                   boxes of neighboring domains may overlap, which only
+ *                   means some domains have additional native cells that
+ *                   contain no native nodes.  Ownership of a point is
+ *                   always decided by the cell containing it.
+ *
+ *                   Granularity of the decomposition is a single cell,
+ *                   so the cell geometry should provide at least several
+ *                   cells per domain for effective load-balancing.
+ *
+ *      Includes public functions:
+ *          BroadcastSFCDecomp()
+ *          FindSFCDecompCoordDomain()
+ *          FreeSFCDecomp()
+ *          GetAllSFCDecompBounds()
+ *          GetSFCDecompCellDomainList()
+ *          GetSFCDecompLocalDomainBounds()
+ *          ReadBinSFCDecompBounds()
+ *          ReadSFCDecompBounds()
+ *          SFCRebalance()
+ *          UniformSFCDecomp()
+ *          WriteSFCDecompBounds()
+ *          XPlotSFCDecomp()
+ *
+ *      Includes private functions:
+ *          AllocSFCDecomp()
+ *          CellBoundary()
+ *          CoordToCell()
+ *          HilbertKey()
+ *          SetSFCDecompBounds()
+ *          SFCKeyCmp()
+ *
+ ***************************************************************************/
+#include "Home.h"
+#include "Decomp.h"
+#include "SFCDecomp.h"
+#include "Restart.h"
+#include "DisplayC.h"
+
+#ifdef USE_HDF
+#include "hdf5.h"
+#endif
+
+/*
+ *      Minimum imbalance ((max - avg) / avg) of the per-process load
+ *      needed before the decomposition will be rebalanced.
+ */
+#define SFC_IMBALANCE_THRESHOLD 0.05
+
+/*
+ *      Define an increment size by which the list of domains
+ *      intersecting a cell will be increased when determining
+ *      cell/domain intersection lists.
+ */
+#define DOMAIN_CNT_INCREMENT 20
+
+typedef struct {
+        long long key;
+        int       cellID;
+} SFCKey_t;
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    HilbertKey
+ *      Description: Return the distance along a 3D Hilbert curve
+ *                   of order <bits> of the point with the specified
+ *                   integer coordinates.  Uses the algorithm of
+ *                   J. Skilling, "Programming the Hilbert curve",
+ *                   AIP Conf. Proc. 707, 381 (2004).
+ *
+ *      Arguments:
+ *          coord  Integer coordinates, each in the range 0 to
+ *                 (2^bits)-1.
+ *          bits   Number of bits per coordinate.
+ *
+ *-------------------------------------------------------------------------*/
+static long long HilbertKey(int coord[3], int bits)
+{
+        int          i, q;
+        unsigned int x[3], m, p, t;
+        long long    key;
+
+        for (i = 0; i < 3; i++) {
+            x[i] = (unsigned int)coord[i];
+        }
+
+        m = 1U << (bits - 1);
+
+/*
+ *      Inverse undo
+ */
+        for (q = m; q > 1; q >>= 1) {
+            p = q - 1;
+            for (i = 0; i < 3; i++) {
+                if (x[i] & q) {
+                    x[0] ^= p;
+                } else {
+                    t = (x[0] ^ x[i]) & p;
+                    x[0] ^= t;
+                    x[i] ^= t;
+                }
+            }
+        }
+
+/*
+ *      Gray encode
+ */
+        for (i = 1; i < 3; i++) {
+            x[i] ^= x[i-1];
+        }
+
+        t = 0;
+
+        for (q = m; q > 1; q >>= 1) {
+            if (x[2] & q) t ^= q - 1;
+        }
+
+        for (i = 0; i < 3; i++) {
+            x[i] ^= t;
+        }
+
+/*
+ *      The curve distance is the bits of the transposed coordinates
+ *      interleaved, most significant first.
+ */
+        key = 0;
+
+        for (q = bits - 1; q >= 0; q--) {
+            for (i = 0; i < 3; i++) {
+                key = (key << 1) | (long long)((x[i] >> q) & 1);
+            }
+        }
+
+        return(key);
+}
+
+
+static int SFCKeyCmp(const void *a, const void *b)
+{
+        const SFCKey_t *keyA = (const SFCKey_t *)a;
+        const SFCKey_t *keyB = (const SFCKey_t *)b;
+
+        if (keyA->key < keyB->key) return(-1);
+        if (keyA->key > keyB->key) return(1);
+
+        return(0);
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    CellBoundary
+ *      Description: Return the coordinate of the lower boundary of the
+ *                   cell with (zero-based) index <index> in the given
+ *                   dimension.  The first and last boundaries are the
+ *                   problem space boundaries; interior boundaries are
+ *                   computed exactly as GetRBDecompCellDomainList() and
+ *                   InitCellNatives() do so the domain bounds fall
+ *                   precisely on the boundaries of the native cells.
+ *
+ *-------------------------------------------------------------------------*/
+static real8 CellBoundary(Param_t *param, int dim, int index)
+{
+        real8 minSide, maxSide;
+        int   numCells;
+
+        switch (dim) {
+        case X:
+            minSide = param->minSideX;
+            maxSide = param->maxSideX;
+            numCells = param->nXcells;
+            break;
+        case Y:
+            minSide = param->minSideY;
+            maxSide = param->maxSideY;
+            numCells = param->nYcells;
+            break;
+        default:
+            minSide = param->minSideZ;
+            maxSide = param->maxSideZ;
+            numCells = param->nZcells;
+            break;
+        }
+
+        if (index <= 0) return(minSide);
+        if (index >= numCells) return(maxSide);
+
+        return(rint(minSide + index * ((maxSide - minSide) / numCells)));
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    CoordToCell
+ *      Description: Return the ID (as defined for SFCDecomp_t) of the
+ *                   primary cell containing the specified coordinates.
+ *                   Coordinates outside the problem space are treated
+ *                   as belonging to the closest cell.
+ *
+ *-------------------------------------------------------------------------*/
+static int CoordToCell(Param_t *param, SFCDecomp_t *decomp, real8 pos[3])
+{
+        int   d, index[3];
+        real8 minSide[3], maxSide[3];
+
+        minSide[X] = param->minSideX;  maxSide[X] = param->maxSideX;
+        minSide[Y] = param->minSideY;  maxSide[Y] = param->maxSideY;
+        minSide[Z] = param->minSideZ;  maxSide[Z] = param->maxSideZ;
+
+        for (d = 0; d < 3; d++) {
+
+            index[d] = (int)floor((pos[d] - minSide[d]) /
+                                  (maxSide[d] - minSide[d]) *
+                                  decomp->cellGeom[d]);
+
+            index[d] = MAX(0, MIN(decomp->cellGeom[d]-1, index[d]));
+
+/*
+ *          Interior cell boundaries are rounded, so the cell computed
+ *          above may be off by one near a boundary.
+ */
+            if ((index[d] > 0) &&
+                (pos[d] < CellBoundary(param, d, index[d]))) {
+                index[d]--;
+            } else if ((index[d] < decomp->cellGeom[d]-1) &&
+                       (pos[d] >= CellBoundary(param, d, index[d]+1))) {
+                index[d]++;
+            }
+        }
+
+        return((index[X] * decomp->cellGeom[Y] + index[Y]) *
+               decomp->cellGeom[Z] + index[Z]);
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    SetSFCDecompBounds
+ *      Description: Set the bounding box of every domain from the
+ *                   current curve ranges.
+ *
+ *-------------------------------------------------------------------------*/
+static void SetSFCDecompBounds(Param_t *param, SFCDecomp_t *decomp)
+{
+        int d, dom, pos, cellID, index[3], minIndex[3], maxIndex[3];
+
+        for (dom = 0; dom < decomp->numDomains; dom++) {
+
+            for (d = 0; d < 3; d++) {
+                minIndex[d] = decomp->cellGeom[d];
+                maxIndex[d] = -1;
+            }
+
+            for (pos = decomp->domStart[dom]; pos < decomp->domStart[dom+1];
+                 pos++) {
+
+                cellID = decomp->cellOrder[pos];
+
+                index[X] = cellID / (decomp->cellGeom[Y] * decomp->cellGeom[Z]);
+                index[Y] = (cellID / decomp->cellGeom[Z]) % decomp->cellGeom[Y];
+                index[Z] = cellID % decomp->cellGeom[Z];
+
+                for (d = 0; d < 3; d++) {
+                    minIndex[d] = MIN(minIndex[d], index[d]);
+                    maxIndex[d] = MAX(maxIndex[d], index[d]);
+                }
+            }
+
+            for (d = 0; d < 3; d++) {
+                decomp->domBounds[dom*6+d]   = CellBoundary(param, d,
+                                                            minIndex[d]);
+                decomp->domBounds[dom*6+3+d] = CellBoundary(param, d,
+                                                            maxIndex[d]+1);
+            }
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    AllocSFCDecomp
+ *      Description: Allocate a new decomposition for the current domain
+ *                   and cell geometry and calculate the order of the
+ *                   cells along the curve.  The domain ranges are
+ *                   left uninitialized.
+ *
+ *-------------------------------------------------------------------------*/
+static SFCDecomp_t *AllocSFCDecomp(Param_t *param)
+{
+        int         i, j, k, bits, maxCells, cellID, coord[3];
+        SFCKey_t    *keys;
+        SFCDecomp_t *decomp;
+
+        decomp = (SFCDecomp_t *)calloc(1, sizeof(SFCDecomp_t));
+
+        decomp->cellGeom[X] = param->nXcells;
+        decomp->cellGeom[Y] = param->nYcells;
+        decomp->cellGeom[Z] = param->nZcells;
+
+        decomp->numCells = param->nXcells * param->nYcells * param->nZcells;
+        decomp->numDomains = param->nXdoms * param->nYdoms * param->nZdoms;
+
+        if (decomp->numCells < decomp->numDomains) {
+            Fatal("Space-filling curve decomposition requires at least\n"
+                  "    one cell per domain: %d cells, %d domains",
+                  decomp->numCells, decomp->numDomains);
+        }
+
+        decomp->domStart  = (int *)malloc((decomp->numDomains+1) *
+                                          sizeof(int));
+        decomp->cellOrder = (int *)malloc(decomp->numCells * sizeof(int));
+        decomp->cellRank  = (int *)malloc(decomp->numCells * sizeof(int));
+        decomp->domBounds = (real8 *)malloc(decomp->numDomains * 6 *
+                                            sizeof(real8));
+
+/*
+ *      Find the order of the smallest power-of-two cube enclosing
+ *      the cell geometry
+ */
+        maxCells = MAX(param->nXcells, MAX(param->nYcells, param->nZcells));
+
+        for (bits = 1; (1 << bits) < maxCells; bits++);
+
+        keys = (SFCKey_t *)malloc(decomp->numCells * sizeof(SFCKey_t));
+
+        for (i = 0; i < param->nXcells; i++) {
+            coord[X] = i;
+            for (j = 0; j < param->nYcells; j++) {
+                coord[Y] = j;
+                for (k = 0; k < param->nZcells; k++) {
+                    coord[Z] = k;
+                    cellID = (i * param->nYcells + j) * param->nZcells + k;
+                    keys[cellID].key = HilbertKey(coord, bits);
+                    keys[cellID].cellID = cellID;
+                }
+            }
+        }
+
+        qsort(keys, decomp->numCells, sizeof(SFCKey_t), SFCKeyCmp);
+
+        for (i = 0; i < decomp->numCells; i++) {
+            decomp->cellOrder[i] = keys[i].cellID;
+            decomp->cellRank[keys[i].cellID] = i;
+        }
+
+        free(keys);
+
+        return(decomp);
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    UniformSFCDecomp
+ *      Description: Generate a decomposition in which each domain
+ *                   owns the same number of cells (to within one).
+ *
+ *      Arguments:
+ *          uniDecomp  Location in which to return to the caller a
+ *                     pointer to the new decomposition.
+ *
+ *-------------------------------------------------------------------------*/
+void UniformSFCDecomp(Param_t *param, SFCDecomp_t **uniDecomp)
+{
+        int         dom;
+        SFCDecomp_t *decomp;
+
+        decomp = AllocSFCDecomp(param);
+
+        for (dom = 0; dom <= decomp->numDomains; dom++) {
+            decomp->domStart[dom] = (int)(((long long)decomp->numCells * dom) /
+                                          decomp->numDomains);
+        }
+
+        SetSFCDecompBounds(param, decomp);
+
+        *uniDecomp = decomp;
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    FreeSFCDecomp
+ *      Description: Free all arrays associated with the decomposition
+ *                   as well as the decomposition structure itself.
+ *
+ *-------------------------------------------------------------------------*/
+void FreeSFCDecomp(SFCDecomp_t *decomp)
+{
+        if (decomp == (SFCDecomp_t *)NULL) {
+            return;
+        }
+
+        free(decomp->domStart);
+        free(decomp->cellOrder);
+        free(decomp->cellRank);
+        free(decomp->domBounds);
+        free(decomp);
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    GetSFCDecompLocalDomainBounds
+ *      Description: Copy the bounding box of the local domain into
+ *                   the <home> structure.
+ *
+ *      Arguments:
+ *          decomp  Pointer to current domain decomposition
+ *
+ *--------------------------------------------------------------------------*/
+void GetSFCDecompLocalDomainBounds(Home_t *home, SFCDecomp_t *decomp)
+{
+        real8 *bounds;
+
+        bounds = &decomp->domBounds[home->myDomain * 6];
+
+        home->domXmin = bounds[0];
+        home->domYmin = bounds[1];
+        home->domZmin = bounds[2];
+
+        home->domXmax = bounds[3];
+        home->domYmax = bounds[4];
+        home->domZmax = bounds[5];
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    FindSFCDecompCoordDomain
+ *      Description: Determines the ID of the domain which owns the
+ *                   cell containing the specified coordinate.
+ *
+ *      Returns:  ID of the owning domain.  Coordinates outside the
+ *                problem space are assigned to the domain owning the
+ *                closest cell.
+ *
+ *-------------------------------------------------------------------------*/
+int FindSFCDecompCoordDomain(Home_t *home, SFCDecomp_t *decomp, real8 x,
+                             real8 y, real8 z)
+{
+        int   rank, lo, hi, mid;
+        real8 pos[3];
+
+        if (decomp == (SFCDecomp_t *)NULL) {
+            return(-1);
+        }
+
+        pos[X] = x;
+        pos[Y] = y;
+        pos[Z] = z;
+
+        rank = decomp->cellRank[CoordToCell(home->param, decomp, pos)];
+
+/*
+ *      Binary search for the last domain whose range starts at or
+ *      before the cell's position on the curve.
+ */
+        lo = 0;
+        hi = decomp->numDomains - 1;
+
+        while (lo < hi) {
+            mid = (lo + hi + 1) / 2;
+            if (decomp->domStart[mid] <= rank) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+
+        return(lo);
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     GetSFCDecompCellDomainList
+ *      Description:  Find out what domains intersect the specified cell
+ *                    return a pointer to the list of domains to the caller
+ *                    along with a count of the number of domains on the
+ *                    returned list.  A domain intersects the cell if the
+ *                    cell is within the domain's bounding box.
+ *
+ *      Arguments:
+ *          cellID     ID of the cell as returned by EncodeCellIdx()
+ *          domainCnt  location in which to return the count of domains
+ *                     intersecting the specified celll
+ *          domainList location in which to return an array containing
+ *                     the IDs of all domains intersecting the specified
+ *                     cell.
+ *
+ *--------------------------------------------------------------------------*/
+void GetSFCDecompCellDomainList(Home_t *home, int cellID, int *domainCnt,
+                                int **domainList)
+{
+        int         dom, domainListEnts;
+        int         xCell, yCell, zCell;
+        real8       xCellSize, yCellSize, zCellSize;
+        real8       vMin[3], vMax[3], *bounds;
+        Param_t     *param;
+        Cell_t      *cell;
+        SFCDecomp_t *decomp;
+
+        param  = home->param;
+        decomp = (SFCDecomp_t *)home->decomp;
+
+/*
+ *      Get the indices of the cell from the cell struct if we have
+ *      it, otherwise calculate it.
+ */
+        cell = home->cellKeys[cellID];
+
+        if (cell != (Cell_t *)NULL) {
+            xCell = cell->xIndex;
+            yCell = cell->yIndex;
+            zCell = cell->zIndex;
+        } else {
+            DecodeCellIdx(home, cellID, &xCell, &yCell, &zCell);
+        }
+
+/*
+ *      Get the min and max coordinates for this cell...
+ *
+ *      WARNING: The cell min and max coordinate values must be
+ *      computed in the same manner or neighboring domains can end
+ *      up with slightly different locations for a shared cell
+ *      boundary (due to numeric round-off.)
+ */
+        xCellSize = (param->maxSideX - param->minSideX) / param->nXcells;
+        yCellSize = (param->maxSideY - param->minSideY) / param->nYcells;
+        zCellSize = (param->maxSideZ - param->minSideZ) / param->nZcells;
+
+        vMin[X] = rint((param->minSideX) + ((xCell-1) * xCellSize));
+        vMin[Y] = rint((param->minSideY) + ((yCell-1) * yCellSize));
+        vMin[Z] = rint((param->minSideZ) + ((zCell-1) * zCellSize));
+
+        vMax[X] = rint((param->minSideX) + (xCell * xCellSize));
+        vMax[Y] = rint((param->minSideY) + (yCell * yCellSize));
+        vMax[Z] = rint((param->minSideZ) + (zCell * zCellSize));
+
+        *domainCnt = 0;
+        domainListEnts = DOMAIN_CNT_INCREMENT;
+        *domainList = (int *)malloc(domainListEnts * sizeof(int));
+
+        for (dom = 0; dom < decomp->numDomains; dom++) {
+
+            bounds = &decomp->domBounds[dom * 6];
+
+            if ((bounds[0] >= vMax[X]) || (bounds[3] <= vMin[X]) ||
+                (bounds[1] >= vMax[Y]) || (bounds[4] <= vMin[Y]) ||
+                (bounds[2] >= vMax[Z]) || (bounds[5] <= vMin[Z])) {
+                continue;
+            }
+
+            (*domainList)[*domainCnt] = dom;
+            *domainCnt += 1;
+
+            if (*domainCnt >= domainListEnts) {
+                domainListEnts += DOMAIN_CNT_INCREMENT;
+                *domainList = (int *)realloc(*domainList,
+                                             domainListEnts * sizeof(int));
+            }
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     GetAllSFCDecompBounds
+ *      Description:  Build a simple array describing the decomposition.
+ *                    The array contains the cell geometry followed by
+ *                    the numDomains+1 curve positions at which the
+ *                    domain ranges start.
+ *
+ *      Arguments:
+ *          decomp     pointer to the current domain decomposition.
+ *          boundsBuf  Array into which to store the data.  This array
+ *                     must be large enough to hold numDomains+4 values.
+ *
+ *--------------------------------------------------------------------------*/
+void GetAllSFCDecompBounds(Home_t *home, SFCDecomp_t *decomp, real8 *boundsBuf)
+{
+        int dom;
+
+        boundsBuf[0] = (real8)decomp->cellGeom[X];
+        boundsBuf[1] = (real8)decomp->cellGeom[Y];
+        boundsBuf[2] = (real8)decomp->cellGeom[Z];
+
+        for (dom = 0; dom <= decomp->numDomains; dom++) {
+            boundsBuf[3+dom] = (real8)decomp->domStart[dom];
+        }
+
+        return;
+}
+
+
+/*------------------------------------------------------------------------
+ *
+ *      Function:       BroadcastSFCDecomp
+ *      Description:    Have task zero broadcast a domain decomposition
+ *                      to all other tasks.  The domain decomposition
+ *                      in home->decomp will be created from this
+ *                      broadcast data before control is returned
+ *                      to the caller.  Only the domain ranges are
+ *                      sent; the cell order is recomputed locally.
+ *
+ *      Arguments:
+ *          decomp   Pointer to decomposition to be broadcast from domain
+ *                   zero to all other domains. Pointer is NULL or
+ *                   uninitialized on all tasks but zero.
+ *
+ *-----------------------------------------------------------------------*/
+void BroadcastSFCDecomp(Home_t *home, SFCDecomp_t *decomp)
+{
+        SFCDecomp_t *inDecomp;
+
+        inDecomp = AllocSFCDecomp(home->param);
+
+        if (home->myDomain == 0) {
+            memcpy(inDecomp->domStart, decomp->domStart,
+                   (inDecomp->numDomains+1) * sizeof(int));
+        }
+
+#ifdef PARALLEL
+        MPI_Bcast(inDecomp->domStart, inDecomp->numDomains+1, MPI_INT,
+                  0, MPI_COMM_WORLD);
+#endif
+
+        SetSFCDecompBounds(home->param, inDecomp);
+
+        home->decomp = (void *)inDecomp;
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    SFCRebalance
+ *      Description: Move the domain ranges along the curve so that
+ *                   each domain gets an equal share of the load.  The
+ *                   load per cell is taken from the global cell load
+ *                   histogram if available, otherwise each domain's
+ *                   load is assumed to be spread evenly over its cells.
+ *
+ *                   The new ranges are computed by task zero and
+ *                   broadcast so all tasks are guaranteed to agree.
+ *
+ *      Arguments:
+ *          loadData  Array containing the current load of each domain
+ *
+ *      Returns:  1 if the decomposition was changed, 0 otherwise
+ *
+ *-------------------------------------------------------------------------*/
+int SFCRebalance(Home_t *home, real8 *loadData)
+{
+        int         i, dom, pos, numCells, numDomains, changed;
+        int         minStart, maxStart, *newStart;
+        real8       maxLoad, avgLoad, target;
+        real8       *cellLoad, *sumLoad;
+        SFCDecomp_t *decomp;
+
+        decomp = (SFCDecomp_t *)home->decomp;
+
+        numCells   = decomp->numCells;
+        numDomains = decomp->numDomains;
+
+        maxLoad = 0.0;
+        avgLoad = 0.0;
+
+        for (dom = 0; dom < numDomains; dom++) {
+            maxLoad = MAX(maxLoad, loadData[dom]);
+            avgLoad += loadData[dom];
+        }
+
+        avgLoad /= numDomains;
+
+        if ((avgLoad <= 0.0) ||
+            ((maxLoad - avgLoad) / avgLoad < SFC_IMBALANCE_THRESHOLD)) {
+            return(0);
+        }
+
+        newStart = (int *)malloc((numDomains+1) * sizeof(int));
+
+        if (home->myDomain == 0) {
+
+            cellLoad = (real8 *)calloc(1, numCells * sizeof(real8));
+            sumLoad = (real8 *)malloc((numCells+1) * sizeof(real8));
+
+            if (home->cellLoad != (real8 *)NULL) {
+                for (i = 0; i < numCells; i++) {
+                    for (pos = home->cellLoadIndex[i];
+                         pos < home->cellLoadIndex[i+1]; pos++) {
+                        cellLoad[i] += home->cellLoad[pos * DLB_PIECE_SIZE];
+                    }
+                }
+            } else {
+                for (dom = 0; dom < numDomains; dom++) {
+                    for (pos = decomp->domStart[dom];
+                         pos < decomp->domStart[dom+1]; pos++) {
+                        cellLoad[decomp->cellOrder[pos]] += loadData[dom] /
+                                (decomp->domStart[dom+1] -
+                                 decomp->domStart[dom]);
+                    }
+                }
+            }
+
+/*
+ *          Cumulative load along the curve; sumLoad[n] is the load of
+ *          the first n cells.
+ */
+            sumLoad[0] = 0.0;
+
+            for (pos = 0; pos < numCells; pos++) {
+                sumLoad[pos+1] = sumLoad[pos] +
+                                 cellLoad[decomp->cellOrder[pos]];
+            }
+
+/*
+ *          Place each range boundary at the cell boundary closest to
+ *          the target cumulative load, keeping at least one cell in
+ *          every domain.
+ */
+            newStart[0] = 0;
+            newStart[numDomains] = numCells;
+            pos = 0;
+
+            for (dom = 1; dom < numDomains; dom++) {
+
+                target = sumLoad[numCells] * dom / numDomains;
+
+                while ((pos < numCells) && (sumLoad[pos] < target)) {
+                    pos++;
+                }
+
+                i = pos;
+
+                if ((i > 0) && (target - sumLoad[i-1] < sumLoad[i] - target)) {
+                    i--;
+                }
+
+                minStart = newStart[dom-1] + 1;
+                maxStart = numCells - (numDomains - dom);
+
+                newStart[dom] = MAX(minStart, MIN(maxStart, i));
+            }
+
+            free(cellLoad);
+            free(sumLoad);
+        }
+
+#ifdef PARALLEL
+        MPI_Bcast(newStart, numDomains+1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+
+        changed = (memcmp(newStart, decomp->domStart,
+                          (numDomains+1) * sizeof(int)) != 0);
+
+        if (changed) {
+            memcpy(decomp->domStart, newStart, (numDomains+1) * sizeof(int));
+            SetSFCDecompBounds(home->param, decomp);
+            GetSFCDecompLocalDomainBounds(home, decomp);
+        }
+
+        free(newStart);
+
+        return(changed);
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    ReadSFCDecompBounds
+ *      Description: Read the decomposition (if any) from the nodal data
+ *                   file and return it to the caller (if requested).
+ *                   If the cell geometry in the file does not match the
+ *                   current cell geometry, the decomposition cannot be
+ *                   used and nothing is returned.
+ *
+ *      Arguments:
+ *          fp          File pointer to the opened nodal data file;
+ *                      should be positioned in the file such that
+ *                      the next item in the file is the decomposition.
+ *          numXDoms    Number of domains in X dimension of decomposition
+ *                      contained in the file
+ *          numYDoms    Number of domains in Y dimension of decomposition
+ *                      contained in the file
+ *          numZDoms    Number of domains in X dimension of decomposition
+ *                      contained in the file
+ *          saveDecomp  Flag indicating if decomposition is to be saved
+ *                      and returned to the caller.  0 == don't save,
+ *                      1 == save.
+ *          oldDecomp   Location in which to return to the caller a
+ *                      pointer to the old domain decomposition read
+ *                      from the file (if necessary).
+ *
+ *------------------------------------------------------------------------*/
+void ReadSFCDecompBounds(Home_t *home, void **filePtr, int numXDoms,
+                         int numYDoms, int numZDoms, int saveDecomp,
+                         SFCDecomp_t **oldDecomp)
+{
+        int         i, domID, start, count, numDomains, cellGeom[3];
+        char        inLine[256];
+        Param_t     *param;
+        SFCDecomp_t *decomp;
+        FILE        *fp = (FILE *)*filePtr;
+
+        param = home->param;
+        decomp = (SFCDecomp_t *)NULL;
+
+        numDomains = numXDoms * numYDoms * numZDoms;
+
+/*
+ *      First line is the cell geometry the curve was built for
+ */
+        Getline(inLine, sizeof(inLine), fp);
+        sscanf(inLine, "%d %d %d", &cellGeom[X], &cellGeom[Y], &cellGeom[Z]);
+
+        if ((cellGeom[X] != param->nXcells) ||
+            (cellGeom[Y] != param->nYcells) ||
+            (cellGeom[Z] != param->nZcells)) {
+            saveDecomp = 0;
+        }
+
+        if (saveDecomp) {
+            decomp = AllocSFCDecomp(param);
+            decomp->domStart[numDomains] = decomp->numCells;
+        }
+
+        for (i = 0; i < numDomains; i++) {
+            Getline(inLine, sizeof(inLine), fp);
+            if (saveDecomp) {
+                sscanf(inLine, "%d %d %d", &domID, &start, &count);
+                decomp->domStart[domID] = start;
+            }
+        }
+
+        if (saveDecomp) {
+            SetSFCDecompBounds(param, decomp);
+            *oldDecomp = decomp;
+        }
+
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    ReadBinSFCDecompBounds
+ *      Description: Read the domain decomposition (if any) from the HDF5
+ *                   data file and return it to the caller.  If the
+ *                   cell geometry in the file does not match the current
+ *                   cell geometry, nothing is returned.
+ *
+ *      Arguments:
+ *          filePtr     File pointer to the opened HDF5 data file;
+ *          numXDoms    Number of domains in X dimension of decomposition
+ *                      contained in the file
+ *          numYDoms    Number of domains in Y dimension of decomposition
+ *                      contained in the file
+ *          numZDoms    Number of domains in X dimension of decomposition
+ *                      contained in the file
+ *          oldDecomp   Location in which to return to the caller a
+ *                      pointer to the old domain decomposition read
+ *                      from the file.
+ *
+ *------------------------------------------------------------------------*/
+void ReadBinSFCDecompBounds(Home_t *home, void *filePtr, int numXDoms,
+                            int numYDoms, int numZDoms,
+                            SFCDecomp_t **oldDecomp)
+{
+#ifdef USE_HDF
+        int         dom, status, numDomains;
+        real8       *boundsBuf;
+        Param_t     *param;
+        SFCDecomp_t *decomp;
+        hid_t       *fileID = (hid_t *)filePtr;
+
+        param = home->param;
+        numDomains = numXDoms * numYDoms * numZDoms;
+
+        boundsBuf = (real8 *)malloc((numDomains + 4) * sizeof(real8));
+
+        status = ReadHDFDataset(*fileID, "/decomposition", H5T_NATIVE_DOUBLE,
+                                numDomains + 4, boundsBuf);
+        if (status != 0) {
+            Fatal("ReadBinSFCDecompBounds: Error reading decomposition");
+        }
+
+        if (((int)boundsBuf[0] == param->nXcells) &&
+            ((int)boundsBuf[1] == param->nYcells) &&
+            ((int)boundsBuf[2] == param->nZcells)) {
+
+            decomp = AllocSFCDecomp(param);
+
+            for (dom = 0; dom <= numDomains; dom++) {
+                decomp->domStart[dom] = (int)boundsBuf[3+dom];
+            }
+
+            SetSFCDecompBounds(param, decomp);
+            *oldDecomp = decomp;
+        }
+
+        free(boundsBuf);
+#endif
+        return;
+}
+
+
+/*-------------------------------------------------------------------------
+ *
+ *      Function:    WriteSFCDecompBounds
+ *      Description: Writes the cell geometry and the curve range of
+ *                   each domain into the restart file.
+ *
+ *      Arguments:
+ *          fp          open file descriptor for the restart file being
+ *                      written
+ *          decomp      pointer to current domain decomposition.
+ *
+ *------------------------------------------------------------------------*/
+void WriteSFCDecompBounds(Home_t *home, FILE *fp, SFCDecomp_t *decomp)
+{
+        int dom;
+
+        fprintf(fp, "# Cell geometry\n");
+
+        if (decomp == (SFCDecomp_t *)NULL) {
+            return;
+        }
+
+        fprintf(fp, "  %d %d %d\n", decomp->cellGeom[X],
+                decomp->cellGeom[Y], decomp->cellGeom[Z]);
+
+        fprintf(fp, "# Dom_ID  First_cell  Cell_count\n");
+
+        for (dom = 0; dom < decomp->numDomains; dom++) {
+            fprintf(fp, "  %d  %d  %d\n", dom, decomp->domStart[dom],
+                    decomp->domStart[dom+1] - decomp->domStart[dom]);
+        }
+
+        return;
+}
+
+
+#ifndef NO_XWINDOW
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     XPlotSFCDecomp
+ *      Description:  Plots the bounding box of each domain of a
+ *                    space-filling curve decomposition in the active
+ *                    X-window display.
+ *
+ *      Arguments:
+ *          xMin      Minimum permitted coordinate in the X dimension
+ *          yMin      Minimum permitted coordinate in the Y dimension
+ *          zMin      Minimum permitted coordinate in the Z dimension
+ *          lMax      Length of the problem space in the largest dimension
+ *          color     color to use for the lines defining the boundaries
+ *          lineWidth self-explanatory
+ *
+ *-------------------------------------------------------------------------*/
+void XPlotSFCDecomp(Home_t *home, SFCDecomp_t *decomp, real8 xMin,
+                    real8 yMin, real8 zMin, real8 lMax, int color,
+                    real8 lineWidth)
+{
+        int   dom;
+        real8 x1, x2, y1, y2, z1, z2, *bounds;
+
+        if (decomp == (SFCDecomp_t *)NULL) {
+            return;
+        }
+
+        for (dom = 0; dom < decomp->numDomains; dom++) {
+
+            bounds = &decomp->domBounds[dom * 6];
+
+            x1 = (bounds[0] - xMin) / lMax * 2 - 1;
+            y1 = (bounds[1] - yMin) / lMax * 2 - 1;
+            z1 = (bounds[2] - zMin) / lMax * 2 - 1;
+
+            x2 = (bounds[3] - xMin) / lMax * 2 - 1;
+            y2 = (bounds[4] - yMin) / lMax * 2 - 1;
+            z2 = (bounds[5] - zMin) / lMax * 2 - 1;
+
+            WinDrawLine(x1, y1, z1, x2, y1, z1, color, lineWidth/2, 0);
+            WinDrawLine(x2, y1, z1, x2, y2, z1, color, lineWidth/2, 0);
+            WinDrawLine(x2, y2, z1, x1, y2, z1, color, lineWidth/2, 0);
+            WinDrawLine(x1, y2, z1, x1, y1, z1, color, lineWidth/2, 0);
+
+            WinDrawLine(x1, y1, z1, x1, y1, z2, color, lineWidth/2, 0);
+            WinDrawLine(x2, y1, z1, x2, y1, z2, color, lineWidth/2, 0);
+            WinDrawLine(x1, y2, z1, x1, y2, z2, color, lineWidth/2, 0);
+            WinDrawLine(x2, y2, z1, x2, y2, z2, color, lineWidth/2, 0);
+
+            WinDrawLine(x1, y1, z2, x2, y1, z2, color, lineWidth/2, 0);
+            WinDrawLine(x2, y1, z2, x2, y2, z2, color, lineWidth/2, 0);
+            WinDrawLine(x2, y2, z2, x1, y2, z2, color, lineWidth/2, 0);
+            WinDrawLine(x1, y2, z2, x1, y1, z2, color, lineWidth/2, 0);
+        }
+
+        return;
+}
+#endif
@@ -0,0 +1,1002 @@
+/***************************************************************************
+ *
+ *      Module:      StressTableGen.c
+ *      Description: Contains all functions needed to compute and
+ *                   write the two stress tables used for computing
+ *                   farfield stress from within the primary image
+ *                   and for periodic images if the fast-multipole
+ *                   code is not being used.
+ *
+ *      Includes functions:
+ *          CalRijm()
+ *          CheckArgs()
+ *          ComputeRijmPoint()
+ *          ComputeRijmSlope()
+ *          ComputeRijmTable()
+ *          GetArgs()
+ *          InitArgs()
+ *          main()
+ *          PrintHelp()
+ *          ReadCheckpoint()
+ *          Usage()
+ *          WriteCheckpoint()
+ *          WriteRijmText()
+ *
+ *      Usage:  stresstablegen [-help] [-size <xlen[,ylen,zlen]>]      \
+ *                             [-nimgx <numximages>] [-nimgy <numyimages>] \
+ *                             [-nimgz <numzimages>] [-nx <nxval>          \
+ *                             [-ny <nyval> [-nz <nzval> [-pbc|-nopbc]     \
+ *                             [-binary] [-checkpoint <ckptfile>]          \
+ *                             [-ckptsecs <seconds>]
+ *
+ *      Overview:
+ *
+ *      The table is computed one plane of grid points (constant X
+ *      index) at a time.  When compiled with PARALLEL defined (the
+ *      stresstablegenp executable built in the src directory) the
+ *      planes are divided into contiguous slabs among the MPI tasks,
+ *      and when compiled with OpenMP support the grid points within
+ *      each plane are distributed among the threads.  The partial
+ *      tables are summed onto task 0 which writes the final table.
+ *
+ *      If a checkpoint file is specified, each task periodically
+ *      writes the planes it has completed to <ckptfile>.<taskID>.
+ *      Rerunning the same command with the same number of tasks
+ *      will resume from those files rather than starting over.
+ *
+ *      By default the table is written in the text format.  The
+ *      -binary option writes the memory-mappable binary format
+ *      described in RijmTable.h instead.  ParaDiS accepts either.
+ *
+ ***************************************************************************/
+#include <string.h>
+#include <time.h>
+#include "Home.h"
+#include "RijmTable.h"
+#include <math.h>
+
+#ifdef PARALLEL
+#include <mpi.h>
+#endif
+
+
+/*
+ *      Indices of 3rd derivatives
+ */
+static int DER3IND[10][3] = {{0,0,0}, {1,1,1}, {2,2,2},
+                             {0,0,1}, {0,0,2}, {1,1,0},
+                             {1,1,2}, {2,2,0}, {2,2,1},
+                             {0,1,2} };
+
+/*
+ *      Identifier written at the start of each checkpoint file (not
+ *      NUL terminated in the file)
+ */
+#define CKPT_MAGIC "RIJMCKPT"
+
+/*
+ *      Define an integer identifier to be associated with each
+ *      posible command line argument.  To be used to index the
+ *      option-specific data in the optList array below.
+ */
+#define OPT_HELP      0
+#define OPT_SIZE      1
+#define OPT_NIMGX     2
+#define OPT_NIMGY     3
+#define OPT_NIMGZ     4
+#define OPT_NX        5
+#define OPT_NY        6
+#define OPT_NZ        7
+#define OPT_NOPBC     8
+#define OPT_OUTFILE   9
+#define OPT_PBC      10
+#define OPT_BINARY   11
+#define OPT_CKPTFILE 12
+#define OPT_CKPTSECS 13
+#define OPT_MAX      14
+
+/*
+ *      Define a structure to hold a command line option's id (type),
+ *      name, the shortest possible unique abbreviation of the option
+ *      name, and a flag indicating if the option is paired with
+ *      a value or not.
+ */
+typedef struct {
+        int     optType;
+        char    *optName;
+        int     optMinAbbrev;
+        int     optPaired;
+} Option_t;
+
+
+Option_t optList[OPT_MAX] = {
+        {OPT_HELP,     "help",      1,      0},
+        {OPT_SIZE,     "size",      1,      1},
+        {OPT_NIMGX,    "nimgx",     5,      1},
+        {OPT_NIMGX,    "nimgy",     5,      1},
+        {OPT_NIMGX,    "nimgz",     5,      1},
+        {OPT_NX,       "nx",        2,      1},
+        {OPT_NY,       "ny",        2,      1},
+        {OPT_NZ,       "nz",        2,      1},
+        {OPT_NOPBC,    "nopbc",     2,      0},
+        {OPT_OUTFILE,  "outfile",   1,      1},
+        {OPT_PBC,      "pbc",       1,      0},
+        {OPT_BINARY,   "binary",    1,      0},
+        {OPT_CKPTFILE, "checkpoint",2,      1},
+        {OPT_CKPTSECS, "ckptsecs",  2,      1}
+};
+
+/*
+ *      Define a structure containing all items corresponding to
+ *      command line options that have assoictaed values.  This
+ *      gives us an easy way to pass the command line arg values
+ *      around to various functions.
+ */
+typedef struct {
+        int   pbc;
+        int   nx;
+        int   ny;
+        int   nz;
+        int   nimagex;
+        int   nimagey;
+        int   nimagez;
+        int   binary;
+        int   ckptSecs;
+        real8 xLen, yLen, zLen;
+        char  *rijmFileName;
+        char  *rijmPBCFileName;
+        char  *ckptFileName;
+} InArgs_t;
+
+/*
+ *      Header written at the start of each task's checkpoint file.
+ *      The table data for the task follows immediately.  A checkpoint
+ *      is only used if every item other than <planesDone> matches the
+ *      current run.
+ */
+typedef struct {
+        char  magic[8];
+        int   pbc;
+        int   gridSize[3];
+        int   numImages[3];
+        int   firstPlane;
+        int   lastPlane;
+        int   planesDone;
+        int   dataLen;
+        real8 boxSize[3];
+} CkptHeader_t;
+
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       Usage
+ *      Description:    Print out a brief message indicating the possible
+ *                      command line options and terminated.
+ *
+ *      Arguments:
+ *              program         name of the program being executed
+ *
+ *-------------------------------------------------------------------------*/
+static void Usage(char *program)
+{
+        printf("Usage:  %16s [-help] [-size <xlen[,ylen,zlen]>] \n",
+               program);
+        printf("                       [-nimgx <numximages>]\n");
+        printf("                       [-nimgy <numyimages>]\n");
+        printf("                       [-nimgz <numzimages>] [-nx <nxval>]\n");
+        printf("                       [-ny <nyval>] [-nz <nzval>] \n");
+        printf("                       [-pbc|-nopbc] [-binary]\n");
+        printf("                       [-checkpoint <ckptfile>]\n");
+        printf("                       [-ckptsecs <seconds>]\n");
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       PrintHelp
+ *      Description:    Print out a detailed description of the available
+ *                      program options, what they represent, how they
+ *                      relate to each other, which are interdependent, or
+ *                      mutually exclusive, default values, etc.
+ *
+ *      Arguments:
+ *              program         name of the program being executed
+ *
+ *-------------------------------------------------------------------------*/
+static void PrintHelp(char *program)
+{
+        Usage(program);
+
+        printf("    Options may be abbreviated to the shortest\n");
+        printf("    non-ambiguous abbreviation of the option.  For\n");
+        printf("    example, '-no' is a valid abbreviation for \n");
+        printf("    '-nopbc' however, '-n' could refer to \n");
+        printf("    numerous options and hence is invalid.\n\n");
+
+        printf("Options:\n\n");
+        printf("  -help             Prints this help information.\n\n");
+        printf("  -binary   Write the table in the binary format\n");
+        printf("            rather than as text.\n\n");
+        printf("  -checkpoint  Base name of the checkpoint files.  If\n");
+        printf("            specified, each task periodically saves\n");
+        printf("            its partial table to <ckptfile>.<taskID>\n");
+        printf("            and resumes from that file when restarted\n");
+        printf("            with the same arguments.\n\n");
+        printf("  -ckptsecs Minimum number of seconds between\n");
+        printf("            checkpoints.  Default is 600.\n\n");
+        printf("  -size     Define the lengths (units of b) of the sides\n");
+        printf("            of the problem space to be generated.  If\n");
+        printf("            a single value is provided, the problem space\n");
+        printf("            is assumed to be cubic, otherwise this \n");
+        printf("            should contain 3 comma-delimited values \n");
+        printf("            corresponding to the lengths of the problem\n");
+        printf("            space in X, Y and Z dimensions respectively.\n\n");
+        printf("  -nimgx    Number of periodic images of the problem\n");
+        printf("            in the X dimension.\n\n");
+        printf("  -nimgy    Number of periodic images of the problem\n");
+        printf("            in the Y dimension.\n\n");
+        printf("  -nimgz    Number of periodic images of the problem\n");
+        printf("            in the Z dimension.\n\n");
+        printf("  -nopbc    Indicates this invocation of the utilitiy is\n");
+        printf("            to create the stress table used for farfield\n");
+        printf("            stress within the primary image\n\n");
+        printf("  -nx       For future use\n\n");
+        printf("  -ny       For future use\n\n");
+        printf("  -nz       For future use\n\n");
+        printf("  -outfile  Name of the file into which to write the\n");
+        printf("            table. \n\n");
+        printf("  -pbc      Indicates this invocation of the utilitiy is\n");
+        printf("            to create the stress table used for periodic\n");
+        printf("            image stress\n\n");
+
+        exit(0);
+}
+
+
+static void CalRijm(real8 rt[3], real8 Rijm[10])
+{
+        int i, j, m, k;
+        real8 R, R2, R3;
+        
+        if ((fabs(rt[0]) < 1e-10) && (fabs(rt[1]) < 1e-10) &&
+            (fabs(rt[2]) < 1e-10)) {
+
+            for (k=0;k<10;k++) {
+                Rijm[k]=0;
+            }
+
+            return;
+        }
+        
+        R2 = rt[0]*rt[0] + rt[1]*rt[1] + rt[2]*rt[2];
+        R  = sqrt(R2);
+        R3 = R*R2;
+            
+        for (k=0;k<10;k++) {
+
+            i = DER3IND[k][0];
+            j = DER3IND[k][1];
+            m = DER3IND[k][2];
+
+            Rijm[k] = (-rt[m]*(i==j) - rt[j]*(i==m) - rt[i]*(j==m) +
+                       3*rt[i]*rt[j]*rt[m]/R2) / R3;
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       ComputeRijmSlope
+ *      Description:    Compute the change in the summed Rijm across the
+ *                      box in each dimension.  These values are used
+ *                      to correct the slope of each table entry.
+ *
+ *      Arguments:
+ *              dRijm   Array in which to return the X, Y and Z slope
+ *                      corrections.
+ *
+ *-------------------------------------------------------------------------*/
+static void ComputeRijmSlope(InArgs_t *inArgs, real8 dRijm[3][10])
+{
+        int   m, dim, imgx, imgy, imgz, img[3];
+        int   NIMGX, NIMGY, NIMGZ;
+        real8 L[3], rt[3], Rijmarray[10];
+
+        NIMGX = inArgs->nimagex;
+        NIMGY = inArgs->nimagey;
+        NIMGZ = inArgs->nimagez;
+
+        L[0] = inArgs->xLen;
+        L[1] = inArgs->yLen;
+        L[2] = inArgs->zLen;
+
+        for (m=0;m<10;m++) {
+            dRijm[0][m]=dRijm[1][m]=dRijm[2][m]=0;
+        }
+
+        for (imgx=-NIMGX;imgx<=NIMGX;imgx++) {
+            for (imgy=-NIMGY;imgy<=NIMGY;imgy++) {
+                for (imgz=-NIMGZ;imgz<=NIMGZ;imgz++) {
+                    img[0]=imgx;
+                    img[1]=imgy;
+                    img[2]=imgz;
+
+                    for (dim=0;dim<3;dim++) {
+
+                        rt[0]=(img[0])*L[0];
+                        rt[1]=(img[1])*L[1];
+                        rt[2]=(img[2])*L[2];
+
+                        rt[dim]=(-0.5+img[dim])*L[dim];
+                        CalRijm(rt, Rijmarray);
+                        for (m=0;m<10;m++) {
+                            dRijm[dim][m]-=Rijmarray[m];
+                        }
+
+                        rt[dim]=( 0.5+img[dim])*L[dim];
+                        CalRijm(rt, Rijmarray);
+                        for (m=0;m<10;m++) {
+                            dRijm[dim][m]+=Rijmarray[m];
+                        }
+                    }
+                }
+            }
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       ComputeRijmPoint
+ *      Description:    Compute the image sum and slope correction for
+ *                      the table entry at grid point (i, j, k).  Only
+ *                      local storage is modified so this function may
+ *                      be called concurrently from multiple threads.
+ *
+ *      Arguments:
+ *              dRijm   Slope corrections from ComputeRijmSlope()
+ *              Rijm    Array in which to return the table entry
+ *
+ *-------------------------------------------------------------------------*/
+static void ComputeRijmPoint(InArgs_t *inArgs, real8 dRijm[3][10],
+                             int i, int j, int k, real8 Rijm[10])
+{
+        int   m, imgx, imgy, imgz;
+        int   pbc, NIMGX, NIMGY, NIMGZ;
+        real8 Lx, Ly, Lz;
+        real8 fx, fy, fz;
+        real8 rt[3], Rijmarray[10];
+
+        pbc = inArgs->pbc;
+
+        NIMGX = inArgs->nimagex;
+        NIMGY = inArgs->nimagey;
+        NIMGZ = inArgs->nimagez;
+
+        Lx = inArgs->xLen;
+        Ly = inArgs->yLen;
+        Lz = inArgs->zLen;
+
+        fx = -0.5+1.0*i/(inArgs->nx-1);
+        fy = -0.5+1.0*j/(inArgs->ny-1);
+        fz = -0.5+1.0*k/(inArgs->nz-1);
+
+        for (m=0;m<10;m++) {
+            Rijm[m]=0;
+            Rijmarray[m]=0;
+        }
+
+        for (imgx=-NIMGX;imgx<=NIMGX;imgx++) {
+            for (imgy=-NIMGY;imgy<=NIMGY;imgy++) {
+                for (imgz=-NIMGZ;imgz<=NIMGZ;imgz++) {
+                    if (!pbc) {
+                        if ((imgx==0) &&
+                            (imgy==0) &&
+                            (imgz==0)) {
+                            continue;
+                        }
+                    }
+
+                    rt[0]=Lx*(fx+imgx);
+                    rt[1]=Ly*(fy+imgy);
+                    rt[2]=Lz*(fz+imgz);
+
+/*
+ *                  As in the original serial loop, a zero separation
+ *                  re-adds the previous image's contribution rather
+ *                  than recomputing it, so tables match those
+ *                  generated by earlier versions of this utility.
+ */
+                    if (!((fabs(rt[0]) < 1e-10) &&
+                          (fabs(rt[1]) < 1e-10) &&
+                          (fabs(rt[2]) < 1e-10))) {
+                        CalRijm(rt, Rijmarray);
+                    }
+
+                    for (m=0;m<10;m++) {
+                        Rijm[m]+=Rijmarray[m];
+                    }
+                }
+            }
+        }
+/*
+ *      Correct for slope
+ */
+        for (m=0;m<10;m++) {
+            Rijm[m] -= dRijm[0][m]*fx;
+            Rijm[m] -= dRijm[1][m]*fy;
+            Rijm[m] -= dRijm[2][m]*fz;
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       WriteCheckpoint
+ *      Description:    Write this task's partial table to its checkpoint
+ *                      file.  The data is written to a temporary file
+ *                      first and then renamed, so an interrupted write
+ *                      never destroys the previous checkpoint.
+ *
+ *-------------------------------------------------------------------------*/
+static void WriteCheckpoint(char *fileName, CkptHeader_t *header,
+                            RijmTable_t *table)
+{
+        char tmpName[512];
+        FILE *fp;
+
+        snprintf(tmpName, sizeof(tmpName), "%s.tmp", fileName);
+
+        if ((fp = fopen(tmpName, "w")) == (FILE *)NULL) {
+            Fatal("WriteCheckpoint: Open error %d on %s", errno, tmpName);
+        }
+
+        if ((fwrite(header, sizeof(CkptHeader_t), 1, fp) != 1) ||
+            (fwrite(table->data, sizeof(real8), table->dataLen, fp) !=
+             (size_t)table->dataLen)) {
+            Fatal("WriteCheckpoint: Write error %d on %s", errno, tmpName);
+        }
+
+        fclose(fp);
+
+        if (rename(tmpName, fileName) != 0) {
+            Fatal("WriteCheckpoint: Error %d renaming %s to %s",
+                  errno, tmpName, fileName);
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       ReadCheckpoint
+ *      Description:    If a checkpoint from a run with identical
+ *                      parameters exists, load its partial table.
+ *
+ *      Arguments:
+ *              header  Header describing the current run.  On success
+ *                      header->planesDone is updated from the file.
+ *
+ *      Returns:  1 if a matching checkpoint was loaded, 0 otherwise
+ *
+ *-------------------------------------------------------------------------*/
+static int ReadCheckpoint(char *fileName, CkptHeader_t *header,
+                          RijmTable_t *table)
+{
+        CkptHeader_t ckpt;
+        FILE         *fp;
+
+        if ((fp = fopen(fileName, "r")) == (FILE *)NULL) {
+            return(0);
+        }
+
+        if (fread(&ckpt, sizeof(CkptHeader_t), 1, fp) != 1) {
+            fclose(fp);
+            return(0);
+        }
+
+        ckpt.planesDone = header->planesDone;
+
+        if (memcmp(&ckpt, header, sizeof(CkptHeader_t)) != 0) {
+            printf("Warning: Ignoring checkpoint %s from a run with "
+                   "different parameters\n", fileName);
+            fclose(fp);
+            return(0);
+        }
+
+        fseek(fp, 0, SEEK_SET);
+
+        if ((fread(header, sizeof(CkptHeader_t), 1, fp) != 1) ||
+            (fread(table->data, sizeof(real8), table->dataLen, fp) !=
+             (size_t)table->dataLen)) {
+            Fatal("ReadCheckpoint: Premature EOF on %s", fileName);
+        }
+
+        fclose(fp);
+
+        return(1);
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       ComputeRijmTable
+ *      Description:    Compute this task's slab of planes of the table.
+ *                      Table entries outside the slab are left zeroed
+ *                      so the partial tables of all tasks may simply be
+ *                      summed to produce the full table.
+ *
+ *-------------------------------------------------------------------------*/
+static void ComputeRijmTable(InArgs_t *inArgs, RijmTable_t *table,
+                             int numTasks, int thisTask)
+{
+        int          i, j, k, NX, NY, NZ;
+        int          numPlanes, extraPlanes;
+        char         ckptFileName[512];
+        time_t       lastCkptTime;
+        real8        dRijm[3][10];
+        CkptHeader_t header;
+
+        NX = inArgs->nx;
+        NY = inArgs->ny;
+        NZ = inArgs->nz;
+
+/*
+ *      Divide the planes as evenly as possible among the tasks
+ */
+        numPlanes   = NX / numTasks;
+        extraPlanes = NX - (numPlanes * numTasks);
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CKPT_MAGIC, sizeof(header.magic));
+
+        header.pbc        = inArgs->pbc;
+        header.firstPlane = thisTask * numPlanes + MIN(thisTask, extraPlanes);
+        header.lastPlane  = header.firstPlane + numPlanes +
+                            (thisTask < extraPlanes ? 1 : 0);
+        header.planesDone = 0;
+        header.dataLen    = table->dataLen;
+
+        VECTOR_COPY(header.gridSize, table->gridSize);
+        VECTOR_COPY(header.numImages, table->numImages);
+        VECTOR_COPY(header.boxSize, table->boxSize);
+
+        if (inArgs->ckptFileName != (char *)NULL) {
+            snprintf(ckptFileName, sizeof(ckptFileName), "%s.%d",
+                     inArgs->ckptFileName, thisTask);
+            if (ReadCheckpoint(ckptFileName, &header, table)) {
+                printf("Task %d: Resuming from %s with %d of %d planes "
+                       "complete\n", thisTask, ckptFileName, header.planesDone,
+                       header.lastPlane - header.firstPlane);
+            }
+        }
+
+        ComputeRijmSlope(inArgs, dRijm);
+
+        lastCkptTime = time((time_t *)NULL);
+
+        for (i = header.firstPlane + header.planesDone;
+             i < header.lastPlane; i++) {
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) private(k)
+#endif
+            for (j=0;j<NY;j++) {
+                for (k=0;k<NZ;k++) {
+                    ComputeRijmPoint(inArgs, dRijm, i, j, k,
+                            &table->data[RIJM_TABLE_OFFSET(table, i, j, k)]);
+                }
+            }
+
+            header.planesDone++;
+
+            if (thisTask == 0) {
+                printf("  <%06.3f%% complete>",
+                       (double)header.planesDone /
+                       (double)(header.lastPlane - header.firstPlane) *
+                       100.0);
+                printf("\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b\b");
+                fflush(NULL);
+            }
+
+            if ((inArgs->ckptFileName != (char *)NULL) &&
+                (i < header.lastPlane - 1) &&
+                (time((time_t *)NULL) - lastCkptTime >= inArgs->ckptSecs)) {
+                WriteCheckpoint(ckptFileName, &header, table);
+                lastCkptTime = time((time_t *)NULL);
+            }
+        }
+
+        if (thisTask == 0) {
+            printf("                    \n");
+        }
+
+/*
+ *      Save the completed slab as well so a failure while gathering
+ *      or writing the table does not lose any of the work.
+ */
+        if (inArgs->ckptFileName != (char *)NULL) {
+            WriteCheckpoint(ckptFileName, &header, table);
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       WriteRijmText
+ *      Description:    Write the table to the specified file in the
+ *                      text format.
+ *
+ *-------------------------------------------------------------------------*/
+static void WriteRijmText(char *fileName, RijmTable_t *table)
+{
+        int   i, j, k, m, offset;
+        FILE  *fp;
+
+        if ((fp = fopen(fileName, "w")) == (FILE *)NULL) {
+            Fatal("WriteRijmText: Open error %d on %s", errno, fileName);
+        }
+
+        fprintf(fp, "%d\n%d\n%d\n", table->gridSize[0], table->gridSize[1],
+                table->gridSize[2]);
+        fprintf(fp, "%e\n%e\n%e\n", table->boxSize[0], table->boxSize[1],
+                table->boxSize[2]);
+        fprintf(fp, "%d\n%d\n%d\n", table->numImages[0], table->numImages[1],
+                table->numImages[2]);
+
+        for (i=0;i<table->gridSize[0];i++) {
+            for (j=0;j<table->gridSize[1];j++) {
+                for (k=0;k<table->gridSize[2];k++) {
+                    offset = RIJM_TABLE_OFFSET(table, i, j, k);
+                    for (m=0;m<10;m++) {
+                        fprintf(fp, "%e\n", table->data[offset+m]);
+                    }
+                }
+            }
+        }
+
+        fclose(fp);
+
+        return;
+}
+
+
+
+
+
+static void InitArgs(InArgs_t *inArgs)
+{
+        inArgs->pbc =  1;
+
+        inArgs->nx  = -1;
+        inArgs->ny  = -1;
+        inArgs->nz  = -1;
+
+        inArgs->nimagex = -1;
+        inArgs->nimagey = -1;
+        inArgs->nimagez = -1;
+
+        inArgs->xLen = -1.0;
+        inArgs->yLen = -1.0;
+        inArgs->zLen = -1.0;
+
+        inArgs->binary   = 0;
+        inArgs->ckptSecs = 600;
+
+        inArgs->rijmFileName    = "Rijm.tbl";
+        inArgs->rijmPBCFileName = "RijmPBC.tbl";
+        inArgs->ckptFileName    = (char *)NULL;
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       GetArgs
+ *      Description:    Parse the command line arguments.  Verify all options
+ *                      are valid keywords and that all options requiring
+ *                      associated values have them.  All user supplied values
+ *                      will be stored in the inArgs structure, and a sanity
+ *                      check on those values will be done elsewhere.
+ *      Arguments
+ *              argc    count of command line args
+ *              argv    command line args
+ *              inArgs  structure to hold user supplied values.  This
+ *                      structure should have been populated with any
+ *                      appropriate default values before this function
+ *                      is called.
+ *
+ *-------------------------------------------------------------------------*/
+static void GetArgs(int argc, char *argv[], InArgs_t *inArgs)
+{
+        int     i, j;
+        char    *argName;
+        char    *argValue = (char *)NULL;
+        char    *token;
+
+        for (i = 1; i < argc; i++) {
+/*
+ *              If the option doesn't begin with a '-' something
+ *              is wrong, so notify the user and terminate.
+ */
+                if (argv[i][0] != '-') {
+                        Usage(argv[0]);
+                        exit(1);
+                }
+
+                argName = &argv[i][1];
+
+/*
+ *              Scan the array of valid options for the user supplied
+ *              option name.  (This may be any unique abbreviation of
+ *              one of any of the options.  If we don't find the option
+ *              notify the user and terminate.
+ */
+                for (j = 0; j < OPT_MAX; j++) {
+                        if (!strncmp(argName, optList[j].optName,
+                                     optList[j].optMinAbbrev)) {
+                                break;
+                        }
+                }
+                if (j == OPT_MAX) {
+                        Usage(argv[0]);
+                        exit(1);
+                }
+
+/*
+ *              Verify that there is an associated value if the specified
+ *              option is supposed to be paired with a value.
+ */
+                if (optList[j].optPaired) {
+                    if (i+1 >= argc) {
+                        Usage(argv[0]);
+                        exit(1);
+                    } else {
+                        argValue = argv[++i];
+                    }
+                }
+
+/*
+ *              Do any option-specific processing...
+ */
+                switch (j)  {
+                case OPT_HELP:
+                        PrintHelp(argv[0]);
+                        exit(0);
+                        break;
+                case OPT_SIZE:
+/*
+ *                      Allow a single value indicating a cubic problem
+ *                      space with the specified dimensions, or 3
+ *                      comma-delimited values specifying the lenth of
+ *                      each dimension of the problem space explicitly
+ */
+                        token = strtok(argValue, ",");
+                        inArgs->xLen = atoi(token);
+                        token = strtok(NULL, ",");
+                        if (token == (char *)NULL) {
+                            inArgs->yLen = inArgs->xLen;
+                            inArgs->zLen = inArgs->xLen;
+                            break;
+                        }
+                        inArgs->yLen = atoi(token);
+                        token = strtok(NULL, ",");
+                        if (token == (char *)NULL) {
+                            Usage(argv[0]);
+                            exit(1);
+                        }
+                        inArgs->zLen = atoi(token);
+                        break;
+                case OPT_NX:
+                        inArgs->nx = atoi(argValue);
+                        break;
+                case OPT_NY:
+                        inArgs->ny = atoi(argValue);
+                        break;
+                case OPT_NZ:
+                        inArgs->nz = atoi(argValue);
+                        break;
+                case OPT_NIMGX:
+                        inArgs->nimagex = atoi(argValue);
+                        break;
+                case OPT_NIMGY:
+                        inArgs->nimagey = atoi(argValue);
+                        break;
+                case OPT_NIMGZ:
+                        inArgs->nimagez = atoi(argValue);
+                        break;
+                case OPT_NOPBC:
+                        inArgs->pbc = 0;
+                        break;
+                case OPT_PBC:
+                        inArgs->pbc = 1;
+                        break;
+                case OPT_OUTFILE:
+                        inArgs->rijmFileName = argValue;
+                        inArgs->rijmPBCFileName = argValue;
+                        break;
+                case OPT_BINARY:
+                        inArgs->binary = 1;
+                        break;
+                case OPT_CKPTFILE:
+                        inArgs->ckptFileName = argValue;
+                        break;
+                case OPT_CKPTSECS:
+                        inArgs->ckptSecs = atoi(argValue);
+                        break;
+                }
+        }
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:       CheckArgs
+ *      Description:    Check the current values for the input arguments.
+ *                      For each value not provided by the caller, apply
+ *                      a default value if it has not yet been set.
+ *
+ *-------------------------------------------------------------------------*/
+static void CheckArgs(InArgs_t *inArgs)
+{
+/*
+ *      Set default to a cubic problem space of approximately 1 micron.
+ */
+        if (inArgs->xLen < 0) {
+            inArgs->xLen = 3500;
+            inArgs->yLen = 3500;
+            inArgs->zLen = 3500;
+        }
+
+
+/*
+ *      Default number of periodic images is 20 in X dimension and
+ *      in Y and Z dimensions defaults to same value as in X dimension
+ *      whether that be the default value or a user provided value.
+ */
+        if (inArgs->nimagex < 0) {
+            inArgs->nimagex = 20;
+        }
+
+        if (inArgs->nimagey < 0) {
+            inArgs->nimagey = inArgs->nimagex;
+        }
+
+        if (inArgs->nimagez < 0) {
+            inArgs->nimagez = inArgs->nimagex;
+        }
+
+/*
+ *      Default number of xxx is 51 in the X dimension and
+ *      in Y and Z dimensions defaults to same value as in X dimension
+ *      whether that be the default value or a user provided value.
+ */
+        if (inArgs->nx < 0) {
+            inArgs->nx = 51;
+        }
+
+        if (inArgs->ny < 0) {
+            inArgs->ny = inArgs->nx;
+        }
+
+        if (inArgs->nz < 0) {
+            inArgs->nz = inArgs->nx;
+        }
+
+        return;
+}
+
+
+int main(int argc, char *argv[])
+{
+        int         numTasks, thisTask;
+        int         gridSize[3];
+        char        *fileName;
+        InArgs_t    inArgs;
+        RijmTable_t table;
+#ifdef PARALLEL
+        real8       *sumData;
+
+        MPI_Init(&argc, &argv);
+        MPI_Comm_rank(MPI_COMM_WORLD, &thisTask);
+        MPI_Comm_size(MPI_COMM_WORLD, &numTasks);
+#else
+        thisTask = 0;
+        numTasks = 1;
+#endif
+
+/*
+ *      First initialize some stuff based on either user-provided
+ *      command line arguments or hard-coded defaults.  Every task
+ *      parses the same command line, so no broadcast is needed.
+ */
+        InitArgs(&inArgs);
+        GetArgs(argc, argv, &inArgs);
+        CheckArgs(&inArgs);
+
+/*
+ *      Now allocate the table being created
+ */
+        gridSize[0] = inArgs.nx;
+        gridSize[1] = inArgs.ny;
+        gridSize[2] = inArgs.nz;
+
+        RijmTableAlloc(&table, gridSize);
+
+        if (table.data == (real8 *)NULL) {
+            Fatal("Unable to allocate %d values for the table", table.dataLen);
+        }
+
+        table.numImages[0] = inArgs.nimagex;
+        table.numImages[1] = inArgs.nimagey;
+        table.numImages[2] = inArgs.nimagez;
+
+        table.boxSize[0] = inArgs.xLen;
+        table.boxSize[1] = inArgs.yLen;
+        table.boxSize[2] = inArgs.zLen;
+
+/*
+ *      Compute this task's portion of the table, then sum the
+ *      partial tables onto task 0.
+ */
+        ComputeRijmTable(&inArgs, &table, numTasks, thisTask);
+
+#ifdef PARALLEL
+        sumData = (real8 *)NULL;
+
+        if (thisTask == 0) {
+            sumData = (real8 *)malloc(table.dataLen * sizeof(real8));
+            if (sumData == (real8 *)NULL) {
+                Fatal("Unable to allocate %d values for the table",
+                      table.dataLen);
+            }
+        }
+
+        MPI_Reduce(table.data, sumData, table.dataLen, MPI_DOUBLE, MPI_SUM,
+                   0, MPI_COMM_WORLD);
+
+        if (thisTask == 0) {
+            free(table.data);
+            table.data = sumData;
+        }
+#endif
+
+/*
+ *      And last write the table out to disk.
+ */
+        if (thisTask == 0) {
+
+            fileName = inArgs.pbc ? inArgs.rijmPBCFileName :
+                                    inArgs.rijmFileName;
+
+            printf("Creating file %s...\n", fileName);
+
+            if (inArgs.binary) {
+                RijmTableWriteBinary(fileName, &table);
+            } else {
+                WriteRijmText(fileName, &table);
+            }
+        }
+
+        RijmTableFree(&table);
+
+#ifdef PARALLEL
+        MPI_Finalize();
+#endif
+        exit(0);
+}
@@ -141,6 +141,8 @@ static void AllocNodeArrays(Node_t *node, int armCount)
         node->nz       = (real8 *)malloc(armCount * sizeof(real8));
         node->sigbLoc  = (real8 *)malloc(armCount * sizeof(real8) * 3);
         node->sigbRem  = (real8 *)malloc(armCount * sizeof(real8) * 3);
+        node->mobCache = (real8 *)malloc(armCount * sizeof(real8) *
+                                         MOB_CACHE_SIZE);
 
         if (node->armCoordIndex != (int *)NULL) {
             node->armCoordIndex = (int *)malloc(armCount * sizeof(int));
@@ -181,6 +183,7 @@ void FreeNodeArrays(Node_t *node)
             free(node->nz);
             free(node->sigbLoc);
             free(node->sigbRem);
+            free(node->mobCache);
 
             if (node->armCoordIndex != (int *)NULL) {
                 free(node->armCoordIndex);
@@ -233,6 +236,10 @@ static void CopyNodeArrays(Node_t *source, Node_t *dest)
             dest->sigbRem[i*3+1]     = source->sigbRem[i*3+1];
             dest->sigbRem[i*3+2]     = source->sigbRem[i*3+2];
 
+            memcpy(&dest->mobCache[i*MOB_CACHE_SIZE],
+                   &source->mobCache[i*MOB_CACHE_SIZE],
+                   MOB_CACHE_SIZE * sizeof(real8));
+
             if (source->armCoordIndex != (int *)NULL) {
                 dest->armCoordIndex[i]   = source->armCoordIndex[i];
             }
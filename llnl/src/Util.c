@@ -1184,6 +1184,9 @@ static void InitNodeArm(Node_t *node, int armID)
         node->sigbRem[3*armID+1] = 0.0;
         node->sigbRem[3*armID+2] = 0.0;
 
+        memset(&node->mobCache[MOB_CACHE_SIZE*armID], 0,
+               MOB_CACHE_SIZE * sizeof(real8));
+
         return;
 }
 
@@ -1224,6 +1227,7 @@ void AllocNodeArms(Node_t *node, int n)
                 free(node->nz);
                 free(node->sigbLoc);
                 free(node->sigbRem);
+                free(node->mobCache);
             }
                 
             node->numNbrs = n;
@@ -1241,6 +1245,7 @@ void AllocNodeArms(Node_t *node, int n)
         
             node->sigbLoc = (real8 *)malloc(n*3*sizeof(real8));
             node->sigbRem = (real8 *)malloc(n*3*sizeof(real8));
+            node->mobCache = (real8 *)malloc(n*MOB_CACHE_SIZE*sizeof(real8));
         }
         
 /*
@@ -1314,6 +1319,7 @@ void FreeNodeArms(Node_t *node)
         free(node->nz);          node->nz = (real8 *)NULL;
         free(node->sigbLoc);     node->sigbLoc = (real8 *)NULL;
         free(node->sigbRem);     node->sigbRem = (real8 *)NULL;
+        free(node->mobCache);    node->mobCache = (real8 *)NULL;
 
         node->numNbrs = 0;
 
@@ -1631,6 +1637,8 @@ void ReallocNodeArms(Node_t *node, int n)
         node->nz = (real8 *) realloc(node->nz, sizeof(real8  )*n);
         node->sigbLoc  = (real8 *) realloc(node->sigbLoc, n*3*sizeof(real8));
         node->sigbRem  = (real8 *) realloc(node->sigbRem, n*3*sizeof(real8));
+        node->mobCache = (real8 *) realloc(node->mobCache,
+                                           n*MOB_CACHE_SIZE*sizeof(real8));
 
 /*
  *      And just initialize the newly allocated arms only, leaving
@@ -14,6 +14,7 @@
 ***************************************************************************/
 #include "Home.h"
 #include "Util.h"
+#include "RijmTable.h"
 #include <math.h>
 
 #ifdef PARALLEL
@@ -194,239 +195,206 @@ static int DER3INVIND[3][3][3]={{{0,3,4},{3,5,9},{4,9,7}},
                                 {{4,9,7},{9,6,8},{7,8,2}}};
 #endif
 
-/* PBC stress table */
-#ifndef MAXSTRGRID
-#define MAXSTRGRID 51
-#endif
-
-static int   Offset1, Offset2, Offset3;
-static real8 *RIJMTABLE;
-static real8 *RIJMPBCTABLE;
+/*
+ *      Image stress tables.  Depending on the format of the table
+ *      files, the table data is either on the heap or memory mapped.
+ */
+static RijmTable_t rijmTable;
+static RijmTable_t rijmPBCTable;
 static real8 RIJMLX, RIJMLY, RIJMLZ;
 
 
 void FreeRijm(void)
 {
-        if (RIJMTABLE) {
-            free(RIJMTABLE);
-            RIJMTABLE = NULL;
-        }
+        RijmTableFree(&rijmTable);
 
         return;
 }
 
 void FreeRijmPBC(void)
 {
-        if (RIJMPBCTABLE) {
-            free(RIJMPBCTABLE);
-            RIJMPBCTABLE = NULL;
-        }
+        RijmTableFree(&rijmPBCTable);
 
         return;
 }
 
-void ReadRijm(Home_t *home)
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     ReadRijmTable
+ *      Description:  Load the specified Rijm table.  Binary format
+ *                    tables are memory mapped by every task (so tasks
+ *                    on the same node share one copy of the table);
+ *                    text tables are read by task zero and broadcast
+ *                    to all other tasks.
+ *
+ *      Arguments:
+ *          fileName  name of the table file
+ *          tbl       table structure to be populated
+ *
+ *-------------------------------------------------------------------------*/
+static void ReadRijmTable(Home_t *home, char *fileName, RijmTable_t *tbl)
 {
-	FILE	*fp;
-	Param_t	*param;
-	int	i, j, k, m;
-	int	NX, NY, NZ;
-	int	NIMGX, NIMGY, NIMGZ, RIJM_Table_Size;
-	real8	Lx, Ly, Lz;
-	real8	ratiox, ratioy, ratioz;
-	real8	rijml[3];
-
-	param=home->param;
-
-	Offset1 = 10*MAXSTRGRID*MAXSTRGRID;
-	Offset2 = 10*MAXSTRGRID;
-	Offset3 = 10;
-
-	RIJM_Table_Size = (MAXSTRGRID*MAXSTRGRID*MAXSTRGRID*10) * sizeof(real8);
-	RIJMTABLE = (real8 *)calloc(1, RIJM_Table_Size);
+        int     isBinary = 0;
+        real8   Lx, Ly, Lz;
+        real8   ratiox, ratioy, ratioz;
+        Param_t *param;
+#ifdef PARALLEL
+        int     tblInfo[6];
+        real8   rijml[3];
+#endif
+
+        param=home->param;
+
+        if (home->myDomain == 0) {
+            printf("Reading file %s ...\n", fileName);
+            isBinary = RijmTableIsBinary(fileName);
+        }
+
+#ifdef PARALLEL
+        MPI_Bcast(&isBinary, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+
 /*
- *	Only processor zero reads in the table.  It will broadcast the
- *	table (and supporting data) to all other processors
+ *      For binary tables, every task maps the file itself.  If the
+ *      mapping fails for some reason, we fall back to having
+ *      task zero read the table and broadcast it.
  */
-	if (home->myDomain == 0) {
-
-		printf("Reading file %s ...\n",param->Rijmfile);
-		fp=fopen(param->Rijmfile,"r");
-		if(fp==NULL) {
-			fprintf(stderr, "ReadRijm file (%s) not found!\n",
-				param->Rijmfile);
-			exit (-1);
-		}
-
-		fscanf(fp,"%d %d %d",&NX,&NY,&NZ);
-		fscanf(fp,"%le %le %le",&Lx,&Ly,&Lz);
-		fscanf(fp,"%d %d %d",&NIMGX,&NIMGY,&NIMGZ);
-
-		if ((NX>MAXSTRGRID)||(NY>MAXSTRGRID)||(NZ>MAXSTRGRID)) {
-			fprintf(stderr,"NX=%d NY=%d NZ=%d MAXSTRGRID=%d\n",
-				NX,NY,NZ,MAXSTRGRID);
-			Fatal("table size larger than static array");
-		}
-    
-		RIJMLX = Lx;
-		RIJMLY = Ly;
-		RIJMLZ = Lz;
-    
-		Lx=param->Lx;
-		Ly=param->Ly;
-		Lz=param->Lz;
+        if (isBinary) {
+            int mapped, allMapped;
 
-		ratiox=RIJMLX/Lx;
-		ratioy=RIJMLY/Ly;
-		ratioz=RIJMLZ/Lz;
+            mapped = RijmTableMapBinary(fileName, tbl);
+            allMapped = mapped;
+#ifdef PARALLEL
+            MPI_Allreduce(&mapped, &allMapped, 1, MPI_INT, MPI_MIN,
+                          MPI_COMM_WORLD);
+#endif
+            if (!allMapped) {
+                if (mapped) RijmTableFree(tbl);
+                isBinary = 0;
+                if (home->myDomain == 0) {
+                    printf("Unable to map %s, reading instead.\n", fileName);
+                }
+            }
+        }
 
-		if((fabs(ratiox-ratioy)>1e-3)||(fabs(ratioy-ratioz)>1e-3)) {
-			printf("Lx=%e Ly=%e Lz=%e\nLX=%e LY=%e LZ=%e\n",
-				Lx,Ly,Lz,RIJMLX,RIJMLY,RIJMLZ);
-			Fatal("Wrong RIJM Table read in");
-		}
+        if (!isBinary) {
+
+            if (home->myDomain == 0) {
+                if (RijmTableIsBinary(fileName)) {
+                    RijmTable_t mapTbl;
+
+                    if (!RijmTableMapBinary(fileName, &mapTbl)) {
+                        Fatal("ReadRijmTable: Unable to read %s", fileName);
+                    }
+                    RijmTableAlloc(tbl, mapTbl.gridSize);
+                    VECTOR_COPY(tbl->numImages, mapTbl.numImages);
+                    VECTOR_COPY(tbl->boxSize, mapTbl.boxSize);
+                    memcpy(tbl->data, mapTbl.data,
+                           tbl->dataLen * sizeof(real8));
+                    RijmTableFree(&mapTbl);
+                } else {
+                    RijmTableReadText(fileName, tbl);
+                }
+#ifdef PARALLEL
+                VECTOR_COPY(&tblInfo[0], tbl->gridSize);
+                VECTOR_COPY(&tblInfo[3], tbl->numImages);
+                VECTOR_COPY(rijml, tbl->boxSize);
+#endif
+            }
 
+#ifdef PARALLEL
+            MPI_Bcast(tblInfo, 6, MPI_INT, 0, MPI_COMM_WORLD);
+            MPI_Bcast(rijml, 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
 
-		for(i=0;i<NX;i++)
-		for(j=0;j<NY;j++)
-		for(k=0;k<NZ;k++)
-		for(m=0;m<10;m++) {
-			fscanf(fp,"%le\n", &RIJMTABLE[i*Offset1+j*Offset2+k*Offset3+m]);
-		}
+            if (home->myDomain != 0) {
+                RijmTableAlloc(tbl, &tblInfo[0]);
+                VECTOR_COPY(tbl->numImages, &tblInfo[3]);
+                VECTOR_COPY(tbl->boxSize, rijml);
+            }
 
-		fclose(fp);
+            MPI_Bcast(tbl->data, tbl->dataLen, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+        }
 
-		param->imgstrgrid[0]=NX;
-		param->imgstrgrid[1]=NY;
-		param->imgstrgrid[2]=NZ;
-    
-		param->imgstrgrid[3]=NIMGX;
-		param->imgstrgrid[4]=NIMGY;
-		param->imgstrgrid[5]=NIMGZ;
+        RIJMLX = tbl->boxSize[0];
+        RIJMLY = tbl->boxSize[1];
+        RIJMLZ = tbl->boxSize[2];
 
-		rijml[0] = RIJMLX;
-		rijml[1] = RIJMLY;
-		rijml[2] = RIJMLZ;
+        Lx=param->Lx;
+        Ly=param->Ly;
+        Lz=param->Lz;
 
-		printf("done.\n");
-	}
+        ratiox=RIJMLX/Lx;
+        ratioy=RIJMLY/Ly;
+        ratioz=RIJMLZ/Lz;
 
-#ifdef PARALLEL
-	MPI_Bcast((char *)RIJMTABLE, RIJM_Table_Size, MPI_CHAR, 0,
-		MPI_COMM_WORLD);
-	MPI_Bcast((char *)&param->imgstrgrid[0], sizeof(param->imgstrgrid),
-		MPI_CHAR, 0,MPI_COMM_WORLD);
-	MPI_Bcast(&rijml[0], 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-#endif
+        if((fabs(ratiox-ratioy)>1e-3)||(fabs(ratioy-ratioz)>1e-3)) {
+            printf("Lx=%e Ly=%e Lz=%e\nLX=%e LY=%e LZ=%e\n",
+                   Lx,Ly,Lz,RIJMLX,RIJMLY,RIJMLZ);
+            Fatal("Wrong RIJM Table (%s) read in", fileName);
+        }
+
+        param->imgstrgrid[0]=tbl->gridSize[0];
+        param->imgstrgrid[1]=tbl->gridSize[1];
+        param->imgstrgrid[2]=tbl->gridSize[2];
 
-	RIJMLX = rijml[0];
-	RIJMLY = rijml[1];
-	RIJMLZ = rijml[2];
+        param->imgstrgrid[3]=tbl->numImages[0];
+        param->imgstrgrid[4]=tbl->numImages[1];
+        param->imgstrgrid[5]=tbl->numImages[2];
 
-	return;
+        if (home->myDomain == 0) {
+            printf("done.\n");
+        }
+
+        return;
 }
 
-void ReadRijmPBC(Home_t *home)
+
+void ReadRijm(Home_t *home)
 {
-	FILE	*fp;
-	Param_t	*param;
-	int	i, j, k, m;
-	int	NX, NY, NZ;
-	int	NIMGX, NIMGY, NIMGZ, RIJM_Table_Size;
-	real8	Lx, Ly, Lz;
-	real8	ratiox, ratioy, ratioz;
-	real8	rijml[3];
-
-	param=home->param;
-
-	Offset1 = 10*MAXSTRGRID*MAXSTRGRID;
-	Offset2 = 10*MAXSTRGRID;
-	Offset3 = 10;
-
-	RIJM_Table_Size = (MAXSTRGRID*MAXSTRGRID*MAXSTRGRID*10) * sizeof(real8);
-	RIJMPBCTABLE = (real8 *)calloc(1, RIJM_Table_Size);
-/*
- *	Only processor zero reads in the table.  It will broadcast the
- *	table (and supporting data) to all other processors
- */
-	if (home->myDomain == 0) {
-
-		printf("Reading file %s ...\n",param->RijmPBCfile);
-		fp=fopen(param->RijmPBCfile,"r");
-		if(fp==NULL) {
-			fprintf(stderr, "ReadRijmPBC file (%s) not found!\n",
-				param->RijmPBCfile);
-			Fatal("ReadRijmPBC() error");
-		}
-
-		fscanf(fp,"%d %d %d",&NX,&NY,&NZ);
-		fscanf(fp,"%le %le %le",&Lx,&Ly,&Lz);
-		fscanf(fp,"%d %d %d",&NIMGX,&NIMGY,&NIMGZ);
- 
-		RIJMLX = Lx;
-		RIJMLY = Ly;
-		RIJMLZ = Lz;
-
-		Lx=param->Lx;
-		Ly=param->Ly;
-		Lz=param->Lz;
-
-		ratiox=RIJMLX/Lx;
-		ratioy=RIJMLY/Ly;
-		ratioz=RIJMLZ/Lz;
-
-		if((fabs(ratiox-ratioy)>1e-3)||(fabs(ratioy-ratioz)>1e-3)) {
-			printf("Lx=%e Ly=%e Lz=%e\n"
-				"LX=%e LY=%e LZ=%e\n",
-				Lx,Ly,Lz,RIJMLX,RIJMLY,RIJMLZ);
-			Fatal("Wrong RIJMPBC Table read in");
-		}
-   
-		for(i=0;i<NX;i++)
-		for(j=0;j<NY;j++)
-		for(k=0;k<NZ;k++)
-		for(m=0;m<10;m++) {
-			fscanf(fp,"%le\n", &RIJMPBCTABLE[i*Offset1+j*Offset2+k*Offset3+m]);
-		}
-
-		fclose(fp);
-
-		param->imgstrgrid[0]=NX;
-		param->imgstrgrid[1]=NY;
-		param->imgstrgrid[2]=NZ;
-		    
-		param->imgstrgrid[3]=NIMGX;
-		param->imgstrgrid[4]=NIMGY;
-		param->imgstrgrid[5]=NIMGZ;
-
-		rijml[0] = RIJMLX;
-		rijml[1] = RIJMLY;
-		rijml[2] = RIJMLZ;
-
-		printf("done.\n");
-	}
+        ReadRijmTable(home, home->param->Rijmfile, &rijmTable);
 
-#ifdef PARALLEL
-	MPI_Bcast((char *)RIJMPBCTABLE, RIJM_Table_Size, MPI_CHAR,
-		  0, MPI_COMM_WORLD);
-	MPI_Bcast((char *)&param->imgstrgrid[0], sizeof(param->imgstrgrid),
-		MPI_CHAR, 0,MPI_COMM_WORLD);
-	MPI_Bcast(&rijml[0], 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-#endif
+        return;
+}
 
-	RIJMLX = rijml[0];
-	RIJMLY = rijml[1];
-	RIJMLZ = rijml[2];
 
-	return;
+void ReadRijmPBC(Home_t *home)
+{
+        ReadRijmTable(home, home->param->RijmPBCfile, &rijmPBCTable);
+
+        return;
 }
 
-void InterpolateRijm(Home_t *home, real8 rt[3], real8 Rijmarray[10], int pbc)
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:     InterpolateRijmBatch
+ *      Description:  Look up (or interpolate) the Rijm values for a set
+ *                    of field points.  The setup that is common to all
+ *                    points is done only once per call, so callers
+ *                    evaluating many points should prefer this over
+ *                    repeated calls to InterpolateRijm().
+ *
+ *      Arguments:
+ *          numPoints  number of field points
+ *          rt         array of <numPoints> relative field point positions
+ *          Rijmarray  array in which to return the <numPoints> sets of
+ *                     Rijm values
+ *          pbc        array of <numPoints> flags indicating which table
+ *                     to use for each point: non-zero to use the PBC
+ *                     table, zero to use the image-only table.
+ *
+ *-------------------------------------------------------------------------*/
+void InterpolateRijmBatch(Home_t *home, int numPoints, real8 (*rt)[3],
+                          real8 (*Rijmarray)[10], int *pbc)
 {
     Param_t *param;
     real8 Lx, Ly, Lz, alpha, beta, gamma, xmin, ymin, zmin;
-    real8 ratiox, ratio2;
-    int m, NX, NY, NZ, nx, ny, nz;
+    real8 ratiox, ratio2, scaleX, scaleY, scaleZ;
+    real8 *vals;
+    int p, m, NX, NY, NZ, nx, ny, nz;
+    RijmTable_t *tbl;
 
     param=home->param;
     NX=param->imgstrgrid[0];
@@ -442,67 +410,94 @@ void InterpolateRijm(Home_t *home, real8 rt[3], real8 Rijmarray[10], int pbc)
     Lz=param->Lz;
     ratiox=RIJMLX/Lx;
     ratio2=ratiox*ratiox;
+
+    scaleX=(NX-1)/Lx;
+    scaleY=(NY-1)/Ly;
+    scaleZ=(NZ-1)/Lz;
     
-    alpha=(rt[0]-xmin)/Lx*(NX-1);
-    beta =(rt[1]-ymin)/Ly*(NY-1);
-    gamma=(rt[2]-zmin)/Lz*(NZ-1);
+    for (p = 0; p < numPoints; p++) {
 
-    while(alpha<    0) alpha+=(NX-1);
-    while(alpha>=NX-1) alpha-=(NX-1);
-    while(beta <    0) beta +=(NY-1);
-    while(beta >=NY-1) beta -=(NY-1);
-    while(gamma<    0) gamma+=(NZ-1);
-    while(gamma>=NZ-1) gamma-=(NZ-1);
+        tbl = pbc[p] ? &rijmPBCTable : &rijmTable;
+        vals = Rijmarray[p];
 
-#ifdef _CUBICINTERPOLATE
-    nx=(int)floor(alpha);
-    ny=(int)floor(beta );
-    nz=(int)floor(gamma);
+        alpha=(rt[p][0]-xmin)*scaleX;
+        beta =(rt[p][1]-ymin)*scaleY;
+        gamma=(rt[p][2]-zmin)*scaleZ;
 
-    alpha-=nx;
-    beta -=ny;
-    gamma-=nz;
-
-    if (pbc)
-    for(m=0;m<10;m++)
-        Rijmarray[m]=
-             (1-alpha)*(1-beta)*(1-gamma)*RIJMPBCTABLE[nx*Offset1+ny*Offset2+nz*Offset3+m]
-            +(1-alpha)*(1-beta)*(  gamma)*RIJMPBCTABLE[nx*Offset1+ny*Offset2+(nz+1)*Offset3+m]   
-            +(1-alpha)*(  beta)*(1-gamma)*RIJMPBCTABLE[nx*Offset1+(ny+1)*Offset2+nz*Offset3+m]    
-            +(1-alpha)*(  beta)*(  gamma)*RIJMPBCTABLE[nx*Offset1+(ny+1)*Offset2+(nz+1)*Offset3+m]    
-            +(  alpha)*(1-beta)*(1-gamma)*RIJMPBCTABLE[(nx+1)*Offset1+ny*Offset2+nz*Offset3+m]   
-            +(  alpha)*(1-beta)*(  gamma)*RIJMPBCTABLE[(nx+1)*Offset1+ny*Offset2+(nz+1)*Offset3+m]
-            +(  alpha)*(  beta)*(1-gamma)*RIJMPBCTABLE[(nx+1)*Offset1+(ny+1)*Offset2+nz*Offset3+m]    
-            +(  alpha)*(  beta)*(  gamma)*RIJMPBCTABLE[(nx+1)*Offset1+(ny+1)*Offset2+(nz+1)*Offset3+m];
-    else
-    for(m=0;m<10;m++)
-        Rijmarray[m]=
-             (1-alpha)*(1-beta)*(1-gamma)*RIJMTABLE[nx*Offset1+ny*Offset2+nz*Offset3+m]
-            +(1-alpha)*(1-beta)*(  gamma)*RIJMTABLE[nx*Offset1+ny*Offset2+(nz+1)*Offset3+m]   
-            +(1-alpha)*(  beta)*(1-gamma)*RIJMTABLE[nx*Offset1+(ny+1)*Offset2+nz*Offset3+m]    
-            +(1-alpha)*(  beta)*(  gamma)*RIJMTABLE[nx*Offset1+(ny+1)*Offset2+(nz+1)*Offset3+m]    
-            +(  alpha)*(1-beta)*(1-gamma)*RIJMTABLE[(nx+1)*Offset1+ny*Offset2+nz*Offset3+m]   
-            +(  alpha)*(1-beta)*(  gamma)*RIJMTABLE[(nx+1)*Offset1+ny*Offset2+(nz+1)*Offset3+m]
-            +(  alpha)*(  beta)*(1-gamma)*RIJMTABLE[(nx+1)*Offset1+(ny+1)*Offset2+nz*Offset3+m]    
-            +(  alpha)*(  beta)*(  gamma)*RIJMTABLE[(nx+1)*Offset1+(ny+1)*Offset2+(nz+1)*Offset3+m];
+        while(alpha<    0) alpha+=(NX-1);
+        while(alpha>=NX-1) alpha-=(NX-1);
+        while(beta <    0) beta +=(NY-1);
+        while(beta >=NY-1) beta -=(NY-1);
+        while(gamma<    0) gamma+=(NZ-1);
+        while(gamma>=NZ-1) gamma-=(NZ-1);
 
+#ifdef _CUBICINTERPOLATE
+        {
+            int   ix, iy, iz, offset;
+            real8 wx, wy, wz, w;
+
+            nx=(int)floor(alpha);
+            ny=(int)floor(beta );
+            nz=(int)floor(gamma);
+
+            alpha-=nx;
+            beta -=ny;
+            gamma-=nz;
+
+            for(m=0;m<10;m++) vals[m]=0.0;
+
+            for (ix = 0; ix < 2; ix++) {
+                wx = ix ? alpha : 1.0-alpha;
+                for (iy = 0; iy < 2; iy++) {
+                    wy = iy ? beta : 1.0-beta;
+                    for (iz = 0; iz < 2; iz++) {
+                        wz = iz ? gamma : 1.0-gamma;
+                        w = wx * wy * wz;
+                        offset = RIJM_TABLE_OFFSET(tbl, nx+ix, ny+iy, nz+iz);
+                        for(m=0;m<10;m++)
+                            vals[m] += w * tbl->data[offset+m];
+                    }
+                }
+            }
+        }
 #else
-    nx=(int)rint(alpha);
-    ny=(int)rint(beta );
-    nz=(int)rint(gamma);
+        nx=(int)rint(alpha);
+        ny=(int)rint(beta );
+        nz=(int)rint(gamma);
 
-    if (pbc)
-    for(m=0;m<10;m++)
-            Rijmarray[m]=RIJMPBCTABLE[nx*Offset1+ny*Offset2+nz*Offset3+m];
-    else
-    for(m=0;m<10;m++)
-            Rijmarray[m]=RIJMTABLE[nx*Offset1+ny*Offset2+nz*Offset3+m];
+        {
+            real8 *tblVals;
 
+            tblVals = &tbl->data[RIJM_TABLE_OFFSET(tbl, nx, ny, nz)];
+
+            for(m=0;m<10;m++)
+                vals[m]=tblVals[m];
+        }
 #endif
-	/* scale stress */
-	for(m=0;m<10;m++)
-	Rijmarray[m]*=ratio2;
+        /* scale stress */
+        for(m=0;m<10;m++)
+            vals[m]*=ratio2;
+    }
 
+    return;
+}
+
+
+void InterpolateRijm(Home_t *home, real8 rt[3], real8 Rijmarray[10], int pbc)
+{
+    real8 pt[1][3], vals[1][10];
+    int   m;
+
+    pt[0][0] = rt[0];
+    pt[0][1] = rt[1];
+    pt[0][2] = rt[2];
+
+    InterpolateRijmBatch(home, 1, pt, vals, &pbc);
+
+    for(m=0;m<10;m++)
+        Rijmarray[m]=vals[0][m];
+
+    return;
 }
 
 #if 0
@@ -594,26 +589,45 @@ void dSegImgStress(Home_t *home,
      *
      * Wei Cai, 7/6/2002
      */
-    real8 rt[3], Rmpp[3], dl[3], bxdl[3], bxRmpp[3];
-    real8 Rijmarray[10], Rijm[3][3][3], Rijmterm[3][3][3];
-/*    real8 R, R2, R3;  */
-    real8 MUover4pi, onepois;
-    int i, j, m;
-
-    MUover4pi = home->param->shearModulus/4/M_PI ;
-    onepois = 1./(1.- home->param->pois) ;
+    real8 rt[3], Rijmarray[10];
 
-    dl[0]=dlx; dl[1]=dly; dl[2]=dlz;
     rt[0]=rx-px; rt[1]=ry-py; rt[2]=rz-pz;
-/*    R2=rt[0]*rt[0]+rt[1]*rt[1]+rt[2]*rt[2];
-      R=sqrt(R2); R3=R*R2;
-*/
 
 #if 0 /* instead of computing Rijmarray for the primary dislocation */
     CalRijm(rt, Rijmarray);
 #else /* use the Rijm table for image sources */
     InterpolateRijm(home, rt, Rijmarray, pbc);
 #endif
+
+    dSegImgStressRijm(home, Sigma, Rijmarray, dlx, dly, dlz,
+                      burgX, burgY, burgZ);
+
+    return;
+}
+
+
+void dSegImgStressRijm(Home_t *home,
+                       real8  Sigma[][3],
+                       real8  Rijmarray[10],
+                       real8  dlx,   real8 dly,   real8 dlz,
+                       real8  burgX, real8 burgY, real8 burgZ)
+{
+    /* calculate image stress due to a differential dislocation segment
+     * from the Rijm values previously looked up for the relative
+     * position of the field point (see InterpolateRijmBatch()).
+     * Sigma[3][3] return stress
+     * Rijmarray[10] Rijm values for the field point
+     * (dlx, dly, dlz) vector of segment length
+     * (burgX, burgY, burgZ) Burgers vector
+     */
+    real8 Rmpp[3], dl[3], bxdl[3], bxRmpp[3];
+    real8 Rijm[3][3][3];
+    real8 MUover4pi, onepois;
+
+    MUover4pi = home->param->shearModulus/4/M_PI ;
+    onepois = 1./(1.- home->param->pois) ;
+
+    dl[0]=dlx; dl[1]=dly; dl[2]=dlz;
     
 /*
     for(i=0;i<3;i++)
@@ -7,88 +7,155 @@
 #include "Home.h"
 #include "TF.h"
 
-void ABCcoeff(ThinFilm_t *thinfilm)
+#ifdef PARALLEL
+static void GatherCoeffs(Home_t *home, ThinFilm_t *thinfilm)
+{
+/*
+ * Give every domain the A, B, C, E, F, G coefficients of all the
+ * modes.  Only needed when DispStress sums the modes directly.
+ */
+  int c, d, i, m, n, col0, cols, nmc;
+  int *counts, *displs, *modeCol;
+  COMPLEX *sendBuf, *recvBuf;
+  COMPLEX **coeff[6];
+
+  int nx = thinfilm->nx;
+  int ny = thinfilm->ny;
+  int nyh = thinfilm->tractionFFT.nyh;
+  int numDomains = home->numDomains;
+
+  coeff[0] = thinfilm->A; coeff[1] = thinfilm->B; coeff[2] = thinfilm->C;
+  coeff[3] = thinfilm->E; coeff[4] = thinfilm->F; coeff[5] = thinfilm->G;
+
+  counts  = (int *)malloc(sizeof(int)*numDomains);
+  displs  = (int *)malloc(sizeof(int)*numDomains);
+  modeCol = (int *)malloc(sizeof(int)*(ny+1));
+
+  for (d=0, n=0; d<numDomains; d++)
+    {
+      col0 = TF_SLAB_START(nyh, d, numDomains);
+      cols = TF_SLAB_START(nyh, d+1, numDomains) - col0;
+      nmc  = fourier_transform_mode_cols(ny, col0, cols, modeCol);
+
+      counts[d] = 2*6*nmc*nx;
+      displs[d] = n;
+      n += counts[d];
+    }
+
+  sendBuf = (COMPLEX *)malloc(sizeof(COMPLEX)*(6*thinfilm->numModeCols*nx+1));
+  recvBuf = (COMPLEX *)malloc(sizeof(COMPLEX)*6*ny*nx);
+
+  for (m=0, n=0; m<thinfilm->numModeCols; m++)
+    for (c=0; c<6; c++)
+      for (i=0; i<nx; i++)
+	sendBuf[n++] = coeff[c][i][thinfilm->modeCol[m]];
+
+  MPI_Allgatherv(sendBuf, 2*6*thinfilm->numModeCols*nx, MPI_DOUBLE,
+		 recvBuf, counts, displs, MPI_DOUBLE, MPI_COMM_WORLD);
+
+  for (d=0, n=0; d<numDomains; d++)
+    {
+      col0 = TF_SLAB_START(nyh, d, numDomains);
+      cols = TF_SLAB_START(nyh, d+1, numDomains) - col0;
+      nmc  = fourier_transform_mode_cols(ny, col0, cols, modeCol);
+
+      for (m=0; m<nmc; m++)
+	for (c=0; c<6; c++)
+	  for (i=0; i<nx; i++)
+	    coeff[c][i][modeCol[m]] = recvBuf[n++];
+    }
+
+  free(sendBuf);
+  free(recvBuf);
+  free(counts);
+  free(displs);
+  free(modeCol);
+}
+#endif
+
+void ABCcoeff(Home_t *home, ThinFilm_t *thinfilm)
 
 /*
  * This program  computes A, B, C, E, F, G coeffs for linear 
  * elastic solution of a thin film with height t
  * Sylvie Aubry Mar 3 2008
  *
+ * Each domain computes the coefficients of the ky columns it owns
+ * after the distributed traction transform (thinfilm->modeCol).
  */
 {
-  int i,j;
-
-#ifndef _CYGWIN
-  fftw_complex *txp,*typ,*tzp,*txm,*tym,*tzm;
-#else
-  complex *txp,*typ,*tzp,*txm,*tym,*tzm;
-#endif
+  int i,j,m,c,ih,jl,mirror;
 
   COMPLEX txS,tyS,tzS,txA,tyA,tzA;
+  COMPLEX tt[6];
+  TractionFFT_t *fft = &thinfilm->tractionFFT;
+  COMPLEX *out;
   int nx = thinfilm->nx;
   int ny = thinfilm->ny;
 
   int nxy = nx*ny;
 
-   txp = (COMPLEX *) malloc(sizeof(COMPLEX)*nx*ny);
-   typ = (COMPLEX *) malloc(sizeof(COMPLEX)*nx*ny);
-   tzp = (COMPLEX *) malloc(sizeof(COMPLEX)*nx*ny);
-
-   txm = (COMPLEX *) malloc(sizeof(COMPLEX)*nx*ny);
-   tym = (COMPLEX *) malloc(sizeof(COMPLEX)*nx*ny);
-   tzm = (COMPLEX *) malloc(sizeof(COMPLEX)*nx*ny);
+  // tt[0..2] : top surface txp, typ, tzp
+  // tt[3..5] : bottom surface txm, tym, tzm
+  fourier_transform_tractions(home,fft);
 
-   fourier_transform_forward(thinfilm->Txp,(fftw_complex *)txp,nx,ny);
-   fourier_transform_forward(thinfilm->Typ,(fftw_complex *)typ,nx,ny);
-   fourier_transform_forward(thinfilm->Tzp,(fftw_complex *)tzp,nx,ny);
-
-   fourier_transform_forward(thinfilm->Txm,(fftw_complex *)txm,nx,ny);
-   fourier_transform_forward(thinfilm->Tym,(fftw_complex *)tym,nx,ny);
-   fourier_transform_forward(thinfilm->Tzm,(fftw_complex *)tzm,nx,ny);
+  out = (COMPLEX *)fft->out;
    
-   for (i=0; i<nx; i++)
-     for (j=0; j<ny; j++)
-       {
-         txS = (txp[j+i*ny] - txm[j+i*ny])/(2.0*nxy);
-	 tyS = (typ[j+i*ny] - tym[j+i*ny])/(2.0*nxy);
-	 tzS = (tzp[j+i*ny] - tzm[j+i*ny])/(2.0*nxy);
+  for (m=0; m<thinfilm->numModeCols; m++)
+    {
+      // Columns with negative ky are the conjugates of the mirrored
+      // modes t(i,j) = conj(t(-i,-j)).
+      j      = thinfilm->modeCol[m];
+      mirror = (j >= fft->nyh);
+      jl     = (mirror ? ny-j : j) - fft->col0;
+
+      for (i=0; i<nx; i++)
+	{
+	  ih = mirror ? (nx-i) % nx : i;
+
+	  for (c=0; c<6; c++)
+	    {
+	      tt[c] = out[(c*fft->cols+jl)*nx+ih];
+	      if (mirror) tt[c] = conj(tt[c]);
+	    }
+
+	  txS = (tt[0] - tt[3])/(2.0*nxy);
+	  tyS = (tt[1] - tt[4])/(2.0*nxy);
+	  tzS = (tt[2] - tt[5])/(2.0*nxy);
 	 
-	 txA = (txp[j+i*ny] + txm[j+i*ny])/(2.0*nxy);
-	 tyA = (typ[j+i*ny] + tym[j+i*ny])/(2.0*nxy);
-	 tzA = (tzp[j+i*ny] + tzm[j+i*ny])/(2.0*nxy);
-
-	 thinfilm->A[i][j] =   thinfilm->MsInv[0][0][i][j]*txA + 
-	                       thinfilm->MsInv[0][1][i][j]*tyA + 
-	                       thinfilm->MsInv[0][2][i][j]*tzS;
-	 thinfilm->B[i][j] =   thinfilm->MsInv[1][0][i][j]*txA + 
-                               thinfilm->MsInv[1][1][i][j]*tyA + 
-		               thinfilm->MsInv[1][2][i][j]*tzS;
-	 thinfilm->C[i][j] =   thinfilm->MsInv[2][0][i][j]*txA + 
-                               thinfilm->MsInv[2][1][i][j]*tyA + 
-		               thinfilm->MsInv[2][2][i][j]*tzS;
-
-	 thinfilm->E[i][j] =   thinfilm->MaInv[0][0][i][j]*txS + 
-                               thinfilm->MaInv[0][1][i][j]*tyS + 
-		               thinfilm->MaInv[0][2][i][j]*tzA;
-	 thinfilm->F[i][j] =   thinfilm->MaInv[1][0][i][j]*txS + 
-                               thinfilm->MaInv[1][1][i][j]*tyS + 
-		               thinfilm->MaInv[1][2][i][j]*tzA;
-	 thinfilm->G[i][j] =   thinfilm->MaInv[2][0][i][j]*txS + 
-                               thinfilm->MaInv[2][1][i][j]*tyS + 
-		               thinfilm->MaInv[2][2][i][j]*tzA;
-       } 
-
-   free(txp);
-   free(typ);
-   free(tzp);
-
-   free(txm);
-   free(tym);
-   free(tzm);
-
-   return;  
+	  txA = (tt[0] + tt[3])/(2.0*nxy);
+	  tyA = (tt[1] + tt[4])/(2.0*nxy);
+	  tzA = (tt[2] + tt[5])/(2.0*nxy);
+
+	  thinfilm->A[i][j] =   thinfilm->MsInv[0][0][i][j]*txA + 
+	                        thinfilm->MsInv[0][1][i][j]*tyA + 
+	                        thinfilm->MsInv[0][2][i][j]*tzS;
+	  thinfilm->B[i][j] =   thinfilm->MsInv[1][0][i][j]*txA + 
+                                thinfilm->MsInv[1][1][i][j]*tyA + 
+		                thinfilm->MsInv[1][2][i][j]*tzS;
+	  thinfilm->C[i][j] =   thinfilm->MsInv[2][0][i][j]*txA + 
+                                thinfilm->MsInv[2][1][i][j]*tyA + 
+		                thinfilm->MsInv[2][2][i][j]*tzS;
+
+	  thinfilm->E[i][j] =   thinfilm->MaInv[0][0][i][j]*txS + 
+                                thinfilm->MaInv[0][1][i][j]*tyS + 
+		                thinfilm->MaInv[0][2][i][j]*tzA;
+	  thinfilm->F[i][j] =   thinfilm->MaInv[1][0][i][j]*txS + 
+                                thinfilm->MaInv[1][1][i][j]*tyS + 
+		                thinfilm->MaInv[1][2][i][j]*tzA;
+	  thinfilm->G[i][j] =   thinfilm->MaInv[2][0][i][j]*txS + 
+                                thinfilm->MaInv[2][1][i][j]*tyS + 
+		                thinfilm->MaInv[2][2][i][j]*tzA;
+	}
+    } 
+
+#ifdef PARALLEL
+  if (!thinfilm->imgStressFFT && home->numDomains > 1)
+    GatherCoeffs(home,thinfilm);
+#endif
+
+  return;  
 }
 
 #endif
 #endif
-
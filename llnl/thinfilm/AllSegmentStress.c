@@ -52,6 +52,8 @@ static real8 *cellCterZ = (real8 *)NULL;
 #endif
 
 int isRightDom(Home_t *home,real8 x, real8 y, real8 z);
+static void NbrCellRange(Param_t *param, int cellIndex[3],
+			 int minIndex[3], int maxIndex[3]);
 void LocalStress(Home_t *home, ThinFilm_t *thinfilm, 
 		 real8 LenVirtualSeg, real8 x, real8 y,real8 z,
 		 int cellIndex[3],real8 locStress[3][3]);
@@ -179,6 +181,111 @@ int isRightDom(Home_t *home,real8 x, real8 y, real8 z)
   return DomID;
 }
 
+/*
+ *      Cells (including the periodic images) holding the 3x3x3 block
+ *      of cells LocalStress sums over for a point in cell <cellIndex>.
+ *      Indices are in [0, ncells+1] when PBC are on, cells 0 and
+ *      ncells+1 being the periodic images.
+ */
+static void NbrCellRange(Param_t *param, int cellIndex[3],
+			 int minIndex[3], int maxIndex[3])
+{
+  int i, nCells[3], boundType[3];
+
+  nCells[0] = param->nXcells;
+  nCells[1] = param->nYcells;
+  nCells[2] = param->nZcells;
+
+  boundType[0] = param->xBoundType;
+  boundType[1] = param->yBoundType;
+  boundType[2] = param->zBoundType;
+
+  for (i = 0; i < 3; i++) 
+    {
+      if (boundType[i] == Periodic) {
+	minIndex[i] = MAX(0, cellIndex[i]-1);
+	maxIndex[i] = MIN(nCells[i]+1, cellIndex[i]+1);
+      } else {
+	minIndex[i] = MAX(1, cellIndex[i]-1);
+	maxIndex[i] = MIN(nCells[i], cellIndex[i]+1);
+      }
+    }
+}
+
+
+/*
+ *      Flag (by cell ID) the base cells holding at least one native
+ *      node with arms.  Only those cells contribute to LocalStress
+ *      on this domain.  The caller frees the returned array.
+ */
+char *MarkNativeSegCells(Home_t *home)
+{
+  int     i, numCells, cellID;
+  char    *nativeSegCell;
+  Node_t  *node;
+  Cell_t  *cell;
+  Param_t *param;
+
+  param = home->param;
+
+  numCells = (param->nXcells+2) * (param->nYcells+2) * (param->nZcells+2);
+  nativeSegCell = (char *)calloc(1, numCells * sizeof(char));
+
+  for (i = 0; i < home->cellCount; i++) 
+    {
+      cellID = home->cellList[i];
+      cell = home->cellKeys[cellID];
+      if (cell == (Cell_t *)NULL) continue;
+
+      for (node = cell->nodeQ; node != (Node_t *)NULL; node = node->nextInCell)
+	{
+	  if ((node->myTag.domainID == home->myDomain) && (node->numNbrs > 0))
+	    {
+	      nativeSegCell[cellID] = 1;
+	      break;
+	    }
+	}
+    }
+
+  return nativeSegCell;
+}
+
+
+/*
+ *      Returns 1 if any cell LocalStress visits for the point (x,y,z)
+ *      is flagged in <nativeSegCell> (see MarkNativeSegCells), i.e. if
+ *      this domain's segments contribute to the local stress there.
+ */
+int NearNativeSegs(Home_t *home, char *nativeSegCell,
+		   real8 x, real8 y, real8 z)
+{
+  int     cx, cy, cz, cellID;
+  int     cellIndex[3], minIndex[3], maxIndex[3];
+  real8   coord[3];
+  Cell_t  *cell;
+
+  coord[0]=x;coord[1]=y;coord[2]=z;
+  LocateCell(home,&cellID,cellIndex,coord);
+
+  NbrCellRange(home->param, cellIndex, minIndex, maxIndex);
+
+  for (cx = minIndex[0]; cx <= maxIndex[0]; cx++) 
+    for (cy = minIndex[1]; cy <= maxIndex[1]; cy++) 
+      for (cz = minIndex[2]; cz <= maxIndex[2]; cz++) 
+	{
+	  cellID = EncodeCellIdx(home, cx, cy, cz);
+	  cell = home->cellKeys[cellID];
+
+	  if (cell == (Cell_t *)NULL) continue;
+	  if (cell->baseIdx >= 0) cellID = cell->baseIdx;
+
+	  if (nativeSegCell[cellID]) return 1;
+	}
+
+  return 0;
+}
+
+
 #if 0
 // Similar to LocalSegForces
 void LocalStress2(Home_t *home, ThinFilm_t *thinfilm, 
@@ -526,6 +633,7 @@ void LocalStress(Home_t *home, ThinFilm_t *thinfilm,
   real8 minXIndex, minYIndex, minZIndex;
   real8 midXIndex, midYIndex, midZIndex;
   int  maxXIndex, maxYIndex, maxZIndex;
+  int  minIndex[3], maxIndex[3];
   real8 a, MU, NU, Ecore, t;
   real8 stress[6],sigmaYoffe[3][3];
   real8 bx, by, bz;
@@ -577,29 +685,11 @@ void LocalStress(Home_t *home, ThinFilm_t *thinfilm,
  *      cells 0 and param->ncells+1 are added for PBC.
  */
 
-  if (param->xBoundType == Periodic) {
-    minXIndex = MAX(0, cellIndex[0]-1);
-    maxXIndex = MIN(param->nXcells+1, cellIndex[0]+1);
-  } else {
-    minXIndex = MAX(1, cellIndex[0]-1);
-    maxXIndex = MIN(param->nXcells, cellIndex[0]+1);
-  }
-  
-  if (param->yBoundType == Periodic) {
-    minYIndex = MAX(0, cellIndex[1]-1);
-    maxYIndex = MIN(param->nYcells+1, cellIndex[1]+1);
-  } else {
-    minYIndex = MAX(1, cellIndex[1]-1);
-    maxYIndex = MIN(param->nYcells, cellIndex[1]+1);
-  }
-  
-  if (param->zBoundType == Periodic) {
-    minZIndex = MAX(0, cellIndex[2]-1);
-    maxZIndex = MIN(param->nZcells+1, cellIndex[2]+1);
-  } else {
-    minZIndex = MAX(1, cellIndex[2]-1);
-    maxZIndex = MIN(param->nZcells, cellIndex[2]+1);
-  }
+  NbrCellRange(param, cellIndex, minIndex, maxIndex);
+
+  minXIndex = minIndex[0]; maxXIndex = maxIndex[0];
+  minYIndex = minIndex[1]; maxYIndex = maxIndex[1];
+  minZIndex = minIndex[2]; maxZIndex = maxIndex[2];
 
 #if deb
   printf("minXIndex=%d maxXIndex=%d\n",minXIndex,maxXIndex);
@@ -640,11 +730,18 @@ void LocalStress(Home_t *home, ThinFilm_t *thinfilm,
  *                  Loop over all nodes in this cell and over each segment
  *                  attached to the node.  Skip any segment that is not
  *                  owned by node1.
+ *
+ *                  The cell queues also hold ghost nodes.  Only segments
+ *                  whose node1 is native are summed here, so that each
+ *                  segment is counted by exactly one domain when the
+ *                  partial stresses are summed over all domains.
  */
 		  
 	node1 = cell->nodeQ;
 	
 	for (; node1 != (Node_t *)NULL; node1=node1->nextInCell) {
+	  if (node1->myTag.domainID != home->myDomain) continue;
+
 	  for (arm = 0; arm < node1->numNbrs; arm++) {
 	    
 	    node2 = GetNeighborNode(home, node1, arm);
@@ -1,134 +1,571 @@
+#include <string.h>
+
 #include "Home.h"
+#include "Util.h"
 #include "TF.h"
 
-void DispStress(ThinFilm_t *thinfilm,real8 r[3], real8 stress[3][3])
-{
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 /***************************************************************************
- * This program computes the stress from the displacement field using 
- * elasticity theory in a thin film and tractions computed in TFUtil.c
- * from AllSegmentStress.c
- * Sylvie Aubry, Wed Feb 27 2008
+ * The image stress at a point r is the sum over all nx*ny Fourier modes
+ * of the stress coefficients built from A, B, C, E, F, G times
+ * exp(i(kx x+ky y)).
+ *
+ * Summing the modes directly for each segment midpoint costs O(nx*ny)
+ * per point.  Instead, once per cycle (after ABCcoeff), TF_ImgStressGrid
+ * evaluates the sum on a set of layers through the film thickness with
+ * one inverse FFT per stress component and layer, on an in-plane grid
+ * oversampled by param->tf_imgStressOversample to keep the interpolation
+ * error small.  DispStress then only interpolates the tabulated stress
+ * (trilinear, periodic in x and y).  When tf_imgStressFFT is zero the
+ * direct modal sum is used.
+ *
+ * The tabulation is distributed over the domains (see TF_ImgStressGrid)
+ * and each domain only receives the x rows of the grid around its own
+ * segments, flagged in thinfilm->imgRowValid.
+ *
+ * Layout of thinfilm->imgStress: imgNz layers of imgNx*imgNy grid
+ * points with the 6 independent components of each point contiguous:
+ *
+ *   imgStress[((k*imgNx + p)*imgNy + q)*6 + c]
+ *
+ * with c = 0..5 for xx, yy, zz, zx, yz, xy.
  *
+ * The stress of the refined surface patches (see SurfacePatches.c) is
+ * added on top, by direct modal sums over the few patches whose domain
+ * holds the point.
  **************************************************************************/
 
-  int k,l,i, j, m, n;
+#define IMG_INDEX(k,p,q,c) \
+        ((((k)*thinfilm->imgNx + (p))*thinfilm->imgNy + (q))*6 + (c))
+
+static void ModeStress(ThinFilm_t *thinfilm, int i, int j, real8 z,
+                       COMPLEX s[6])
+{
+/***************************************************************************
+ * Stress coefficients of mode (i,j) at height z without the in-plane
+ * phase factor exp(i(kx x+ky y)).
+ **************************************************************************/
   double kx, ky;
-  double kz, kx2, ky2, kz2, kz3, kxy, kxz, kyz,kxmy;
+  double kz, kx2, ky2, kz2, kxy, kxmy;
   double lm, l2m,lpm,lmpm,l2mpm;
-  double coshk, sinhk,alpha;
-  double x,y,z;
+  double coshk, sinhk;
   COMPLEX expk;
-  
-  int nx     = thinfilm->nx;
-  int ny     = thinfilm->ny;
-  double  t  = thinfilm->t;
 
-  double TFLx     = thinfilm->TFLx;
-  double TFLy     = thinfilm->TFLy;
   double mu       = thinfilm->mu;
   double lambda   = thinfilm->lambda;
 
+#ifdef _CYGWIN
+  COMPLEX I = complex(0.0, 1.0);
+#endif
+
   lm  = lambda + mu;
   l2m = lm     + mu;
   lmpm= lambda/lm;
   l2mpm= l2m/lm;
   lpm = mu/lm;
 
-  // r is the point at the mid segment between two nodes.
-  // stress is evaluated for each kx,ky in [1:nx]*[1:ny] at this point
-  
-  for (i=0; i<3; i++) 
-    for (j = 0; j < 3; j++)
-      stress[i][j] = 0.0;
-  
+  kx = thinfilm->kx[i];
+  ky = thinfilm->ky[j];
+
+  kx2 = kx*kx;
+  ky2 = ky*ky;
+
+  kz2 = kx2+ky2;
+  kxmy = kx2-ky2;
+
+  kz  = sqrt(kz2);
+  kxy = kx*ky;
+
+  COMPLEX AA = thinfilm->A[i][j];
+  COMPLEX BB = thinfilm->B[i][j];
+  COMPLEX CC = thinfilm->C[i][j];
+  COMPLEX EE = thinfilm->E[i][j];
+  COMPLEX FF = thinfilm->F[i][j];
+  COMPLEX GG = thinfilm->G[i][j];
+
+  coshk = cosh(kz*z);
+  sinhk = sinh(kz*z);
+  expk  = mu;
+
+  s[0] =
+    2.0*expk*((I*AA*lmpm*kz + (I*EE*kx2*z+I*BB*kxy-CC*kx2))*coshk +
+	      (I*EE*lmpm*kz + (I*AA*kx2*z-I*FF*kxy-GG*kx2))*sinhk);
+
+  s[1] =
+    2.0*expk*((I*AA*lmpm*kz + (I*EE*ky2*z-I*BB*kxy-CC*ky2))*coshk +
+	      (I*EE*lmpm*kz + (I*AA*ky2*z+I*FF*kxy-GG*ky2))*sinhk);
+
+  s[2] =
+    -2.0*expk*((kz2*(I*EE*z - CC)-l2mpm*I*AA*kz)*coshk +
+	       (kz2*(I*AA*z - GG)-l2mpm*I*EE*kz)*sinhk);
+
+  s[3] =
+    expk*(((2.0*AA*kx*z-FF*ky+2.0*I*GG*kx)*kz-2.0*EE*kx*lpm)*coshk +
+	  ((2.0*EE*kx*z+BB*ky+2.0*I*CC*kx)*kz-2.0*AA*kx*lpm)*sinhk);
+
+  s[4] =
+    expk*(((2.0*AA*ky*z+FF*kx+2.0*I*GG*ky)*kz-2.0*EE*ky*lpm)*coshk +
+	  ((2.0*EE*ky*z-BB*kx+2.0*I*CC*ky)*kz-2.0*AA*ky*lpm)*sinhk);
+
+  s[5] =
+    I*expk*((2.0*EE*kxy*z-kxmy*BB+2.0*I*kxy*CC)*coshk +
+	    (2.0*AA*kxy*z+kxmy*FF+2.0*I*kxy*GG)*sinhk);
+}
+
+static void DispStressDirect(ThinFilm_t *thinfilm,real8 r[3],
+                             real8 stress[3][3])
+{
+  int i, j, c;
+  double x,y,z;
+  double alpha, sig[6];
+  COMPLEX phase, s[6];
+
+  int nx     = thinfilm->nx;
+  int ny     = thinfilm->ny;
+
+  double TFLx     = thinfilm->TFLx;
+  double TFLy     = thinfilm->TFLy;
+
+#ifdef _CYGWIN
+  COMPLEX I = complex(0.0, 1.0);
+#endif
+
+  // Translated for FFT origin accuracy
+  x = r[0] + TFLx*0.5;
+  y = r[1] + TFLy*0.5;
   z = r[2];
 
-  if (fabs(z) > t) return;
-  
+  for (c=0; c<6; c++) sig[c] = 0.0;
+
+  for (j=0; j<ny; j++)
+    for (i=0; i<nx; i++)
+      {
+	ModeStress(thinfilm,i,j,z,s);
+
+	alpha = thinfilm->kx[i]*x+thinfilm->ky[j]*y;
+	phase = cos(alpha)+I*sin(alpha);
+
+	for (c=0; c<6; c++)
+	  {
+#ifndef _CYGWIN
+	    sig[c] += creal(phase*s[c]);
+#else
+	    sig[c] += real(phase*s[c]);
+#endif
+	  }
+      }
+
+  stress[0][0] = sig[0];
+  stress[1][1] = sig[1];
+  stress[2][2] = sig[2];
+  stress[2][0] = sig[3];
+  stress[1][2] = sig[4];
+  stress[0][1] = sig[5];
+}
+
+static void PatchStress(ThinFilm_t *thinfilm, real8 r[3],
+                        real8 stress[3][3])
+{
+/***************************************************************************
+ * Add the stress of the surface patches at point r to the six
+ * independent components of stress.  The patch coefficients are
+ * swapped into a private copy of the model patch so that threads can
+ * evaluate points concurrently.
+ **************************************************************************/
+  int n;
+  real8 rl[3], s[3][3];
+  ThinFilm_t patch;
+  SurfacePatch_t *p;
+
+  patch = *thinfilm->patchModel;
 
-  for (j=0; j<ny; j++) 
+  for (n=0; n<thinfilm->numPatches; n++)
     {
-      ky = thinfilm->ky[j];
-      ky2 = ky*ky;
-      
-      for (i=0; i<nx; i++) 
+      p = &thinfilm->patches[n];
+
+      // Nearest periodic image of the point relative to the patch center
+      rl[0] = r[0] - p->center[0];
+      rl[1] = r[1] - p->center[1];
+      rl[2] = r[2];
+
+      rl[0] -= thinfilm->TFLx*rint(rl[0]/thinfilm->TFLx);
+      rl[1] -= thinfilm->TFLy*rint(rl[1]/thinfilm->TFLy);
+
+      if (fabs(rl[0]) >= 0.5*patch.TFLx || fabs(rl[1]) >= 0.5*patch.TFLy)
+	continue;
+
+      patch.A = p->A; patch.B = p->B; patch.C = p->C;
+      patch.E = p->E; patch.F = p->F; patch.G = p->G;
+
+      DispStressDirect(&patch,rl,s);
+
+      stress[0][0] += s[0][0];
+      stress[1][1] += s[1][1];
+      stress[2][2] += s[2][2];
+      stress[2][0] += s[2][0];
+      stress[1][2] += s[1][2];
+      stress[0][1] += s[0][1];
+    }
+}
+
+static void MarkImgRowsNeeded(Home_t *home, ThinFilm_t *thinfilm, char *need)
+{
+/***************************************************************************
+ * Flag the x rows of the fine grid DispStress may interpolate from on
+ * this domain.  The midpoints of the segments of the native nodes lie
+ * within one cell of the domain, which also leaves room for the nodes
+ * to move during the step.
+ **************************************************************************/
+  int p, plo, phi;
+  real8 cellX;
+
+  int nxf     = thinfilm->imgNx;
+  double TFLx = thinfilm->TFLx;
+  Param_t *param = home->param;
+
+#ifdef _PRINTSTRESS
+  // PrintStress evaluates the whole surface on every domain
+  for (p=0; p<nxf; p++) need[p] = 1;
+  return;
+#endif
+
+  cellX = param->Lx / param->nXcells;
+
+  plo = (int)floor((home->domXmin - cellX + TFLx*0.5) * nxf / TFLx);
+  phi = (int)floor((home->domXmax + cellX + TFLx*0.5) * nxf / TFLx) + 1;
+
+  for (p=0; p<nxf; p++) need[p] = (phi - plo + 1 >= nxf);
+
+  for (p=plo; p<=phi && phi-plo+1 < nxf; p++)
+    need[((p % nxf) + nxf) % nxf] = 1;
+}
+
+static void GatherImgStressRows(Home_t *home, ThinFilm_t *thinfilm)
+{
+/***************************************************************************
+ * Send the rows of thinfilm->imgStress tabulated on this domain to
+ * the domains that need them.
+ **************************************************************************/
+  int d, p, k, n, row0, rows;
+  int *sendCounts, *sendDispls, *recvCounts, *recvDispls;
+  char *needAll;
+  double *sendBuf, *recvBuf;
+
+  int nxf = thinfilm->imgNx;
+  int nyf = thinfilm->imgNy;
+  int nz  = thinfilm->imgNz;
+  int rowLen = nyf*6;
+  int numDomains = home->numDomains;
+
+  needAll = (char *)malloc(nxf*numDomains);
+
+  MarkImgRowsNeeded(home, thinfilm, thinfilm->imgRowValid);
+
+#ifdef PARALLEL
+  MPI_Allgather(thinfilm->imgRowValid, nxf, MPI_CHAR, 
+		needAll, nxf, MPI_CHAR, MPI_COMM_WORLD);
+#else
+  memcpy(needAll, thinfilm->imgRowValid, nxf);
+#endif
+
+  sendCounts = (int *)malloc(sizeof(int)*numDomains);
+  sendDispls = (int *)malloc(sizeof(int)*numDomains);
+  recvCounts = (int *)malloc(sizeof(int)*numDomains);
+  recvDispls = (int *)malloc(sizeof(int)*numDomains);
+
+  for (d=0; d<numDomains; d++)
+    {
+      sendCounts[d] = 0;
+      for (p=thinfilm->imgRow0; p<thinfilm->imgRow0+thinfilm->imgRows; p++)
+	if (needAll[d*nxf+p]) sendCounts[d] += nz*rowLen;
+
+      row0 = TF_SLAB_START(nxf, d, numDomains);
+      rows = TF_SLAB_START(nxf, d+1, numDomains) - row0;
+
+      recvCounts[d] = 0;
+      for (p=row0; p<row0+rows; p++)
+	if (thinfilm->imgRowValid[p]) recvCounts[d] += nz*rowLen;
+
+      sendDispls[d] = (d == 0) ? 0 : sendDispls[d-1] + sendCounts[d-1];
+      recvDispls[d] = (d == 0) ? 0 : recvDispls[d-1] + recvCounts[d-1];
+    }
+
+  sendBuf = (double *)malloc(sizeof(double)*
+			     (sendDispls[numDomains-1]+sendCounts[numDomains-1]+1));
+  recvBuf = (double *)malloc(sizeof(double)*
+			     (recvDispls[numDomains-1]+recvCounts[numDomains-1]+1));
+
+  for (d=0, n=0; d<numDomains; d++)
+    for (p=thinfilm->imgRow0; p<thinfilm->imgRow0+thinfilm->imgRows; p++)
+      {
+	if (!needAll[d*nxf+p]) continue;
+	for (k=0; k<nz; k++, n+=rowLen)
+	  memcpy(sendBuf+n, &thinfilm->imgStress[IMG_INDEX(k,p,0,0)],
+		 sizeof(double)*rowLen);
+      }
+
+#ifdef PARALLEL
+  MPI_Alltoallv(sendBuf, sendCounts, sendDispls, MPI_DOUBLE,
+		recvBuf, recvCounts, recvDispls, MPI_DOUBLE, MPI_COMM_WORLD);
+#else
+  memcpy(recvBuf, sendBuf, sizeof(double)*sendCounts[0]);
+#endif
+
+  for (d=0, n=0; d<numDomains; d++)
+    {
+      row0 = TF_SLAB_START(nxf, d, numDomains);
+      rows = TF_SLAB_START(nxf, d+1, numDomains) - row0;
+
+      for (p=row0; p<row0+rows; p++)
 	{
-	  kx = thinfilm->kx[i];
-	  kx2 = kx*kx;
-	  
-	  kz2 = kx2+ky2;
-	  kxmy = kx2-ky2;
-	      
-	  kz  = sqrt(kz2);
-	  kz3 = kz2*kz;
-	  
-	  kxz = kx*kz;
-	  kyz = ky*kz;
-	  
-	  kxy = kx*ky;
-	 
-	  COMPLEX AA = thinfilm->A[i][j];
-	  COMPLEX BB = thinfilm->B[i][j];
-	  COMPLEX CC = thinfilm->C[i][j];
-	  COMPLEX EE = thinfilm->E[i][j];
-	  COMPLEX FF = thinfilm->F[i][j];
-	  COMPLEX GG = thinfilm->G[i][j];
-#ifdef _CYGWIN
-          COMPLEX I = complex(0.0, 1.0);
+	  if (!thinfilm->imgRowValid[p]) continue;
+	  for (k=0; k<nz; k++, n+=rowLen)
+	    memcpy(&thinfilm->imgStress[IMG_INDEX(k,p,0,0)], recvBuf+n,
+		   sizeof(double)*rowLen);
+	}
+    }
+
+  free(sendBuf); free(recvBuf);
+  free(sendCounts); free(sendDispls);
+  free(recvCounts); free(recvDispls);
+  free(needAll);
+}
+
+void TF_ImgStressGrid(Home_t *home, ThinFilm_t *thinfilm)
+{
+/***************************************************************************
+ * Tabulate the image stress on the layers.  Must be called after
+ * ABCcoeff each time the coefficients change.
+ *
+ * Each domain evaluates the modes of its own ky columns and transforms
+ * them along x.  An all-to-all then gives each domain its slab of x
+ * rows of the fine grid, with all the modes, to transform along y.
+ * Finally each domain receives the rows it needs (see
+ * MarkImgRowsNeeded) from the domains that transformed them.
+ **************************************************************************/
+  int k, d, m, p, q, c, n, nmcd, col0, cols;
+  int *sendCounts, *sendDispls, *recvCounts, *recvDispls, *modeCol;
+  COMPLEX *colBuf, *rowBuf, *sendBuf, *recvBuf;
+
+  int nx     = thinfilm->nx;
+  int ny     = thinfilm->ny;
+  int nxf    = thinfilm->imgNx;
+  int nyf    = thinfilm->imgNy;
+  int nz     = thinfilm->imgNz;
+  int nmc    = thinfilm->numModeCols;
+  int rows   = thinfilm->imgRows;
+  int nyh    = ny/2 + 1;
+  int numDomains = home->numDomains;
+
+  if (!thinfilm->imgStressFFT) return;
+
+  colBuf = (COMPLEX *)thinfilm->imgColBuf;
+  rowBuf = (COMPLEX *)thinfilm->imgRowBuf;
+
+  // Modes of the own columns, zero padded to nxf along x.  Mode
+  // (i,j) goes to the padded index with the same (possibly negative)
+  // wave number.
+#ifdef _OPENMP
+#pragma omp parallel for private(m,p,c) schedule(dynamic, 1)
 #endif
-	  
-	  // Translated for FFT origin accuracy
-	  x = r[0] + TFLx*0.5;
-	  y = r[1] + TFLy*0.5;
-	  
-	  coshk = cosh(kz*z);
-	  sinhk = sinh(kz*z);
-	  alpha = kx*x+ky*y;
-	  expk  = mu*(cos(alpha)+I*sin(alpha));
-	  
-	  thinfilm->Stress[0][0][i][j] = 
-	    2.0*expk*((I*AA*lmpm*kz + (I*EE*kx2*z+I*BB*kxy-CC*kx2))*coshk + 
-		    (I*EE*lmpm*kz + (I*AA*kx2*z-I*FF*kxy-GG*kx2))*sinhk);
-	  
-	  thinfilm->Stress[1][1][i][j] = 
-	    2.0*expk*((I*AA*lmpm*kz + (I*EE*ky2*z-I*BB*kxy-CC*ky2))*coshk +
-		    (I*EE*lmpm*kz + (I*AA*ky2*z+I*FF*kxy-GG*ky2))*sinhk);
-	  
-	  thinfilm->Stress[2][2][i][j] = 
-	    -2.0*expk*((kz2*(I*EE*z - CC)-l2mpm*I*AA*kz)*coshk + 
-		     (kz2*(I*AA*z - GG)-l2mpm*I*EE*kz)*sinhk);
-	  
-	  thinfilm->Stress[2][0][i][j] = 
-	    expk*(((2.0*AA*kx*z-FF*ky+2.0*I*GG*kx)*kz-2.0*EE*kx*lpm)*coshk + 
-		  ((2.0*EE*kx*z+BB*ky+2.0*I*CC*kx)*kz-2.0*AA*kx*lpm)*sinhk);
-	  
-	  thinfilm->Stress[1][2][i][j] = 
-	    expk*(((2.0*AA*ky*z+FF*kx+2.0*I*GG*ky)*kz-2.0*EE*ky*lpm)*coshk + 
-		  ((2.0*EE*ky*z-BB*kx+2.0*I*CC*ky)*kz-2.0*AA*ky*lpm)*sinhk);
-	  
-	  thinfilm->Stress[0][1][i][j] = 
-	    I*expk*((2.0*EE*kxy*z-kxmy*BB+2.0*I*kxy*CC)*coshk + 
-		    (2.0*AA*kxy*z+kxmy*FF+2.0*I*kxy*GG)*sinhk);
+  for (k=0; k<nz; k++)
+    {
+      int i, j, ip;
+      real8 z;
+      COMPLEX s[6];
+
+      z = thinfilm->imgZmin + k*thinfilm->imgDz;
+
+      for (m=0; m<nmc; m++)
+	{
+	  j = thinfilm->modeCol[m];
+
+	  for (c=0; c<6; c++)
+	    for (p=0; p<nxf; p++)
+	      colBuf[((k*6+c)*nmc+m)*nxf+p] = 0.0;
+
+	  for (i=0; i<nx; i++)
+	    {
+	      ModeStress(thinfilm,i,j,z,s);
+	      ip = (thinfilm->kx[i] < 0.0) ? nxf-nx+i : i;
+	      for (c=0; c<6; c++)
+		colBuf[((k*6+c)*nmc+m)*nxf+ip] = s[c];
+	    }
 	}
     }
-  
-  for (k=0; k<3; k++) 
-    for (l=0; l<3; l++) 
-      for (i=0; i<nx; i++) 
-	for (j=0; j<ny; j++) 
+
+  if (thinfilm->imgColPlan != (fftw_plan)NULL)
+    fftw_execute(thinfilm->imgColPlan);
+
+  // Transpose: rows of the fine grid to the domains transforming them
+  sendCounts = (int *)malloc(sizeof(int)*numDomains);
+  sendDispls = (int *)malloc(sizeof(int)*numDomains);
+  recvCounts = (int *)malloc(sizeof(int)*numDomains);
+  recvDispls = (int *)malloc(sizeof(int)*numDomains);
+  modeCol    = (int *)malloc(sizeof(int)*(ny+1));
+
+  for (d=0; d<numDomains; d++)
+    {
+      col0 = TF_SLAB_START(nyh, d, numDomains);
+      cols = TF_SLAB_START(nyh, d+1, numDomains) - col0;
+      nmcd = fourier_transform_mode_cols(ny, col0, cols, modeCol);
+
+      sendCounts[d] = 2*nz*6*nmc*(TF_SLAB_START(nxf, d+1, numDomains) -
+				  TF_SLAB_START(nxf, d, numDomains));
+      recvCounts[d] = 2*nz*6*nmcd*rows;
+
+      sendDispls[d] = (d == 0) ? 0 : sendDispls[d-1] + sendCounts[d-1];
+      recvDispls[d] = (d == 0) ? 0 : recvDispls[d-1] + recvCounts[d-1];
+    }
+
+  sendBuf = (COMPLEX *)malloc(sizeof(COMPLEX)*(nz*6*nmc*nxf+1));
+  recvBuf = (COMPLEX *)malloc(sizeof(COMPLEX)*(nz*6*ny*rows+1));
+
+  for (d=0, n=0; d<numDomains; d++)
+    for (k=0; k<nz*6; k++)
+      for (m=0; m<nmc; m++)
+	for (p=TF_SLAB_START(nxf, d, numDomains); 
+	     p<TF_SLAB_START(nxf, d+1, numDomains); p++)
+	  sendBuf[n++] = colBuf[(k*nmc+m)*nxf+p];
+
+#ifdef PARALLEL
+  MPI_Alltoallv(sendBuf, sendCounts, sendDispls, MPI_DOUBLE,
+		recvBuf, recvCounts, recvDispls, MPI_DOUBLE, MPI_COMM_WORLD);
+#else
+  memcpy(recvBuf, sendBuf, sizeof(double)*sendCounts[0]);
+#endif
+
+  for (n=0; n<nz*6*rows*nyf; n++) rowBuf[n] = 0.0;
+
+  for (d=0, n=0; d<numDomains; d++)
+    {
+      col0 = TF_SLAB_START(nyh, d, numDomains);
+      cols = TF_SLAB_START(nyh, d+1, numDomains) - col0;
+      nmcd = fourier_transform_mode_cols(ny, col0, cols, modeCol);
+
+      for (k=0; k<nz*6; k++)
+	for (m=0; m<nmcd; m++)
+	  {
+	    q = (thinfilm->ky[modeCol[m]] < 0.0) ? nyf-ny+modeCol[m] : modeCol[m];
+	    for (p=0; p<rows; p++)
+	      rowBuf[(k*rows+p)*nyf+q] = recvBuf[n++];
+	  }
+    }
+
+  free(sendBuf); free(recvBuf);
+  free(sendCounts); free(sendDispls);
+  free(recvCounts); free(recvDispls);
+  free(modeCol);
+
+  if (thinfilm->imgRowPlan != (fftw_plan)NULL)
+    fftw_execute(thinfilm->imgRowPlan);
+
+  for (k=0; k<nz; k++)
+    for (c=0; c<6; c++)
+      for (p=0; p<rows; p++)
+	for (q=0; q<nyf; q++)
 	  {
-#ifndef _CYGWIN	
-	    stress[k][l] += creal(thinfilm->Stress[k][l][i][j]);
+#ifndef _CYGWIN
+	    thinfilm->imgStress[IMG_INDEX(k,thinfilm->imgRow0+p,q,c)] =
+	      creal(rowBuf[((k*6+c)*rows+p)*nyf+q]);
 #else
-	    stress[k][l] += real(thinfilm->Stress[k][l][i][j]);
+	    thinfilm->imgStress[IMG_INDEX(k,thinfilm->imgRow0+p,q,c)] =
+	      real(rowBuf[((k*6+c)*rows+p)*nyf+q]);
 #endif
 	  }
 
+  GatherImgStressRows(home, thinfilm);
+}
+
+void DispStress(ThinFilm_t *thinfilm,real8 r[3], real8 stress[3][3])
+{
+/***************************************************************************
+ * This program computes the stress from the displacement field using
+ * elasticity theory in a thin film and tractions computed in TFUtil.c
+ * from AllSegmentStress.c
+ * Sylvie Aubry, Wed Feb 27 2008
+ *
+ **************************************************************************/
+
+  int c, p0, p1, q0, q1, k0, k1;
+  real8 fx, fy, fz, wx, wy, wz;
+  real8 sig[6];
+
+  int nxf    = thinfilm->imgNx;
+  int nyf    = thinfilm->imgNy;
+  int nz     = thinfilm->imgNz;
+  double  t  = thinfilm->t;
+
+  double TFLx     = thinfilm->TFLx;
+  double TFLy     = thinfilm->TFLy;
+
+  // r is the point at the mid segment between two nodes.
+
+  stress[0][0] = 0.0; stress[0][1] = 0.0; stress[0][2] = 0.0;
+  stress[1][0] = 0.0; stress[1][1] = 0.0; stress[1][2] = 0.0;
+  stress[2][0] = 0.0; stress[2][1] = 0.0; stress[2][2] = 0.0;
+
+  if (fabs(r[2]) > t) return;
+
+  if (!thinfilm->imgStressFFT)
+    {
+      DispStressDirect(thinfilm,r,stress);
+    }
+  else
+    {
+      // Translated for FFT origin accuracy
+      fx = (r[0] + TFLx*0.5) * nxf / TFLx;
+      fy = (r[1] + TFLy*0.5) * nyf / TFLy;
+      fz = (r[2] - thinfilm->imgZmin) / thinfilm->imgDz;
+
+      p0 = (int)floor(fx);
+      q0 = (int)floor(fy);
+      k0 = MIN((int)floor(fz), nz-2);
+
+      wx = fx - p0;
+      wy = fy - q0;
+      wz = fz - k0;
+
+      p0 %= nxf; if (p0 < 0) p0 += nxf;
+      q0 %= nyf; if (q0 < 0) q0 += nyf;
+
+      p1 = (p0+1) % nxf;
+      q1 = (q0+1) % nyf;
+      k1 = k0+1;
+
+      if (!thinfilm->imgRowValid[p0] || !thinfilm->imgRowValid[p1])
+	Fatal("DispStress: image stress at x = %g is not tabulated "
+	      "on this domain", r[0]);
+
+      for (c=0; c<6; c++)
+	{
+	  sig[c] =
+	    (1.0-wz)*((1.0-wx)*((1.0-wy)*thinfilm->imgStress[IMG_INDEX(k0,p0,q0,c)] +
+				     wy *thinfilm->imgStress[IMG_INDEX(k0,p0,q1,c)]) +
+		           wx *((1.0-wy)*thinfilm->imgStress[IMG_INDEX(k0,p1,q0,c)] +
+				     wy *thinfilm->imgStress[IMG_INDEX(k0,p1,q1,c)])) +
+	         wz *((1.0-wx)*((1.0-wy)*thinfilm->imgStress[IMG_INDEX(k1,p0,q0,c)] +
+				     wy *thinfilm->imgStress[IMG_INDEX(k1,p0,q1,c)]) +
+		           wx *((1.0-wy)*thinfilm->imgStress[IMG_INDEX(k1,p1,q0,c)] +
+				     wy *thinfilm->imgStress[IMG_INDEX(k1,p1,q1,c)]));
+	}
+
+      stress[0][0] = sig[0];
+      stress[1][1] = sig[1];
+      stress[2][2] = sig[2];
+      stress[2][0] = sig[3];
+      stress[1][2] = sig[4];
+      stress[0][1] = sig[5];
+    }
+
+  if (thinfilm->numPatches > 0) PatchStress(thinfilm,r,stress);
+
   stress[1][0] = stress[0][1];
   stress[2][1] = stress[1][2];
   stress[0][2] = stress[2][0];
 
   return;
 }
-
-  
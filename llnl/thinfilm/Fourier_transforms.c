@@ -1,31 +1,222 @@
 #ifdef _THINFILM
 #ifdef _TFIMGSTRESS
 
+#include <string.h>
+
 #include "Home.h"
 #include "TF.h"
 
-void fourier_transform_forward(fftw_complex* M,fftw_complex* m, 
-			       int nx, int ny)
+/***************************************************************************
+ * Distributed forward transforms of the surface tractions.
+ *
+ * The nx*ny traction grids are split over the domains in slabs of x
+ * rows: TF_stress_boundary leaves domain d with the rows
+ * [row0, row0+rows) of every component in fft->in.  The 2D transform
+ * is done in two passes of batched 1D transforms planned once at
+ * startup:
+ *
+ *   - real-to-complex transforms along y of the local rows, giving
+ *     the ny/2+1 non-negative ky modes of each row;
+ *   - an all-to-all that hands each domain all nx rows of its slab
+ *     [col0, col0+cols) of those ky columns;
+ *   - complex transforms along x of the local columns.
+ *
+ * No domain ever holds a full grid, and each Fourier coefficient is
+ * computed by exactly one domain.  The modes with negative ky follow
+ * from the Hermitian symmetry t(i,j) = conj(t(-i,-j)) of the real
+ * tractions, so the domain owning ky column j also owns column ny-j
+ * (see fourier_transform_mode_cols).
+ **************************************************************************/
+
+static void AllToAll(fftw_complex *sendBuf, int *sendCounts, int *sendDispls,
+		     fftw_complex *recvBuf, int *recvCounts, int *recvDispls)
+{
+  // Counts and displacements are in doubles.
+#ifdef PARALLEL
+  MPI_Alltoallv(sendBuf, sendCounts, sendDispls, MPI_DOUBLE,
+		recvBuf, recvCounts, recvDispls, MPI_DOUBLE, MPI_COMM_WORLD);
+#else
+  memcpy(recvBuf, sendBuf, sizeof(double)*sendCounts[0]);
+#endif
+}
+
+void fourier_transform_tractions_init(Home_t *home, TractionFFT_t *fft,
+				      int nx, int ny, int howmany)
+{
+  int d, n, rows, cols;
+  int nyh = ny/2 + 1;
+  int numDomains = home->numDomains;
+  int myDomain   = home->myDomain;
+
+  fft->nx = nx;
+  fft->ny = ny;
+  fft->nyh = nyh;
+  fft->howmany = howmany;
+
+  fft->row0 = TF_SLAB_START(nx, myDomain, numDomains);
+  fft->rows = TF_SLAB_START(nx, myDomain+1, numDomains) - fft->row0;
+  fft->col0 = TF_SLAB_START(nyh, myDomain, numDomains);
+  fft->cols = TF_SLAB_START(nyh, myDomain+1, numDomains) - fft->col0;
+
+  fft->sendCounts = (int *)malloc(sizeof(int)*numDomains);
+  fft->sendDispls = (int *)malloc(sizeof(int)*numDomains);
+  fft->recvCounts = (int *)malloc(sizeof(int)*numDomains);
+  fft->recvDispls = (int *)malloc(sizeof(int)*numDomains);
+
+  // Domain d receives the rows of this domain restricted to its ky
+  // columns, and sends its rows restricted to the ky columns here.
+  for (d=0, n=0; d<numDomains; d++)
+    {
+      cols = TF_SLAB_START(nyh, d+1, numDomains) - 
+	     TF_SLAB_START(nyh, d, numDomains);
+      fft->sendCounts[d] = 2*howmany*fft->rows*cols;
+      fft->sendDispls[d] = n;
+      n += fft->sendCounts[d];
+    }
+
+  for (d=0, n=0; d<numDomains; d++)
+    {
+      rows = TF_SLAB_START(nx, d+1, numDomains) - 
+	     TF_SLAB_START(nx, d, numDomains);
+      fft->recvCounts[d] = 2*howmany*rows*fft->cols;
+      fft->recvDispls[d] = n;
+      n += fft->recvCounts[d];
+    }
+
+  fft->in      = (double *)fftw_malloc(sizeof(double)*(howmany*fft->rows*ny+1));
+  fft->rowOut  = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+					     (howmany*fft->rows*nyh+1));
+  fft->sendBuf = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+					     (howmany*fft->rows*nyh+1));
+  fft->recvBuf = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+					     (howmany*fft->cols*nx+1));
+  fft->colIn   = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+					     (howmany*fft->cols*nx+1));
+  fft->out     = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+					     (howmany*fft->cols*nx+1));
+
+  if (fft->in == NULL || fft->rowOut == NULL || fft->sendBuf == NULL ||
+      fft->recvBuf == NULL || fft->colIn == NULL || fft->out == NULL)
+    {
+      printf("Not enough memory to allocate traction FFT arrays\n");
+      exit(0);
+    }
+
+  // A domain may own no rows or no columns when the grid is smaller
+  // than the number of domains.
+  fft->rowPlan = (fftw_plan)NULL;
+  fft->colPlan = (fftw_plan)NULL;
+
+  if (fft->rows > 0)
+    fft->rowPlan = fftw_plan_many_dft_r2c(1, &ny, howmany*fft->rows,
+					  fft->in, NULL, 1, ny,
+					  fft->rowOut, NULL, 1, nyh,
+					  FFTW_MEASURE);
+  if (fft->cols > 0)
+    fft->colPlan = fftw_plan_many_dft(1, &nx, howmany*fft->cols,
+				      fft->colIn, NULL, 1, nx,
+				      fft->out, NULL, 1, nx,
+				      FFTW_FORWARD, FFTW_MEASURE);
+}
+
+void fourier_transform_tractions(Home_t *home, TractionFFT_t *fft)
 {
-  fftw_plan plan;
+/***************************************************************************
+ * Forward transform the <howmany> real slabs in fft->in, laid out as
+ * in[(c*rows + il)*ny + j] for the rows row0+il.  On return
+ *
+ *   out[(c*cols + jl)*nx + i]
+ *
+ * holds the coefficient (i, col0+jl) of the unnormalized 2D transform
+ * of component c.
+ **************************************************************************/
+  int c, d, i, il, jl, n, rows, cols, row0, col0;
+  double *src, *dst;
+
+  int nx  = fft->nx;
+  int nyh = fft->nyh;
+  int numDomains = home->numDomains;
+
+  if (fft->rowPlan != (fftw_plan)NULL) fftw_execute(fft->rowPlan);
+
+  // fftw_complex is handled as pairs of doubles so that the same
+  // code serves both the C99 complex and the double[2] definitions.
+  dst = (double *)fft->sendBuf;
+
+  for (d=0, n=0; d<numDomains; d++)
+    {
+      col0 = TF_SLAB_START(nyh, d, numDomains);
+      cols = TF_SLAB_START(nyh, d+1, numDomains) - col0;
+
+      for (c=0; c<fft->howmany; c++)
+	for (il=0; il<fft->rows; il++)
+	  {
+	    src = (double *)(fft->rowOut + (c*fft->rows+il)*nyh + col0);
+	    memcpy(dst+n, src, sizeof(double)*2*cols);
+	    n += 2*cols;
+	  }
+    }
+
+  AllToAll(fft->sendBuf, fft->sendCounts, fft->sendDispls,
+	   fft->recvBuf, fft->recvCounts, fft->recvDispls);
 
-  plan = fftw_plan_dft_2d(nx,ny,M,m,FFTW_FORWARD,FFTW_ESTIMATE);
-  fftw_execute(plan);
-  
-  fftw_destroy_plan(plan);
+  src = (double *)fft->recvBuf;
+  dst = (double *)fft->colIn;
+
+  for (d=0, n=0; d<numDomains; d++)
+    {
+      row0 = TF_SLAB_START(nx, d, numDomains);
+      rows = TF_SLAB_START(nx, d+1, numDomains) - row0;
+
+      for (c=0; c<fft->howmany; c++)
+	for (il=0; il<rows; il++)
+	  for (jl=0; jl<fft->cols; jl++, n+=2)
+	    {
+	      i = row0 + il;
+	      dst[2*((c*fft->cols+jl)*nx+i)]   = src[n];
+	      dst[2*((c*fft->cols+jl)*nx+i)+1] = src[n+1];
+	    }
+    }
+
+  if (fft->colPlan != (fftw_plan)NULL) fftw_execute(fft->colPlan);
+}
+
+void fourier_transform_tractions_free(TractionFFT_t *fft)
+{
+  if (fft->rowPlan != (fftw_plan)NULL) fftw_destroy_plan(fft->rowPlan);
+  if (fft->colPlan != (fftw_plan)NULL) fftw_destroy_plan(fft->colPlan);
+  fftw_free(fft->in);
+  fftw_free(fft->rowOut);
+  fftw_free(fft->sendBuf);
+  fftw_free(fft->recvBuf);
+  fftw_free(fft->colIn);
+  fftw_free(fft->out);
+  free(fft->sendCounts);
+  free(fft->sendDispls);
+  free(fft->recvCounts);
+  free(fft->recvDispls);
 }
 
-void fourier_transform_backward(fftw_complex* M, fftw_complex* m, 
-			       int nz, int nq)
+int fourier_transform_mode_cols(int ny, int col0, int cols, int *modeCol)
 {
-  fftw_plan plan;
+/***************************************************************************
+ * Full spectrum ky columns whose coefficients are computed by the
+ * domain owning the half spectrum columns [col0, col0+cols): each
+ * column jh and, when it is a distinct negative wave number, its
+ * mirror ny-jh.  Returns the number of columns stored in modeCol,
+ * which must hold 2*cols entries.
+ **************************************************************************/
+  int jh, n = 0;
+  int nyh = ny/2 + 1;
 
-  plan = fftw_plan_dft_2d(nz,nq,m,M,FFTW_BACKWARD,FFTW_ESTIMATE);
-  fftw_execute(plan);
-  
-  fftw_destroy_plan(plan);
+  for (jh=col0; jh<col0+cols; jh++)
+    {
+      modeCol[n++] = jh;
+      if (jh > 0 && ny-jh >= nyh) modeCol[n++] = ny-jh;
+    }
+
+  return n;
 }
 
 #endif
 #endif
-
@@ -36,6 +36,7 @@
 #define NO_COLLISIONS        0x04
 #define NO_MESH_COARSEN      0x08
 #define NODE_CHK_DBL_LINK    0x10
+#define NODE_REMESH_LOCK     0x20
 
 /*
  *      Used as bit flags to indicate the type of nodal data items
@@ -105,6 +105,10 @@ struct _param {
  */
         int   decompType;       /* Selects decomposition type */
         int   DLBfreq;          /* how often to load balance */
+        int   DLBcellCost;      /* Toggles use of the per-cell cost */
+                                /* histogram when placing new domain */
+                                /* boundaries.  If zero, load is     */
+                                /* assumed uniform within a domain   */
         int   numDLBCycles;     /* Number of initial load-balance-only */
                                 /* cycles to be executed before main   */
                                 /* processing loop is entered.  This   */
@@ -265,6 +269,12 @@ struct _param {
                                    /* initialization to point to the      */
                                    /* appropriate mobility function       */
 
+        void  (*mobilityCacheFunc)(Home_t *home, Node_t **nodeList,
+                                   int numNodes);  /* Fills the per-arm   */
+                                   /* mobility cache of a list of nodes   */
+                                   /* before their mobility is evaluated. */
+                                   /* NULL if the law does not cache.     */
+
         real8 MobScrew;
         real8 MobEdge;
         real8 MobClimb;
@@ -543,6 +553,16 @@ struct _param {
   real8 tf_Mx;              /* Bending moments                                  */
   real8 tf_Bend_theta;      /* Angle between the bending axis and x-ais         */
 
+  int   tf_imgStressFFT;    /* Toggle: 1 = tabulate the image stress on layers  */
+                            /* through the film by inverse FFT and interpolate, */
+                            /* 0 = sum the Fourier modes directly at each point */
+  int   tf_imgStressOversample; /* In-plane refinement of the image stress  */
+                            /* grid relative to tf_nx, tf_ny                    */
+  int   tf_patchCells;      /* Width, in tf_nx x tf_ny grid cells, of the       */
+                            /* surface tiles refined around surface             */
+                            /* intersections.  0 = no refinement                */
+  int   tf_patchRefine;     /* Refinement of the tractions on those tiles       */
+
   real8 TF_delSegLength;    /* Counts deleted segments during TF remesh         */
 #endif
 
@@ -37,6 +37,48 @@ typedef std::complex<double> complex;
  */ 
 #define VALS_PER_SEG 9
 
+/* First index of slab d when n indices are split over nd domains */
+#define TF_SLAB_START(n,d,nd) (((n)*(d))/(nd))
+
+/*
+ * Slab decomposed transform of the surface tractions (see
+ * Fourier_transforms.c).  In real space a domain owns the x rows
+ * [row0, row0+rows) of the nx*ny grids, in Fourier space the ky
+ * columns [col0, col0+cols) of the nx*(ny/2+1) half spectra.
+ */
+typedef struct {
+  int           nx, ny, nyh, howmany;
+  int           row0, rows;
+  int           col0, cols;
+  int           *sendCounts, *sendDispls;   // all-to-all, in doubles
+  int           *recvCounts, *recvDispls;
+  double*       in;      // in[(c*rows+il)*ny+j], real tractions
+  fftw_complex* rowOut;  // rowOut[(c*rows+il)*nyh+jh]
+  fftw_complex* sendBuf;
+  fftw_complex* recvBuf;
+  fftw_complex* colIn;   // colIn[(c*cols+jl)*nx+i]
+  fftw_complex* out;     // out[(c*cols+jl)*nx+i], unnormalized spectra
+  fftw_plan     rowPlan, colPlan;
+} TractionFFT_t;
+
+/*
+ * Locally refined correction patch of the surface traction grids
+ * (see SurfacePatches.c).  The patch solves the thin film problem for
+ * the tractions left over by the coarse grids on one tile of the
+ * surfaces, on a periodic domain twice the tile size centered on the
+ * tile.
+ */
+typedef struct {
+  int       tile[2];       // Tile indices in x and y
+  real8     center[2];     // Center of the tile and of the patch domain
+  COMPLEX** A;
+  COMPLEX** B;
+  COMPLEX** C;
+  COMPLEX** E;
+  COMPLEX** F;
+  COMPLEX** G;
+} SurfacePatch_t;
+
 /* Thin Film structure definition*/
 struct _thinfilm 
 {
@@ -56,13 +98,15 @@ struct _thinfilm
   double*           kx;
   double*           ky;
 
-  fftw_complex*     Txp;
-  fftw_complex*     Typ;
-  fftw_complex*     Tzp;
+  /* Tractions on the top (xp,yp,zp) then bottom (xm,ym,zm) surface,
+   * transformed on the slabs of this domain */
+  TractionFFT_t     tractionFFT;
 
-  fftw_complex*     Txm;
-  fftw_complex*     Tym;
-  fftw_complex*     Tzm;
+  /* Full spectrum ky columns of A..G computed on this domain.  All
+   * columns are gathered on every domain only when the image stress
+   * is summed directly (imgStressFFT == 0). */
+  int               numModeCols;
+  int*              modeCol;
 
   COMPLEX** A;
   COMPLEX** B;
@@ -76,6 +120,25 @@ struct _thinfilm
 
   double**  Grid[3];
 
+  /* Image stress tabulated on layers (see DispStress.c) */
+  int       imgStressFFT;
+  int       imgNx, imgNy, imgNz;
+  double    imgZmin, imgDz;
+  double*   imgStress;
+  int       imgRow0, imgRows;    // x rows of the fine grid transformed here
+  char*     imgRowValid;         // rows of imgStress filled on this domain
+  fftw_complex* imgColBuf;       // modes of the own ky columns
+  fftw_complex* imgRowBuf;       // modes of the own x rows
+  fftw_plan imgColPlan, imgRowPlan;
+
+  /* Refined patches on the surface tiles holding surface intersections.
+   * patchModel holds the wave numbers, matrices and traction transform
+   * shared by all the patches, which only differ by their coefficients */
+  int               patchCells, patchRefine;      // Tile width in coarse cells, refinement
+  int               numPatches, allocPatches;
+  SurfacePatch_t*   patches;
+  struct _thinfilm  *patchModel;
+
 
 #if !defined _NOYOFFESTRESS | !defined _NOVIRTUALSEG
 /*
@@ -93,15 +156,22 @@ typedef struct _thinfilm ThinFilm_t;
 
 void Mmatrix(ThinFilm_t *thinfilm);
 void Minvmatrix(ThinFilm_t *thinfilm);
-void ABCcoeff(ThinFilm_t *thinfilm);
+void ABCcoeff(Home_t *home, ThinFilm_t *thinfilm);
 
 /* ThinFilm class routines in TF/thinfilm.c */
 void TF_allocations(Home_t *home, ThinFilm_t *thinfilm);
 void TF_Create_Matrices(ThinFilm_t *thinfilm);
 void TF_Create_Grid(Param_t *param, ThinFilm_t *thinfilm);
 void TF_Create_kpoints(ThinFilm_t *thinfilm);
+void TF_Create_ImgStressGrid(Home_t *home, ThinFilm_t *thinfilm);
+void TF_ImgStressGrid(Home_t *home, ThinFilm_t *thinfilm);
 void TF_stress_boundary(Home_t *home,ThinFilm_t *thinfilm);
 
+/* Refined surface patches in TF/SurfacePatches.c */
+void TF_Create_SurfacePatches(Home_t *home, ThinFilm_t *thinfilm);
+void TF_SurfacePatches(Home_t *home, ThinFilm_t *thinfilm);
+void TF_Free_SurfacePatches(ThinFilm_t *thinfilm);
+
 /* ParaDiS routines in TF_Util.c */
 void TF_Init(Home_t *home,ThinFilm_t **tf_ptr);
 void TF_Step(Home_t *home,ThinFilm_t *thinfilm);
@@ -119,10 +189,17 @@ void AllSegmentStress(Home_t *home,ThinFilm_t *thinfilm,
 		      real8 xm, real8 ym, real8 zm,
                       real8 totStress[3][3]);
 void FreeCellCters(void);
+char *MarkNativeSegCells(Home_t *home);
+int NearNativeSegs(Home_t *home, char *nativeSegCell,
+		   real8 x, real8 y, real8 z);
+int isRightDom(Home_t *home, real8 x, real8 y, real8 z);
 
 /* Fourier Transform */
-void  fourier_transform_forward(fftw_complex* M, fftw_complex* m, 
-				int nx, int ny);
+void fourier_transform_tractions_init(Home_t *home, TractionFFT_t *fft,
+				      int nx, int ny, int howmany);
+void fourier_transform_tractions(Home_t *home, TractionFFT_t *fft);
+void fourier_transform_tractions_free(TractionFFT_t *fft);
+int  fourier_transform_mode_cols(int ny, int col0, int cols, int *modeCol);
 
 /* Virtual functions */
 
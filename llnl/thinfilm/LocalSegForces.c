@@ -2361,6 +2361,10 @@ void LocalSegForces(Home_t *home, int reqType)
         Segment_t  *segList, *nbrSegList, **cellSegLists;
         NativeSeg_t   *nativeSegList = NULL;
         SegmentPair_t *segPairList = NULL;
+#if defined _THINFILM & !defined _NOVIRTUALSEG
+        int        numVirtualSegs = 0;
+        SemiInfSeg_t  *virtualSegList = (SemiInfSeg_t *)NULL;
+#endif
 
 
         homeCells       = home->cellCount;
@@ -2389,6 +2393,67 @@ void LocalSegForces(Home_t *home, int reqType)
 	//Sylvie Aubry
 	BuildSurfaceSegList(home, thinfilm);
 #endif
+#endif
+
+#ifdef _THINFILM
+#ifndef _NOVIRTUALSEG
+/*
+ *      Set up the virtual segments once here rather than for every
+ *      native segment.  Each surface segment becomes a semi-infinite
+ *      segment starting at its surface node and going away from its
+ *      inside node.
+ */
+        if (thinfilm->surfaceSegList != (real8 *)NULL) {
+            int   iVS, bufIndex = 0;
+            real8 *VSsegList;
+            real8 rs[3], rm[3], bb[3], xs[3];
+            real8 LenVirtualSeg = thinfilm->LenVirtualSeg;
+            real8 dx, dy, dz, dr;
+
+            VSsegList = thinfilm->surfaceSegList;
+            numVirtualSegs = thinfilm->surfaceSegCount;
+            virtualSegList = (SemiInfSeg_t *)malloc(numVirtualSegs *
+                                                   sizeof(SemiInfSeg_t));
+
+            for (iVS = 0; iVS < numVirtualSegs; iVS++) {
+
+                rs[0] = VSsegList[bufIndex++];
+                rs[1] = VSsegList[bufIndex++];
+                rs[2] = VSsegList[bufIndex++];
+
+                rm[0] = VSsegList[bufIndex++];
+                rm[1] = VSsegList[bufIndex++];
+                rm[2] = VSsegList[bufIndex++];
+
+                bb[0] = VSsegList[bufIndex++];
+                bb[1] = VSsegList[bufIndex++];
+                bb[2] = VSsegList[bufIndex++];
+
+                // Surface node becomes virtual node
+                dx = rm[0] - rs[0];
+                dy = rm[1] - rs[1];
+                dz = rm[2] - rs[2];
+
+                dr = sqrt(dx*dx+dy*dy+dz*dz);
+                dr = LenVirtualSeg/dr;
+
+                xs[0] = rs[0];
+                xs[1] = rs[1];
+                xs[2] = rs[2];
+
+                rs[0] = rm[0] - dx*dr;
+                rs[1] = rm[1] - dy*dr;
+                rs[2] = rm[2] - dz*dr;
+
+                // rm is on the surface
+                rm[0] = xs[0];
+                rm[1] = xs[1];
+                rm[2] = xs[2];
+
+                SemiInfiniteSegInit(&virtualSegList[iVS], rm, rs, bb);
+            }
+        }
+#endif
 #endif
 
         totalNativeSegs = 0;
@@ -2991,76 +3056,37 @@ void LocalSegForces(Home_t *home, int reqType)
 #ifdef _THINFILM
 #ifndef _NOVIRTUALSEG
 /*
- *                  Add Virtual Segments now using lists of virtual segments
- *                  This assumes the lists of virtual segments has been built.
+ *                  Add Virtual Segments now using the list of virtual
+ *                  segments set up before this loop.
  *                  Apply virtual segments on segment [pos[1],pos[2]].
  */
+                    if (virtualSegList != (SemiInfSeg_t *)NULL) {
+                        real8 p3[3], p4[3], mb[3];
 
-                    int iVS,bufIndex = 0;
-                    real8 *VSsegList;
-                    real8 rs[3], rm[3], bb[3];
-                    real8 LenVirtualSeg = thinfilm->LenVirtualSeg;
-                    real8 dr, f[3], xs[3];
-
-                    if (thinfilm->surfaceSegList != (real8 *)NULL)
-                      {
-                        VSsegList = thinfilm->surfaceSegList;
-
-                        //SA printf("I have %d surface nodes\n",thinfilm->surfaceSegCount);
-
-                        for (iVS = 0; iVS < thinfilm->surfaceSegCount; iVS++)
-                          {
-                            rs[0] = VSsegList[bufIndex++];
-                            rs[1] = VSsegList[bufIndex++];
-                            rs[2] = VSsegList[bufIndex++];
-
-                            rm[0] = VSsegList[bufIndex++];
-                            rm[1] = VSsegList[bufIndex++];
-                            rm[2] = VSsegList[bufIndex++];
-
-                            bb[0] = VSsegList[bufIndex++];
-                            bb[1] = VSsegList[bufIndex++];
-                            bb[2] = VSsegList[bufIndex++];
-
-                            // Surface node becomes virtual node
-                            dx = rm[0] - rs[0];
-                            dy = rm[1] - rs[1];
-                            dz = rm[2] - rs[2];
-
-                            dr = sqrt(dx*dx+dy*dy+dz*dz);
-                            dr = LenVirtualSeg/dr;
-
-                            xs[0] = rs[0];
-                            xs[1] = rs[1];
-                            xs[2] = rs[2];
-
-                            rs[0] = rm[0] - dx*dr;
-                            rs[1] = rm[1] - dy*dr;
-                            rs[2] = rm[2] - dz*dr;
-
-                            // rm is on the surface
-                            rm[0] = xs[0];
-                            rm[1] = xs[1];
-                            rm[2] = xs[2];
-
-                            SemiInfiniteSegSegForce(rm[0], rm[1], rm[2], rs[0], rs[1], rs[2],
-                                                    x1, y1, z1, x2, y2, z2,
-                                                    bb[0], bb[1], bb[2],
-                                                    -bx1,-by1,-bz1,
-                                                    a, MU, NU,
-                                                    &f[0],  &f[1],  &f[2],
-                                                    &f1[0], &f1[1], &f1[2],
-                                                    &f2[0], &f2[1], &f2[2]);
-
-                            VECTOR_ADD(node1SegForce, f1);
-                            VECTOR_ADD(node2SegForce, f2);
-
-                            for (j = 0; j < 3; j++) {
-                              nativeSegList[i].seg->f1[j] += f1[j];
-                              nativeSegList[i].seg->f2[j] += f2[j];
-                            }
-                          }
-                      }
+                        p3[0] = x1;
+                        p3[1] = y1;
+                        p3[2] = z1;
+
+                        p4[0] = x2;
+                        p4[1] = y2;
+                        p4[2] = z2;
+
+                        mb[0] = -bx1;
+                        mb[1] = -by1;
+                        mb[2] = -bz1;
+
+                        SemiInfiniteSegSegForceSum(virtualSegList,
+                                                   numVirtualSegs, p3, p4,
+                                                   mb, a, MU, NU, f1, f2);
+
+                        VECTOR_ADD(node1SegForce, f1);
+                        VECTOR_ADD(node2SegForce, f2);
+
+                        for (j = 0; j < 3; j++) {
+                            nativeSegList[i].seg->f1[j] += f1[j];
+                            nativeSegList[i].seg->f2[j] += f2[j];
+                        }
+                    }
 #endif
 #endif
 
@@ -3254,6 +3280,12 @@ void LocalSegForces(Home_t *home, int reqType)
         free(nativeSegList);
         free(segPairList);
 
+#if defined _THINFILM & !defined _NOVIRTUALSEG
+        if (virtualSegList != (SemiInfSeg_t *)NULL) {
+            free(virtualSegList);
+        }
+#endif
+
         free(cellSegLists);
         free(nativeSegCounts);
         free(totalSegCounts);
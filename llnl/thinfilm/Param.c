@@ -143,6 +143,14 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
         BindVar(CPList, "DLBfreq", &param->DLBfreq, V_INT, 1, VFLAG_NULL);
         param->DLBfreq = 3;
 
+/*
+ *      The force routines of this application do not record per-cell
+ *      costs, so keep the per-domain load model unless asked for.
+ */
+        BindVar(CPList, "DLBcellCost", &param->DLBcellCost, V_INT, 1,
+                VFLAG_NULL);
+        param->DLBcellCost = 0;
+
         BindVar(CPList, "xBoundMin", &param->xBoundMin, V_DBL, 1, VFLAG_NULL);
 
         BindVar(CPList, "xBoundMax", &param->xBoundMax, V_DBL, 1, VFLAG_NULL);
@@ -866,6 +874,22 @@ void CtrlParamInit(Param_t *param, ParamList_t *CPList)
                 VFLAG_NULL);
         param->tf_Bend_theta = 0.0;
 
+        BindVar(CPList, "TF_imgStressFFT", &param->tf_imgStressFFT, V_INT, 1,
+                VFLAG_NULL);
+        param->tf_imgStressFFT = 1;
+
+        BindVar(CPList, "TF_imgStressOversample",
+                &param->tf_imgStressOversample, V_INT, 1, VFLAG_NULL);
+        param->tf_imgStressOversample = 2;
+
+        BindVar(CPList, "TF_patchCells", &param->tf_patchCells, V_INT, 1,
+                VFLAG_NULL);
+        param->tf_patchCells = 0;
+
+        BindVar(CPList, "TF_patchRefine", &param->tf_patchRefine, V_INT, 1,
+                VFLAG_NULL);
+        param->tf_patchRefine = 4;
+
 #endif
 
         return;
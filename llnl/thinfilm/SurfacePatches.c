@@ -0,0 +1,505 @@
+/***************************************************************************
+ *
+ *  Module      : SurfacePatches.c
+ *  Description : Locally refined corrections to the surface tractions
+ *                near the surface intersections
+ *
+ *  The coarse nx*ny grids of TF_stress_boundary only cancel the
+ *  tractions at their grid points.  Near a segment crossing a surface
+ *  the traction varies on a scale much smaller than the grid spacing,
+ *  and refining the whole grids to that scale is expensive.  Instead,
+ *  the surfaces are divided into tiles of param->tf_patchCells coarse
+ *  cells, and each tile holding (or within one coarse cell of) the
+ *  surface node of a segment in thinfilm->surfaceSegList, on either
+ *  surface, gets a patch:
+ *
+ *    - the tractions are evaluated on the tile, on both surfaces, at
+ *      param->tf_patchRefine times the coarse resolution;
+ *    - the tractions the coarse solution cancels, i.e. the Fourier
+ *      interpolant of the coarse grid tractions, are subtracted.  The
+ *      residual vanishes at the coarse grid points, so it is small on
+ *      the tile edges, which lie on coarse grid lines;
+ *    - the residual, zero outside the tile, is solved for with the same
+ *      Fourier method as the coarse grids, on a periodic film twice
+ *      the tile size centered on the tile.
+ *
+ *  DispStress adds the stress of every patch whose domain holds the
+ *  field point.  The tiles do not overlap, so neither do the residuals.
+ *
+ *  All the patches share the wave numbers, matrices and distributed
+ *  traction transform of thinfilm->patchModel and only differ by their
+ *  A..G coefficients, which are gathered on every domain.  Each domain
+ *  evaluates the tractions at the points its own segments contribute
+ *  to, and the interpolant of the coarse modes it owns.
+ *
+ **************************************************************************/
+
+#ifdef _THINFILM
+#ifdef _TFIMGSTRESS
+
+#include <string.h>
+
+#include "Home.h"
+#include "Util.h"
+#include "TF.h"
+
+static COMPLEX **AllocCoeff(int nx, int ny)
+{
+  int i;
+  COMPLEX **a;
+
+  a = (COMPLEX **)malloc(sizeof(COMPLEX*)*nx);
+  if (a == NULL) Fatal("Not enough memory to allocate patch coefficients");
+
+  for (i=0; i<nx; i++)
+    {
+      a[i] = (COMPLEX *)malloc(sizeof(COMPLEX)*ny);
+      if (a[i] == NULL)
+	Fatal("Not enough memory to allocate patch coefficients");
+    }
+
+  return a;
+}
+
+static void FreeCoeff(COMPLEX **a, int nx)
+{
+  int i;
+
+  for (i=0; i<nx; i++) free(a[i]);
+  free(a);
+}
+
+void TF_Create_SurfacePatches(Home_t *home, ThinFilm_t *thinfilm)
+{
+  // Set up the model patch: a periodic film of two by two tiles,
+  // sampled at the refined resolution.
+
+  int i, j, nPad;
+  Param_t *param = home->param;
+  ThinFilm_t *model;
+
+  thinfilm->patchCells  = param->tf_patchCells;
+  thinfilm->patchRefine = MAX(1, param->tf_patchRefine);
+  thinfilm->numPatches  = 0;
+
+  if (thinfilm->patchCells <= 0) return;
+
+  if (thinfilm->nx % thinfilm->patchCells != 0 ||
+      thinfilm->ny % thinfilm->patchCells != 0)
+    Fatal("TF_patchCells (%d) must divide TF_nx (%d) and TF_ny (%d)",
+	  thinfilm->patchCells, thinfilm->nx, thinfilm->ny);
+
+  nPad = 2*thinfilm->patchCells*thinfilm->patchRefine;
+
+  model = (ThinFilm_t *)calloc(1, sizeof(ThinFilm_t));
+  thinfilm->patchModel = model;
+
+  model->nx     = nPad;
+  model->ny     = nPad;
+  model->TFLx   = 2.0*thinfilm->patchCells*thinfilm->TFLx/thinfilm->nx;
+  model->TFLy   = 2.0*thinfilm->patchCells*thinfilm->TFLy/thinfilm->ny;
+  model->t      = thinfilm->t;
+  model->mu     = thinfilm->mu;
+  model->nu     = thinfilm->nu;
+  model->lambda = thinfilm->lambda;
+
+  // The patch coefficients are needed on every domain, which
+  // ABCcoeff only gathers for a direct modal sum.
+  model->imgStressFFT = 0;
+
+  model->kx = (double *)malloc(sizeof(double)*nPad);
+  model->ky = (double *)malloc(sizeof(double)*nPad);
+
+  if (model->kx == NULL || model->ky == NULL)
+    Fatal("Not enough memory to allocate the surface patches");
+
+  for (i=0; i<3; i++)
+    for (j=0; j<3; j++)
+      {
+	model->MsInv[i][j] = AllocCoeff(nPad, nPad);
+	model->MaInv[i][j] = AllocCoeff(nPad, nPad);
+      }
+
+  TF_Create_kpoints(model);
+  Minvmatrix(model);
+
+  fourier_transform_tractions_init(home,&model->tractionFFT,nPad,nPad,6);
+
+  model->modeCol = (int *)malloc(sizeof(int)*(2*model->tractionFFT.cols+1));
+  model->numModeCols =
+    fourier_transform_mode_cols(nPad,model->tractionFFT.col0,
+				model->tractionFFT.cols,model->modeCol);
+
+  if (home->myDomain == 0)
+    printf("Surface patches of %d x %d cells refined %d times\n\n",
+	   thinfilm->patchCells, thinfilm->patchCells,
+	   thinfilm->patchRefine);
+}
+
+void TF_Free_SurfacePatches(ThinFilm_t *thinfilm)
+{
+  int i, j, nPad;
+  ThinFilm_t *model = thinfilm->patchModel;
+  SurfacePatch_t *patch;
+
+  if (model == (ThinFilm_t *)NULL) return;
+
+  nPad = model->nx;
+
+  for (i=0; i<thinfilm->allocPatches; i++)
+    {
+      patch = &thinfilm->patches[i];
+      FreeCoeff(patch->A, nPad); FreeCoeff(patch->B, nPad);
+      FreeCoeff(patch->C, nPad); FreeCoeff(patch->E, nPad);
+      FreeCoeff(patch->F, nPad); FreeCoeff(patch->G, nPad);
+    }
+  free(thinfilm->patches);
+
+  for (i=0; i<3; i++)
+    for (j=0; j<3; j++)
+      {
+	FreeCoeff(model->MsInv[i][j], nPad);
+	FreeCoeff(model->MaInv[i][j], nPad);
+      }
+
+  fourier_transform_tractions_free(&model->tractionFFT);
+
+  free(model->modeCol);
+  free(model->kx);free(model->ky);
+  free(model);
+
+  thinfilm->patchModel   = (ThinFilm_t *)NULL;
+  thinfilm->patches      = (SurfacePatch_t *)NULL;
+  thinfilm->numPatches   = 0;
+  thinfilm->allocPatches = 0;
+}
+
+static int MarkPatchTiles(Home_t *home, ThinFilm_t *thinfilm,
+			  char *tileMark, int ntx, int nty)
+{
+  // Mark the tiles holding a surface node, and their neighbors when
+  // the node is within one coarse cell of the common edge.
+
+  int numTiles = 0;
+
+#if !defined _NOYOFFESTRESS | !defined _NOVIRTUALSEG
+  int   s, ix, iy, dx, dy, tx, ty, lox, hix, loy, hiy;
+  real8 fx, fy, margin;
+  Param_t *param = home->param;
+
+  real8 tileX = thinfilm->TFLx/ntx;
+  real8 tileY = thinfilm->TFLy/nty;
+
+  margin = 1.0/thinfilm->patchCells;
+
+  for (s=0; s<thinfilm->surfaceSegCount; s++)
+    {
+      fx = (thinfilm->surfaceSegList[s*VALS_PER_SEG  ] - param->minSideX)/tileX;
+      fy = (thinfilm->surfaceSegList[s*VALS_PER_SEG+1] - param->minSideY)/tileY;
+
+      ix = (int)floor(fx);
+      iy = (int)floor(fy);
+
+      fx -= ix;
+      fy -= iy;
+
+      lox = (fx < margin)       ? -1 : 0;
+      hix = (fx > 1.0 - margin) ?  1 : 0;
+      loy = (fy < margin)       ? -1 : 0;
+      hiy = (fy > 1.0 - margin) ?  1 : 0;
+
+      for (dx=lox; dx<=hix; dx++)
+	for (dy=loy; dy<=hiy; dy++)
+	  {
+	    tx = (ix+dx) % ntx; if (tx < 0) tx += ntx;
+	    ty = (iy+dy) % nty; if (ty < 0) ty += nty;
+
+	    if (!tileMark[tx*nty+ty]) numTiles++;
+	    tileMark[tx*nty+ty] = 1;
+	  }
+    }
+#endif
+
+  return numTiles;
+}
+
+static void SubtractCoarseTractions(ThinFilm_t *thinfilm, int numTiles,
+				    int nt, real8 (*pts)[2], real8 *t)
+{
+/***************************************************************************
+ * Subtract from the tractions t at the refined points the Fourier
+ * interpolant of the coarse grid tractions, which is what the coarse
+ * solution cancels on the surfaces.  Only the ky columns owned by this
+ * domain are summed; the contributions of the other domains are added
+ * by the reduction of the tractions.  The phases factor into x and y
+ * parts since the points of a tile lie on a regular grid.
+ **************************************************************************/
+  int n, a, b, c, i, j, m, ih, jl, mirror, k;
+  real8 xt, yt;
+  COMPLEX tt, sum, *ex, *ey, *out;
+
+  TractionFFT_t *fft = &thinfilm->tractionFFT;
+  int nx  = thinfilm->nx;
+  int ny  = thinfilm->ny;
+  int nmc = thinfilm->numModeCols;
+  real8 nxy = 1.0*nx*ny;
+
+#ifdef _CYGWIN
+  COMPLEX I = complex(0.0, 1.0);
+#endif
+
+  if (nmc == 0) return;
+
+  out = (COMPLEX *)fft->out;
+  ex  = (COMPLEX *)malloc(sizeof(COMPLEX)*nt*nx);
+  ey  = (COMPLEX *)malloc(sizeof(COMPLEX)*nt*nmc);
+
+  for (n=0; n<numTiles; n++)
+    {
+      // Translated for FFT origin accuracy, like the coarse modes
+      for (a=0; a<nt; a++)
+	{
+	  xt = pts[(n*nt+a)*nt][0] + thinfilm->TFLx*0.5;
+	  for (i=0; i<nx; i++)
+	    ex[a*nx+i] = cexp(I*thinfilm->kx[i]*xt)/nxy;
+	}
+
+      for (b=0; b<nt; b++)
+	{
+	  yt = pts[n*nt*nt+b][1] + thinfilm->TFLy*0.5;
+	  for (m=0; m<nmc; m++)
+	    ey[b*nmc+m] = cexp(I*thinfilm->ky[thinfilm->modeCol[m]]*yt);
+	}
+
+      for (m=0; m<nmc; m++)
+	{
+	  // Columns with negative ky are the conjugates of the mirrored
+	  // modes t(i,j) = conj(t(-i,-j)), as in ABCcoeff.
+	  j      = thinfilm->modeCol[m];
+	  mirror = (j >= fft->nyh);
+	  jl     = (mirror ? ny-j : j) - fft->col0;
+
+	  for (c=0; c<6; c++)
+	    for (a=0; a<nt; a++)
+	      {
+		sum = 0.0;
+		for (i=0; i<nx; i++)
+		  {
+		    ih = mirror ? (nx-i) % nx : i;
+		    tt = out[(c*fft->cols+jl)*nx+ih];
+		    if (mirror) tt = conj(tt);
+		    sum += tt*ex[a*nx+i];
+		  }
+
+		for (b=0; b<nt; b++)
+		  {
+		    k = (n*nt + a)*nt + b;
+		    t[k*6+c] -= creal(sum*ey[b*nmc+m]);
+		  }
+	      }
+	}
+    }
+
+  free(ex);free(ey);
+}
+
+void TF_SurfacePatches(Home_t *home, ThinFilm_t *thinfilm)
+{
+  // Rebuild the patches around the current surface intersections.
+  // Must be called after ABCcoeff, whose transformed coarse tractions
+  // are still in thinfilm->tractionFFT.
+
+  int i, j, k, a, b, c, n, il, numTiles, tx, ty;
+  int ntx, nty, nt, i0, nPad, numPoints, doPoint;
+  char *tileMark, *nativeSegCell;
+  real8 tileX, tileY, hx, hy, x0, y0;
+  real8 s[3][3], grids[3];
+  real8 (*pts)[2], *t;
+  SurfacePatch_t *patch;
+  TractionFFT_t *fft;
+  ThinFilm_t *model = thinfilm->patchModel;
+  Param_t *param = home->param;
+
+  int numDomains = home->numDomains;
+  int myDomain   = home->myDomain;
+
+  thinfilm->numPatches = 0;
+
+  if (model == (ThinFilm_t *)NULL) return;
+
+  ntx  = thinfilm->nx/thinfilm->patchCells;
+  nty  = thinfilm->ny/thinfilm->patchCells;
+  nt   = thinfilm->patchCells*thinfilm->patchRefine;
+  nPad = model->nx;
+  i0   = (nPad - nt)/2;
+  fft  = &model->tractionFFT;
+
+  tileX = thinfilm->TFLx/ntx;
+  tileY = thinfilm->TFLy/nty;
+  hx    = tileX/nt;
+  hy    = tileY/nt;
+
+  tileMark = (char *)calloc(ntx*nty, sizeof(char));
+  numTiles = MarkPatchTiles(home, thinfilm, tileMark, ntx, nty);
+
+  if (numTiles == 0)
+    {
+      free(tileMark);
+      return;
+    }
+
+  if (numTiles > thinfilm->allocPatches)
+    {
+      thinfilm->patches = (SurfacePatch_t *)
+	realloc(thinfilm->patches, sizeof(SurfacePatch_t)*numTiles);
+      if (thinfilm->patches == NULL)
+	Fatal("Not enough memory to allocate the surface patches");
+
+      for (n=thinfilm->allocPatches; n<numTiles; n++)
+	{
+	  patch = &thinfilm->patches[n];
+	  patch->A = AllocCoeff(nPad, nPad); patch->B = AllocCoeff(nPad, nPad);
+	  patch->C = AllocCoeff(nPad, nPad); patch->E = AllocCoeff(nPad, nPad);
+	  patch->F = AllocCoeff(nPad, nPad); patch->G = AllocCoeff(nPad, nPad);
+	}
+      thinfilm->allocPatches = numTiles;
+    }
+
+  // Tiles in a fixed order so every domain builds the same list.  The
+  // domain of a patch is centered on its tile.
+  n = 0;
+  for (tx=0; tx<ntx; tx++)
+    for (ty=0; ty<nty; ty++)
+      {
+	if (!tileMark[tx*nty+ty]) continue;
+
+	patch = &thinfilm->patches[n++];
+	patch->tile[0]   = tx;
+	patch->tile[1]   = ty;
+	patch->center[0] = param->minSideX + tx*tileX - i0*hx + 0.5*model->TFLx;
+	patch->center[1] = param->minSideY + ty*tileY - i0*hy + 0.5*model->TFLy;
+      }
+  free(tileMark);
+
+  // Refined points of all the tiles, nt*nt per tile, each with the
+  // top surface tractions then the bottom surface ones.
+  numPoints = numTiles*nt*nt;
+  pts = (real8 (*)[2])malloc(sizeof(real8[2])*numPoints);
+  t   = (real8 *)calloc(numPoints*6, sizeof(real8));
+
+  for (n=0; n<numTiles; n++)
+    {
+      patch = &thinfilm->patches[n];
+      x0 = param->minSideX + patch->tile[0]*tileX;
+      y0 = param->minSideY + patch->tile[1]*tileY;
+
+      for (a=0; a<nt; a++)
+	for (b=0; b<nt; b++)
+	  {
+	    k = (n*nt + a)*nt + b;
+	    pts[k][0] = x0 + a*hx;
+	    pts[k][1] = y0 + b*hy;
+	  }
+    }
+
+  // Tractions at the refined points, split among the domains like in
+  // TF_stress_boundary: the local stress near the native segments, the
+  // remote stress inside the domain and the Yoffe stress on an equal
+  // share of the points.
+  nativeSegCell = MarkNativeSegCells(home);
+
+  for (k=0; k<numPoints; k++)
+    for (c=0; c<6; c+=3)
+      {
+	grids[0] = pts[k][0];
+	grids[1] = pts[k][1];
+	grids[2] = (c == 0) ? thinfilm->t : -thinfilm->t;
+
+	doPoint = NearNativeSegs(home,nativeSegCell,
+				 grids[0],grids[1],grids[2]) ||
+	          (isRightDom(home,grids[0],grids[1],grids[2]) == myDomain);
+
+	if (doPoint)
+	  AllSegmentStress(home,thinfilm,grids[0],grids[1],grids[2],s);
+	else
+	  Init3x3(s);
+
+#ifndef _NOYOFFESTRESS
+	int ii,jj;
+	real8 Ys[3][3];
+	if (k % numDomains == myDomain)
+	  {
+	    AllYoffeStress(home,thinfilm,grids[0],grids[1],grids[2],Ys);
+	    for (ii=0; ii<3; ii++)
+	      for (jj=0; jj<3; jj++)
+		s[ii][jj] += Ys[ii][jj];
+	    doPoint = 1;
+	  }
+#endif
+
+	if (!doPoint) continue;
+
+	if (c == 0)
+	  {
+	    t[k*6  ] = -s[0][2];
+	    t[k*6+1] = -s[1][2];
+	    t[k*6+2] = -s[2][2];
+	  }
+	else
+	  {
+	    t[k*6+3] = s[0][2];
+	    t[k*6+4] = s[1][2];
+	    t[k*6+5] = s[2][2];
+	  }
+      }
+
+  free(nativeSegCell);
+
+  SubtractCoarseTractions(thinfilm, numTiles, nt, pts, t);
+
+#ifdef PARALLEL
+  MPI_Allreduce(MPI_IN_PLACE, t, numPoints*6, MPI_DOUBLE, MPI_SUM,
+		MPI_COMM_WORLD);
+#endif
+
+  // Solve each patch for the residual, placed on the tile in the
+  // middle of the otherwise traction free patch domain.  Each domain
+  // fills its own slab of rows of the patch transform.
+  for (n=0; n<numTiles; n++)
+    {
+      patch = &thinfilm->patches[n];
+
+      for (c=0; c<6; c++)
+	for (il=0; il<fft->rows; il++)
+	  {
+	    a = fft->row0 + il - i0;
+
+	    for (j=0; j<nPad; j++)
+	      {
+		b = j - i0;
+		i = (c*fft->rows+il)*nPad+j;
+
+		if (a < 0 || a >= nt || b < 0 || b >= nt)
+		  fft->in[i] = 0.0;
+		else
+		  fft->in[i] = t[((n*nt + a)*nt + b)*6+c];
+	      }
+	  }
+
+      model->A = patch->A; model->B = patch->B; model->C = patch->C;
+      model->E = patch->E; model->F = patch->F; model->G = patch->G;
+
+      ABCcoeff(home,model);
+    }
+
+  model->A = (COMPLEX **)NULL; model->B = (COMPLEX **)NULL;
+  model->C = (COMPLEX **)NULL; model->E = (COMPLEX **)NULL;
+  model->F = (COMPLEX **)NULL; model->G = (COMPLEX **)NULL;
+
+  free(pts);free(t);
+
+  thinfilm->numPatches = numTiles;
+}
+
+#endif
+#endif
@@ -132,6 +132,17 @@ void TF_Init(Home_t *home,ThinFilm_t **tf_ptr)
 #ifdef  _TFIMGSTRESS
   /* Allocate dynamic arrays */
   TF_allocations(home,thinfilm);
+
+  /* plan the traction transforms */
+  fourier_transform_tractions_init(home,&thinfilm->tractionFFT,
+				   thinfilm->nx,thinfilm->ny,6);
+
+  /* modes whose coefficients are computed on this domain */
+  thinfilm->modeCol = (int *)malloc(sizeof(int)*
+				    (2*thinfilm->tractionFFT.cols+1));
+  thinfilm->numModeCols = 
+    fourier_transform_mode_cols(thinfilm->ny,thinfilm->tractionFFT.col0,
+				thinfilm->tractionFFT.cols,thinfilm->modeCol);
   
   /* compute kx and ky */
   TF_Create_kpoints(thinfilm);
@@ -142,6 +153,12 @@ void TF_Init(Home_t *home,ThinFilm_t **tf_ptr)
   /* create cartesian grid */
   TF_Create_Grid(param,thinfilm);
 
+  /* create layers for the image stress */
+  TF_Create_ImgStressGrid(home,thinfilm);
+
+  /* set up the refined surface patches */
+  TF_Create_SurfacePatches(home,thinfilm);
+
 #endif
 }
 
@@ -153,7 +170,13 @@ void TF_Step(Home_t *home,ThinFilm_t *thinfilm)
 #ifdef _TFIMGSTRESS  
   // Calculates ABCEFG coefficient for stress tensor used 
   // in ParaDiS code.
-  ABCcoeff(thinfilm);
+  ABCcoeff(home,thinfilm);
+
+  // Tabulates the image stress for DispStress.
+  TF_ImgStressGrid(home,thinfilm);
+
+  // Corrects the image stress near the surface intersections.
+  TF_SurfacePatches(home,thinfilm);
 #endif
 }
 
@@ -161,8 +184,6 @@ void TF_Step(Home_t *home,ThinFilm_t *thinfilm)
 void TF_Finish(ThinFilm_t * thinfilm)
 {
   free(thinfilm->kx);free(thinfilm->ky);
-  free(thinfilm->Txp);free(thinfilm->Typ);free(thinfilm->Tzp);
-  free(thinfilm->Txm);free(thinfilm->Tym);free(thinfilm->Tzm);
 
   int NXMAX = thinfilm->nx;
   int NYMAX = thinfilm->ny;
@@ -202,6 +223,24 @@ void TF_Finish(ThinFilm_t * thinfilm)
       free(thinfilm->Grid[i]);
     }
 
+#ifdef _TFIMGSTRESS
+  fourier_transform_tractions_free(&thinfilm->tractionFFT);
+  free(thinfilm->modeCol);
+  TF_Free_SurfacePatches(thinfilm);
+#endif
+
+  if (thinfilm->imgStressFFT)
+    {
+      free(thinfilm->imgStress);
+      free(thinfilm->imgRowValid);
+      fftw_free(thinfilm->imgColBuf);
+      fftw_free(thinfilm->imgRowBuf);
+      if (thinfilm->imgColPlan != (fftw_plan)NULL)
+	fftw_destroy_plan(thinfilm->imgColPlan);
+      if (thinfilm->imgRowPlan != (fftw_plan)NULL)
+	fftw_destroy_plan(thinfilm->imgRowPlan);
+    }
+
 }
 
 
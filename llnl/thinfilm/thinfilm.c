@@ -35,46 +35,6 @@ void TF_allocations(Home_t *home, ThinFilm_t *thinfilm)
       exit(0);
     }  
 
-  thinfilm->Txp = (fftw_complex *)malloc(sizeof(fftw_complex)*NXMAX*NYMAX);
-  if (thinfilm->Txp == NULL) 
-    {
-      printf("Not enough memory to allocate Tx\n");
-      exit(0);
-    }
-
-  thinfilm->Typ = (fftw_complex *)malloc(sizeof(fftw_complex)*NXMAX*NYMAX);
-  if (thinfilm->Typ == NULL) 
-    {
-      printf("Not enough memory to allocate Ty\n");
-      exit(0);
-    }
-
-  thinfilm->Tzp = (fftw_complex *)malloc(sizeof(fftw_complex)*NXMAX*NYMAX);
-  if (thinfilm->Tzp == NULL) 
-    {
-      printf("Not enough memory to allocate Tz\n");
-      exit(0);
-    }
-  
-  thinfilm->Txm = (fftw_complex *)malloc(sizeof(fftw_complex)*NXMAX*NYMAX);
-  if (thinfilm->Txm == NULL) 
-    {
-      printf("Not enough memory to allocate Tx\n");
-      exit(0);
-    }
-  thinfilm->Tym = (fftw_complex *)malloc(sizeof(fftw_complex)*NXMAX*NYMAX);
-  if (thinfilm->Tym == NULL) 
-    {
-      printf("Not enough memory to allocate Ty\n");
-      exit(0);
-    }
-  thinfilm->Tzm = (fftw_complex *)malloc(sizeof(fftw_complex)*NXMAX*NYMAX);
-  if (thinfilm->Tzm == NULL) 
-    {
-      printf("Not enough memory to allocate Tz\n");
-      exit(0);
-    }
-
   thinfilm->A = (COMPLEX **)malloc(sizeof(COMPLEX*)*NXMAX);
   if (thinfilm->A == NULL) 
     {
@@ -237,6 +197,78 @@ void TF_Create_Grid(Param_t *param, ThinFilm_t *thinfilm)
     }
 }
 
+void TF_Create_ImgStressGrid(Home_t *home, ThinFilm_t *thinfilm)
+{
+  // Layers on which TF_ImgStressGrid tabulates the image stress.
+  // The layers run from the bottom surface z = -t to the top
+  // surface z = t and are spaced like the in-plane grid points.
+  //
+  // The inverse transforms are distributed like the traction ones:
+  // along x for the ky columns of A..G computed on this domain, then
+  // along y for this domain's slab of x rows of the fine grid.
+
+  int ov, nxf, nyf, nz, nmc;
+  real8 dz;
+  Param_t *param = home->param;
+
+  thinfilm->imgStressFFT = param->tf_imgStressFFT;
+  if (!thinfilm->imgStressFFT) return;
+
+  ov = MAX(1, param->tf_imgStressOversample);
+
+  thinfilm->imgNx = ov*thinfilm->nx;
+  thinfilm->imgNy = ov*thinfilm->ny;
+
+  dz = MIN(thinfilm->TFLx/thinfilm->imgNx, thinfilm->TFLy/thinfilm->imgNy);
+
+  thinfilm->imgNz = (int)ceil(2.0*thinfilm->t/dz) + 1;
+  if (thinfilm->imgNz < 2) thinfilm->imgNz = 2;
+  thinfilm->imgDz = 2.0*thinfilm->t/(thinfilm->imgNz-1);
+  thinfilm->imgZmin = -thinfilm->t;
+
+  nxf = thinfilm->imgNx;
+  nyf = thinfilm->imgNy;
+  nz  = thinfilm->imgNz;
+  nmc = thinfilm->numModeCols;
+
+  thinfilm->imgRow0 = TF_SLAB_START(nxf, home->myDomain, home->numDomains);
+  thinfilm->imgRows = TF_SLAB_START(nxf, home->myDomain+1, home->numDomains) -
+                      thinfilm->imgRow0;
+
+  thinfilm->imgStress = (double *)malloc(sizeof(double)*6*nz*nxf*nyf);
+  thinfilm->imgRowValid = (char *)calloc(1, nxf);
+  thinfilm->imgColBuf = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+						    (nz*6*nmc*nxf+1));
+  thinfilm->imgRowBuf = (fftw_complex *)fftw_malloc(sizeof(fftw_complex)*
+						    (nz*6*thinfilm->imgRows*nyf+1));
+
+  if (thinfilm->imgStress == NULL || thinfilm->imgRowValid == NULL ||
+      thinfilm->imgColBuf == NULL || thinfilm->imgRowBuf == NULL) 
+    {
+      printf("Not enough memory to allocate image stress grid\n");
+      exit(0);
+    }
+
+  // In-place batched transforms.  FFTW_ESTIMATE does not touch the
+  // arrays.
+  thinfilm->imgColPlan = (fftw_plan)NULL;
+  thinfilm->imgRowPlan = (fftw_plan)NULL;
+
+  if (nmc > 0)
+    thinfilm->imgColPlan = 
+      fftw_plan_many_dft(1, &nxf, nz*6*nmc,
+			 thinfilm->imgColBuf, NULL, 1, nxf,
+			 thinfilm->imgColBuf, NULL, 1, nxf,
+			 FFTW_BACKWARD, FFTW_ESTIMATE);
+
+  if (thinfilm->imgRows > 0)
+    thinfilm->imgRowPlan = 
+      fftw_plan_many_dft(1, &nyf, nz*6*thinfilm->imgRows,
+			 thinfilm->imgRowBuf, NULL, 1, nyf,
+			 thinfilm->imgRowBuf, NULL, 1, nyf,
+			 FFTW_BACKWARD, FFTW_ESTIMATE);
+}
+
 void TF_Create_kpoints(ThinFilm_t *thinfilm)
 {
   int i,j;
@@ -273,130 +305,117 @@ void TF_stress_boundary(Home_t *home,ThinFilm_t *thinfilm)
   // Calculate Tractions on thin film surfaces from stress in the system
   // F = sigma . n  = -T 
   // Done every time step 
-
-  int i,j,k,l;
+  //
+  // Each domain only evaluates the grid points its own segments
+  // contribute to: the points near cells holding its native segments
+  // (local stress), the points inside its domain (remote stress) and,
+  // for the Yoffe stress which is computed from the global surface
+  // segment list, the points of its slab of grid rows.  The partial
+  // tractions are summed with a single reduce-scatter that leaves
+  // each domain with its slab of rows, which is where the distributed
+  // traction FFT expects them.
+
+  int i,j,k,c,n,il;
+  int doPoint, inSlab;
+  int *counts;
+  char *nativeSegCell;
   real8 s[3][3],grids[3];
+  real8 *t, *t_slab;
 
   int nx = thinfilm->nx;
   int ny = thinfilm->ny;
-  real8 TFLx = thinfilm->TFLx;
-  real8 TFLy = thinfilm->TFLy;
-  real8 *tx, *ty, *tz, *tx_tot, *ty_tot, *tz_tot;
+  int numDomains = home->numDomains;
+  int myDomain   = home->myDomain;
+  TractionFFT_t *fft = &thinfilm->tractionFFT;
+
+  // Rows of the traction grid owned by each domain
+  counts = (int *)malloc(sizeof(int)*numDomains);
 
-  // Allocate tx, ty, tz
-  tx = (real8 *)malloc(sizeof(double)*nx*ny*2);
-  ty = (real8 *)malloc(sizeof(double)*nx*ny*2);
-  tz = (real8 *)malloc(sizeof(double)*nx*ny*2);
+  for (n=0; n<numDomains; n++) 
+    counts[n] = (TF_SLAB_START(nx, n+1, numDomains) - 
+		 TF_SLAB_START(nx, n, numDomains))*ny*6;
 
-  tx_tot = (real8 *)malloc(sizeof(double)*nx*ny*2);
-  ty_tot = (real8 *)malloc(sizeof(double)*nx*ny*2);
-  tz_tot = (real8 *)malloc(sizeof(double)*nx*ny*2);
+  // The six components of a grid point are kept together: the
+  // top surface tractions then the bottom surface ones.
+  t      = (real8 *)calloc(1, sizeof(double)*nx*ny*6);
+  t_slab = (real8 *)malloc(sizeof(double)*(fft->rows*ny*6+1));
 
+  nativeSegCell = MarkNativeSegCells(home);
 
-  // Bottom surface
   for (i=0; i<nx; i++)
     {
-    for (j=0; j<ny; j++) 
-      {
-	grids[0] = thinfilm->Grid[0][i][j];
-	grids[1] = thinfilm->Grid[1][i][j];
-	grids[2] =-thinfilm->Grid[2][i][j];
-	
-	AllSegmentStress(home,thinfilm,grids[0],grids[1],grids[2],s);
+      inSlab = (i >= fft->row0 && i < fft->row0 + fft->rows);
 
-#if 1
-#ifndef _NOYOFFESTRESS
-	int ii,jj;
-	real8 Ys[3][3];
-	AllYoffeStress(home,thinfilm,grids[0],grids[1],grids[2],Ys);
-	for (ii=0; ii<3; ii++) 
-	  for (jj=0; jj<3; jj++)
-	    s[ii][jj] += Ys[ii][jj];
-#endif
-#endif
+      for (j=0; j<ny; j++) 
+	{
+	  // c = 0 : top surface, c = 3 : bottom surface
+	  for (c=0; c<6; c+=3)
+	    {
+	      grids[0] = thinfilm->Grid[0][i][j];
+	      grids[1] = thinfilm->Grid[1][i][j];
+	      grids[2] = (c == 0) ? thinfilm->Grid[2][i][j] : 
+		                   -thinfilm->Grid[2][i][j];
 
-        tx[j+i*ny] = s[0][2];
-        ty[j+i*ny] = s[1][2];
-        tz[j+i*ny] = s[2][2];
-      }
-    }
+	      doPoint = NearNativeSegs(home,nativeSegCell,
+				       grids[0],grids[1],grids[2]) ||
+		        (isRightDom(home,grids[0],grids[1],grids[2]) == myDomain);
 
-  // Top surface 
-  for (i=0; i<nx; i++) 
-    for (j=0; j<ny; j++) 
-      {
-	grids[0] = thinfilm->Grid[0][i][j];
-	grids[1] = thinfilm->Grid[1][i][j];
-	grids[2] = thinfilm->Grid[2][i][j];
-	
-	AllSegmentStress(home,thinfilm,grids[0],grids[1],grids[2],s);
+	      if (doPoint)
+		AllSegmentStress(home,thinfilm,grids[0],grids[1],grids[2],s);
+	      else
+		Init3x3(s);
 
 #if 1
 #ifndef _NOYOFFESTRESS
-	int ii,jj;
-	real8 Ys[3][3];
-	AllYoffeStress(home,thinfilm,grids[0],grids[1],grids[2],Ys);
-	for (ii=0; ii<3; ii++) 
-	  for (jj=0; jj<3; jj++)
-	    s[ii][jj] += Ys[ii][jj];
+	      int ii,jj;
+	      real8 Ys[3][3];
+	      if (inSlab)
+		{
+		  AllYoffeStress(home,thinfilm,grids[0],grids[1],grids[2],Ys);
+		  for (ii=0; ii<3; ii++) 
+		    for (jj=0; jj<3; jj++)
+		      s[ii][jj] += Ys[ii][jj];
+		  doPoint = 1;
+		}
 #endif
 #endif
 
-        tx[j+i*ny+nx*ny] = -s[0][2];
-        ty[j+i*ny+nx*ny] = -s[1][2];
-        tz[j+i*ny+nx*ny] = -s[2][2];
-      }
+	      if (!doPoint) continue;
+
+	      k = (j+i*ny)*6 + c;
+	      if (c == 0)
+		{
+		  t[k  ] = -s[0][2];
+		  t[k+1] = -s[1][2];
+		  t[k+2] = -s[2][2];
+		}
+	      else
+		{
+		  t[k  ] = s[0][2];
+		  t[k+1] = s[1][2];
+		  t[k+2] = s[2][2];
+		}
+	    }
+	}
+    }
+
+  free(nativeSegCell);
 
 #ifdef PARALLEL
-  MPI_Allreduce(tx, tx_tot, 2*nx*ny, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(ty, ty_tot, 2*nx*ny, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-  MPI_Allreduce(tz, tz_tot, 2*nx*ny, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Reduce_scatter(t, t_slab, counts, MPI_DOUBLE, 
+		     MPI_SUM, MPI_COMM_WORLD);
 #else
-  for (i = 0; i < nx*2; i++)
-    for (j = 0; j < ny; j++)
-      {
-	tx_tot[j+i*ny] = tx[j+i*ny];
-	ty_tot[j+i*ny] = ty[j+i*ny];
-	tz_tot[j+i*ny] = tz[j+i*ny];
-      }
+  for (k=0; k<nx*ny*6; k++) t_slab[k] = t[k];
 #endif
 
+  // Component-major layout for the row transforms
+  for (il=0; il<fft->rows; il++)
+    for (j=0; j<ny; j++) 
+      for (c=0; c<6; c++)
+	fft->in[(c*fft->rows+il)*ny+j] = t_slab[(j+il*ny)*6+c];
 
-
-  for (i=0; i<nx; i++)
-    {
-      for (j=0; j<ny; j++) 
-	{
-#ifndef _CYGWIN
-        thinfilm->Txm[j+i*ny] = tx_tot[j+i*ny];
-	thinfilm->Tym[j+i*ny] = ty_tot[j+i*ny];
-	thinfilm->Tzm[j+i*ny] = tz_tot[j+i*ny];
-
-        thinfilm->Txp[j+i*ny] = tx_tot[j+i*ny+nx*ny];
-	thinfilm->Typ[j+i*ny] = ty_tot[j+i*ny+nx*ny];
-	thinfilm->Tzp[j+i*ny] = tz_tot[j+i*ny+nx*ny];
-#else
-	thinfilm->Txm[j+i*ny][0] = tx_tot[j+i*ny];
-	thinfilm->Tym[j+i*ny][0] = ty_tot[j+i*ny];
-	thinfilm->Tzm[j+i*ny][0] = tz_tot[j+i*ny];
-
-	thinfilm->Txm[j+i*ny][1] = 0.0;
-	thinfilm->Tym[j+i*ny][1] = 0.0;
-	thinfilm->Tzm[j+i*ny][1] = 0.0;
-
-	thinfilm->Txp[j+i*ny][0] = tx_tot[j+i*ny+nx*ny];
-	thinfilm->Typ[j+i*ny][0] = ty_tot[j+i*ny+nx*ny];
-	thinfilm->Tzp[j+i*ny][0] = tz_tot[j+i*ny+nx*ny];
-
-	thinfilm->Txp[j+i*ny][1] = 0.0;
-	thinfilm->Typ[j+i*ny][1] = 0.0;
-	thinfilm->Tzp[j+i*ny][1] = 0.0;
-#endif
-      }
-    }
-
-  free(tx);free(ty);free(tz);
-  free(tx_tot);free(ty_tot);free(tz_tot);
+  free(t);free(t_slab);
+  free(counts);
 }
 
 
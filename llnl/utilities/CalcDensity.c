@@ -8,14 +8,26 @@
  *                      line args, and write the data to a file that
  *                      can be visualized via some external tool.
  *
+ *                      Any number of control files may be specified
+ *                      in order to process a whole series of restart
+ *                      files in one invocation.  When compiled with
+ *                      OpenMP support, the files in a series are
+ *                      distributed dynamically among the threads.  When
+ *                      only a single file is processed, the threads are
+ *                      instead used to rasterize the segments of that
+ *                      file into the density grid.
+ *
  *      Usage:  CalcDensity -b -g <gridx[,y,z]> -h -d <dataFile> \
- *                          -o <outFile> <ctrlFile>
+ *                          -o <outFile> <ctrlFile> [ctrlFile ...]
  *
- *      Includes functions: 
+ *      Includes functions:
+ *          BuildNodeHash()
+ *          CalcFileDensity()
  *          DeleteUnreferencedNodes()
  *          FindDensity()
- *          FindNode()
  *          FindNodeIndex()
+ *          FreeDensityGrid()
+ *          InitDensityGrid()
  *          ProcessBinNodalData()
  *          ProcessNodalData()
  *          ReadDataParams()
@@ -24,6 +36,7 @@
  *          ReallocNodeInfo()
  *          ReallocSegList()
  *          SetDensity()
+ *          SumThreadGrids()
  *          Usage()
  *
  *      Output file format:
@@ -73,6 +86,33 @@ typedef struct {
     real8 pos[3];
 } NodeInfo_t;
 
+/*
+ *      Open addressing hash table mapping node tags to indices in
+ *      the NodeInfo_t array.  <numSlots> is always a power of 2 and
+ *      empty slots contain -1.
+ */
+typedef struct {
+    int   numSlots;
+    int   *slot;
+} NodeHash_t;
+
+/*
+ *      Define a structure holding the density grid for a single
+ *      data file along with the grid geometry.  Each thread rasterizes
+ *      segments into its own grid in <threadGrid>, (thread 0 uses
+ *      <densityGrid> directly) and the grids are summed into
+ *      <densityGrid> after all segments have been processed.
+ */
+typedef struct {
+    int   gridSize[3];
+    int   numGridElements;
+    int   numThreads;
+    real8 cellSize[3];
+    real8 burgVolFactor;
+    real8 *densityGrid;
+    real8 **threadGrid;
+} DensityGrid_t;
+
 
 /*---------------------------------------------------------------------------
  *
@@ -260,27 +300,69 @@ static void SetDensity(Home_t *home, real8 *densGrid, int gridSize[3],
 
 /*---------------------------------------------------------------------------
  *
- *      Function:    FindNode
- *      Description: Comparison function (suitable for use with bsearch)
- *                   that compares tag <a> with the tag in the
- *                   NodeInfo_t structure at <b>.
+ *      Function:    NodeHashSlot
+ *      Description: Compute the initial hash table slot for a tag.
  *
- *      Returns:
- *          -1 if tag <a> <  tag <b.tag>
- *           0 if tag <a> == tag <b.tag>
- *          +1 if tag <a> >  tag <b.tag>
+ *-------------------------------------------------------------------------*/
+static int NodeHashSlot(Tag_t *tag, int numSlots)
+{
+        unsigned int key;
+
+        key = ((unsigned int)tag->domainID * 2654435761U) ^
+              ((unsigned int)tag->index * 40503U);
+
+        return((int)(key & (unsigned int)(numSlots - 1)));
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    BuildNodeHash
+ *      Description: (Re)build the tag index for the <nodeInfo> array.
+ *                   The table is grown as needed to keep the load
+ *                   factor at or below one half.
+ *
+ *      Arguments:
+ *          hash      hash table to be rebuilt
+ *          nodeInfo  array of NodeInfo_t structures
+ *          numNodes  number of elements in array <nodeInfo>
  *
  *-------------------------------------------------------------------------*/
-static int FindNode(const void *a, const void *b)
+static void BuildNodeHash(NodeHash_t *hash, NodeInfo_t *nodeInfo,
+                          int numNodes)
 {
-        Tag_t      *tag = (Tag_t *)a;
-        NodeInfo_t *node = (NodeInfo_t *)b;
+        int i, slot, mask, neededSlots;
+
+        neededSlots = 1024;
 
-        if (tag->domainID < node->tag.domainID) return(-1);
-        if (tag->domainID > node->tag.domainID) return(1);
-        if (tag->index < node->tag.index) return(-1);
+        while (neededSlots < 2 * numNodes) {
+            neededSlots <<= 1;
+        }
+
+        if (neededSlots > hash->numSlots) {
+            free(hash->slot);
+            hash->slot = (int *)malloc(neededSlots * sizeof(int));
+            if (hash->slot == (int *)NULL) {
+                Fatal("Error allocating node hash table");
+            }
+            hash->numSlots = neededSlots;
+        }
+
+        mask = hash->numSlots - 1;
+
+        for (i = 0; i < hash->numSlots; i++) {
+            hash->slot[i] = -1;
+        }
+
+        for (i = 0; i < numNodes; i++) {
+            slot = NodeHashSlot(&nodeInfo[i].tag, hash->numSlots);
+            while (hash->slot[slot] >= 0) {
+                slot = (slot + 1) & mask;
+            }
+            hash->slot[slot] = i;
+        }
 
-        return(tag->index > node->tag.index);
+        return;
 }
 
 
@@ -293,24 +375,120 @@ static int FindNode(const void *a, const void *b)
  *      Arguments:
  *          tag       tag of the node to search for
  *          nodeInfo  array of NodeInfo_t structures
- *          numNodes  number of elements in array <nodeInfo>
+ *          hash      tag index for <nodeInfo> built by BuildNodeHash()
  *
  *      Returns:  Index in <nodeInfo> of the element whose tag matches <tag>
  *                or -1 if not found.
  *
  *-------------------------------------------------------------------------*/
-static int FindNodeIndex(Tag_t *tag, NodeInfo_t *nodeInfo, int numNodes)
+static int FindNodeIndex(Tag_t *tag, NodeInfo_t *nodeInfo, NodeHash_t *hash)
 {
-        NodeInfo_t *found;
+        int slot, index, mask;
 
-        found = (NodeInfo_t *)bsearch(tag, nodeInfo, numNodes,
-                                      sizeof(NodeInfo_t), FindNode);
+        mask = hash->numSlots - 1;
+        slot = NodeHashSlot(tag, hash->numSlots);
 
-        if (found == (NodeInfo_t *)NULL) {
-            return(-1);
-        } else {
-            return(found - nodeInfo);
+        while ((index = hash->slot[slot]) >= 0) {
+            if ((nodeInfo[index].tag.domainID == tag->domainID) &&
+                (nodeInfo[index].tag.index == tag->index)) {
+                return(index);
+            }
+            slot = (slot + 1) & mask;
         }
+
+        return(-1);
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    InitDensityGrid
+ *      Description: Allocate the density grid and one private grid
+ *                   for each additional thread that will rasterize
+ *                   segments into it.
+ *
+ *      Arguments:
+ *          grid        structure to initialize.  Caller must have set
+ *                      gridSize, cellSize and burgVolFactor.
+ *          numThreads  number of threads that will call FindDensity()
+ *                      in parallel for this grid.
+ *
+ *-------------------------------------------------------------------------*/
+static void InitDensityGrid(DensityGrid_t *grid, int numThreads)
+{
+        int i;
+
+        grid->numGridElements = grid->gridSize[X] * grid->gridSize[Y] *
+                                grid->gridSize[Z];
+        grid->numThreads = numThreads;
+
+        grid->threadGrid = (real8 **)malloc(numThreads * sizeof(real8 *));
+
+        for (i = 0; i < numThreads; i++) {
+            grid->threadGrid[i] = (real8 *)calloc(1, grid->numGridElements *
+                                                  sizeof(real8));
+            if (grid->threadGrid[i] == (real8 *)NULL) {
+                Fatal("calloc error getting density field of size %d elements",
+                      grid->numGridElements);
+            }
+        }
+
+        grid->densityGrid = grid->threadGrid[0];
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    FreeDensityGrid
+ *      Description: Release all arrays associated with the density grid
+ *
+ *-------------------------------------------------------------------------*/
+static void FreeDensityGrid(DensityGrid_t *grid)
+{
+        int i;
+
+        for (i = 0; i < grid->numThreads; i++) {
+            free(grid->threadGrid[i]);
+        }
+
+        free(grid->threadGrid);
+
+        grid->threadGrid = (real8 **)NULL;
+        grid->densityGrid = (real8 *)NULL;
+
+        return;
+}
+
+
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    SumThreadGrids
+ *      Description: Add the contributions accumulated in each thread's
+ *                   private grid into the density grid.  The sum is
+ *                   distributed among threads by grid cell.
+ *
+ *-------------------------------------------------------------------------*/
+static void SumThreadGrids(DensityGrid_t *grid)
+{
+        int i, t;
+
+#ifdef _OPENMP
+#pragma omp parallel for private(t) num_threads(grid->numThreads)
+#endif
+        for (i = 0; i < grid->numGridElements; i++) {
+            for (t = 1; t < grid->numThreads; t++) {
+                grid->densityGrid[i] += grid->threadGrid[t][i];
+            }
+        }
+
+        for (t = 1; t < grid->numThreads; t++) {
+            memset(grid->threadGrid[t], 0,
+                   grid->numGridElements * sizeof(real8));
+        }
+
+        return;
 }
 
 
@@ -321,90 +499,129 @@ static int FindNodeIndex(Tag_t *tag, NodeInfo_t *nodeInfo, int numNodes)
  *                   endpoints (if known) and calculate the contribution
  *                   to all appropriate density grid cells for each segment.
  *
+ *                   The segments are distributed among the threads
+ *                   with each thread updating its own copy of the grid.
+ *                   Processed segments are then removed from the list
+ *                   serially.
+ *
  *      Arguments:
  *          segList       array of segments
- *          numAllocSegs  number of allocated elements in array <segList>
  *          numSegs       number of used elements in array <segList>
  *          nodeInfo      array of nodal data
  *          numNodes      number of nodes in array <nodeInfo>
- *          densityGrid   3-D density grid represented as a single
- *                        dimension array.
- *          gridSize      specifies the size of the density grid in
- *                        X, Y and Z dimensions.
- *          cellSize      length (units of b) of density grid cells
- *                        in X, Y and Z.
- *          burgVolFactor  factor by which segment length is adjusted to
- *                       calculate density.
+ *          nodeHash      tag index for <nodeInfo>.  Rebuilt by this
+ *                        function.
+ *          grid          density grid to update
  *
  *-------------------------------------------------------------------------*/
-static void FindDensity(Home_t *home, Seg_t *segList, int *numAllocSegs,
-                        int *numSegs, NodeInfo_t *nodeInfo, int numNodes,
-                        real8 *densityGrid, int gridSize[3],
-                        real8 cellSize[3], real8 burgVolFactor)
+static void FindDensity(Home_t *home, Seg_t *segList, int *numSegs,
+                        NodeInfo_t *nodeInfo, int numNodes,
+                        NodeHash_t *nodeHash, DensityGrid_t *grid)
 {
-        int     i, j, index1, index2;
+        int     i, j, threadID, index1, index2;
         int     cellIndex[3];
+        int     *segNodes;
         real8   p1[3], p2[3], lineDir[3];
+        real8   *densGrid;
         Param_t *param;
 
         param = home->param;
 
+        if (*numSegs == 0) {
+            return;
+        }
+
+        BuildNodeHash(nodeHash, nodeInfo, numNodes);
+
+        segNodes = (int *)malloc(*numSegs * 2 * sizeof(int));
+
 /*
  *      Loop through all the segments currently on the list.  If
- *      we have the node info (position) of eahc endpoint loaded
+ *      we have the node info (position) of each endpoint loaded
  *      into memory, we can process the segment.  Otherwise skip
  *      it for now.
  */
-        for (i = 0; i < *numSegs; i++) {
+#ifdef _OPENMP
+#pragma omp parallel private(i, j, threadID, index1, index2, cellIndex, \
+                             p1, p2, lineDir, densGrid) \
+                     num_threads(grid->numThreads)
+#endif
+        {
+#ifdef _OPENMP
+            threadID = omp_get_thread_num();
+#else
+            threadID = 0;
+#endif
+            densGrid = grid->threadGrid[threadID];
 
-            index1 = FindNodeIndex(&segList[i].tag1, nodeInfo, numNodes);
-            index2 = FindNodeIndex(&segList[i].tag2, nodeInfo, numNodes);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 256)
+#endif
+            for (i = 0; i < *numSegs; i++) {
 
-            if ((index1 < 0) || (index2 < 0)) {
-                continue;
-            }
+                index1 = FindNodeIndex(&segList[i].tag1, nodeInfo, nodeHash);
+                index2 = FindNodeIndex(&segList[i].tag2, nodeInfo, nodeHash);
 
-            for (j = 0; j < 3; j++) {
-               p1[j] = nodeInfo[index1].pos[j];
-               p2[j] = nodeInfo[index2].pos[j];
-            }
+                segNodes[i*2  ] = index1;
+                segNodes[i*2+1] = index2;
 
-            PBCPOSITION(param, p1[X], p1[Y], p1[Z], &p2[X], &p2[Y], &p2[Z]);
+                if ((index1 < 0) || (index2 < 0)) {
+                    continue;
+                }
+
+                for (j = 0; j < 3; j++) {
+                   p1[j] = nodeInfo[index1].pos[j];
+                   p2[j] = nodeInfo[index2].pos[j];
+                }
+
+                PBCPOSITION(param, p1[X], p1[Y], p1[Z],
+                            &p2[X], &p2[Y], &p2[Z]);
 /*
- *          Get the direction of the segment from point p1 to p2.
+ *              Get the direction of the segment from point p1 to p2.
  */
-            for (j = 0; j < 3; j++) {
-                lineDir[j] = (p2[j] >= p1[j] ? 1 : -1);
-            }
+                for (j = 0; j < 3; j++) {
+                    lineDir[j] = (p2[j] >= p1[j] ? 1 : -1);
+                }
 /*
- *          Get the cell indices in the density grid for 
- *          point p1.  If the point is actually outside the
- *          primary simulation space, the cell indices may
- *          be less than zero or greater than the maximum
- *          index, but that is okay since the indices
- *          will be shifted for PBC (or to the closest primary
- *          cell if PBC is not enabled).
+ *              Get the cell indices in the density grid for
+ *              point p1.  If the point is actually outside the
+ *              primary simulation space, the cell indices may
+ *              be less than zero or greater than the maximum
+ *              index, but that is okay since the indices
+ *              will be shifted for PBC (or to the closest primary
+ *              cell if PBC is not enabled).
  */
-            for (j = 0; j < 3; j++) {
+                for (j = 0; j < 3; j++) {
 
-                cellIndex[j] = (int) floor((p1[j] - param->minCoordinates[j]) /
-                               cellSize[j]);
-            }
+                    cellIndex[j] = (int) floor((p1[j] -
+                                                param->minCoordinates[j]) /
+                                               grid->cellSize[j]);
+                }
 
 /*
- *          Increment the density values for all cells in the
- *          density field containing any portion of this
- *          segment.
+ *              Increment the density values for all cells in the
+ *              density field containing any portion of this
+ *              segment.
  */
-            SetDensity(home, densityGrid, gridSize, cellSize,
-                       p1, p2, lineDir, cellIndex, burgVolFactor);
+                SetDensity(home, densGrid, grid->gridSize, grid->cellSize,
+                           p1, p2, lineDir, cellIndex, grid->burgVolFactor);
+            }
+        }
 
 /*
- *          Decrement the reference count for each of the segment
- *          endpoints, and remove this segment from the list by
- *          copying the last segment in the list over top of the
- *          current one.
+ *      Decrement the reference count for each of the endpoints of
+ *      the processed segments, and remove those segments from the list
+ *      by copying the last segment in the list over top of each.
  */
+        for (i = *numSegs - 1; i >= 0; i--) {
+
+            index1 = segNodes[i*2  ];
+            index2 = segNodes[i*2+1];
+
+            if ((index1 < 0) || (index2 < 0)) {
+                continue;
+            }
+
             nodeInfo[index1].refCnt--;
             nodeInfo[index2].refCnt--;
 
@@ -413,13 +630,10 @@ static void FindDensity(Home_t *home, Seg_t *segList, int *numAllocSegs,
             }
 
             *numSegs -= 1;
-/*
- *          And decrement i so we process the segment we just moved
- *          in the array.
- */
-            i--;
         }
 
+        free(segNodes);
+
         return;
 }
 
@@ -465,14 +679,15 @@ static void Usage(char *progName)
         printf("                  [-d <dataFile>]\n");
         printf("                  [-g <gridX[,gridY,gridZ]>]\n");
         printf("                  [-o <outFile>]\n");
-        printf("                  <ctrlFile>\n");
+        printf("                  <ctrlFile> [ctrlFile ...]\n");
         printf("\n");
 
         printf("  Where:\n");
         printf("      -b    indicates the use of an HDF5 restart file\n");
         printf("      -d    specifies the name of the nodal data file.  If\n");
         printf("            none is given default behavior is the same as\n");
-        printf("            the ParaDiS default for data file name.\n");
+        printf("            the ParaDiS default for data file name.  Only\n");
+        printf("            valid with a single control file.\n");
         printf("      -g    specifies the density grid size.  If the the\n");
         printf("            size in Y and Z dimensions are not given they\n");
         printf("            default to the size in the X dimension.  Default\n");
@@ -480,13 +695,19 @@ static void Usage(char *progName)
         printf("      -o    specifies the name of the density output file.  If\n");
         printf("            none is given default behavior is the same as\n");
         printf("            the base control file name with a '.dens' suffix\n");
-        printf("            appended\n");
+        printf("            appended.  Only valid with a single control file.\n");
+        printf("\n");
+        printf("  If multiple control files are given, the density of\n");
+        printf("  each restart is written to its own '.dens' file.\n");
+        printf("  Set OMP_NUM_THREADS to control the number of files\n");
+        printf("  processed at once.\n");
         printf("\n");
 
         return;
 }
 
 
+
 /*---------------------------------------------------------------------------
  *
  *      Function:    ReallocNodeInfo
@@ -652,14 +873,14 @@ static void ReadDataParams(Home_t *home, FILE *fpData)
  *                      Do a quick verification of the decomposition type
  */
                         if ((param->dataDecompType < 1) ||
-                            (param->dataDecompType > 2)) {
-                            Fatal("dataDecompType=%d is invalid.  Type must be 1 or 2\n",
+                            (param->dataDecompType > 3)) {
+                            Fatal("dataDecompType=%d is invalid.  Type must be 1, 2 or 3\n",
                                   param->dataDecompType);
                         }
 
                         ReadDecompBounds(home, (void **)&fpData, doBinRead,
                                          param->decompType,
-                                         &home->decomp);
+                                         (void **)NULL);
                     } else if (strcmp(token, "nodalData") == 0) {
 /*
  *                      When we hit the nodal data, we can break
@@ -714,19 +935,11 @@ static void ReadDataParams(Home_t *home, FILE *fpData)
  *          fpData       file pointer to open nodal data file.
  *          baseFileName Name of the nodal data file stripped of any
  *                       sequence number suffix.
- *          densityGrid  3-D density grid represented as a single
- *                       dimension array.
- *          gridSize     specifies the size of the density grid in
- *                       X, Y and Z dimensions.
- *          cellSize     length (units of b) of density grid cells
- *                       in X, Y and Z.
- *          burgVolFactor  factor by which segment length is adjusted to
- *                       calculate density.
+ *          grid         density grid to update
  *
  *-------------------------------------------------------------------------*/
 static void ProcessNodalData(Home_t *home, FILE *fpData, char *baseFileName,
-                             real8 *densityGrid, int gridSize[3],
-                             real8 cellSize[3], real8 burgVolFactor)
+                             DensityGrid_t *grid)
 {
         int        i, j;
         int        numArms, fileSeqNum;
@@ -739,6 +952,7 @@ static void ProcessNodalData(Home_t *home, FILE *fpData, char *baseFileName,
         Seg_t      *segList;
         Param_t    *param;
         NodeInfo_t *nodeInfo;
+        NodeHash_t nodeHash;
 
         param = home->param;
 
@@ -755,6 +969,9 @@ static void ProcessNodalData(Home_t *home, FILE *fpData, char *baseFileName,
         numAllocNodes = 0;
         nodeInfo      = (NodeInfo_t *)NULL;
 
+        nodeHash.numSlots = 0;
+        nodeHash.slot     = (int *)NULL;
+
 /*
  *      Set up some initial nodeInfo and segment arrays.
  */
@@ -800,9 +1017,8 @@ static void ProcessNodalData(Home_t *home, FILE *fpData, char *baseFileName,
  */
             if (readThisBlock > NODE_READ_BLOCK_CNT) {
 
-                FindDensity(home, segList, &numAllocSegs, &numSegs,
-                            nodeInfo, numNodes, densityGrid,
-                            gridSize, cellSize, burgVolFactor);
+                FindDensity(home, segList, &numSegs, nodeInfo, numNodes,
+                            &nodeHash, grid);
 
                 DeleteUnreferencedNodes(nodeInfo, &numNodes);
 
@@ -871,9 +1087,14 @@ static void ProcessNodalData(Home_t *home, FILE *fpData, char *baseFileName,
 /*
  *      Process any remaining segments in the list
  */
-        FindDensity(home, segList, &numAllocSegs, &numSegs,
-                    nodeInfo, numNodes, densityGrid,
-                    gridSize, cellSize, burgVolFactor);
+        FindDensity(home, segList, &numSegs, nodeInfo, numNodes,
+                    &nodeHash, grid);
+
+        fclose(fpData);
+
+        free(segList);
+        free(nodeInfo);
+        free(nodeHash.slot);
 
         return;
 }
@@ -891,19 +1112,11 @@ static void ProcessNodalData(Home_t *home, FILE *fpData, char *baseFileName,
  *          fileID       file pointer to open HDF5 file.
  *          baseFileName Name of the nodal data file stripped of any
  *                       sequence number suffix.
- *          densityGrid  3-D density grid represented as a single
- *                       dimension array.
- *          gridSize     specifies the size of the density grid in
- *                       X, Y and Z dimensions.
- *          cellSize     length (units of b) of density grid cells
- *                       in X, Y and Z.
- *          burgVolFactor  factor by which segment length is adjusted to
- *                       calculate density.
+ *          grid         density grid to update
  *
  *-------------------------------------------------------------------------*/
 static void ProcessBinNodalData(Home_t *home, hid_t fileID, char *baseFileName,
-                                real8 *densityGrid, int gridSize[3],
-                                real8 cellSize[3], real8 burgVolFactor)
+                                DensityGrid_t *grid)
 {
         int        i;
         int        totNodesRead, status;
@@ -919,6 +1132,7 @@ static void ProcessBinNodalData(Home_t *home, hid_t fileID, char *baseFileName,
         Seg_t      *segList;
         Param_t    *param;
         NodeInfo_t *nodeInfo;
+        NodeHash_t nodeHash;
 
 
         param = home->param;
@@ -941,6 +1155,9 @@ static void ProcessBinNodalData(Home_t *home, hid_t fileID, char *baseFileName,
         numAllocNodes = 0;
         nodeInfo      = (NodeInfo_t *)NULL;
 
+        nodeHash.numSlots = 0;
+        nodeHash.slot     = (int *)NULL;
+
 /*
  *      Find the range of tasks for which data is included in this
  *      first data file segment.
@@ -1046,9 +1263,8 @@ static void ProcessBinNodalData(Home_t *home, hid_t fileID, char *baseFileName,
                 if ((readThisBlock != 0) &&
                     ((readThisBlock + taskNodeCount) > NODE_READ_BLOCK_CNT)) {
 
-                    FindDensity(home, segList, &numAllocSegs, &numSegs,
-                                nodeInfo, numNodes, densityGrid,
-                                gridSize, cellSize, burgVolFactor);
+                    FindDensity(home, segList, &numSegs, nodeInfo, numNodes,
+                                &nodeHash, grid);
 
                     DeleteUnreferencedNodes(nodeInfo, &numNodes);
 
@@ -1165,131 +1381,70 @@ static void ProcessBinNodalData(Home_t *home, hid_t fileID, char *baseFileName,
 /*
  *      Process any remaining segments in the list
  */
-        FindDensity(home, segList, &numAllocSegs, &numSegs,
-                    nodeInfo, numNodes, densityGrid,
-                    gridSize, cellSize, burgVolFactor);
+        FindDensity(home, segList, &numSegs, nodeInfo, numNodes,
+                    &nodeHash, grid);
+
+        free(segList);
+        free(nodeInfo);
+        free(nodeHash.slot);
 
         return;
 }
 #endif
 
 
-main(int argc, char *argv[])
+/*---------------------------------------------------------------------------
+ *
+ *      Function:    CalcFileDensity
+ *      Description: Read a single restart file, calculate the density
+ *                   grid and write it to the output file.
+ *
+ *      Arguments:
+ *          ctrlFile    name of the control file
+ *          dataFile    name of the nodal data file or NULL to use the
+ *                      default name derived from <ctrlFile>
+ *          outFile     name of the density output file or NULL to use
+ *                      the default name derived from <ctrlFile>
+ *          gridSize    specifies the size of the density grid in
+ *                      X, Y and Z dimensions.
+ *          doBinRead   1 if the nodal data is known to be in HDF5 format
+ *          numThreads  number of threads to use for rasterizing the
+ *                      segments into the density grid.
+ *
+ *-------------------------------------------------------------------------*/
+static void CalcFileDensity(char *ctrlFile, char *dataFile, char *outFile,
+                            int gridSize[3], int doBinRead, int numThreads)
 {
-        int         i, j, k, fd, offset, status;
-        int         doBinRead, fileSeqNum;
-        int         numGridElements;
-        int         gridSize[3];
-        real8       cellVol, burgVolFactor;
-        real8       cellSize[3], centerCoord[3];
-        real8       *densityGrid;
-        char        *dataFile, *ctrlFile, *outFile;
-        char        *sep, *start, *argValue, *argTok;
-        char        tmpDataFile[256], tmpOutFile[256], testFile[256];
-        char        tmpFileName[256], baseFileName[256];
-        Home_t      home;
-        Param_t     *param;
-        FILE        *fpData, *fpOut;
-        struct stat statbuf;
+        int           i, j, k, fd, offset, status;
+        int           fileSeqNum;
+        real8         cellVol;
+        real8         centerCoord[3];
+        char          *sep, *start;
+        char          tmpDataFile[256], tmpOutFile[256], testFile[256];
+        char          tmpFileName[256], baseFileName[256];
+        Home_t        home;
+        Param_t       *param;
+        FILE          *fpData, *fpOut;
+        DensityGrid_t grid;
+        struct stat   statbuf;
 #ifdef USE_HDF
-        hid_t       fileID;
+        hid_t         fileID;
 
         fileID = -1;
 #endif
 
-        ctrlFile = (char *)NULL;
-        dataFile = (char *)NULL;
-        outFile  = (char *)NULL;
-
-        doBinRead = 0;
         fileSeqNum = 0;
-
-        gridSize[X] = 25;
-        gridSize[Y] = 25;
-        gridSize[Z] = 25;
+        fpData = (FILE *)NULL;
 
         memset(&home, 0, sizeof(Home_t));
-/*
- *      Get command line options
- */
-        for (i = 1; i < argc; i++) {
-
-            if (!strcmp(argv[i], "-b")) {
-                doBinRead = 1;
-            } else if (!strcmp(argv[i], "-d")) {
-                if (i >= (argc - 1)) {
-                    Usage(argv[0]);
-                    exit(1);
-                }
-                dataFile = argv[++i];
-            } else if (!strcmp(argv[i], "-h")) {
-                Usage(argv[0]);
-                exit(0);
-            } else if (!strcmp(argv[i], "-g")) {
-                if (i >= (argc - 1)) {
-                    Usage(argv[0]);
-                    exit(1);
-                }
-                argValue = argv[++i];
-                argTok = strtok(argValue, ",");
-                gridSize[X] = atoi(argTok);
-                argTok = strtok(NULL, ",");
-                if (argTok == (char *)NULL) {
-                    gridSize[Y] = gridSize[X];
-                    gridSize[Z] = gridSize[X];
-                    continue;
-                }
-                gridSize[Y] = atoi(argTok);
-                argTok = strtok(NULL, ",");
-                if (argTok == (char *)NULL) {
-                    Usage(argv[0]);
-                    exit(1);
-                }
-                gridSize[Z] = atoi(argTok);
-            } else if (!strcmp(argv[i], "-o")) {
-                if (i >= (argc - 1)) {
-                    Usage(argv[0]);
-                    exit(1);
-                }
-                outFile = argv[++i];
-            } else {
-                ctrlFile = argv[i];
-            }
-        }
-
-        if ((gridSize[X] < 1) ||
-            (gridSize[Y] < 1) ||
-            (gridSize[Z] < 1)) {
-            Fatal("Invalid density grid size %dX%dX%d",
-                  gridSize[X], gridSize[Y], gridSize[Z]);
-        }
-
-/*
- *      If no control file was specified, abort.
- */
-        if (ctrlFile == (char *)NULL) {
-            Usage(argv[0]);
-            exit(1);
-        }
-
-/*
- *      Allocate the density grid
- */
-        numGridElements = gridSize[X] * gridSize[Y] * gridSize[Z];
-
-        densityGrid = (real8 *)calloc(1, numGridElements*sizeof(real8));
-
-        if (densityGrid == (real8 *)NULL) {
-            Fatal("calloc error getting density field of size %d elements",
-                  numGridElements);
-        }
 
 /*
  *      If user did not provide an output file name, just use
  *      the control file name with a '.dens' suffix appended.
  */
         if (outFile == (char *)NULL) {
-            sprintf(tmpOutFile, "%s%s", ctrlFile, DENSITY_FILE_SUFFIX);
+            snprintf(tmpOutFile, sizeof(tmpOutFile), "%s%s", ctrlFile,
+                     DENSITY_FILE_SUFFIX);
             outFile = tmpOutFile;
         }
 
@@ -1347,7 +1502,7 @@ main(int argc, char *argv[])
 #ifndef USE_HDF
         if (doBinRead) {
             printf("\nERROR:\n");
-            printf("The specified restart file is apparently a binary\n");
+            printf("The restart file %s is apparently a binary\n", dataFile);
             printf("restart file, but this utility has not been compiled\n");
             printf("with HDF support.  Please recompile with HDF support\n");
             printf("and try again. \n\n");
@@ -1362,70 +1517,84 @@ main(int argc, char *argv[])
         home.dataParamList = (ParamList_t *)calloc(1,sizeof(ParamList_t));
 
 /*
- *      Initialize the control and data parameter lists and read the
- *      control file.
+ *      The parameter parsing and restart header code is shared with
+ *      ParaDiS and was not written to be called concurrently, so only
+ *      one thread at a time reads the parameters of its file.  HDF5
+ *      may not be thread-safe either, so binary restarts are read
+ *      entirely within the critical section.
+ */
+#ifdef _OPENMP
+#pragma omp critical (CALC_DENSITY_READ_PARAMS)
+#endif
+        {
+/*
+ *          Initialize the control and data parameter lists and read the
+ *          control file.
  */
-        CtrlParamInit(param, home.ctrlParamList);
-        DataParamInit(param, home.dataParamList);
+            CtrlParamInit(param, home.ctrlParamList);
+            DataParamInit(param, home.dataParamList);
 
-        ReadControlFile(&home, ctrlFile);
+            ReadControlFile(&home, ctrlFile);
 
 /*
- *      Open up the nodal data file (or first segment) for reading.
- *      If we can't open the file, exit with an error.
+ *          Open up the nodal data file (or first segment) for reading.
+ *          If we can't open the file, exit with an error.
  */
-        snprintf(tmpFileName, sizeof(tmpFileName), "%s", dataFile);
- 
-        if (!strcmp(&tmpFileName[strlen(tmpFileName)-2], ".0")) {
-            tmpFileName[strlen(tmpFileName)-2] = 0;
-        }
+            snprintf(tmpFileName, sizeof(tmpFileName), "%s", dataFile);
+
+            if (!strcmp(&tmpFileName[strlen(tmpFileName)-2], ".0")) {
+                tmpFileName[strlen(tmpFileName)-2] = 0;
+            }
 
-        snprintf(baseFileName, sizeof(baseFileName), "%s", tmpFileName);
+            snprintf(baseFileName, sizeof(baseFileName), "%s", tmpFileName);
 
 
-        if (doBinRead) {
+            if (doBinRead) {
 #ifdef USE_HDF
-            if (stat(dataFile, &statbuf) == 0) {
-                fileID = H5Fopen(baseFileName, H5F_ACC_RDONLY, H5P_DEFAULT);
-                if (fileID < 0) {
-                    Fatal("Error opening file %s to read nodal data",
-                    dataFile);
-                }
-            } else {
-                snprintf(tmpFileName, sizeof(tmpFileName), "%s.%d",
-                         baseFileName, fileSeqNum);
-                fileID = H5Fopen(tmpFileName, H5F_ACC_RDONLY, H5P_DEFAULT);
-                if (fileID < 0) {
-                    Fatal("Error %d opening file %s to read nodal data",
-                          dataFile);
+                if (stat(dataFile, &statbuf) == 0) {
+                    fileID = H5Fopen(baseFileName, H5F_ACC_RDONLY,
+                                     H5P_DEFAULT);
+                    if (fileID < 0) {
+                        Fatal("Error opening file %s to read nodal data",
+                        dataFile);
+                    }
+                } else {
+                    snprintf(tmpFileName, sizeof(tmpFileName), "%s.%d",
+                             baseFileName, fileSeqNum);
+                    fileID = H5Fopen(tmpFileName, H5F_ACC_RDONLY,
+                                     H5P_DEFAULT);
+                    if (fileID < 0) {
+                        Fatal("Error %d opening file %s to read nodal data",
+                              dataFile);
+                    }
                 }
-            }
 #endif
-        } else {
-            if ((fpData = fopen(tmpFileName, "r")) == (FILE *)NULL) {
-                snprintf(tmpFileName, sizeof(tmpFileName), "%s.%d",
-                         baseFileName, fileSeqNum);
+            } else {
                 if ((fpData = fopen(tmpFileName, "r")) == (FILE *)NULL) {
-                    Fatal("Error %d opening file %s to read nodal data",
-                          errno, dataFile);
+                    snprintf(tmpFileName, sizeof(tmpFileName), "%s.%d",
+                             baseFileName, fileSeqNum);
+                    if ((fpData = fopen(tmpFileName, "r")) == (FILE *)NULL) {
+                        Fatal("Error %d opening file %s to read nodal data",
+                              errno, dataFile);
+                    }
                 }
             }
-        }
 
 /*
- *      Read the data file parameters and do some initializations
- *      before reading the rest of the nodal data
+ *          Read the data file parameters and do some initializations
+ *          before reading the rest of the nodal data
  */
-        if (doBinRead) {
+            if (doBinRead) {
 #ifdef USE_HDF
-            status = ReadBinDataParams(&home, fileID);
-            if (status != 0) {
-                Fatal("ReadBinDataFile: Error reading basic params from %s",
-                      dataFile);
-            }
+                status = ReadBinDataParams(&home, fileID);
+                if (status != 0) {
+                    Fatal("ReadBinDataFile: Error reading basic params "
+                          "from %s", dataFile);
+                }
 #endif
-        } else {
-            ReadDataParams(&home, fpData);
+            } else {
+                ReadDataParams(&home, fpData);
+            }
         }
 
 
@@ -1483,11 +1652,18 @@ main(int argc, char *argv[])
         }
 #endif
 
-        burgVolFactor = 1.0 / (param->burgMag * param->burgMag * cellVol);
+        VECTOR_COPY(grid.gridSize, gridSize);
+
+        grid.burgVolFactor = 1.0 / (param->burgMag * param->burgMag * cellVol);
+
+        grid.cellSize[X] = param->Lx / (real8)gridSize[X];
+        grid.cellSize[Y] = param->Ly / (real8)gridSize[Y];
+        grid.cellSize[Z] = param->Lz / (real8)gridSize[Z];
 
-        cellSize[X] = param->Lx / (real8)gridSize[X];
-        cellSize[Y] = param->Ly / (real8)gridSize[Y];
-        cellSize[Z] = param->Lz / (real8)gridSize[Z];
+/*
+ *      Allocate the density grid
+ */
+        InitDensityGrid(&grid, numThreads);
 
 /*
  *      Now need to read the nodal data and process it.  There may
@@ -1501,14 +1677,17 @@ main(int argc, char *argv[])
  */
         if (doBinRead) {
 #ifdef USE_HDF
-            ProcessBinNodalData(&home, fileID, baseFileName, densityGrid,
-                                gridSize, cellSize, burgVolFactor);
+#ifdef _OPENMP
+#pragma omp critical (CALC_DENSITY_READ_PARAMS)
+#endif
+            ProcessBinNodalData(&home, fileID, baseFileName, &grid);
 #endif
         } else {
-            ProcessNodalData(&home, fpData, baseFileName, densityGrid,
-                             gridSize, cellSize, burgVolFactor);
+            ProcessNodalData(&home, fpData, baseFileName, &grid);
         }
-        
+
+        SumThreadGrids(&grid);
+
 /*
  *      Density field has been updated with contributions from
  *      all segments, so now just write out the density file.
@@ -1532,24 +1711,158 @@ main(int argc, char *argv[])
 
         for (i = 0; i < gridSize[X]; i++) {
             centerCoord[X] = param->minCoordinates[X] +
-                             ((0.5 + (real8)i) * cellSize[X]);
+                             ((0.5 + (real8)i) * grid.cellSize[X]);
             for (j = 0; j < gridSize[Y]; j++) {
                 centerCoord[Y] = param->minCoordinates[Y] +
-                                 ((0.5 + (real8)j) * cellSize[Y]);
+                                 ((0.5 + (real8)j) * grid.cellSize[Y]);
                 for (k = 0; k < gridSize[Z]; k++) {
                     centerCoord[Z] = param->minCoordinates[Z] +
-                                     ((0.5 + (real8)k) * cellSize[Z]);
+                                     ((0.5 + (real8)k) * grid.cellSize[Z]);
                     offset = i * gridSize[Y] * gridSize[Z] +
                              j * gridSize[Z] + k;
                     fprintf(fpOut, "%13.5e %13.5e %13.5e %13.5e  "
                             "# cell = %d,%d,%d\n",
                             centerCoord[X], centerCoord[Y], centerCoord[Z],
-                            densityGrid[offset], i, j, k);
+                            grid.densityGrid[offset], i, j, k);
                 }
             }
         }
 
         fclose(fpOut);
 
+/*
+ *      Release everything associated with this file so a long
+ *      series of files does not accumulate memory.
+ */
+        FreeDensityGrid(&grid);
+
+        free(home.ctrlParamList->varList);
+        free(home.dataParamList->varList);
+        free(home.ctrlParamList);
+        free(home.dataParamList);
+        free(home.param);
+
+        return;
+}
+
+
+main(int argc, char *argv[])
+{
+        int         i, numCtrlFiles, numThreads;
+        int         doBinRead;
+        int         gridSize[3];
+        char        *dataFile, *outFile;
+        char        *argValue, *argTok;
+        char        **ctrlFiles;
+
+        dataFile = (char *)NULL;
+        outFile  = (char *)NULL;
+
+        doBinRead = 0;
+
+        gridSize[X] = 25;
+        gridSize[Y] = 25;
+        gridSize[Z] = 25;
+
+        numCtrlFiles = 0;
+        ctrlFiles = (char **)malloc(argc * sizeof(char *));
+
+/*
+ *      Get command line options
+ */
+        for (i = 1; i < argc; i++) {
+
+            if (!strcmp(argv[i], "-b")) {
+                doBinRead = 1;
+            } else if (!strcmp(argv[i], "-d")) {
+                if (i >= (argc - 1)) {
+                    Usage(argv[0]);
+                    exit(1);
+                }
+                dataFile = argv[++i];
+            } else if (!strcmp(argv[i], "-h")) {
+                Usage(argv[0]);
+                exit(0);
+            } else if (!strcmp(argv[i], "-g")) {
+                if (i >= (argc - 1)) {
+                    Usage(argv[0]);
+                    exit(1);
+                }
+                argValue = argv[++i];
+                argTok = strtok(argValue, ",");
+                gridSize[X] = atoi(argTok);
+                argTok = strtok(NULL, ",");
+                if (argTok == (char *)NULL) {
+                    gridSize[Y] = gridSize[X];
+                    gridSize[Z] = gridSize[X];
+                    continue;
+                }
+                gridSize[Y] = atoi(argTok);
+                argTok = strtok(NULL, ",");
+                if (argTok == (char *)NULL) {
+                    Usage(argv[0]);
+                    exit(1);
+                }
+                gridSize[Z] = atoi(argTok);
+            } else if (!strcmp(argv[i], "-o")) {
+                if (i >= (argc - 1)) {
+                    Usage(argv[0]);
+                    exit(1);
+                }
+                outFile = argv[++i];
+            } else {
+                ctrlFiles[numCtrlFiles++] = argv[i];
+            }
+        }
+
+        if ((gridSize[X] < 1) ||
+            (gridSize[Y] < 1) ||
+            (gridSize[Z] < 1)) {
+            Fatal("Invalid density grid size %dX%dX%d",
+                  gridSize[X], gridSize[Y], gridSize[Z]);
+        }
+
+/*
+ *      If no control file was specified, abort.  An explicit data
+ *      or output file name only makes sense for a single file.
+ */
+        if (numCtrlFiles == 0) {
+            Usage(argv[0]);
+            exit(1);
+        }
+
+        if ((numCtrlFiles > 1) &&
+            ((dataFile != (char *)NULL) || (outFile != (char *)NULL))) {
+            Fatal("The -d and -o options may not be used with "
+                  "multiple control files");
+        }
+
+/*
+ *      With a single file, all threads are used to rasterize its
+ *      segments.  With a series of files, each thread processes
+ *      whole files and handles the next available file as soon as
+ *      it finishes the previous one.
+ */
+#ifdef _OPENMP
+        numThreads = (numCtrlFiles > 1) ? 1 : omp_get_max_threads();
+#else
+        numThreads = 1;
+#endif
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) if (numCtrlFiles > 1)
+#endif
+        for (i = 0; i < numCtrlFiles; i++) {
+
+            CalcFileDensity(ctrlFiles[i], dataFile, outFile, gridSize,
+                            doBinRead, numThreads);
+
+            if (numCtrlFiles > 1) {
+                printf("Wrote density for %s\n", ctrlFiles[i]);
+            }
+        }
+
+        free(ctrlFiles);
+
         exit(0);
 }
@@ -543,6 +543,11 @@ static void GetOldStyleDataParams(Home_t *home, FILE *fp)
             param->dataDecompType = param->decompType;
         }
 
+        if ((param->dataDecompType < 1) || (param->dataDecompType > 3)) {
+            Fatal("dataDecompType=%d is invalid.  Type must be 1, 2 or 3\n",
+                  param->dataDecompType);
+        }
+
         param->nXdoms = param->dataDecompGeometry[X];
         param->nYdoms = param->dataDecompGeometry[Y];
         param->nZdoms = param->dataDecompGeometry[Z];
@@ -706,9 +711,17 @@ static void ConvertDataFile(Home_t *home, char *baseDataFileName)
                         param->nYdoms = param->dataDecompGeometry[Y];
                         param->nZdoms = param->dataDecompGeometry[Z];
 
+                        if ((param->dataDecompType < 1) ||
+                            (param->dataDecompType > 3)) {
+                            Fatal("dataDecompType=%d is invalid.  Type must "
+                                  "be 1, 2 or 3\n", param->dataDecompType);
+                        }
+
 /*
  *                      For RB decompositions we need to initialize
  *                      some stuff before we read the decomposition data.
+ *                      SFC decompositions (type 3) only need the cell
+ *                      geometry, which the control file has provided.
  */
                         if (param->decompType == 2) {
                             for (home->xMaxLevel = 0;